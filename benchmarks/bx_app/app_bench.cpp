@@ -0,0 +1,281 @@
+#include <benchmark/benchmark.h>
+#include <bx/app.hpp>
+
+#include <iostream>
+#include <streambuf>
+
+using namespace bx;
+
+bx_register_category(bench, 1)
+
+// Swallows std::cout so unfiltered logs measure formatting, not the terminal
+struct null_streambuf_t : std::streambuf
+{
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+struct cout_silencer_t
+{
+    cout_silencer_t() : prev(std::cout.rdbuf(&buffer)) {}
+    ~cout_silencer_t() { std::cout.rdbuf(prev); }
+
+    null_streambuf_t buffer;
+    std::streambuf* prev;
+};
+
+//
+// Config
+//
+static void config_get_hit(benchmark::State& state)
+{
+    config_set<i32>("bench.value", new i32(42));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(config_get<i32>("bench.value"));
+    state.SetItemsProcessed(state.iterations());
+    config_clear();
+}
+
+static void config_get_miss(benchmark::State& state)
+{
+    for (auto _ : state)
+        benchmark::DoNotOptimize(config_get<i32>("bench.missing"));
+    state.SetItemsProcessed(state.iterations());
+}
+
+//
+// Logging
+//
+static void log_filtered_macro(benchmark::State& state)
+{
+    bx_log_set_category_types(bench, log_t::ERROR);
+    for (auto _ : state)
+        bx_info(bench, "filtered {} {}", 42, 1.5f);
+    state.SetItemsProcessed(state.iterations());
+    bx_log_set_category_types(bench, static_cast<log_t>(0xFF));
+}
+
+static void log_filtered_runtime(benchmark::State& state)
+{
+    bx_log_set_category_types(bench, log_t::ERROR);
+    const category_t category = category_mask<bx_category_bench_t>();
+    for (auto _ : state)
+        log_v(log_t::INFO, category, bx_func, bx_file, bx_line, "filtered");
+    state.SetItemsProcessed(state.iterations());
+    bx_log_set_category_types(bench, static_cast<log_t>(0xFF));
+}
+
+static void log_unfiltered(benchmark::State& state)
+{
+    cout_silencer_t silencer;
+    for (auto _ : state)
+        bx_info(bench, "unfiltered {} {}", 42, 1.5f);
+    state.SetItemsProcessed(state.iterations());
+}
+
+//
+// Profiler
+//
+static void profile_push_pop_idle(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        profile_push(0, "bench", bx_func, bx_file, bx_line);
+        profile_pop();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void profile_push_pop_recording(benchmark::State& state)
+{
+    profile_start();
+    for (auto _ : state)
+    {
+        profile_push(0, "bench", bx_func, bx_file, bx_line);
+        profile_pop();
+    }
+    profile_stop();
+    state.SetItemsProcessed(state.iterations());
+}
+
+//
+// Files
+//
+static void file_get_path_drive(benchmark::State& state)
+{
+    file_add_drive("[bench]", "/tmp/bx_bench");
+    for (auto _ : state)
+        benchmark::DoNotOptimize(file_get_path("[bench]/textures/albedo.png"));
+    state.SetItemsProcessed(state.iterations());
+}
+
+//
+// Frame loop on the Null backends
+//
+static void app_frame(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        app_begin_frame();
+        app_end_frame(true, false);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+//
+// Graphics submission on the Null backend, the cost of bx itself
+//
+struct gfx_bench_scene_t
+{
+    gfx_bench_scene_t()
+    {
+        gfx_shader_desc_t shader_desc{};
+        shader_desc.name = "bench_shader";
+        shader = gfx_create_shader(shader_desc);
+
+        gfx_pipeline_desc_t pipeline_desc{};
+        pipeline_desc.name = "bench_pipeline";
+        pipeline_desc.shaders = array_view<handle_id>{ &shader, 1 };
+        pipeline = gfx_create_pipeline(pipeline_desc);
+
+        gfx_buffer_desc_t buffer_desc{};
+        buffer_desc.name = "bench_buffer";
+        buffer_desc.size = 64 * 1024;
+        buffer_desc.usage = gfx_buffer_usage_t::VERTEX;
+        vertices = gfx_create_buffer(buffer_desc);
+        buffer_desc.usage = gfx_buffer_usage_t::INDEX;
+        indices = gfx_create_buffer(buffer_desc);
+    }
+
+    ~gfx_bench_scene_t()
+    {
+        gfx_destroy_buffer(indices);
+        gfx_destroy_buffer(vertices);
+        gfx_destroy_pipeline(pipeline);
+        gfx_destroy_shader(shader);
+    }
+
+    void draw(handle_id cb, u32 draws) const
+    {
+        const u64 offset = 0;
+        gfx_bind_pipeline(cb, pipeline);
+        gfx_bind_vertex_buffers(cb, 0, 1, &vertices, &offset);
+        gfx_bind_index_buffer(cb, indices);
+        for (u32 i = 0; i < draws; ++i)
+            gfx_draw_indexed(cb, 36, 1, i * 36);
+    }
+
+    handle_id shader{};
+    handle_id pipeline{};
+    handle_id vertices{};
+    handle_id indices{};
+};
+
+static void gfx_draw_immediate(benchmark::State& state)
+{
+    const gfx_bench_scene_t scene{};
+    const u32 draws = static_cast<u32>(state.range(0));
+    for (auto _ : state)
+        scene.draw(invalid_handle, draws);
+    state.SetItemsProcessed(state.iterations() * draws);
+}
+
+static void gfx_draw_command_buffer(benchmark::State& state)
+{
+    const gfx_bench_scene_t scene{};
+    const u32 draws = static_cast<u32>(state.range(0));
+    for (auto _ : state)
+    {
+        const handle_id cb = gfx_begin_command_buffer();
+        scene.draw(cb, draws);
+        gfx_submit(cb);
+    }
+    state.SetItemsProcessed(state.iterations() * draws);
+}
+
+static void gfx_draw_logged(benchmark::State& state)
+{
+    const gfx_bench_scene_t scene{};
+    const u32 draws = static_cast<u32>(state.range(0));
+    gfx_null_set_logging(true);
+    for (auto _ : state)
+    {
+        scene.draw(invalid_handle, draws);
+        gfx_null_clear_log();
+    }
+    gfx_null_set_logging(false);
+    state.SetItemsProcessed(state.iterations() * draws);
+}
+
+// Replays a captured frame, e.g. one dumped by an application
+static void gfx_replay_frame(benchmark::State& state)
+{
+    const gfx_bench_scene_t scene{};
+    const u32 draws = static_cast<u32>(state.range(0));
+    gfx_null_set_logging(true);
+    gfx_null_clear_log();
+    scene.draw(invalid_handle, draws);
+    gfx_null_set_logging(false);
+
+    array<gfx_null_command_t> frame{};
+    for (const auto& command : gfx_null_get_log())
+        frame.push_back(command);
+    gfx_null_clear_log();
+
+    for (auto _ : state)
+        gfx_null_replay(array_view<gfx_null_command_t>{ frame });
+    state.SetItemsProcessed(state.iterations() * draws);
+}
+
+//
+// Vertex quantization, per vertex of a typical mesh stream
+//
+static void gfx_quantize_mesh(benchmark::State& state)
+{
+    const usize vertices = static_cast<usize>(state.range(0));
+    array<f32> positions{};
+    array<f32> tangents{};
+    array<f32> uvs{};
+    positions.resize(vertices * 3);
+    tangents.resize(vertices * 4);
+    uvs.resize(vertices * 2);
+    for (usize i = 0; i < positions.size(); ++i)
+        positions[i] = static_cast<f32>(i % 97) * 0.25f;
+    for (usize i = 0; i < tangents.size(); ++i)
+        tangents[i] = static_cast<f32>(i % 7) / 3.0f - 1.0f;
+    for (usize i = 0; i < uvs.size(); ++i)
+        uvs[i] = static_cast<f32>(i % 31) / 30.0f;
+
+    array<u16> q_positions{};
+    array<u32> q_tangents{};
+    array<u16> q_uvs{};
+    q_positions.resize(vertices * 4);
+    q_tangents.resize(vertices);
+    q_uvs.resize(vertices * 2);
+
+    const f32 min[3] = { 0.0f, 0.0f, 0.0f };
+    const f32 max[3] = { 24.0f, 24.0f, 24.0f };
+    for (auto _ : state)
+    {
+        gfx_quantize_positions(positions.data(), q_positions.data(), vertices, min, max);
+        gfx_quantize_snorm_10_10_10_2(tangents.data(), q_tangents.data(), vertices);
+        gfx_quantize_f16(uvs.data(), q_uvs.data(), vertices * 2);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * vertices);
+}
+
+BENCHMARK(config_get_hit);
+BENCHMARK(config_get_miss);
+BENCHMARK(log_filtered_macro);
+BENCHMARK(log_filtered_runtime);
+BENCHMARK(log_unfiltered);
+BENCHMARK(profile_push_pop_idle);
+BENCHMARK(profile_push_pop_recording);
+BENCHMARK(file_get_path_drive);
+BENCHMARK(app_frame);
+BENCHMARK(gfx_draw_immediate)->Arg(1000);
+BENCHMARK(gfx_draw_command_buffer)->Arg(1000);
+BENCHMARK(gfx_draw_logged)->Arg(1000);
+BENCHMARK(gfx_replay_frame)->Arg(1000);
+BENCHMARK(gfx_quantize_mesh)->Arg(65536);
@@ -0,0 +1,32 @@
+#include <benchmark/benchmark.h>
+
+#ifdef BX_BENCH_APP
+#include <bx/app.hpp>
+#endif
+
+// Pass --benchmark_out=<file> --benchmark_out_format=json to keep results,
+// the bx_bench_json target does this for regression tracking between releases.
+int main(int argc, char** argv)
+{
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+
+#ifdef BX_BENCH_APP
+    // Null device and gfx backends, no window or GPU needed
+    bx::app_config_t config{};
+    config.width = 1280;
+    config.height = 720;
+    config.title = "bx_bench";
+    if (bx::app_init(config) != bx::result_t::OK)
+        return 1;
+#endif
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+#ifdef BX_BENCH_APP
+    bx::app_shutdown();
+#endif
+    return 0;
+}
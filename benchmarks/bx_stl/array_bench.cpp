@@ -0,0 +1,101 @@
+#include <benchmark/benchmark.h>
+#include <bx/array.hpp>
+
+#include <vector>
+
+using namespace bx;
+
+//
+// Adapters so both containers run the exact same benchmark body
+//
+struct bx_array_t
+{
+    array<u64> arr;
+
+    void push_back(u64 v) { arr.push_back(v); }
+    void reserve(usize n) { arr.reserve(n); }
+    usize size() const { return arr.size(); }
+};
+
+struct std_vector_t
+{
+    std::vector<u64> arr;
+
+    void push_back(u64 v) { arr.push_back(v); }
+    void reserve(usize n) { arr.reserve(n); }
+    usize size() const { return arr.size(); }
+};
+
+template <typename A>
+static void array_push_back(benchmark::State& state)
+{
+    const usize count = static_cast<usize>(state.range(0));
+    for (auto _ : state)
+    {
+        A a;
+        for (usize i = 0; i < count; ++i)
+            a.push_back(i);
+        benchmark::DoNotOptimize(a.arr);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename A>
+static void array_push_back_reserved(benchmark::State& state)
+{
+    const usize count = static_cast<usize>(state.range(0));
+    for (auto _ : state)
+    {
+        A a;
+        a.reserve(count);
+        for (usize i = 0; i < count; ++i)
+            a.push_back(i);
+        benchmark::DoNotOptimize(a.arr);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename A>
+static void array_move(benchmark::State& state)
+{
+    const usize count = static_cast<usize>(state.range(0));
+    A a;
+    for (usize i = 0; i < count; ++i)
+        a.push_back(i);
+
+    for (auto _ : state)
+    {
+        A b;
+        b.arr = std::move(a.arr);
+        benchmark::DoNotOptimize(b.arr);
+        a.arr = std::move(b.arr);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <typename A>
+static void array_iterate(benchmark::State& state)
+{
+    const usize count = static_cast<usize>(state.range(0));
+    A a;
+    for (usize i = 0; i < count; ++i)
+        a.push_back(i);
+
+    for (auto _ : state)
+    {
+        u64 sum = 0;
+        for (const u64 v : a.arr)
+            sum += v;
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(array_push_back, bx_array_t)->Range(64, 1 << 18);
+BENCHMARK_TEMPLATE(array_push_back, std_vector_t)->Range(64, 1 << 18);
+BENCHMARK_TEMPLATE(array_push_back_reserved, bx_array_t)->Range(64, 1 << 18);
+BENCHMARK_TEMPLATE(array_push_back_reserved, std_vector_t)->Range(64, 1 << 18);
+BENCHMARK_TEMPLATE(array_move, bx_array_t)->Arg(1 << 10);
+BENCHMARK_TEMPLATE(array_move, std_vector_t)->Arg(1 << 10);
+BENCHMARK_TEMPLATE(array_iterate, bx_array_t)->Range(64, 1 << 18);
+BENCHMARK_TEMPLATE(array_iterate, std_vector_t)->Range(64, 1 << 18);
@@ -0,0 +1,113 @@
+#include <benchmark/benchmark.h>
+#include <bx/hash_map.hpp>
+
+#include <unordered_map>
+#include <vector>
+#include <random>
+
+using namespace bx;
+
+//
+// Adapters so both containers run the exact same benchmark body
+//
+struct bx_map_t
+{
+    hash_map<u64, u64> map;
+
+    void insert(u64 k, u64 v) { map.insert(k, v); }
+    bool find(u64 k) const { return map.get(k) != nullptr; }
+    void erase(u64 k) { map.erase(k); }
+};
+
+struct std_map_t
+{
+    std::unordered_map<u64, u64> map;
+
+    void insert(u64 k, u64 v) { map.insert(std::make_pair(k, v)); }
+    bool find(u64 k) const { return map.find(k) != map.end(); }
+    void erase(u64 k) { map.erase(k); }
+};
+
+static std::vector<u64> make_keys(usize count, u64 seed)
+{
+    std::mt19937_64 rng(seed);
+    std::vector<u64> keys(count);
+    for (auto& k : keys)
+        k = rng();
+    return keys;
+}
+
+template <typename M>
+static void hash_map_insert(benchmark::State& state)
+{
+    const auto keys = make_keys(static_cast<usize>(state.range(0)), 1);
+    for (auto _ : state)
+    {
+        M m;
+        for (const u64 k : keys)
+            m.insert(k, k);
+        benchmark::DoNotOptimize(m.map);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename M>
+static void hash_map_find_hit(benchmark::State& state)
+{
+    const auto keys = make_keys(static_cast<usize>(state.range(0)), 1);
+    M m;
+    for (const u64 k : keys)
+        m.insert(k, k);
+
+    for (auto _ : state)
+    {
+        for (const u64 k : keys)
+            benchmark::DoNotOptimize(m.find(k));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename M>
+static void hash_map_find_miss(benchmark::State& state)
+{
+    const auto keys = make_keys(static_cast<usize>(state.range(0)), 1);
+    const auto misses = make_keys(static_cast<usize>(state.range(0)), 2);
+    M m;
+    for (const u64 k : keys)
+        m.insert(k, k);
+
+    for (auto _ : state)
+    {
+        for (const u64 k : misses)
+            benchmark::DoNotOptimize(m.find(k));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename M>
+static void hash_map_erase(benchmark::State& state)
+{
+    const auto keys = make_keys(static_cast<usize>(state.range(0)), 1);
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        M m;
+        for (const u64 k : keys)
+            m.insert(k, k);
+        state.ResumeTiming();
+
+        for (const u64 k : keys)
+            m.erase(k);
+        benchmark::DoNotOptimize(m.map);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(hash_map_insert, bx_map_t)->Range(64, 1 << 18);
+BENCHMARK_TEMPLATE(hash_map_insert, std_map_t)->Range(64, 1 << 18);
+BENCHMARK_TEMPLATE(hash_map_find_hit, bx_map_t)->Range(64, 1 << 18);
+BENCHMARK_TEMPLATE(hash_map_find_hit, std_map_t)->Range(64, 1 << 18);
+BENCHMARK_TEMPLATE(hash_map_find_miss, bx_map_t)->Range(64, 1 << 18);
+BENCHMARK_TEMPLATE(hash_map_find_miss, std_map_t)->Range(64, 1 << 18);
+BENCHMARK_TEMPLATE(hash_map_erase, bx_map_t)->Range(64, 1 << 18);
+BENCHMARK_TEMPLATE(hash_map_erase, std_map_t)->Range(64, 1 << 18);
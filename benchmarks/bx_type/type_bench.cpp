@@ -0,0 +1,37 @@
+#include <benchmark/benchmark.h>
+#include <bx/type.hpp>
+
+using namespace bx;
+
+struct bench_component_t
+{
+    f32 x, y, z;
+};
+
+bx_register_type(bench_component_t)
+
+static void type_id_lookup(benchmark::State& state)
+{
+    for (auto _ : state)
+        benchmark::DoNotOptimize(type_id<bench_component_t>());
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void type_name_by_id(benchmark::State& state)
+{
+    const type_t id = type_id<bench_component_t>();
+    for (auto _ : state)
+        benchmark::DoNotOptimize(type_name(id));
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void type_name_by_type(benchmark::State& state)
+{
+    for (auto _ : state)
+        benchmark::DoNotOptimize(type_name<bench_component_t>());
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(type_id_lookup);
+BENCHMARK(type_name_by_id);
+BENCHMARK(type_name_by_type);
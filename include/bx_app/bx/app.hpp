@@ -7,16 +7,25 @@
 #include <bx/string.hpp>
 #include <fmt/format.h>
 
-#define bx_register_category(T) \
-	struct bx_api bx_category_##T##_t {}; \
-	template<> inline bx::category_t bx::category_mask<bx_category_##T##_t>() noexcept { static const auto c = bx::register_category(#T); return c; }
+#include <atomic>
+
+// Categories own a fixed bit (0-63) so they can be filtered at compile time
+// with BX_LOG_CATEGORY_MASK and looked up in flat per-category tables.
+#define bx_register_category(T, bit) \
+	struct bx_api bx_category_##T##_t { static constexpr u32 id = bit; static_assert(bit < 64, "category bit must be below 64"); }; \
+	template<> inline bx::category_t bx::category_mask<bx_category_##T##_t>() noexcept { static const auto c = bx::register_category(#T, bit); return c; }
+
+#ifndef BX_LOG_CATEGORY_MASK
+#define BX_LOG_CATEGORY_MASK (~0ull)
+#endif
 
 #define bx_log_set_category_types(T, types) bx::log_set_category_types(bx::category_mask<bx_category_##T##_t>(), types)
 
 #if (BX_LOG_LEVEL > 0)
 #define _bx_log(T, lvl, fstr, ...) bx::logf(lvl, fstr, ##__VA_ARGS__)
-#define _bx_log_v(T, lvl, fstr, ...) bx::logf_v(lvl, bx::category_mask<bx_category_##T##_t>(), bx_func, bx_file, bx_line, fstr, ##__VA_ARGS__)
-#define bx_fatal(T, fstr, ...) _bx_log_v(T, bx::log_t::FATAL, fstr, ##__VA_ARGS__)
+#define _bx_log_v(T, lvl, fstr, ...) do { if (bx::log_enabled<bx_category_##T##_t>(lvl)) bx::logf_v(lvl, bx::category_mask<bx_category_##T##_t>(), bx_func, bx_file, bx_line, fstr, ##__VA_ARGS__); } while (0)
+// Fatal errors and failed asserts are never filtered by category
+#define bx_fatal(T, fstr, ...) bx::logf_v(bx::log_t::FATAL, bx::category_mask<bx_category_##T##_t>(), bx_func, bx_file, bx_line, fstr, ##__VA_ARGS__)
 #define bx_assert(expr, msg) do { if (!(expr)) { bx_fatal(bx, "Assertion failed '{}'", msg); } } while (0)
 #define bx_ensure(expr) bx_assert(expr, #expr)
 #else
@@ -52,8 +61,8 @@
 
 namespace bx
 {
-	// TODO: Lets rethink how categories are done, atm not very clean design
-	bx_api category_t register_category(cstring name) noexcept;
+	// Returns the category's mask, a bit already claimed by another name is fatal
+	bx_api category_t register_category(cstring name, u32 bit) noexcept;
 
 	template<typename>
 	category_t category_mask() noexcept { return 0; }
@@ -75,6 +84,12 @@ namespace bx
 		i32 height{ 0 };
 		cstring title{ nullptr };
 		bool vsync{ true };
+		usize frame_memory{ 4 * 1024 * 1024 };
+		usize upload_memory{ 12 * 1024 * 1024 }; // gfx upload ring, split between the frames in flight
+		cstring shader_cache{ nullptr };		// directory for compiled shaders, e.g. "[cache]/shaders", nullptr disables
+		bool shader_cache_warmup{ true };		// read last run's binaries on a background thread at startup
+		bool watch_files{ true };				// report changes under the file drives, see file_watch_subscribe
+		u32 gfx_stats_history{ 240 };			// frames kept by gfx_get_frame_stats_history
 	};
 
 	bx_api result_t app_init(const app_config_t& config) noexcept;
@@ -93,6 +108,13 @@ namespace bx
 
 	bx_api u64 app_timestamp_ns() noexcept;
 
+	// Transient memory reset at the start of every app_begin_frame(), sized by
+	// app_config_t::frame_memory. Nothing allocated here may outlive the frame.
+	bx_api linear_allocator& app_frame_allocator() noexcept;
+
+	template <typename T>
+	using frame_array = array<T, allocator_ref<linear_allocator>>;
+
 	// ------------------------------------------
 	// -             Logging API                -
 	// ------------------------------------------
@@ -113,22 +135,184 @@ namespace bx
 
 	bx_api void log_set_category_types(category_t category, log_t types) noexcept;
 
+	namespace detail
+	{
+		// Levels turned off per category bit, zero (all on) until log_set_category_types
+		extern bx_api std::atomic<u8> log_disabled[64];
+	}
+
+	// Compile-time category filter plus one load and one branch at runtime
+	template <typename C>
+	bx_force_inline bool log_enabled(log_t level) noexcept
+	{
+		return (BX_LOG_CATEGORY_MASK & (1ull << C::id)) != 0
+			&& (detail::log_disabled[C::id].load(std::memory_order_relaxed) & static_cast<u8>(level)) == 0;
+	}
+
 	bx_api void log(log_t level, cstring str) noexcept;
 
 	template<typename... Args>
 	inline void logf(log_t level, cstring fstr, Args&&... args) noexcept
 	{
-		auto str = fmt::format(fstr, std::forward<Args>(args)...);
-		log(level, str.c_str());
+		fmt::memory_buffer str;
+		fmt::format_to(std::back_inserter(str), fstr, std::forward<Args>(args)...);
+		str.push_back('\0');
+		log(level, str.data());
 	}
 
 	bx_api void log_v(log_t level, category_t category, cstring func, cstring file, i32 line, cstring str) noexcept;
 
+	// Async mode: logf_v only copies the format string pointer and its packed
+	// arguments into a lock-free queue, a background thread formats, calls the
+	// log callback and writes in batches. The format string must be a literal.
+	// FATAL drains the queue before crashing. Toggle it while no other thread
+	// logs, app_shutdown() turns it off.
+	// A full queue blocks producers while the writer makes progress, messages
+	// that can't get in once it stalls are dropped and counted.
+	bx_api void log_set_async(bool enabled) noexcept;
+	bx_api bool log_is_async() noexcept;
+
+	// Blocks until every queued message has been written, returns at once
+	// when called from the writer thread, e.g. inside the log callback
+	bx_api void log_flush() noexcept;
+
+	// Messages dropped because the async queue stayed full
+	bx_api u64 log_dropped_count() noexcept;
+
+	namespace detail
+	{
+		enum struct log_arg_t : u8
+		{
+			BOOL, CHAR, I64, U64, F32, F64, STRING, POINTER
+		};
+
+		// Arguments packed as [type][value] pairs, strings as [type][u16 length][chars]
+		struct bx_api log_args_t
+		{
+			u8 data[384];
+			u16 size{ 0 };
+			u8 count{ 0 };
+		};
+
+		template <typename T>
+		struct log_string_arg : std::integral_constant<bool,
+			std::is_convertible<T, cstring>::value || std::is_convertible<T, string_view>::value
+			|| std::is_same<T, std::string>::value> {};
+
+		template <typename T>
+		struct log_packable : std::integral_constant<bool,
+			std::is_arithmetic<T>::value || std::is_pointer<T>::value || log_string_arg<T>::value> {};
+
+		template <typename... Args>
+		struct log_all_packable : std::true_type {};
+
+		template <typename T, typename... Args>
+		struct log_all_packable<T, Args...> : std::integral_constant<bool,
+			log_packable<typename std::decay<T>::type>::value && log_all_packable<Args...>::value> {};
+
+		inline bool log_pack_raw(log_args_t& args, log_arg_t type, cvptr data, usize size) noexcept
+		{
+			if (args.size + 1 + size > sizeof(args.data))
+				return false;
+
+			args.data[args.size] = static_cast<u8>(type);
+			std::memcpy(args.data + args.size + 1, data, size);
+			args.size = static_cast<u16>(args.size + 1 + size);
+			++args.count;
+			return true;
+		}
+
+		inline bool log_pack_string(log_args_t& args, cstring str, usize len) noexcept
+		{
+			if (!str || len > 0xFFFF || args.size + 3 + len > sizeof(args.data))
+				return false;
+
+			const u16 len16 = static_cast<u16>(len);
+			args.data[args.size] = static_cast<u8>(log_arg_t::STRING);
+			std::memcpy(args.data + args.size + 1, &len16, sizeof(len16));
+			std::memcpy(args.data + args.size + 3, str, len);
+			args.size = static_cast<u16>(args.size + 3 + len);
+			++args.count;
+			return true;
+		}
+
+		inline bool log_pack(log_args_t& args, bool value) noexcept { return log_pack_raw(args, log_arg_t::BOOL, &value, sizeof(value)); }
+		inline bool log_pack(log_args_t& args, char value) noexcept { return log_pack_raw(args, log_arg_t::CHAR, &value, sizeof(value)); }
+		inline bool log_pack(log_args_t& args, f32 value) noexcept { return log_pack_raw(args, log_arg_t::F32, &value, sizeof(value)); }
+		inline bool log_pack(log_args_t& args, f64 value) noexcept { return log_pack_raw(args, log_arg_t::F64, &value, sizeof(value)); }
+		inline bool log_pack(log_args_t& args, long double value) noexcept { return log_pack(args, static_cast<f64>(value)); }
+		inline bool log_pack(log_args_t& args, cstring value) noexcept { return log_pack_string(args, value, value ? std::strlen(value) : 0); }
+		inline bool log_pack(log_args_t& args, char* value) noexcept { return log_pack(args, static_cast<cstring>(value)); }
+		inline bool log_pack(log_args_t& args, string_view value) noexcept { return log_pack_string(args, value.cstr, value.size); }
+		inline bool log_pack(log_args_t& args, const std::string& value) noexcept { return log_pack_string(args, value.data(), value.size()); }
+
+		template <typename A>
+		inline bool log_pack(log_args_t& args, const basic_string<A>& value) noexcept { return log_pack_string(args, value.data(), value.size()); }
+
+		template <usize N>
+		inline bool log_pack(log_args_t& args, const string_fixed<N>& value) noexcept { return log_pack_string(args, value.data(), value.size()); }
+
+		template <typename T>
+		inline typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value, bool>::type
+			log_pack(log_args_t& args, T value) noexcept
+		{
+			const i64 v = static_cast<i64>(value);
+			return log_pack_raw(args, log_arg_t::I64, &v, sizeof(v));
+		}
+
+		template <typename T>
+		inline typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value, bool>::type
+			log_pack(log_args_t& args, T value) noexcept
+		{
+			const u64 v = static_cast<u64>(value);
+			return log_pack_raw(args, log_arg_t::U64, &v, sizeof(v));
+		}
+
+		template <typename T>
+		inline bool log_pack(log_args_t& args, T* value) noexcept
+		{
+			const cvptr v = value;
+			return log_pack_raw(args, log_arg_t::POINTER, &v, sizeof(v));
+		}
+
+		inline bool log_pack_all(log_args_t&) noexcept { return true; }
+
+		template <typename T, typename... Args>
+		inline bool log_pack_all(log_args_t& args, const T& value, const Args&... rest) noexcept
+		{
+			return log_pack(args, value) && log_pack_all(args, rest...);
+		}
+
+		template <typename... Args>
+		inline bool log_try_async(std::false_type, log_t, category_t, cstring, cstring, i32, cstring, const Args&...) noexcept
+		{
+			return false;
+		}
+
+		bx_api bool log_push(log_t level, category_t category, cstring func, cstring file, i32 line, cstring fstr, const log_args_t& args) noexcept;
+
+		template <typename... Args>
+		inline bool log_try_async(std::true_type, log_t level, category_t category, cstring func, cstring file, i32 line, cstring fstr, const Args&... args) noexcept
+		{
+			if (!log_is_async())
+				return false;
+
+			log_args_t packed;
+			return log_pack_all(packed, args...) && log_push(level, category, func, file, line, fstr, packed);
+		}
+	}
+
 	template<typename... Args>
 	inline void logf_v(log_t level, category_t category, cstring func, cstring file, i32 line, cstring fstr, Args&&... args) noexcept
 	{
-		auto str = fmt::format(fstr, std::forward<Args>(args)...);
-		log_v(level, category, func, file, line, str.c_str());
+		// Argument types the queue cannot carry, or a full record, fall back to formatting here
+		if (detail::log_try_async(detail::log_all_packable<Args...>{}, level, category, func, file, line, fstr, args...))
+			return;
+
+		fmt::memory_buffer str;
+		fmt::format_to(std::back_inserter(str), fstr, std::forward<Args>(args)...);
+		str.push_back('\0');
+		log_v(level, category, func, file, line, str.data());
 	}
 
 	// ------------------------------------------
@@ -139,6 +323,7 @@ namespace bx
 	{
 		u64 category{ 0 };
 		u32 depth{ 0 };
+		u32 thread_id{ 0 };
 		u64 start_ts{ 0 };
 		u64 end_ts{ 0 };
 		cstring label{ nullptr };
@@ -148,13 +333,34 @@ namespace bx
 
 	bx_api void profile_start() noexcept;
 	bx_api void profile_stop() noexcept;
+
+	// Merges every thread's recent entries since profile_start(), ordered by start time.
+	// The view stays valid until the next call, call it from a single thread.
 	bx_api array_view<profile_entry_t> profile_get_entries() noexcept;
 
 	bx_api void profile_push(u64 category, cstring label, cstring func, cstring file, i32 line) noexcept;
 	bx_api void profile_pop() noexcept;
 
+	// Functions of the calling thread's open scopes, outermost first
 	bx_api array_view<cstring> profile_get_stack() noexcept;
 
+	enum struct profile_format_t : u8
+	{
+		CHROME_JSON,	// Chrome Trace Event format, chrome://tracing and ui.perfetto.dev
+		PERFETTO,		// Perfetto protobuf trace
+	};
+
+	// Streams captured entries to a file in fixed-size chunks. Call flush
+	// periodically (e.g. once per frame) during long captures so the rings
+	// never wrap over unexported entries, scopes still open are written once
+	// they close. Only one export can be active at a time.
+	bx_api bool profile_export_begin(cstring filepath, profile_format_t format) noexcept;
+	bx_api bool profile_export_flush() noexcept;
+	bx_api bool profile_export_end() noexcept;
+
+	// One-shot export of everything still held by the rings
+	bx_api bool profile_export(cstring filepath, profile_format_t format) noexcept;
+
 	struct bx_api profile_t
 	{
 		explicit profile_t(u64 category, cstring label, cstring func, cstring file, i32 line) noexcept
@@ -172,12 +378,24 @@ namespace bx
 
 	bx_api bool file_add_drive(cstring drive, cstring root) noexcept;
 
-	bx_api string file_get_path(cstring filename) noexcept;
+	bx_api string_fixed<512> file_get_path(cstring filename) noexcept;
 
 	bx_api string_view file_get_ext(cstring filename) noexcept;
 
 	bx_api u64 file_get_timestamp(cstring filename) noexcept;
 
+	// Files written under the drives since the last frame, as "[drive]/path"
+	using file_watch_fn = void (*)(vptr user, array_view<cstring> paths);
+
+	// Called from app_begin_frame when files changed. A background thread gathers
+	// the changes (inotify on Linux, no watcher elsewhere yet) so nothing polls
+	// the disk. A file is reported once its writes settled. Graphics thread
+	// only, callbacks may subscribe and unsubscribe, new subscribers are called
+	// from the next change on.
+	bx_api handle_id file_watch_subscribe(file_watch_fn callback, vptr user) noexcept;
+
+	bx_api void file_watch_unsubscribe(handle_id subscription) noexcept;
+
 	// ------------------------------------------
 	// -          Configuration API             -
 	// ------------------------------------------
@@ -196,14 +414,14 @@ namespace bx
 	void config_set(cstring name, T* data, config_freefn_t free = nullptr) noexcept
 	{
 		const u64 type = type_id<T>();
-		config_set(type, name, data, free ? free : [](cvptr ptr) { delete static_cast<T*>(ptr); });
+		config_set(type, name, data, free ? free : [](cvptr ptr) { delete static_cast<const T*>(ptr); });
 	}
 
 	template<typename T>
 	T* config_get(cstring name) noexcept
 	{
 		const u64 type = type_id<T>();
-		return static_cast<T*>(config_get(type, name));
+		return static_cast<T*>(const_cast<vptr>(config_get(type, name)));
 	}
 
 	template<typename T>
@@ -253,18 +471,36 @@ namespace bx
 
 	enum struct gfx_topology_t : u8 { TRIANGLES, TRIANGLE_STRIP, LINES, LINE_STRIP, POINTS };
 
-	enum struct gfx_attribute_format_t : u8 { FLOAT32 };
+	// SNORM and UNORM read as floats in [-1, 1] and [0, 1], UINT as integers
+	// (uint, uvec). INT_2_10_10_10_REV packs a signed xyzw into 4 bytes, needs a
+	// count of 4 and is normalized when the attribute says so.
+	enum struct gfx_attribute_format_t : u8
+	{
+		FLOAT32, FLOAT16,
+		SNORM8, UNORM8, SNORM16, UNORM16,
+		UINT8, UINT16,
+		INT_2_10_10_10_REV
+	};
 
 	enum struct gfx_resource_type_t : u8
 	{
 		COMBINED_IMAGE_SAMPLER, STORAGE_IMAGE, UNIFORM_BUFFER, STORAGE_BUFFER, SAMPLER, TEXTURE
 	};
 
-	enum struct gfx_buffer_usage_t : u8 { VERTEX, INDEX, UNIFORM, STORAGE, INDIRECT };
+	enum struct gfx_buffer_usage_t : u8 { VERTEX, INDEX, UNIFORM, STORAGE, INDIRECT, STAGING };
+
+	enum struct gfx_index_type_t : u8 { UINT16, UINT32 };
 
 	enum struct gfx_memory_usage_t : u8 { GPU_ONLY, CPU_TO_GPU, GPU_TO_CPU };
 
-	enum struct gfx_texture_format_t : u8 { R8U_NORM, RG8U_NORM, RGBA8U_NORM, RGBA16F, DEPTH24_STENCIL8 };
+	// BC, ETC2 and ASTC formats store 4x4 texel blocks, regions of those start on
+	// block boundaries and their rows are always tightly packed
+	enum struct gfx_texture_format_t : u8
+	{
+		R8U_NORM, RG8U_NORM, RGBA8U_NORM, RGBA16F, DEPTH24_STENCIL8,
+		BC1U_NORM, BC3U_NORM, BC4U_NORM, BC5U_NORM, BC7U_NORM,
+		ETC2_RGB8U_NORM, ETC2_RGBA8U_NORM, ASTC_4X4U_NORM
+	};
 
 	enum struct gfx_texture_filter_t : u8 { NEAREST, LINEAR };
 
@@ -312,6 +548,7 @@ namespace bx
 		u32 height{ 0 };
 		u32 depth{ 1 };
 		u8 mip_levels{ 1 };
+		u8 first_mip{ 0 }; // finest mip given storage, see gfx_set_texture_resident_mips
 		gfx_texture_filter_t min_filter{ gfx_texture_filter_t::NEAREST };
 		gfx_texture_filter_t mag_filter{ gfx_texture_filter_t::NEAREST };
 		gfx_texture_wrap_t wrap_u{ gfx_texture_wrap_t::CLAMP_TO_EDGE };
@@ -324,9 +561,13 @@ namespace bx
 		u8 mip_level{ 0 };
 		i32 x{ 0 };
 		i32 y{ 0 };
+		i32 z{ 0 };
 		u32 width{ 0 };
 		u32 height{ 0 };
-		u32 row_stride{ 0 };
+		u32 depth{ 1 };
+		u32 layer{ 0 };		// cube face, in +X -X +Y -Y +Z -Z order
+		u32 row_stride{ 0 };	// bytes, 0 when rows are tightly packed
+		u64 offset{ 0 };		// into the source data or buffer
 	};
 
 	struct bx_api gfx_vertex_attribute_t
@@ -357,8 +598,18 @@ namespace bx
 		bool blend_enable{ false };
 	};
 
+	struct bx_api gfx_resource_layout_binding_t
+	{
+		u32 set{ 0 };
+		u32 binding{ 0 };
+		gfx_resource_type_t type{};
+	};
+
+	// What the shaders of a pipeline declare. GL reads the bindings from the
+	// shaders themselves, the Null backend checks bound sets against it.
 	struct bx_api gfx_resource_layout_t
 	{
+		array_view<gfx_resource_layout_binding_t> bindings{};
 	};
 
 	struct bx_api gfx_pipeline_desc_t
@@ -372,10 +623,29 @@ namespace bx
 		array_view<gfx_color_blend_attachment_t> color_attachments{};
 	};
 
+	// Uniform buffers, storage buffers, sampled textures and storage images each
+	// number their bindings on their own, as GL binding points and texture and
+	// image units do. TEXTURE and COMBINED_IMAGE_SAMPLER are the same in GL, the
+	// texture samples with its own filter and wrap modes.
+	struct bx_api gfx_resource_binding_t
+	{
+		u32 binding{ 0 };
+		gfx_resource_type_t type{};
+		handle_id resource{ invalid_handle };	// buffer or texture
+		u64 offset{ 0 };						// buffers only
+		u64 size{ 0 };							// buffers only, 0 runs to the end of the buffer
+	};
+
+	// Sets are baked at creation and bound with one call per resource type.
+	// With bindless, sampled textures instead go into a table of resident handles
+	// bound as the storage buffer table_binding, indexed by texture binding:
+	//   layout(std430, binding = N) readonly buffer textures { sampler2D tex[]; };
 	struct bx_api gfx_resource_set_desc_t
 	{
 		cstring name{ nullptr };
-		//array_view<gfx_resource_binding_t> bindings{};
+		array_view<gfx_resource_binding_t> bindings{};
+		bool bindless{ false };		// ignored unless supports_bindless_textures
+		u32 table_binding{ 0 };
 	};
 
 	struct bx_api gfx_attachment_desc_t
@@ -426,6 +696,48 @@ namespace bx
 		gfx_shader_stage_t dst_stage{};
 	};
 
+	// Layouts of the records read from INDIRECT buffers, they match GL and Vulkan
+	struct bx_api gfx_draw_indirect_command_t
+	{
+		u32 vertex_count;
+		u32 instance_count;
+		u32 first_vertex;
+		u32 first_instance;
+	};
+
+	struct bx_api gfx_draw_indexed_indirect_command_t
+	{
+		u32 index_count;
+		u32 instance_count;
+		u32 first_index;
+		i32 vertex_offset;
+		u32 first_instance;
+	};
+
+	// Input of gfx_cull_instances, 32 bytes to match the std430 layout
+	struct bx_api gfx_cull_instance_t
+	{
+		f32 center[3];	// bounding sphere, same space as the frustum planes
+		f32 radius;
+		u32 index_count;
+		u32 first_index;
+		i32 vertex_offset;
+		u32 reserved;
+	};
+
+	struct bx_api gfx_cull_desc_t
+	{
+		handle_id instances{};	// STORAGE buffer, instance_count gfx_cull_instance_t
+		handle_id commands{};	// INDIRECT buffer, room for instance_count gfx_draw_indexed_indirect_command_t
+		handle_id count{};		// INDIRECT buffer, receives the u32 draw count
+		handle_id visible{};	// STORAGE buffer, optional, room for instance_count u32
+		u32 instance_count{ 0 };
+
+		// Planes as (nx, ny, nz, d) with normals pointing inside, a sphere is kept
+		// unless it lies fully behind one of them
+		f32 planes[6][4]{};
+	};
+
 	struct bx_api gfx_info_t
 	{
 		cstring backend{ nullptr };
@@ -439,22 +751,97 @@ namespace bx
 			u32 max_texture_size{ 0 };
 			bool supports_compute{ false };
 			bool supports_geometry_shader{ false };
+			bool supports_copy_image{ false }; // gfx_set_texture_resident_mips can reallocate
+			bool supports_bc{ false };		// BC1-BC5 sampled as is, otherwise decoded to RGBA8 on upload
+			bool supports_persistent_mapping{ false }; // mapped buffers stay mapped, BC decoding can copy from them
+			bool supports_base_instance{ false };	// first_instance of draws and indirect records reaches the shader
+			bool supports_bc7{ false };
+			bool supports_etc2{ false };
+			bool supports_astc{ false };
+			bool supports_bindless_textures{ false }; // gfx_resource_set_desc_t::bindless
 		};
 		features_t features{};
 	};
 
 	bx_api const gfx_info_t& gfx_get_info() noexcept;
 
+	struct bx_api gfx_state_stats_t
+	{
+		u64 issued{ 0 };
+		u64 skipped{ 0 };
+	};
+
+	// Driver state changes issued versus dropped because nothing would change
+	bx_api gfx_state_stats_t gfx_get_state_stats() noexcept;
+
+	bx_api void gfx_reset_state_stats() noexcept;
+
+	struct bx_api gfx_resource_stats_t
+	{
+		u32 count{ 0 };
+		u64 bytes{ 0 }; // as requested at creation, textures count their resident mips
+	};
+
+	// Counters of one frame, resources are what was alive at its end
+	struct bx_api gfx_frame_stats_t
+	{
+		u64 frame{ 0 };
+		f64 frame_time{ 0 };			// seconds, see app_frame_time
+		u32 draws{ 0 };					// an indirect call counts once
+		u32 dispatches{ 0 };
+		u32 pipeline_binds{ 0 };
+		u32 buffer_binds{ 0 };			// vertex and index buffers
+		u32 redundant_binds{ 0 };		// state changes dropped because nothing would change
+		u64 upload_bytes{ 0 };			// gfx_update_buffer and gfx_upload_texture_data
+		u32 shader_compiles{ 0 };		// compiles and links, program binaries and cached SPIR-V not included
+		f64 shader_compile_time{ 0 };	// seconds, compile workers included
+
+		gfx_resource_stats_t shaders{};
+		gfx_resource_stats_t buffers{};
+		gfx_resource_stats_t textures{};
+		gfx_resource_stats_t framebuffers{};
+		gfx_resource_stats_t pipelines{};
+		gfx_resource_stats_t resource_sets{};
+	};
+
+	// Last finished frame
+	bx_api const gfx_frame_stats_t& gfx_get_frame_stats() noexcept;
+
+	// Copies up to count of the latest frames to stats, oldest first, and returns
+	// how many were copied. app_config_t::gfx_stats_history frames are kept.
+	bx_api u32 gfx_get_frame_stats_history(gfx_frame_stats_t* stats, u32 count) noexcept;
+
+#ifdef BX_APP_IMGUI
+	// ImGui window plotting the history, call between app_begin_frame and app_end_frame
+	bx_api void gfx_stats_overlay(bool* open = nullptr) noexcept;
+#endif
+
+	// Call after touching the native context outside of bx (ImGui, raw API calls)
+	bx_api void gfx_invalidate_state() noexcept;
+
 	bx_api void gfx_push_debug_group(cstring name) noexcept;
 
 	bx_api void gfx_pop_debug_group() noexcept;
 
 	bx_api void gfx_insert_debug_marker(cstring name) noexcept;
 
+	// Descs equal in everything but the name share one shader, each create takes
+	// a reference and each destroy drops one. The same goes for pipelines.
 	bx_api handle_id gfx_create_shader(const gfx_shader_desc_t& desc) noexcept;
 
 	bx_api void gfx_destroy_shader(handle_id handle) noexcept;
 
+	// Compiles GLSL to SPIR-V on a worker pool. Macros are defined right after
+	// #version and #include "path" is resolved through the file drives, either
+	// "[drive]/path" or relative to the including file. Results are cached on
+	// disk under app_config_t::shader_cache by preprocessed source.
+	bx_api handle_id gfx_compile_shader(const gfx_shader_desc_t& desc) noexcept;
+
+	bx_api bool gfx_compile_shader_ready(handle_id job) noexcept;
+
+	// Blocks until the job is done and releases it, false when it failed to compile
+	bx_api bool gfx_compile_shader_wait(handle_id job, array<u8>& spirv) noexcept;
+
 	bx_api handle_id gfx_create_buffer(const gfx_buffer_desc_t& desc) noexcept;
 
 	bx_api void gfx_destroy_buffer(handle_id handle) noexcept;
@@ -463,14 +850,110 @@ namespace bx
 
 	bx_api void gfx_unmap_buffer(handle_id handle) noexcept;
 
+	// GPU_ONLY buffers are updated through a staging copy from the upload ring
 	bx_api void gfx_update_buffer(handle_id handle, u64 dst_offset, cvptr src, u64 size) noexcept;
 
+	// Transient GPU visible memory from the upload ring, for uniforms and dynamic
+	// vertices. Write data, then bind buffer at offset. Valid until the end of the
+	// frame, the ring waits for the GPU before the memory is handed out again.
+	struct bx_api gfx_upload_t
+	{
+		u8* data{ nullptr };
+		handle_id buffer{};
+		u64 offset{ 0 };
+		u64 size{ 0 };
+	};
+
+	// Graphics thread only. data is nullptr once this frame's share of the ring
+	// is used up, alignment must be a power of two.
+	bx_api gfx_upload_t gfx_upload_alloc(u64 size, u64 alignment = 256) noexcept;
+
 	bx_api handle_id gfx_create_texture(const gfx_texture_desc_t& desc) noexcept;
 
 	bx_api void gfx_destroy_texture(handle_id texture) noexcept;
 
 	bx_api void gfx_upload_texture_data(handle_id texture, const u8* data, u32 region_count, const gfx_texture_region_t* regions) noexcept;
 
+	// Tightly packed size of one image, cube faces and array layers not included
+	bx_api u64 gfx_texture_size(gfx_texture_format_t format, u32 width, u32 height, u32 depth = 1) noexcept;
+
+	bx_api bool gfx_texture_format_is_compressed(gfx_texture_format_t format) noexcept;
+
+	// Bytes of one vertex attribute, 0 when count doesn't suit the format
+	bx_api u32 gfx_attribute_size(gfx_attribute_format_t format, u32 count) noexcept;
+
+	// Vertex stream quantization into the compact attribute formats, SIMD where
+	// the target has it. count is the number of f32 values read from src, except
+	// for the packed formats which count vertices. Normalized formats clamp to
+	// their range and round to nearest, halfs round to nearest even.
+	bx_api void gfx_quantize_f16(const f32* src, u16* dst, usize count) noexcept;		// UVs, positions
+	bx_api void gfx_quantize_snorm8(const f32* src, i8* dst, usize count) noexcept;		// normals
+	bx_api void gfx_quantize_unorm8(const f32* src, u8* dst, usize count) noexcept;		// colors, weights
+	bx_api void gfx_quantize_snorm16(const f32* src, i16* dst, usize count) noexcept;
+	bx_api void gfx_quantize_unorm16(const f32* src, u16* dst, usize count) noexcept;	// UVs in [0, 1]
+
+	// count xyzw vertices into INT_2_10_10_10_REV, for normals and tangents with
+	// their handedness in w, which ends up as -1, 0 or 1
+	bx_api void gfx_quantize_snorm_10_10_10_2(const f32* src, u32* dst, usize count) noexcept;
+
+	// count xyz positions into UNORM16 xyzw relative to the bounds, w is 1. The
+	// shader gets back the position as min + value * (max - min).
+	bx_api void gfx_quantize_positions(const f32* src, u16* dst, usize count, const f32 min[3], const f32 max[3]) noexcept;
+
+	// Decodes a BC1, BC3, BC4 or BC5 image to tightly packed RGBA8, dst holds
+	// width * height * 4 bytes. False for any other format.
+	bx_api bool gfx_decode_texture(gfx_texture_format_t format, u32 width, u32 height, const u8* src, u8* dst) noexcept;
+
+	// Reallocates storage so only first_mip and the coarser mips exist, mips on both
+	// sides of the change keep their content. False when the device can't copy
+	// between textures, the storage is then left untouched.
+	bx_api bool gfx_set_texture_resident_mips(handle_id texture, u32 first_mip) noexcept;
+
+	// Finest mip sampling may read, clamped to the resident mips
+	bx_api void gfx_set_texture_min_mip(handle_id texture, u32 mip) noexcept;
+
+	// Fills dst with one mip of a streamed texture, tightly packed, cube faces one
+	// after the other. Runs on a streaming worker, returning false drops the mip.
+	using gfx_stream_load_fn = bool (*)(vptr user, u32 mip, u8* dst, u64 size);
+
+	struct bx_api gfx_stream_texture_desc_t
+	{
+		gfx_texture_desc_t texture{};
+		gfx_stream_load_fn load{ nullptr };
+		vptr user{ nullptr };
+		cstring filepath{ nullptr }; // "[drive]/path" read by load, its mips load again when it changes
+	};
+
+	struct bx_api gfx_stream_budget_t
+	{
+		u64 upload_bytes_per_frame{ 8 * 1024 * 1024 };
+		u64 resident_bytes{ 256 * 1024 * 1024 };
+		u64 staging_bytes{ 32 * 1024 * 1024 };
+	};
+
+	struct bx_api gfx_stream_stats_t
+	{
+		u64 resident_bytes{ 0 };
+		u64 uploaded_bytes{ 0 };	// during the last update
+		u64 evicted_mips{ 0 };
+		u32 loading{ 0 };			// mips decoding or waiting for upload budget
+	};
+
+	// Streamed textures are decoded on worker threads, staged and uploaded coarse
+	// to fine over frames within the budget. The handle is a regular texture.
+	// Graphics thread only, except for the load callbacks.
+	bx_api handle_id gfx_stream_texture(const gfx_stream_texture_desc_t& desc) noexcept;
+
+	bx_api void gfx_stream_release(handle_id texture) noexcept; // destroys the texture
+
+	// Marks the texture used this frame and asks for mips down to mip. Over budget
+	// the least recently requested textures lose their finest mips first.
+	bx_api void gfx_stream_request(handle_id texture, u32 mip) noexcept;
+
+	bx_api void gfx_stream_set_budget(const gfx_stream_budget_t& budget) noexcept;
+
+	bx_api gfx_stream_stats_t gfx_stream_get_stats() noexcept;
+
 	bx_api handle_id gfx_create_framebuffer(const gfx_framebuffer_desc_t& desc) noexcept;
 
 	bx_api void gfx_destroy_framebuffer(handle_id fb) noexcept;
@@ -481,12 +964,27 @@ namespace bx
 
 	bx_api void gfx_destroy_pipeline(handle_id handle) noexcept;
 
+	// Writes the live pipelines and their shaders for gfx_warm_up_pipelines to
+	// create at load time in a later run, before the first frame needs them
+	bx_api bool gfx_save_pipeline_list(cstring filepath) noexcept;
+
+	// Returns how many pipelines were created. They hold a reference until
+	// gfx_shutdown, so later creates from the same descs are cache hits.
+	bx_api u32 gfx_warm_up_pipelines(cstring filepath) noexcept;
+
 	bx_api handle_id gfx_create_resource_set(const gfx_resource_set_desc_t& desc) noexcept;
 
 	//bx_api void gfx_update_resource_set(handle_id set_handle, u32 binding_count, const gfx_resource_binding_t* bindings) noexcept;
 
 	bx_api void gfx_destroy_resource_set(handle_id set_handle) noexcept;
 
+	// Command buffers record on any thread, one thread per buffer at a time, and
+	// replay on the graphics thread at gfx_submit(). Commands taking a cb run
+	// immediately when cb is invalid_handle. Resource creation is never recorded.
+	bx_api handle_id gfx_begin_command_buffer() noexcept; // invalid_handle when the pool is exhausted
+
+	bx_api void gfx_discard_command_buffer(handle_id cb) noexcept;
+
 	bx_api void gfx_clear_rt(handle_id rt, f32 cv[4]) noexcept;
 
 	bx_api void gfx_clear_ds(handle_id ds);
@@ -495,25 +993,134 @@ namespace bx
 
 	bx_api void gfx_bind_vertex_buffers(handle_id cb, u32 first_binding, u32 binding_count, const handle_id* vertex_buffers, const u64* offsets) noexcept;
 
-	bx_api void gfx_bind_index_buffer(handle_id cb, handle_id index_buffer, u32 index_type) noexcept;
+	bx_api void gfx_bind_index_buffer(handle_id cb, handle_id index_buffer, gfx_index_type_t index_type = gfx_index_type_t::UINT32) noexcept;
 
 	bx_api void gfx_bind_resource_set(handle_id cb, handle_id pipeline, handle_id set, u32 set_index) noexcept;
 
 	bx_api void gfx_draw(handle_id cb, u32 vertex_count, u32 instance_count = 1, u32 first_vertex = 0, u32 first_instance = 0) noexcept;
 
-	bx_api void gfx_draw_indexed(handle_id cb, u32 index_count, u32 instance_count = 1, u32 first_index = 0, i32 vertex_offset = 0) noexcept;
+	bx_api void gfx_draw_indexed(handle_id cb, u32 index_count, u32 instance_count = 1, u32 first_index = 0, i32 vertex_offset = 0, u32 first_instance = 0) noexcept;
+
+	// Draws draw_count records read from an INDIRECT buffer, stride 0 means tightly
+	// packed. Many records go to the driver in one call where the device allows it.
+	bx_api void gfx_draw_indirect(handle_id cb, handle_id buffer, u64 offset, u32 draw_count, u32 stride = 0) noexcept;
+
+	bx_api void gfx_draw_indexed_indirect(handle_id cb, handle_id buffer, u64 offset, u32 draw_count, u32 stride = 0) noexcept;
+
+	// Same as gfx_draw_indexed_indirect with the draw count read from a u32 in
+	// count_buffer, clamped to max_draw_count. Lets the GPU decide what to draw.
+	bx_api void gfx_draw_indexed_indirect_count(handle_id cb, handle_id buffer, u64 offset, handle_id count_buffer, u64 count_offset, u32 max_draw_count, u32 stride = 0) noexcept;
 
 	bx_api void gfx_copy_buffer(handle_id cb, handle_id src, handle_id dst, u64 src_offset, u64 dst_offset, u64 size) noexcept;
+
+	// Texture upload from a buffer, regions[i].offset is the buffer offset. Source
+	// memory may come from gfx_upload_alloc or a STAGING buffer.
+	bx_api void gfx_copy_buffer_to_texture(handle_id cb, handle_id buffer, handle_id texture, u32 region_count, const gfx_texture_region_t* regions) noexcept;
 	
 	bx_api void gfx_dispatch(handle_id cb, u32 x, u32 y, u32 z) noexcept;
 	
-	bx_api void gfx_submit(handle_id cb) noexcept; // submit and execute or immediate execute
+	bx_api void gfx_submit(handle_id cb) noexcept; // replays cb and returns it to the pool
 	
 	bx_api void gfx_wait_idle() noexcept;
 	
 	bx_api void gfx_pipeline_barrier(handle_id cb, const gfx_memory_barrier_t& barrier) noexcept;
+
+	// Frustum culls instances on the GPU and writes one compacted draw command per
+	// visible instance. first_instance holds its index in desc.instances where the
+	// device supports base instance and is 0 otherwise, desc.visible receives the
+	// same indices in command order for shaders that look them up by draw index.
+	// The results are ready for gfx_draw_indexed_indirect_count once this returns.
+	// Uses storage buffer bindings 0 to 3. Needs compute, see gfx_info_t.
+	bx_api void gfx_cull_instances(handle_id cb, const gfx_cull_desc_t& desc) noexcept;
+
+	// ------------------------------------------
+	// -          Null Graphics API             -
+	// ------------------------------------------
+
+	// Only the Null graphics backend defines these. It validates every call,
+	// counts it and, when logging is on, appends it to a log that tests inspect
+	// and benchmarks replay without a GPU.
+
+	enum struct gfx_null_cmd_t : u8
+	{
+		BEGIN_FRAME, END_FRAME, SUBMIT,
+		CREATE_SHADER, DESTROY_SHADER,
+		CREATE_BUFFER, DESTROY_BUFFER, MAP_BUFFER, UNMAP_BUFFER, UPDATE_BUFFER,
+		CREATE_TEXTURE, DESTROY_TEXTURE, UPLOAD_TEXTURE,
+		CREATE_FRAMEBUFFER, DESTROY_FRAMEBUFFER,
+		CREATE_PIPELINE, DESTROY_PIPELINE,
+		CREATE_RESOURCE_SET, DESTROY_RESOURCE_SET,
+		CLEAR_RT, CLEAR_DS,
+		BIND_PIPELINE, BIND_VERTEX_BUFFER, BIND_INDEX_BUFFER, BIND_RESOURCE_SET,
+		DRAW, DRAW_INDEXED, DRAW_INDIRECT, DRAW_INDEXED_INDIRECT, DRAW_INDEXED_INDIRECT_COUNT,
+		COPY_BUFFER, COPY_BUFFER_TO_TEXTURE, DISPATCH, PIPELINE_BARRIER, CULL_INSTANCES
+	};
+
+	// Handles and args follow the parameters of the gfx call in order, created
+	// handles come first. One BIND_VERTEX_BUFFER per binding, args binding and offset.
+	struct bx_api gfx_null_command_t
+	{
+		gfx_null_cmd_t type{};
+		bool error{ false };	// rejected by validation, had no effect
+		u32 frame{ 0 };
+		handle_id handles[3]{};
+		u64 args[5]{};
+	};
+
+	struct bx_api gfx_null_stats_t
+	{
+		u32 commands{ 0 };			// every call, resource creation included
+		u32 draws{ 0 };				// an indirect call counts once
+		u64 vertices{ 0 };			// direct draws, vertex or index count times instances
+		u32 pipeline_binds{ 0 };
+		u32 buffer_binds{ 0 };		// vertex and index
+		u32 resource_set_binds{ 0 };
+		u32 dispatches{ 0 };
+		u32 copies{ 0 };
+		u32 uploads{ 0 };			// buffer updates and texture uploads
+		u64 upload_bytes{ 0 };
+		u32 barriers{ 0 };
+		u32 submits{ 0 };
+		u32 errors{ 0 };
+	};
+
+	// Off by default, the log grows until cleared
+	bx_api void gfx_null_set_logging(bool enabled) noexcept;
+
+	bx_api array_view<gfx_null_command_t> gfx_null_get_log() noexcept;
+
+	bx_api void gfx_null_clear_log() noexcept;
+
+	bx_api gfx_null_stats_t gfx_null_get_frame_stats() noexcept; // last finished frame
+
+	bx_api gfx_null_stats_t gfx_null_get_current_stats() noexcept; // frame in progress
+
+	// One line per command, the path may start with a drive
+	bx_api bool gfx_null_dump_log(cstring filepath) noexcept;
+
+	// Issues the binds, draws, copies, dispatches and barriers of a log again,
+	// recorded into cb or run immediately. Everything else is skipped, texture
+	// regions and cull planes are not kept by the log.
+	bx_api void gfx_null_replay(array_view<gfx_null_command_t> commands, handle_id cb = invalid_handle) noexcept;
 }
 
-bx_register_category(bx)
+// Lets bx strings be passed straight to the log macros
+template <>
+struct fmt::formatter<bx::string_view> : fmt::formatter<fmt::string_view>
+{
+	template <typename FormatContext>
+	auto format(const bx::string_view& str, FormatContext& ctx) const -> decltype(ctx.out())
+	{
+		return fmt::formatter<fmt::string_view>::format(fmt::string_view(str.cstr, str.size), ctx);
+	}
+};
+
+template <typename A>
+struct fmt::formatter<bx::basic_string<A>> : fmt::formatter<bx::string_view> {};
+
+template <usize N>
+struct fmt::formatter<bx::string_fixed<N>> : fmt::formatter<bx::string_view> {};
+
+bx_register_category(bx, 0)
 
 #endif // BX_APP
\ No newline at end of file
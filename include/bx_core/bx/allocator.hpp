@@ -0,0 +1,215 @@
+#ifndef BX_ALLOCATOR_HPP
+#define BX_ALLOCATOR_HPP
+
+#include <bx/core.hpp>
+
+#include <new>
+
+namespace bx
+{
+	// ------------------------------------------
+	// -             Allocator API              -
+	// ------------------------------------------
+
+	// Containers take the allocator as a template parameter and call it
+	// directly, there is no virtual interface. An allocator provides:
+	//
+	//   vptr allocate(usize size, usize align) noexcept;     // nullptr on failure
+	//   void deallocate(vptr ptr, usize size) noexcept;      // size matches allocate
+	//
+	// Stateless allocators are stored inline at no size cost. Stateful ones
+	// (arena, pool, tracking) are shared with containers through allocator_ref.
+
+	constexpr usize default_align = alignof(std::max_align_t);
+
+	constexpr bool is_pow2(const usize n) noexcept { return n != 0 && (n & (n - 1)) == 0; }
+
+	constexpr usize align_up(const usize n, const usize align) noexcept { return (n + align - 1) & ~(align - 1); }
+
+	// Global heap, the default for every bx container. Alignments above
+	// default_align are honored, one that isn't a power of two fails.
+	struct bx_api heap_allocator
+	{
+		vptr allocate(usize size, usize align = default_align) noexcept;
+		void deallocate(vptr ptr, usize size) noexcept;
+	};
+
+	// Non-owning handle to a stateful allocator, copies share the same instance
+	template <typename A>
+	struct bx_api allocator_ref
+	{
+		allocator_ref(A& allocator) noexcept : m_allocator(&allocator) {}
+
+		inline vptr allocate(usize size, usize align = default_align) noexcept { return m_allocator->allocate(size, align); }
+		inline void deallocate(vptr ptr, usize size) noexcept { m_allocator->deallocate(ptr, size); }
+
+		inline A& get() const noexcept { return *m_allocator; }
+
+	private:
+		A* m_allocator;
+	};
+
+	// Bump allocator over one block. Only the most recent allocation can be
+	// given back, everything else is released at once by reset().
+	struct bx_api linear_allocator
+	{
+		using marker_t = usize;
+
+		linear_allocator() noexcept = default;
+
+		// Uses external memory, never freed by the allocator
+		linear_allocator(vptr buffer, usize size) noexcept;
+
+		~linear_allocator() noexcept;
+
+		linear_allocator(const linear_allocator&) = delete;
+		linear_allocator& operator=(const linear_allocator&) = delete;
+
+		// Allocates a block of the given size from the heap, releases any previous owned block
+		bool init(usize size) noexcept;
+		void shutdown() noexcept;
+
+		inline vptr allocate(usize size, usize align = default_align) noexcept
+		{
+			const uptr base = reinterpret_cast<uptr>(m_data);
+			const usize offset = align_up(base + m_offset, align) - base;
+			if (offset + size > m_size || offset + size < offset)
+				return nullptr;
+
+			m_last = offset;
+			m_offset = offset + size;
+			if (m_offset > m_peak)
+				m_peak = m_offset;
+			return m_data + offset;
+		}
+
+		inline void deallocate(vptr ptr, usize size) noexcept
+		{
+			(void)size;
+			if (ptr && static_cast<u8*>(ptr) == m_data + m_last)
+				m_offset = m_last;
+		}
+
+		inline marker_t marker() const noexcept { return m_offset; }
+		inline void rewind(marker_t marker) noexcept { m_offset = marker < m_offset ? marker : m_offset; m_last = m_offset; }
+		inline void reset() noexcept { m_offset = 0; m_last = 0; }
+
+		inline usize used() const noexcept { return m_offset; }
+		inline usize peak() const noexcept { return m_peak; }
+		inline usize capacity() const noexcept { return m_size; }
+
+	private:
+		u8* m_data{ nullptr };
+		usize m_size{ 0 };
+		usize m_offset{ 0 };
+		usize m_last{ 0 };
+		usize m_peak{ 0 };
+		bool m_owned{ false };
+	};
+
+	// Fixed size blocks with an intrusive free list, O(1) allocate and free.
+	// Requests larger than the block size or alignment fail.
+	struct bx_api pool_allocator
+	{
+		pool_allocator() noexcept = default;
+		~pool_allocator() noexcept;
+
+		pool_allocator(const pool_allocator&) = delete;
+		pool_allocator& operator=(const pool_allocator&) = delete;
+
+		bool init(usize block_size, usize block_count, usize align = default_align) noexcept;
+		void shutdown() noexcept;
+
+		inline vptr allocate(usize size, usize align = default_align) noexcept
+		{
+			if (!m_free || size > m_block_size || align > m_align)
+				return nullptr;
+
+			node_t* node = m_free;
+			m_free = node->next;
+			++m_used;
+			return node;
+		}
+
+		inline void deallocate(vptr ptr, usize size) noexcept
+		{
+			(void)size;
+			if (!ptr)
+				return;
+
+			node_t* node = static_cast<node_t*>(ptr);
+			node->next = m_free;
+			m_free = node;
+			--m_used;
+		}
+
+		inline bool owns(cvptr ptr) const noexcept
+		{
+			const u8* p = static_cast<const u8*>(ptr);
+			return p >= m_blocks && p < m_blocks + m_block_size * m_block_count;
+		}
+
+		inline usize block_size() const noexcept { return m_block_size; }
+		inline usize block_count() const noexcept { return m_block_count; }
+		inline usize used() const noexcept { return m_used; }
+
+	private:
+		struct node_t { node_t* next; };
+
+		u8* m_data{ nullptr };
+		u8* m_blocks{ nullptr };
+		node_t* m_free{ nullptr };
+		usize m_block_size{ 0 };
+		usize m_block_count{ 0 };
+		usize m_align{ 0 };
+		usize m_used{ 0 };
+	};
+
+	// Counts live bytes and allocations going through the wrapped allocator
+	template <typename A = heap_allocator>
+	struct bx_api tracking_allocator
+	{
+		tracking_allocator() noexcept = default;
+		explicit tracking_allocator(const A& allocator) noexcept : m_allocator(allocator) {}
+
+		inline vptr allocate(usize size, usize align = default_align) noexcept
+		{
+			vptr ptr = m_allocator.allocate(size, align);
+			if (ptr)
+			{
+				m_bytes += size;
+				++m_count;
+				++m_total_count;
+				if (m_bytes > m_peak_bytes)
+					m_peak_bytes = m_bytes;
+			}
+			return ptr;
+		}
+
+		inline void deallocate(vptr ptr, usize size) noexcept
+		{
+			if (!ptr)
+				return;
+
+			m_allocator.deallocate(ptr, size);
+			m_bytes -= size;
+			--m_count;
+		}
+
+		inline usize bytes() const noexcept { return m_bytes; }
+		inline usize peak_bytes() const noexcept { return m_peak_bytes; }
+		inline usize count() const noexcept { return m_count; }
+		inline usize total_count() const noexcept { return m_total_count; }
+
+		inline A& get() noexcept { return m_allocator; }
+
+	private:
+		A m_allocator{};
+		usize m_bytes{ 0 };
+		usize m_peak_bytes{ 0 };
+		usize m_count{ 0 };
+		usize m_total_count{ 0 };
+	};
+}
+
+#endif // BX_ALLOCATOR_HPP
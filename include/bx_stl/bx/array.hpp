@@ -3,6 +3,7 @@
 
 #include <bx/core.hpp>
 #include <bx/type_traits.hpp>
+#include <bx/allocator.hpp>
 
 #include <new>
 #include <initializer_list>
@@ -10,24 +11,31 @@
 
 namespace bx
 {
-    template<typename T>
-    struct bx_api array
+    // Memory comes from A, see bx/allocator.hpp. Stateless allocators add no size.
+    template<typename T, typename A = heap_allocator>
+    struct bx_api array : private A
     {
         using value_type = T;
         using iterator = T*;
         using const_iterator = const T*;
+        using allocator_type = A;
 
         array() noexcept = default;
 
-        explicit array(usize count) noexcept
+        explicit array(const A& allocator) noexcept
+            : A(allocator)
+        {}
+
+        explicit array(usize count, const A& allocator = A{}) noexcept
+            : A(allocator)
         {
             static_assert(std::is_default_constructible<T>::value,
                 "T must be default constructible to use resize or count constructor");
             resize(count);
         }
 
-        array(std::initializer_list<T> init) noexcept
-            : array(init.size())
+        array(std::initializer_list<T> init, const A& allocator = A{}) noexcept
+            : array(init.size(), allocator)
         {
             usize i = 0;
             for (auto it = init.begin(); it != init.end() && i < init.size(); ++it, ++i)
@@ -37,14 +45,14 @@ namespace bx
         ~array() noexcept
         {
             clear();
-            ::operator delete[](m_data, std::nothrow);
+            release();
         }
 
         array(const array&) = delete;
         array& operator=(const array&) = delete;
 
         array(array&& other) noexcept
-            : m_data(other.m_data), m_size(other.m_size), m_capacity(other.m_capacity)
+            : A(static_cast<A&&>(other)), m_data(other.m_data), m_size(other.m_size), m_capacity(other.m_capacity)
         {
             other.m_data = nullptr;
             other.m_size = 0;
@@ -56,8 +64,9 @@ namespace bx
             if (this != &other)
             {
                 clear();
-                ::operator delete[](m_data, std::nothrow);
+                release();
 
+                static_cast<A&>(*this) = static_cast<A&&>(other);
                 m_data = other.m_data;
                 m_size = other.m_size;
                 m_capacity = other.m_capacity;
@@ -84,6 +93,7 @@ namespace bx
         inline const T& back() const noexcept { return m_data[m_size - 1]; }
 
         inline usize size() const noexcept { return m_size; }
+        inline usize capacity() const noexcept { return m_capacity; }
         inline bool empty() const noexcept { return m_size == 0; }
 
         inline T* data() noexcept { return m_data; }
@@ -155,7 +165,7 @@ namespace bx
             if (new_capacity <= m_capacity)
                 return true;
 
-            T* new_data = static_cast<T*>(::operator new[](new_capacity * sizeof(T), std::nothrow));
+            T* new_data = static_cast<T*>(allocator().allocate(new_capacity * sizeof(T), alignof(T)));
             if (!new_data)
                 return false; // allocation failed
 
@@ -165,13 +175,22 @@ namespace bx
                 m_data[i].~T();
             }
 
-            ::operator delete[](m_data, std::nothrow);
+            release();
             m_data = new_data;
             m_capacity = new_capacity;
             return true;
         }
 
+        inline A& allocator() noexcept { return *this; }
+        inline const A& allocator() const noexcept { return *this; }
+
     private:
+        inline void release() noexcept
+        {
+            if (m_data)
+                allocator().deallocate(m_data, m_capacity * sizeof(T));
+        }
+
         T* m_data{ nullptr };
         usize m_size{ 0 };
         usize m_capacity{ 0 };
@@ -220,7 +239,8 @@ namespace bx
 		
 		array_view() noexcept = default;
 
-        array_view(array<T>& arr) noexcept
+        template<typename A>
+        array_view(array<T, A>& arr) noexcept
             : m_data(arr.data()), m_size(arr.size())
         {}
 
@@ -2,10 +2,192 @@
 #define BX_HANDLE_MAP
 
 #include <bx/core.hpp>
+#include <bx/array.hpp>
+
+#include <utility>
 
 namespace bx
 {
-	struct handle_map {}; // TODO: Implement
+	// Generational slot map, objects live densely packed for iteration while
+	// handles stay stable. A handle stores the slot index in its low 32 bits and
+	// the slot generation in its high 32 bits (the data/meta halves of a handle_t).
+	// Live slots have odd generations, so a stale or freed handle always fails
+	// the generation check and no handle is ever equal to invalid_handle.
+	template <typename T>
+	struct bx_api handle_map
+	{
+		using value_type = T;
+		using iterator = T*;
+		using const_iterator = const T*;
+
+		handle_map() noexcept = default;
+
+		handle_map(const handle_map&) = delete;
+		handle_map& operator=(const handle_map&) = delete;
+
+		handle_map(handle_map&& other) noexcept
+			: m_dense(static_cast<array<T>&&>(other.m_dense))
+			, m_dense_slots(static_cast<array<u32>&&>(other.m_dense_slots))
+			, m_slots(static_cast<array<slot_t>&&>(other.m_slots))
+			, m_free_head(other.m_free_head)
+		{
+			other.m_free_head = free_end;
+		}
+
+		handle_map& operator=(handle_map&& other) noexcept
+		{
+			if (this != &other)
+			{
+				m_dense = static_cast<array<T>&&>(other.m_dense);
+				m_dense_slots = static_cast<array<u32>&&>(other.m_dense_slots);
+				m_slots = static_cast<array<slot_t>&&>(other.m_slots);
+				m_free_head = other.m_free_head;
+				other.m_free_head = free_end;
+			}
+			return *this;
+		}
+
+		static inline u32 handle_index(handle_id handle) noexcept { return static_cast<u32>(handle); }
+		static inline u32 handle_generation(handle_id handle) noexcept { return static_cast<u32>(handle >> 32); }
+		static inline handle_id make_handle(u32 index, u32 generation) noexcept
+		{
+			return (static_cast<handle_id>(generation) << 32) | static_cast<handle_id>(index);
+		}
+
+		inline handle_id insert(const T& obj) noexcept { return emplace(obj); }
+		inline handle_id insert(T&& obj) noexcept { return emplace(static_cast<T&&>(obj)); }
+
+		// Returns invalid_handle if allocation failed
+		template<typename... Args>
+		handle_id emplace(Args&&... args) noexcept
+		{
+			const usize dense = m_dense.size();
+			if (!grow(m_dense, dense + 1) || !grow(m_dense_slots, dense + 1))
+				return invalid_handle;
+
+			u32 index = m_free_head;
+			if (index == free_end)
+			{
+				if (!grow(m_slots, m_slots.size() + 1))
+					return invalid_handle;
+
+				index = static_cast<u32>(m_slots.size());
+				m_slots.push_back(slot_t{});
+			}
+			else
+			{
+				m_free_head = m_slots[index].dense;
+			}
+
+			slot_t& slot = m_slots[index];
+			slot.generation = (slot.generation + 1) | 1u;
+			slot.dense = static_cast<u32>(dense);
+
+			m_dense.emplace_back(std::forward<Args>(args)...);
+			m_dense_slots.push_back(index);
+			return make_handle(index, slot.generation);
+		}
+
+		// Moves the last object into the freed dense spot, invalidates pointers and iterators
+		bool remove(handle_id handle) noexcept
+		{
+			const u32 index = handle_index(handle);
+			if (!valid(handle))
+				return false;
+
+			slot_t& slot = m_slots[index];
+			const u32 dense = slot.dense;
+			const u32 last = static_cast<u32>(m_dense.size() - 1);
+			if (dense != last)
+			{
+				m_dense[dense] = static_cast<T&&>(m_dense[last]);
+				m_dense_slots[dense] = m_dense_slots[last];
+				m_slots[m_dense_slots[dense]].dense = dense;
+			}
+			m_dense.pop_back();
+			m_dense_slots.pop_back();
+
+			++slot.generation;
+			slot.dense = m_free_head;
+			m_free_head = index;
+			return true;
+		}
+
+		inline T* get(handle_id handle) noexcept
+		{
+			return valid(handle) ? &m_dense[m_slots[handle_index(handle)].dense] : nullptr;
+		}
+
+		inline const T* get(handle_id handle) const noexcept
+		{
+			return valid(handle) ? &m_dense[m_slots[handle_index(handle)].dense] : nullptr;
+		}
+
+		inline bool contains(handle_id handle) const noexcept { return valid(handle); }
+
+		// Handle of the object stored at a dense position, matches iteration order
+		inline handle_id handle_at(usize dense) const noexcept
+		{
+			const u32 index = m_dense_slots[dense];
+			return make_handle(index, m_slots[index].generation);
+		}
+
+		inline iterator begin() noexcept { return m_dense.begin(); }
+		inline iterator end() noexcept { return m_dense.end(); }
+
+		inline const_iterator begin() const noexcept { return m_dense.begin(); }
+		inline const_iterator end() const noexcept { return m_dense.end(); }
+
+		inline T* data() noexcept { return m_dense.data(); }
+		inline const T* data() const noexcept { return m_dense.data(); }
+
+		inline usize size() const noexcept { return m_dense.size(); }
+		inline usize capacity() const noexcept { return m_dense.capacity(); }
+		inline bool empty() const noexcept { return m_dense.empty(); }
+
+		inline bool reserve(usize count) noexcept
+		{
+			return m_dense.reserve(count) && m_dense_slots.reserve(count) && m_slots.reserve(count);
+		}
+
+		inline void clear() noexcept
+		{
+			for (usize i = m_dense.size(); i-- > 0; )
+				remove(handle_at(i));
+		}
+
+	private:
+		static constexpr u32 free_end = ~0u;
+
+		// reserve allocates exactly what it is asked for, double so inserts stay amortized O(1)
+		template <typename U>
+		static bool grow(array<U>& values, usize count) noexcept
+		{
+			const usize capacity = values.capacity();
+			if (count <= capacity)
+				return true;
+			const usize doubled = capacity * 2 > 8 ? capacity * 2 : 8;
+			return values.reserve(count > doubled ? count : doubled);
+		}
+
+		struct slot_t
+		{
+			u32 dense{ 0 };			// dense index while live, next free slot while free
+			u32 generation{ 0 };	// odd while live, even while free
+		};
+
+		inline bool valid(handle_id handle) const noexcept
+		{
+			const u32 index = handle_index(handle);
+			return index < m_slots.size() && m_slots[index].generation == handle_generation(handle)
+				&& (handle_generation(handle) & 1u) != 0;
+		}
+
+		array<T> m_dense{};
+		array<u32> m_dense_slots{};
+		array<slot_t> m_slots{};
+		u32 m_free_head{ free_end };
+	};
 }
 
-#endif // BX_HANDLE_MAP
\ No newline at end of file
+#endif // BX_HANDLE_MAP
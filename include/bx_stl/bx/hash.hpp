@@ -0,0 +1,51 @@
+#ifndef BX_HASH
+#define BX_HASH
+
+#include <bx/core.hpp>
+
+#include <functional>
+
+namespace bx
+{
+	// Finalizer of MurmurHash3, spreads entropy over all 64 bits so the
+	// control byte (low 7 bits) and the probe start (upper bits) stay independent.
+	inline u64 hash_mix(u64 h) noexcept
+	{
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccdull;
+		h ^= h >> 33;
+		h *= 0xc4ceb9fe1a85ec53ull;
+		h ^= h >> 33;
+		return h;
+	}
+
+	// FNV-1a 64-bit over a byte range
+	inline u64 hash_bytes(cvptr data, usize size) noexcept
+	{
+		const u8* bytes = static_cast<const u8*>(data);
+		u64 h = 14695981039346656037ull;
+		for (usize i = 0; i < size; ++i)
+		{
+			h ^= bytes[i];
+			h *= 1099511628211ull;
+		}
+		return h;
+	}
+
+	// Folds value into seed, the order of the values matters
+	inline u64 hash_combine(u64 seed, u64 value) noexcept
+	{
+		return hash_mix(seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2)));
+	}
+
+	template <typename T>
+	struct bx_api hash
+	{
+		inline u64 operator()(const T& value) const noexcept
+		{
+			return hash_mix(static_cast<u64>(std::hash<T>{}(value)));
+		}
+	};
+}
+
+#endif // BX_HASH
@@ -2,12 +2,490 @@
 #define BX_HASH_MAP
 
 #include <bx/core.hpp>
-#include <unordered_map>
+#include <bx/type_traits.hpp>
+#include <bx/hash.hpp>
+#include <bx/allocator.hpp>
+
+#include <new>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BX_HASH_MAP_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__aarch64__) || defined(_M_ARM64)
+#define BX_HASH_MAP_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 namespace bx
 {
-	template <typename K, typename V>
-	using hash_map = std::unordered_map<K, V>; // TODO: Temp fallback to c++ stl
+	namespace detail
+	{
+		constexpr u8 ctrl_empty = 0x80;
+		constexpr usize group_width = 16;
+
+		bx_force_inline u32 ctz64(u64 v) noexcept
+		{
+#if defined(_MSC_VER)
+			unsigned long i = 0;
+			_BitScanForward64(&i, v);
+			return static_cast<u32>(i);
+#else
+			return static_cast<u32>(__builtin_ctzll(v));
+#endif
+		}
+
+		// Set of matching slots inside a group, one bit (or nibble on NEON) per slot.
+		struct group_mask_t
+		{
+			group_mask_t(u64 bits, u32 shift) noexcept : bits(bits), shift(shift) {}
+
+			inline explicit operator bool() const noexcept { return bits != 0; }
+			inline u32 lowest() const noexcept { return ctz64(bits) >> shift; }
+			inline void pop() noexcept { bits &= bits - 1; }
+
+			u64 bits;
+			u32 shift;
+		};
+
+		// A window of group_width control bytes, loaded unaligned from any position.
+		struct group_t
+		{
+			explicit group_t(const u8* ctrl) noexcept
+			{
+#if defined(BX_HASH_MAP_SSE2)
+				m_ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+#elif defined(BX_HASH_MAP_NEON)
+				m_ctrl = vld1q_u8(ctrl);
+#else
+				m_ptr = ctrl;
+#endif
+			}
+
+			inline group_mask_t match(u8 h2) const noexcept
+			{
+#if defined(BX_HASH_MAP_SSE2)
+				const __m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(h2)), m_ctrl);
+				return group_mask_t{ static_cast<u64>(static_cast<u32>(_mm_movemask_epi8(cmp))), 0 };
+#elif defined(BX_HASH_MAP_NEON)
+				return neon_mask(vceqq_u8(m_ctrl, vdupq_n_u8(h2)));
+#else
+				u64 bits = 0;
+				for (usize i = 0; i < group_width; ++i)
+					bits |= static_cast<u64>(m_ptr[i] == h2) << i;
+				return group_mask_t{ bits, 0 };
+#endif
+			}
+
+			inline group_mask_t match_empty() const noexcept
+			{
+				// Only the empty control byte has its high bit set
+#if defined(BX_HASH_MAP_SSE2)
+				return group_mask_t{ static_cast<u64>(static_cast<u32>(_mm_movemask_epi8(m_ctrl))), 0 };
+#elif defined(BX_HASH_MAP_NEON)
+				return neon_mask(vcltzq_s8(vreinterpretq_s8_u8(m_ctrl)));
+#else
+				u64 bits = 0;
+				for (usize i = 0; i < group_width; ++i)
+					bits |= static_cast<u64>((m_ptr[i] & ctrl_empty) != 0) << i;
+				return group_mask_t{ bits, 0 };
+#endif
+			}
+
+		private:
+#if defined(BX_HASH_MAP_SSE2)
+			__m128i m_ctrl;
+#elif defined(BX_HASH_MAP_NEON)
+			static inline group_mask_t neon_mask(uint8x16_t cmp) noexcept
+			{
+				// Narrow each byte to a nibble, then keep one bit per nibble
+				const uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(cmp), 4);
+				const u64 bits = vget_lane_u64(vreinterpret_u64_u8(nibbles), 0);
+				return group_mask_t{ bits & 0x8888888888888888ull, 2 };
+			}
+
+			uint8x16_t m_ctrl;
+#else
+			const u8* m_ptr;
+#endif
+		};
+	}
+
+	// Open addressing hash map with Swiss table style control bytes.
+	// Slots are probed linearly, a group of control bytes at a time, and erase
+	// shifts the following run back instead of leaving tombstones.
+	// Allocation failures leave the map untouched and are reported through
+	// the return value (end() / false), never by throwing.
+	template <typename K, typename V, typename H = hash<K>, typename A = heap_allocator>
+	struct bx_api hash_map : private A
+	{
+		struct entry_t
+		{
+			template<typename... Args>
+			entry_t(const K& key, Args&&... args) noexcept
+				: first(key), second(std::forward<Args>(args)...)
+			{}
+
+			K first;
+			V second;
+		};
+
+		template<typename E>
+		struct iterator_t
+		{
+			iterator_t() noexcept = default;
+			iterator_t(E* slot, const u8* ctrl, const u8* ctrl_end) noexcept
+				: m_slot(slot), m_ctrl(ctrl), m_ctrl_end(ctrl_end)
+			{
+				skip_empty();
+			}
+
+			inline E& operator*() const noexcept { return *m_slot; }
+			inline E* operator->() const noexcept { return m_slot; }
+
+			inline iterator_t& operator++() noexcept
+			{
+				++m_slot;
+				++m_ctrl;
+				skip_empty();
+				return *this;
+			}
+
+			inline bool operator==(const iterator_t& other) const noexcept { return m_slot == other.m_slot; }
+			inline bool operator!=(const iterator_t& other) const noexcept { return m_slot != other.m_slot; }
+
+		private:
+			inline void skip_empty() noexcept
+			{
+				while (m_ctrl != m_ctrl_end && *m_ctrl == detail::ctrl_empty)
+				{
+					++m_slot;
+					++m_ctrl;
+				}
+			}
+
+			E* m_slot{ nullptr };
+			const u8* m_ctrl{ nullptr };
+			const u8* m_ctrl_end{ nullptr };
+		};
+
+		using key_type = K;
+		using mapped_type = V;
+		using value_type = entry_t;
+		using iterator = iterator_t<entry_t>;
+		using const_iterator = iterator_t<const entry_t>;
+
+		using allocator_type = A;
+
+		hash_map() noexcept = default;
+
+		explicit hash_map(const A& allocator) noexcept
+			: A(allocator)
+		{}
+
+		explicit hash_map(usize count, const A& allocator = A{}) noexcept
+			: A(allocator)
+		{
+			reserve(count);
+		}
+
+		~hash_map() noexcept
+		{
+			clear();
+			release();
+		}
+
+		hash_map(const hash_map&) = delete;
+		hash_map& operator=(const hash_map&) = delete;
+
+		hash_map(hash_map&& other) noexcept
+			: A(static_cast<A&&>(other)), m_slots(other.m_slots), m_ctrl(other.m_ctrl), m_size(other.m_size), m_capacity(other.m_capacity)
+		{
+			other.m_slots = nullptr;
+			other.m_ctrl = nullptr;
+			other.m_size = 0;
+			other.m_capacity = 0;
+		}
+
+		hash_map& operator=(hash_map&& other) noexcept
+		{
+			if (this != &other)
+			{
+				clear();
+				release();
+
+				static_cast<A&>(*this) = static_cast<A&&>(other);
+				m_slots = other.m_slots;
+				m_ctrl = other.m_ctrl;
+				m_size = other.m_size;
+				m_capacity = other.m_capacity;
+
+				other.m_slots = nullptr;
+				other.m_ctrl = nullptr;
+				other.m_size = 0;
+				other.m_capacity = 0;
+			}
+			return *this;
+		}
+
+		inline iterator begin() noexcept { return iterator(m_slots, m_ctrl, m_ctrl + m_capacity); }
+		inline iterator end() noexcept { return iterator(m_slots + m_capacity, m_ctrl + m_capacity, m_ctrl + m_capacity); }
+
+		inline const_iterator begin() const noexcept { return const_iterator(m_slots, m_ctrl, m_ctrl + m_capacity); }
+		inline const_iterator end() const noexcept { return const_iterator(m_slots + m_capacity, m_ctrl + m_capacity, m_ctrl + m_capacity); }
+
+		inline usize size() const noexcept { return m_size; }
+		inline bool empty() const noexcept { return m_size == 0; }
+		inline usize capacity() const noexcept { return m_capacity; }
+
+		inline iterator find(const K& key) noexcept
+		{
+			const usize i = find_index(key);
+			return i == m_capacity ? end() : iterator(m_slots + i, m_ctrl + i, m_ctrl + m_capacity);
+		}
+
+		inline const_iterator find(const K& key) const noexcept
+		{
+			const usize i = find_index(key);
+			return i == m_capacity ? end() : const_iterator(m_slots + i, m_ctrl + i, m_ctrl + m_capacity);
+		}
+
+		inline V* get(const K& key) noexcept
+		{
+			const usize i = find_index(key);
+			return i == m_capacity ? nullptr : &m_slots[i].second;
+		}
+
+		inline const V* get(const K& key) const noexcept
+		{
+			const usize i = find_index(key);
+			return i == m_capacity ? nullptr : &m_slots[i].second;
+		}
+
+		inline bool contains(const K& key) const noexcept { return find_index(key) != m_capacity; }
+
+		// Constructs the value in place if the key is missing, returns end() if allocation failed
+		template<typename... Args>
+		inline iterator emplace(const K& key, Args&&... args) noexcept
+		{
+			const usize i = emplace_index(key, std::forward<Args>(args)...);
+			return i == m_capacity ? end() : iterator(m_slots + i, m_ctrl + i, m_ctrl + m_capacity);
+		}
+
+		inline iterator insert(const K& key, const V& value) noexcept { return emplace(key, value); }
+		inline iterator insert(const K& key, V&& value) noexcept { return emplace(key, static_cast<V&&>(value)); }
+
+		inline iterator insert_or_assign(const K& key, const V& value) noexcept
+		{
+			const usize i = find_index(key);
+			if (i == m_capacity)
+				return emplace(key, value);
+
+			m_slots[i].second = value;
+			return iterator(m_slots + i, m_ctrl + i, m_ctrl + m_capacity);
+		}
+
+		// Removes the key and shifts the rest of its probe run back, invalidates iterators
+		bool erase(const K& key) noexcept
+		{
+			usize i = find_index(key);
+			if (i == m_capacity)
+				return false;
+
+			m_slots[i].~entry_t();
+			set_ctrl(i, detail::ctrl_empty);
+			--m_size;
+
+			const usize mask = m_capacity - 1;
+			usize j = i;
+			for (;;)
+			{
+				j = (j + 1) & mask;
+				if (m_ctrl[j] == detail::ctrl_empty)
+					break;
+
+				// Only move entries whose home slot lies at or before the hole
+				const usize home = h1(H{}(m_slots[j].first));
+				if (((j - home) & mask) < ((j - i) & mask))
+					continue;
+
+				new (m_slots + i) entry_t(static_cast<entry_t&&>(m_slots[j]));
+				m_slots[j].~entry_t();
+				set_ctrl(i, m_ctrl[j]);
+				set_ctrl(j, detail::ctrl_empty);
+				i = j;
+			}
+			return true;
+		}
+
+		inline void clear() noexcept
+		{
+			for (usize i = 0; i < m_capacity; ++i)
+			{
+				if (m_ctrl[i] != detail::ctrl_empty)
+				{
+					m_slots[i].~entry_t();
+					set_ctrl(i, detail::ctrl_empty);
+				}
+			}
+			m_size = 0;
+		}
+
+		// Makes room for count entries without rehashing, returns false if allocation failed
+		inline bool reserve(usize count) noexcept
+		{
+			usize new_capacity = detail::group_width;
+			while (new_capacity * 7 / 8 < count)
+				new_capacity *= 2;
+
+			if (new_capacity <= m_capacity)
+				return true;
+
+			return rehash(new_capacity);
+		}
+
+		inline A& allocator() noexcept { return *this; }
+		inline const A& allocator() const noexcept { return *this; }
+
+	private:
+		static inline u8 h2(u64 h) noexcept { return static_cast<u8>(h & 0x7F); }
+		inline usize h1(u64 h) const noexcept { return static_cast<usize>(h >> 7) & (m_capacity - 1); }
+
+		inline void set_ctrl(usize i, u8 c) noexcept
+		{
+			m_ctrl[i] = c;
+
+			// Mirror the first group past the end so unaligned loads can wrap around
+			if (i < detail::group_width)
+				m_ctrl[m_capacity + i] = c;
+		}
+
+		inline usize find_index(const K& key) const noexcept
+		{
+			return m_capacity == 0 ? 0 : find_index(key, H{}(key));
+		}
+
+		inline usize find_index(const K& key, u64 h) const noexcept
+		{
+			if (m_capacity == 0)
+				return 0;
+
+			const usize mask = m_capacity - 1;
+			const u8 tag = h2(h);
+			usize pos = h1(h);
+			for (;;)
+			{
+				const detail::group_t group(m_ctrl + pos);
+				for (auto m = group.match(tag); m; m.pop())
+				{
+					const usize i = (pos + m.lowest()) & mask;
+					if (m_slots[i].first == key)
+						return i;
+				}
+
+				if (group.match_empty())
+					return m_capacity;
+
+				pos = (pos + detail::group_width) & mask;
+			}
+		}
+
+		template<typename... Args>
+		usize emplace_index(const K& key, Args&&... args) noexcept
+		{
+			const u64 h = H{}(key);
+			const usize found = find_index(key, h);
+			if (found != m_capacity)
+				return found;
+
+			if (!grow_for_insert())
+				return m_capacity;
+
+			const usize i = find_free(h);
+			new (m_slots + i) entry_t(key, std::forward<Args>(args)...);
+			set_ctrl(i, h2(h));
+			++m_size;
+			return i;
+		}
+
+		inline usize find_free(u64 h) const noexcept
+		{
+			const usize mask = m_capacity - 1;
+			usize pos = h1(h);
+			for (;;)
+			{
+				const auto m = detail::group_t(m_ctrl + pos).match_empty();
+				if (m)
+					return (pos + m.lowest()) & mask;
+
+				pos = (pos + detail::group_width) & mask;
+			}
+		}
+
+		inline bool grow_for_insert() noexcept
+		{
+			// Keep the load factor under 7/8 so probe runs stay short and always end
+			if ((m_size + 1) * 8 <= m_capacity * 7)
+				return true;
+
+			return rehash(m_capacity == 0 ? detail::group_width : m_capacity * 2);
+		}
+
+		bool rehash(usize new_capacity) noexcept
+		{
+			const usize slot_bytes = new_capacity * sizeof(entry_t);
+			u8* block = static_cast<u8*>(allocator().allocate(block_bytes(new_capacity), alignof(entry_t)));
+			if (!block)
+				return false; // allocation failed
+
+			entry_t* old_slots = m_slots;
+			u8* old_ctrl = m_ctrl;
+			const usize old_capacity = m_capacity;
+
+			m_slots = reinterpret_cast<entry_t*>(block);
+			m_ctrl = block + slot_bytes;
+			m_capacity = new_capacity;
+			for (usize i = 0; i < new_capacity + detail::group_width; ++i)
+				m_ctrl[i] = detail::ctrl_empty;
+
+			for (usize i = 0; i < old_capacity; ++i)
+			{
+				if (old_ctrl[i] == detail::ctrl_empty)
+					continue;
+
+				const u64 h = H{}(old_slots[i].first);
+				const usize j = find_free(h);
+				new (m_slots + j) entry_t(static_cast<entry_t&&>(old_slots[i]));
+				old_slots[i].~entry_t();
+				set_ctrl(j, h2(h));
+			}
+
+			if (old_slots)
+				allocator().deallocate(old_slots, block_bytes(old_capacity));
+			return true;
+		}
+
+		// Slots and control bytes (plus the mirrored group) share one block
+		static inline usize block_bytes(usize capacity) noexcept
+		{
+			return capacity * sizeof(entry_t) + capacity + detail::group_width;
+		}
+
+		inline void release() noexcept
+		{
+			if (m_slots)
+				allocator().deallocate(m_slots, block_bytes(m_capacity));
+		}
+
+		entry_t* m_slots{ nullptr };
+		u8* m_ctrl{ nullptr };
+		usize m_size{ 0 };
+		usize m_capacity{ 0 };
+	};
 }
 
-#endif // BX_HASH_MAP
\ No newline at end of file
+#endif // BX_HASH_MAP
@@ -3,15 +3,16 @@
 
 #include <bx/core.hpp>
 #include <bx/array.hpp>
-#include <string>
+#include <bx/hash.hpp>
+#include <bx/allocator.hpp>
+
+#include <new>
+#include <cstdio>
+#include <cstring>
+#include <cstdarg>
 
 namespace bx
 {
-	using string = std::string; // TODO: Temp fallback to c++ stl
-
-	template <usize N>
-	struct bx_api string_fixed {}; // TODO: Implement string fixed size
-
 	struct bx_api string_view
 	{
 		using iterator = char*;
@@ -26,9 +27,357 @@ namespace bx
 		constexpr const_iterator begin() const noexcept { return cstr; }
 		constexpr const_iterator end() const noexcept { return cstr + size; }
 
+		inline bool operator==(const string_view& other) const noexcept
+		{
+			return size == other.size && (size == 0 || std::memcmp(cstr, other.cstr, size) == 0);
+		}
+		inline bool operator!=(const string_view& other) const noexcept { return !(*this == other); }
+
 		cstring cstr{ nullptr };
 		usize size{ 0 };
 	};
+
+	// Owned, null terminated string. Up to inline_capacity() characters are stored
+	// inside the object itself, longer strings spill to memory from A. On
+	// allocation failure the string is left unchanged, same as bx::array.
+	template <typename A = heap_allocator>
+	struct bx_api basic_string : private A
+	{
+		using iterator = char*;
+		using const_iterator = const char*;
+		using allocator_type = A;
+
+		static constexpr usize inline_capacity() noexcept { return 23; }
+
+		basic_string() noexcept { m_inline[0] = '\0'; }
+		explicit basic_string(const A& allocator) noexcept : A(allocator) { m_inline[0] = '\0'; }
+		basic_string(cstring cstr) noexcept : basic_string() { if (cstr) append(cstr, std::strlen(cstr)); }
+		basic_string(cstring cstr, usize len) noexcept : basic_string() { append(cstr, len); }
+		explicit basic_string(string_view view) noexcept : basic_string() { append(view.cstr, view.size); }
+
+		~basic_string() noexcept
+		{
+			release();
+		}
+
+		basic_string(const basic_string& other) noexcept : basic_string(other.allocator()) { append(other.data(), other.size()); }
+
+		basic_string& operator=(const basic_string& other) noexcept
+		{
+			if (this != &other)
+			{
+				clear();
+				append(other.data(), other.size());
+			}
+			return *this;
+		}
+
+		basic_string(basic_string&& other) noexcept
+			: A(static_cast<A&&>(other)), m_size(other.m_size)
+		{
+			std::memcpy(m_inline, other.m_inline, sizeof(m_inline));
+			other.m_size = 0;
+			other.m_inline[0] = '\0';
+		}
+
+		basic_string& operator=(basic_string&& other) noexcept
+		{
+			if (this != &other)
+			{
+				release();
+
+				static_cast<A&>(*this) = static_cast<A&&>(other);
+				std::memcpy(m_inline, other.m_inline, sizeof(m_inline));
+				m_size = other.m_size;
+
+				other.m_size = 0;
+				other.m_inline[0] = '\0';
+			}
+			return *this;
+		}
+
+		basic_string& operator=(cstring cstr) noexcept
+		{
+			clear();
+			if (cstr)
+				append(cstr, std::strlen(cstr));
+			return *this;
+		}
+
+		inline char& operator[](usize i) noexcept { return data()[i]; }
+		inline const char& operator[](usize i) const noexcept { return data()[i]; }
+
+		inline iterator begin() noexcept { return data(); }
+		inline iterator end() noexcept { return data() + size(); }
+
+		inline const_iterator begin() const noexcept { return data(); }
+		inline const_iterator end() const noexcept { return data() + size(); }
+
+		inline char* data() noexcept { return is_heap() ? m_heap.data : m_inline; }
+		inline const char* data() const noexcept { return is_heap() ? m_heap.data : m_inline; }
+		inline cstring c_str() const noexcept { return data(); }
+
+		inline usize size() const noexcept { return m_size & ~heap_flag; }
+		inline usize length() const noexcept { return size(); }
+		inline usize capacity() const noexcept { return is_heap() ? m_heap.capacity : inline_capacity(); }
+		inline bool empty() const noexcept { return size() == 0; }
+
+		inline operator string_view() const noexcept { return string_view{ data(), size() }; }
+
+		// Capacity excludes the null terminator
+		bool reserve(usize new_capacity) noexcept
+		{
+			if (new_capacity <= capacity())
+				return true;
+
+			char* new_data = static_cast<char*>(allocator().allocate(new_capacity + 1, 1));
+			if (!new_data)
+				return false;
+
+			const usize len = size();
+			std::memcpy(new_data, data(), len + 1);
+
+			release();
+
+			m_heap.data = new_data;
+			m_heap.capacity = new_capacity;
+			m_size = len | heap_flag;
+			return true;
+		}
+
+		// New characters are filled with fill
+		inline void resize(usize new_size, char fill = '\0') noexcept
+		{
+			const usize len = size();
+			if (new_size > len)
+			{
+				if (!grow(new_size))
+					return;
+				std::memset(data() + len, fill, new_size - len);
+			}
+			set_size(new_size);
+		}
+
+		basic_string& append(cstring str, usize len) noexcept
+		{
+			if (len == 0)
+				return *this;
+
+			// str may point into this string, keep it valid across a reallocation
+			const usize old_size = size();
+			const bool aliased = str >= data() && str < data() + old_size;
+			const usize offset = aliased ? static_cast<usize>(str - data()) : 0;
+			if (!grow(old_size + len))
+				return *this;
+
+			std::memmove(data() + old_size, aliased ? data() + offset : str, len);
+			set_size(old_size + len);
+			return *this;
+		}
+
+		inline basic_string& append(cstring str) noexcept { return str ? append(str, std::strlen(str)) : *this; }
+		inline basic_string& append(const basic_string& str) noexcept { return append(str.data(), str.size()); }
+		inline basic_string& append(string_view view) noexcept { return append(view.cstr, view.size); }
+
+		inline basic_string& operator+=(cstring str) noexcept { return append(str); }
+		inline basic_string& operator+=(const basic_string& str) noexcept { return append(str); }
+		inline basic_string& operator+=(string_view view) noexcept { return append(view); }
+		inline basic_string& operator+=(char c) noexcept { push_back(c); return *this; }
+
+		inline void push_back(char c) noexcept { append(&c, 1); }
+
+		inline void pop_back() noexcept
+		{
+			if (!empty())
+				set_size(size() - 1);
+		}
+
+		// Keeps the allocated capacity
+		inline void clear() noexcept { set_size(0); }
+
+		inline bool operator==(const basic_string& other) const noexcept { return string_view(*this) == string_view(other); }
+		inline bool operator!=(const basic_string& other) const noexcept { return !(*this == other); }
+		inline bool operator==(cstring other) const noexcept { return other && string_view(*this) == string_view{ other, std::strlen(other) }; }
+		inline bool operator!=(cstring other) const noexcept { return !(*this == other); }
+
+		inline A& allocator() noexcept { return *this; }
+		inline const A& allocator() const noexcept { return *this; }
+
+	private:
+		static constexpr usize heap_flag = usize(1) << (sizeof(usize) * 8 - 1);
+
+		inline bool is_heap() const noexcept { return (m_size & heap_flag) != 0; }
+
+		inline void release() noexcept
+		{
+			if (is_heap())
+				allocator().deallocate(m_heap.data, m_heap.capacity + 1);
+		}
+
+		inline void set_size(usize new_size) noexcept
+		{
+			m_size = new_size | (m_size & heap_flag);
+			data()[new_size] = '\0';
+		}
+
+		// Geometric growth so repeated appends stay amortized
+		inline bool grow(usize required) noexcept
+		{
+			const usize cap = capacity();
+			if (required <= cap)
+				return true;
+			return reserve(required > cap * 2 ? required : cap * 2);
+		}
+
+		struct heap_t
+		{
+			char* data;
+			usize capacity;
+		};
+
+		union
+		{
+			char m_inline[24];
+			heap_t m_heap;
+		};
+		usize m_size{ 0 };
+	};
+
+	// Stack only string, never allocates. Writes past N - 1 characters are
+	// truncated, functions return false when that happens.
+	template <usize N>
+	struct bx_api string_fixed
+	{
+		static_assert(N > 0, "string_fixed needs room for the null terminator");
+
+		using iterator = char*;
+		using const_iterator = const char*;
+
+		string_fixed() noexcept { m_data[0] = '\0'; }
+		string_fixed(cstring cstr) noexcept : string_fixed() { assign(cstr); }
+		string_fixed(cstring cstr, usize len) noexcept : string_fixed() { append(cstr, len); }
+
+		string_fixed& operator=(cstring cstr) noexcept
+		{
+			assign(cstr);
+			return *this;
+		}
+
+		inline char& operator[](usize i) noexcept { return m_data[i]; }
+		inline const char& operator[](usize i) const noexcept { return m_data[i]; }
+
+		inline iterator begin() noexcept { return m_data; }
+		inline iterator end() noexcept { return m_data + m_size; }
+
+		inline const_iterator begin() const noexcept { return m_data; }
+		inline const_iterator end() const noexcept { return m_data + m_size; }
+
+		inline char* data() noexcept { return m_data; }
+		inline const char* data() const noexcept { return m_data; }
+		inline cstring c_str() const noexcept { return m_data; }
+
+		inline usize size() const noexcept { return m_size; }
+		inline usize length() const noexcept { return m_size; }
+		static constexpr usize capacity() noexcept { return N - 1; }
+		inline bool empty() const noexcept { return m_size == 0; }
+
+		inline operator string_view() const noexcept { return string_view{ m_data, m_size }; }
+
+		inline bool assign(cstring str) noexcept
+		{
+			clear();
+			return append(str);
+		}
+
+		bool append(cstring str, usize len) noexcept
+		{
+			const usize room = capacity() - m_size;
+			const usize count = len < room ? len : room;
+			std::memmove(m_data + m_size, str, count);
+			m_size += count;
+			m_data[m_size] = '\0';
+			return count == len;
+		}
+
+		inline bool append(cstring str) noexcept { return str ? append(str, std::strlen(str)) : true; }
+		inline bool append(string_view view) noexcept { return append(view.cstr, view.size); }
+
+		inline bool push_back(char c) noexcept { return append(&c, 1); }
+
+		inline string_fixed& operator+=(cstring str) noexcept { append(str); return *this; }
+		inline string_fixed& operator+=(string_view view) noexcept { append(view); return *this; }
+		inline string_fixed& operator+=(char c) noexcept { push_back(c); return *this; }
+
+		// printf style, replaces the current contents
+		bool format(cstring fstr, ...) noexcept
+		{
+			clear();
+			va_list args;
+			va_start(args, fstr);
+			const bool result = append_vformat(fstr, args);
+			va_end(args);
+			return result;
+		}
+
+		bool append_format(cstring fstr, ...) noexcept
+		{
+			va_list args;
+			va_start(args, fstr);
+			const bool result = append_vformat(fstr, args);
+			va_end(args);
+			return result;
+		}
+
+		bool append_vformat(cstring fstr, va_list args) noexcept
+		{
+			const usize room = capacity() - m_size;
+			const int written = std::vsnprintf(m_data + m_size, room + 1, fstr, args);
+			if (written < 0)
+			{
+				m_data[m_size] = '\0';
+				return false;
+			}
+
+			const usize count = static_cast<usize>(written);
+			m_size += count < room ? count : room;
+			return count <= room;
+		}
+
+		inline void clear() noexcept
+		{
+			m_size = 0;
+			m_data[0] = '\0';
+		}
+
+		inline bool operator==(string_view other) const noexcept { return string_view(*this) == other; }
+		inline bool operator!=(string_view other) const noexcept { return !(*this == other); }
+		inline bool operator==(cstring other) const noexcept { return other && string_view(*this) == string_view{ other, std::strlen(other) }; }
+		inline bool operator!=(cstring other) const noexcept { return !(*this == other); }
+
+	private:
+		char m_data[N];
+		usize m_size{ 0 };
+	};
+
+	template <>
+	struct bx_api hash<string_view>
+	{
+		inline u64 operator()(const string_view& value) const noexcept
+		{
+			return hash_mix(hash_bytes(value.cstr, value.size));
+		}
+	};
+
+	using string = basic_string<>;
+
+	template <typename A>
+	struct bx_api hash<basic_string<A>>
+	{
+		inline u64 operator()(const basic_string<A>& value) const noexcept
+		{
+			return hash_mix(hash_bytes(value.data(), value.size()));
+		}
+	};
 }
 
-#endif // BX_STRING
\ No newline at end of file
+#endif // BX_STRING
@@ -4,20 +4,20 @@
 #include <chrono>
 #include <atomic>
 #include <vector>
-#include <unordered_map>
+#include <thread>
+#include <cstdio>
+#include <cstring>
+#include <fmt/args.h>
 
 static bx::array<bx::category_t> g_categories{};
-static std::unordered_map<bx::category_t, cstring> g_categories_map{};
+static cstring g_category_names[64]{};
 
 static bx::log_callback_t g_log_callback = nullptr;
-static std::unordered_map<bx::category_t, bx::log_t> g_log_masks{};
+std::atomic<u8> bx::detail::log_disabled[64]{};
 
-static bool g_profiling = false;
-static u32 g_profile_depth = 0;
-static std::vector<cstring> g_profile_stack{};
-static std::vector<bx::profile_entry_t> g_profile_entries{};
+static bx::hash_map<u64, cstring> g_drives{};
 
-static std::unordered_map<u64, cstring> g_drives{};
+static bx::linear_allocator g_frame_allocator{};
 
 struct config_data_t
 {
@@ -25,23 +25,40 @@ struct config_data_t
 	bx::config_freefn_t free{ nullptr };
 };
 
-static std::unordered_map<u64, config_data_t> g_config{};
+static bx::hash_map<u64, config_data_t> g_config{};
 
-bx::category_t bx::register_category(cstring name) noexcept
+static u32 category_index(bx::category_t category) noexcept
 {
-	static category_t g_id{ 0 };
-	category_t next = bit_mask(g_id++);
-	g_categories.emplace_back(next);
-	g_categories_map.insert(std::make_pair(next, name));
-	return next;
+	u32 index = 0;
+	while (index < 63 && (category & (1ull << index)) == 0)
+		++index;
+	return index;
+}
+
+bx::category_t bx::register_category(cstring name, u32 bit) noexcept
+{
+	if (bit >= 64)
+		return default_category;
+
+	const category_t mask = 1ull << bit;
+	cstring owner = g_category_names[bit];
+	if (owner)
+	{
+		// Not bx_fatal, the bx category may be the one being registered
+		if (std::strcmp(owner, name) != 0)
+			logf_v(log_t::FATAL, default_category, bx_func, bx_file, bx_line, "Category '{}' claims bit {} already owned by '{}'", name, bit, owner);
+		return mask;
+	}
+
+	g_categories.emplace_back(mask);
+	g_category_names[bit] = name;
+	return mask;
 }
 
 cstring bx::category_name(category_t id) noexcept
 {
-	auto it = g_categories_map.find(id);
-	if (it == g_categories_map.end())
-		return "unknown";
-	return it->second;
+	cstring name = id ? g_category_names[category_index(id)] : nullptr;
+	return name ? name : "unknown";
 }
 
 bx::array_view<bx::category_t> bx::get_categories() noexcept
@@ -53,6 +70,11 @@ bx::result_t bx::app_init(const app_config_t& config) noexcept
 {
 	bx_profile(bx);
 
+	if (!g_frame_allocator.init(config.frame_memory))
+		return result_t::OUT_OF_MEMORY;
+
+	bx::file_watch_init(config);
+
 	if (!bx::dvc_init(config))
 		return result_t::FAIL;
 
@@ -66,8 +88,21 @@ void bx::app_shutdown() noexcept
 {
 	bx_profile(bx);
 
-	bx::dvc_shutdown();
+	// Reverse of init, gfx releases its objects while the device's context is current
 	bx::gfx_shutdown();
+	bx::dvc_shutdown();
+
+	bx::file_watch_shutdown();
+
+	g_frame_allocator.shutdown();
+
+	// Drains and stops the writer thread if async logging is on
+	bx::log_set_async(false);
+}
+
+bx::linear_allocator& bx::app_frame_allocator() noexcept
+{
+	return g_frame_allocator;
 }
 
 u64 bx::app_timestamp_ms() noexcept
@@ -116,7 +151,10 @@ void bx::log_set_category_types(category_t category, log_t types) noexcept
 {
 	bx_profile(bx);
 
-	g_log_masks[category] = types;
+	if (category == default_category)
+		return;
+
+	detail::log_disabled[category_index(category)].store(static_cast<u8>(~static_cast<u32>(types)), std::memory_order_relaxed);
 }
 
 static cstring get_func_name(cstring func)
@@ -146,11 +184,12 @@ static void crash(cstring reason, cstring file, i32 line)
 	std::cerr << "The application has encountered an unexpected state and must terminate.\n";
 	std::cerr << "Please report this issue with the following stack trace:\n\n";
 
-	if (!g_profile_stack.empty())
+	const auto stack = bx::profile_get_stack();
+	if (!stack.empty())
 	{
-		for (usize i = g_profile_stack.size(); i-- > 0; )
+		for (usize i = stack.size(); i-- > 0; )
 		{
-			std::cerr << i << ": " << g_profile_stack[i] << "()\n";
+			std::cerr << i << ": " << stack[i] << "()\n";
 		}
 	}
 	else
@@ -183,30 +222,58 @@ void bx::log(log_t level, cstring str) noexcept
 	}
 }
 
-void bx::log_v(log_t level, category_t category, cstring func, cstring file, i32 line, cstring msg) noexcept
+static bool log_category_enabled(bx::log_t level, bx::category_t category) noexcept
 {
-	auto it = g_log_masks.find(category);
-	if (it != g_log_masks.end() && ((u32)it->second & (u32)level) == 0)
-		return;
+	if (level == bx::log_t::FATAL || category == bx::default_category)
+		return true;
+
+	const u8 disabled = bx::detail::log_disabled[category_index(category)].load(std::memory_order_relaxed);
+	return (disabled & static_cast<u8>(level)) == 0;
+}
 
+// "[LEVEL:category] (file:line) func: ", func and file already trimmed
+static void log_format_prefix(fmt::memory_buffer& buffer, bx::log_t level, bx::category_t category, cstring func_name, cstring file_name, i32 line) noexcept
+{
 	cstring level_str = nullptr;
 	switch (level) {
-	case log_t::INFO:		level_str = "INFO"; break;
-	case log_t::WARN:		level_str = "WARN"; break;
-	case log_t::ERROR:		level_str = "ERROR"; break;
-	case log_t::FATAL:		level_str = "FATAL"; break;
-	case log_t::VERBOSE:	level_str = "VERBOSE"; break;
-	case log_t::DEBUG:		level_str = "DEBUG"; break;
+	case bx::log_t::INFO:		level_str = "INFO"; break;
+	case bx::log_t::WARN:		level_str = "WARN"; break;
+	case bx::log_t::ERROR:		level_str = "ERROR"; break;
+	case bx::log_t::FATAL:		level_str = "FATAL"; break;
+	case bx::log_t::VERBOSE:	level_str = "VERBOSE"; break;
+	case bx::log_t::DEBUG:		level_str = "DEBUG"; break;
+	}
+
+	cstring category_str = bx::category_name(category);
+	fmt::format_to(std::back_inserter(buffer), "[{}:{}] ({}:{}) {}: ", level_str, category_str, file_name, line, func_name);
+}
+
+static bool log_push_string(bx::log_t level, bx::category_t category, cstring func, cstring file, i32 line, cstring msg) noexcept;
+
+void bx::log_v(log_t level, category_t category, cstring func, cstring file, i32 line, cstring msg) noexcept
+{
+	if (!log_category_enabled(level, category))
+		return;
+
+	// Keep ordering with queued messages, preformatted text rides the queue too
+	if (log_is_async())
+	{
+		if (level != log_t::FATAL && log_push_string(level, category, func, file, line, msg))
+			return;
+		log_flush();
 	}
 
 	cstring func_name = get_func_name(func);
 	cstring file_name = get_file_name(file);
 
-	cstring category_str = category_name(category);
-	std::string formatted = fmt::format("[{}:{}] ({}:{}) {}: {}", level_str, category_str, file_name, line, func_name, msg);
-	
+	fmt::memory_buffer buffer;
+	log_format_prefix(buffer, level, category, func_name, file_name, line);
+	buffer.append(fmt::string_view(msg));
+	buffer.push_back('\0');
+	cstring formatted = buffer.data();
+
 	if (g_log_callback)
-		g_log_callback(level, category, func_name, file_name, line, formatted.c_str());
+		g_log_callback(level, category, func_name, file_name, line, formatted);
 
 	switch (level)
 	{
@@ -228,68 +295,328 @@ void bx::log_v(log_t level, category_t category, cstring func, cstring file, i32
 	}
 }
 
-void bx::profile_start() noexcept
+// ------------------------------------------
+// -            Async logging               -
+// ------------------------------------------
+
+#define BX_LOG_QUEUE_CAPACITY 1024 // records, power of two
+#define BX_LOG_BATCH_SIZE (64 * 1024)
+#define BX_LOG_FULL_WAIT_MS 100 // how long a full queue may make no progress before messages are dropped
+
+struct log_record_t
 {
-	bx_profile(bx);
+	bx::log_t level{ bx::log_t::INFO };
+	bx::category_t category{ 0 };
+	cstring func{ nullptr };
+	cstring file{ nullptr };
+	i32 line{ 0 };
+	cstring fstr{ nullptr };
+	bx::detail::log_args_t args{};
+};
 
-	g_profile_entries.clear();
-	g_profiling = true;
+// Bounded MPMC queue (D. Vyukov), each slot's sequence tells producers and
+// the consumer whose turn it is, so neither side takes a lock
+struct log_slot_t
+{
+	std::atomic<u64> sequence{ 0 };
+	log_record_t record{};
+};
+
+struct log_queue_t
+{
+	log_slot_t slots[BX_LOG_QUEUE_CAPACITY];
+	std::atomic<u64> enqueue_pos{ 0 };
+	u64 dequeue_pos{ 0 };					// writer thread only
+	std::atomic<u64> written_pos{ 0 };		// records fully written and flushed
+	std::atomic<u64> stalled_pos{ 0 };		// enqueue_pos + 1 when producers gave up waiting, 0 if none
+	std::atomic<bool> running{ false };
+	std::thread thread{};
+};
+
+static std::atomic<log_queue_t*> g_log_queue{ nullptr };
+// Threads that may still hold the queue pointer, disabling waits for these before deleting it
+static std::atomic<u32> g_log_users{ 0 };
+
+struct log_user_t
+{
+	log_user_t() noexcept { g_log_users.fetch_add(1, std::memory_order_seq_cst); }
+	~log_user_t() noexcept { g_log_users.fetch_sub(1, std::memory_order_release); }
+};
+
+static std::atomic<u64> g_log_dropped{ 0 };
+
+static bool log_is_writer(const log_queue_t& queue) noexcept
+{
+	return queue.thread.get_id() == std::this_thread::get_id();
 }
 
-void bx::profile_stop() noexcept
+// Returns false when the caller must write the message itself. A full queue
+// is waited on while the writer keeps freeing slots, if it stalls for
+// BX_LOG_FULL_WAIT_MS the message is dropped and counted instead.
+template <typename Fn>
+static bool log_enqueue(log_queue_t& queue, Fn&& fill) noexcept
 {
-	bx_profile(bx);
+	using clock = std::chrono::steady_clock;
 
-	g_profiling = false;
+	u64 pos = queue.enqueue_pos.load(std::memory_order_relaxed);
+	clock::time_point stalled_since{};
+	for (;;)
+	{
+		log_slot_t& slot = queue.slots[pos & (BX_LOG_QUEUE_CAPACITY - 1)];
+		const u64 sequence = slot.sequence.load(std::memory_order_acquire);
+		const i64 diff = static_cast<i64>(sequence - pos);
+		if (diff == 0)
+		{
+			if (queue.enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+			{
+				fill(slot.record);
+				slot.sequence.store(pos + 1, std::memory_order_release);
+				return true;
+			}
+		}
+		else if (diff < 0)
+		{
+			// The writer can't wait on itself, its messages go out synchronously
+			if (log_is_writer(queue))
+				return false;
+
+			// Once one producer gave up, the others drop too until a slot frees up
+			const u64 last = pos;
+			pos = queue.enqueue_pos.load(std::memory_order_relaxed);
+			if (pos == last && queue.stalled_pos.load(std::memory_order_relaxed) == pos + 1)
+			{
+				g_log_dropped.fetch_add(1, std::memory_order_relaxed);
+				return true;
+			}
+
+			if (pos != last || stalled_since == clock::time_point{})
+			{
+				stalled_since = clock::now();
+			}
+			else if (clock::now() - stalled_since > std::chrono::milliseconds(BX_LOG_FULL_WAIT_MS))
+			{
+				queue.stalled_pos.store(pos + 1, std::memory_order_relaxed);
+				g_log_dropped.fetch_add(1, std::memory_order_relaxed);
+				return true;
+			}
+			std::this_thread::yield();
+		}
+		else
+		{
+			pos = queue.enqueue_pos.load(std::memory_order_relaxed);
+		}
+	}
 }
 
-bx::array_view<bx::profile_entry_t> bx::profile_get_entries() noexcept
+bool bx::detail::log_push(log_t level, category_t category, cstring func, cstring file, i32 line, cstring fstr, const log_args_t& args) noexcept
 {
-	bx_profile(bx);
+	log_user_t user;
+	log_queue_t* queue = g_log_queue.load(std::memory_order_seq_cst);
+	if (!queue || level == log_t::FATAL)
+		return false;
 
-	return { g_profile_entries.data(), g_profile_entries.size() };
+	if (!log_category_enabled(level, category))
+		return true;
+
+	return log_enqueue(*queue, [&](log_record_t& record)
+		{
+			record.level = level;
+			record.category = category;
+			record.func = func;
+			record.file = file;
+			record.line = line;
+			record.fstr = fstr;
+			std::memcpy(record.args.data, args.data, args.size);
+			record.args.size = args.size;
+			record.args.count = args.count;
+		});
 }
 
-void bx::profile_push(u64 category, cstring label, cstring func, cstring file, i32 line) noexcept
+static bool log_push_string(bx::log_t level, bx::category_t category, cstring func, cstring file, i32 line, cstring msg) noexcept
 {
-	const auto depth = g_profile_depth++;
-	g_profile_stack.emplace_back(func);
+	bx::detail::log_args_t args;
+	if (!bx::detail::log_pack(args, msg))
+		return false;
+	return bx::detail::log_push(level, category, func, file, line, "{}", args);
+}
 
-	if (!g_profiling)
+static void log_unpack(const bx::detail::log_args_t& args, fmt::dynamic_format_arg_store<fmt::format_context>& store) noexcept
+{
+	using bx::detail::log_arg_t;
+
+	const u8* data = args.data;
+	const u8* end = args.data + args.size;
+	while (data < end)
+	{
+		const log_arg_t type = static_cast<log_arg_t>(*data++);
+		switch (type)
+		{
+		case log_arg_t::BOOL: { bool v; std::memcpy(&v, data, sizeof(v)); data += sizeof(v); store.push_back(v); break; }
+		case log_arg_t::CHAR: { char v; std::memcpy(&v, data, sizeof(v)); data += sizeof(v); store.push_back(v); break; }
+		case log_arg_t::I64: { i64 v; std::memcpy(&v, data, sizeof(v)); data += sizeof(v); store.push_back(v); break; }
+		case log_arg_t::U64: { u64 v; std::memcpy(&v, data, sizeof(v)); data += sizeof(v); store.push_back(v); break; }
+		case log_arg_t::F32: { f32 v; std::memcpy(&v, data, sizeof(v)); data += sizeof(v); store.push_back(v); break; }
+		case log_arg_t::F64: { f64 v; std::memcpy(&v, data, sizeof(v)); data += sizeof(v); store.push_back(v); break; }
+		case log_arg_t::POINTER: { cvptr v; std::memcpy(&v, data, sizeof(v)); data += sizeof(v); store.push_back(v); break; }
+		case log_arg_t::STRING:
+		{
+			u16 len;
+			std::memcpy(&len, data, sizeof(len));
+			data += sizeof(len);
+			store.push_back(fmt::string_view(reinterpret_cast<cstring>(data), len));
+			data += len;
+			break;
+		}
+		}
+	}
+}
+
+static void log_write_batch(fmt::memory_buffer& batch, std::FILE* stream) noexcept
+{
+	if (batch.size() == 0)
 		return;
+	std::fwrite(batch.data(), 1, batch.size(), stream);
+	std::fflush(stream);
+	batch.clear();
+}
+
+struct log_writer_state_t
+{
+	fmt::memory_buffer out{};
+	fmt::memory_buffer err{};
+	fmt::memory_buffer line{};
+	fmt::dynamic_format_arg_store<fmt::format_context> store{};
+};
 
-	profile_entry_t entry{};
-	entry.category = category;
-	entry.depth = depth;
-	entry.start_ts = app_timestamp_ns();
-	entry.end_ts = 0;
-	entry.label = label;
-	entry.file = file;
-	entry.line = line;
+// Formats every record that is ready, returns false if there was none
+static bool log_drain(log_queue_t* queue, log_writer_state_t& state) noexcept
+{
+	bool wrote = false;
+	for (;;)
+	{
+		log_slot_t& slot = queue->slots[queue->dequeue_pos & (BX_LOG_QUEUE_CAPACITY - 1)];
+		if (slot.sequence.load(std::memory_order_acquire) != queue->dequeue_pos + 1)
+			break;
+		wrote = true;
+
+		const log_record_t& record = slot.record;
+		cstring func_name = get_func_name(record.func);
+		cstring file_name = get_file_name(record.file);
+
+		fmt::memory_buffer& line = state.line;
+		line.clear();
+		log_format_prefix(line, record.level, record.category, func_name, file_name, record.line);
+		state.store.clear();
+		log_unpack(record.args, state.store);
+		fmt::vformat_to(std::back_inserter(line), fmt::string_view(record.fstr), state.store);
+		line.push_back('\0');
+
+		if (g_log_callback)
+			g_log_callback(record.level, record.category, func_name, file_name, record.line, line.data());
+
+		fmt::memory_buffer& batch = record.level == bx::log_t::ERROR ? state.err : state.out;
+		batch.append(line.data(), line.data() + line.size() - 1);
+		batch.push_back('\n');
+
+		slot.sequence.store(queue->dequeue_pos + BX_LOG_QUEUE_CAPACITY, std::memory_order_release);
+		++queue->dequeue_pos;
+
+		if (state.out.size() > BX_LOG_BATCH_SIZE)
+			log_write_batch(state.out, stdout);
+		if (state.err.size() > BX_LOG_BATCH_SIZE)
+			log_write_batch(state.err, stderr);
+	}
 
-	g_profile_entries.emplace_back(entry);
+	// Queue drained, hand the batch to the OS and publish progress
+	log_write_batch(state.out, stdout);
+	log_write_batch(state.err, stderr);
+	queue->written_pos.store(queue->dequeue_pos, std::memory_order_release);
+	return wrote;
 }
 
-void bx::profile_pop() noexcept
+static void log_writer(log_queue_t* queue) noexcept
 {
-	if (g_profile_depth > 0)
-		g_profile_depth--;
+	log_writer_state_t state;
 
-	if (!g_profile_stack.empty())
-		g_profile_stack.pop_back();
+	u32 idle = 0;
+	for (;;)
+	{
+		if (log_drain(queue, state))
+		{
+			idle = 0;
+			continue;
+		}
 
-	if (!g_profiling)
+		if (!queue->running.load(std::memory_order_acquire))
+			break;
+
+		if (++idle < 64)
+			std::this_thread::yield();
+		else
+			std::this_thread::sleep_for(std::chrono::microseconds(500));
+	}
+}
+
+void bx::log_set_async(bool enabled) noexcept
+{
+	log_queue_t* queue = g_log_queue.load(std::memory_order_acquire);
+	if (enabled == (queue != nullptr))
 		return;
 
-	if (!g_profile_entries.empty())
-		g_profile_entries.back().end_ts = app_timestamp_ns();
+	if (enabled)
+	{
+		queue = new (std::nothrow) log_queue_t();
+		if (!queue)
+			return;
+
+		for (u64 i = 0; i < BX_LOG_QUEUE_CAPACITY; ++i)
+			queue->slots[i].sequence.store(i, std::memory_order_relaxed);
+
+		// iostream output still pending must come out before the writer's
+		std::cout.flush();
+		std::cerr.flush();
+
+		queue->running.store(true, std::memory_order_relaxed);
+		queue->thread = std::thread(log_writer, queue);
+		g_log_queue.store(queue, std::memory_order_release);
+	}
+	else
+	{
+		// New producers now see no queue, the ones that loaded it before must finish their push
+		g_log_queue.store(nullptr, std::memory_order_seq_cst);
+		while (g_log_users.load(std::memory_order_acquire) != 0)
+			std::this_thread::yield();
+
+		queue->running.store(false, std::memory_order_release);
+		queue->thread.join();
+
+		// The writer may have seen its last slot empty just before a push landed
+		log_writer_state_t state;
+		log_drain(queue, state);
+		delete queue;
+	}
 }
 
-bx_api bx::array_view<cstring> bx::profile_get_stack() noexcept
+bool bx::log_is_async() noexcept
 {
-	bx_profile(bx);
+	return g_log_queue.load(std::memory_order_relaxed) != nullptr;
+}
+
+void bx::log_flush() noexcept
+{
+	log_user_t user;
+	log_queue_t* queue = g_log_queue.load(std::memory_order_seq_cst);
+	if (!queue || log_is_writer(*queue))
+		return;
 
-	return { g_profile_stack.data(), g_profile_stack.size() };
+	const u64 target = queue->enqueue_pos.load(std::memory_order_acquire);
+	while (queue->written_pos.load(std::memory_order_acquire) < target)
+		std::this_thread::yield();
+}
+
+u64 bx::log_dropped_count() noexcept
+{
+	return g_log_dropped.load(std::memory_order_relaxed);
 }
 
 bool bx::file_add_drive(cstring drive, cstring root) noexcept
@@ -297,57 +624,39 @@ bool bx::file_add_drive(cstring drive, cstring root) noexcept
 	bx_profile(bx);
 
 	u64 hash = hash_cstring(drive);
-	if (g_drives.find(hash) != g_drives.end())
+	if (g_drives.contains(hash))
 		return false;
-	g_drives.insert(std::make_pair(hash, root));
+	g_drives.insert(hash, root);
+	file_watch_add_drive(drive, root);
 	return true;
 }
 
-bx::string bx::file_get_path(cstring filename) noexcept
+bx::string_fixed<512> bx::file_get_path(cstring filename) noexcept
 {
 	bx_profile(bx);
 
 	if (!filename || filename[0] != '[')
-		return "";
+		return {};
 
 	cstring end = std::strchr(filename, ']');
 	if (!end)
-		return "";
+		return {};
 
-	usize drive_len = 1 + end - filename;
-	nstring<512> drive_name{};
-	std::memcpy(drive_name, filename, drive_len);
-	drive_name[drive_len] = '\0';
+	// Hash the "[drive]" prefix in place, same FNV-1a as hash_cstring
+	const usize drive_len = 1 + end - filename;
+	const auto root = g_drives.get(bx::hash_bytes(filename, drive_len));
+	if (!root)
+		return {};
 
-	u64 hash = hash_cstring(drive_name);
-	auto it = g_drives.find(hash);
-	if (it == g_drives.end())
-		return "";
-
-	nstring<512> filepath{};
-	filepath[0] = '\0';
-	std::strncpy(filepath, it->second, 511);
-	filepath[511] = '\0';
-
-	usize root_len = std::strlen(filepath);
-	if (root_len > 0 && filepath[root_len - 1] != '/' && filepath[root_len - 1] != '\\')
-	{
-		if (root_len < 511)
-		{
-			filepath[root_len] = '/';
-			filepath[root_len + 1] = '\0';
-			++root_len;
-		}
-	}
+	string_fixed<512> filepath = *root;
+	if (!filepath.empty() && filepath[filepath.size() - 1] != '/' && filepath[filepath.size() - 1] != '\\')
+		filepath.push_back('/');
 
 	cstring relative = end + 1;
 	if (*relative == '/' || *relative == '\\')
 		++relative;
 
-	usize remaining_space = 511 - root_len;
-	std::strncat(filepath, relative, remaining_space);
-	filepath[511] = '\0';
-
+	filepath.append(relative);
 	return filepath;
 }
 
@@ -383,7 +692,7 @@ u64 bx::file_get_timestamp(cstring filename) noexcept
 {
 	bx_profile(bx);
 
-	string fp = bx::file_get_path(filename);
+	const auto fp = bx::file_get_path(filename);
 	if (fp.empty())
 		return 0;
 
@@ -419,7 +728,7 @@ void bx::config_set(const u64 type, cstring name, cvptr data, const config_freef
 	config_data_t cfg{};
 	cfg.data = data;
 	cfg.free = free;
-	g_config[hash] = cfg;
+	g_config.insert_or_assign(hash, cfg);
 }
 
 cvptr bx::config_get(const u64 type, cstring name) noexcept
@@ -427,10 +736,10 @@ cvptr bx::config_get(const u64 type, cstring name) noexcept
 	bx_profile(bx);
 
 	const u64 hash = hash_cstring(name) ^ type;
-	const auto it = g_config.find(hash);
-	if (it == g_config.end())
+	const auto cfg = g_config.get(hash);
+	if (!cfg)
 		return nullptr;
-	return it->second.data;
+	return cfg->data;
 }
 
 bool bx::config_has(const u64 type, cstring name) noexcept
@@ -438,7 +747,7 @@ bool bx::config_has(const u64 type, cstring name) noexcept
 	bx_profile(bx);
 
 	const u64 hash = hash_cstring(name) ^ type;
-	return g_config.find(hash) != g_config.end();
+	return g_config.contains(hash);
 }
 
 void bx::config_clear() noexcept
@@ -2,7 +2,10 @@
 #define BX_APP_IMPL
 
 #include <bx/app.hpp>
-#include <unordered_map>
+#include <bx/hash_map.hpp>
+#include <bx/handle_map.hpp>
+
+#define BX_GFX_FRAMES_IN_FLIGHT 3
 
 namespace bx
 {
@@ -39,45 +42,101 @@ namespace bx
 		};
 	};
 
-	template <typename T>
-	struct bx_api handlemap
+	bx_api bool dvc_init(const app_config_t& config) noexcept;
+	bx_api void dvc_shutdown() noexcept;
+
+	// File watcher, started by app_init. Drives added before or after are watched.
+	bx_api void file_watch_init(const app_config_t& config) noexcept;
+	bx_api void file_watch_shutdown() noexcept;
+	bx_api void file_watch_add_drive(cstring drive, cstring root) noexcept;
+
+	// Hands the changes gathered since the last call to the subscribers, called
+	// by the device backend from app_begin_frame before gfx_begin_frame
+	bx_api void file_watch_update() noexcept;
+
+	bx_api bool gfx_init(const app_config_t& config) noexcept;
+	bx_api void gfx_shutdown() noexcept;
+
+	// Called by the device backend around every frame, presented or not
+	bx_api void gfx_begin_frame() noexcept;
+	bx_api void gfx_end_frame() noexcept;
+
+	// Frame statistics. Backends count into the frame in progress on the graphics
+	// thread and close it at the end of gfx_end_frame, compile time may come from
+	// any thread.
+	bx_api void gfx_stats_init(const app_config_t& config) noexcept;
+	bx_api void gfx_stats_shutdown() noexcept;
+	bx_api void gfx_stats_end_frame() noexcept;
+	bx_api gfx_frame_stats_t& gfx_stats() noexcept;
+	bx_api void gfx_stats_shader_compiled(u64 ns) noexcept;
+
+	inline void gfx_stats_created(gfx_resource_stats_t& resource, u64 bytes = 0) noexcept
 	{
-		inline handle_id insert(const T& obj) noexcept
-		{
-			auto handle = counter++;
-			map.insert(std::make_pair(handle, obj));
-			return handle;
-		}
+		++resource.count;
+		resource.bytes += bytes;
+	}
 
-		inline void remove(handle_id handle) noexcept
-		{
-			const auto it = map.find(handle);
-			if (it == map.end())
-				return;
+	inline void gfx_stats_destroyed(gfx_resource_stats_t& resource, u64 bytes = 0) noexcept
+	{
+		--resource.count;
+		resource.bytes -= bytes;
+	}
 
-			map.erase(it);
-		}
+	// Bytes of one mip with every cube face, and of the mips from first_mip down
+	bx_api u64 gfx_texture_mip_size(const gfx_texture_desc_t& desc, u32 mip) noexcept;
+	bx_api u64 gfx_texture_storage_size(const gfx_texture_desc_t& desc, u32 first_mip = 0) noexcept;
 
-		inline T* get(handle_id handle) noexcept
-		{
-			auto it = map.find(handle);
-			if (it == map.end())
-				return nullptr;
-			return &it->second;
-		}
-
-	private:
-		handle_id counter{ 1 };
-		std::unordered_map<handle_id, T> map;
-	};
+	// Texture streaming, driven by the backend from gfx_begin_frame and gfx_shutdown
+	bx_api void gfx_stream_update() noexcept;
+	bx_api void gfx_stream_shutdown() noexcept;
 
-	bx_api bool dvc_init(const app_config_t& config) noexcept;
-	bx_api void dvc_shutdown() noexcept;
+	// desc.source or desc.filepath with macros defined and includes expanded.
+	// files receives the path hashes of desc.filepath and every include.
+	bx_api bool gfx_preprocess_glsl(const gfx_shader_desc_t& desc, bx::string& source, bx::array<u64>* files = nullptr) noexcept;
 
-	bx_api bool gfx_init(const app_config_t& config) noexcept;
-	bx_api void gfx_shutdown() noexcept;
+	// gfx_compile_shader_wait that also hands out the files the source came from
+	bx_api bool gfx_compile_shader_wait(handle_id job, array<u8>& spirv, bx::array<u64>* files) noexcept;
+
+	// Owned copy of a shader desc loaded from desc.filepath, kept by backends to
+	// compile the shader again when one of its files changes
+	struct gfx_shader_reload_t
+	{
+		gfx_shader_stage_t stage{};
+		gfx_shader_lang_t lang{};
+		bx::string filepath{};
+		bx::string entrypoint{};
+		bx::array<bx::string> macros{};		// name, value pairs
+		bx::array<u64> files{};				// path hashes of the file and its includes
+	};
 
-	bx_api bx::string gfx_compile_glsl(cstring src) noexcept;
+	bx_api void gfx_shader_reload_init(gfx_shader_reload_t& reload, const gfx_shader_desc_t& desc) noexcept;
+
+	// The desc to compile again, its macros point into macros and reload
+	bx_api gfx_shader_desc_t gfx_shader_reload_desc(const gfx_shader_reload_t& reload, bx::array<gfx_shader_macro_t>& macros) noexcept;
+
+	bx_api bool gfx_shader_reload_matches(const gfx_shader_reload_t& reload, array_view<cstring> paths) noexcept;
+
+	// Joins the compile workers, jobs nobody waited for are dropped
+	bx_api void gfx_shader_compiler_shutdown() noexcept;
+
+	// Compiled shaders on disk under app_config_t::shader_cache. Blobs are opaque,
+	// tagged with a backend defined format, keys are expected to cover the device.
+	bx_api void gfx_shader_cache_init(const app_config_t& config) noexcept;
+	bx_api void gfx_shader_cache_shutdown() noexcept;
+	bx_api bool gfx_shader_cache_load(u64 key, u32& format, bx::array<u8>& binary) noexcept;
+	bx_api void gfx_shader_cache_store(u64 key, u32 format, const u8* binary, usize size) noexcept;
+
+	// Shaders and pipelines shared between identical descs. Backends look a desc
+	// up before creating, a hit already holds another reference, add what they
+	// created and release before destroying, which is false while references remain.
+	bx_api void gfx_pipeline_cache_init() noexcept;
+	bx_api void gfx_pipeline_cache_shutdown() noexcept;
+	bx_api handle_id gfx_pipeline_cache_find(const gfx_shader_desc_t& desc) noexcept;
+	bx_api handle_id gfx_pipeline_cache_find(const gfx_pipeline_desc_t& desc) noexcept;
+	bx_api void gfx_pipeline_cache_add(const gfx_shader_desc_t& desc, handle_id shader) noexcept;
+	bx_api void gfx_pipeline_cache_add(const gfx_pipeline_desc_t& desc, handle_id pipeline) noexcept;
+	bx_api bool gfx_pipeline_cache_release_shader(handle_id shader) noexcept;
+	bx_api bool gfx_pipeline_cache_release_pipeline(handle_id pipeline) noexcept;
 }
 
 // Enum helpers
@@ -227,6 +227,10 @@ bool bx::app_begin_frame() noexcept
 	std::fill_n(g_key_pressed, GLFW_KEY_LAST + 1, false);
 	std::fill_n(g_key_released, GLFW_KEY_LAST + 1, false);
 
+	app_frame_allocator().reset();
+
+	file_watch_update();
+
 	/*if (glfwGetWindowAttrib(g_window, GLFW_ICONIFIED) != 0)
 	{
 		ImGui_ImplGlfw_Sleep(10);
@@ -271,6 +275,10 @@ void bx::app_end_frame(const bool present, const bool should_close) noexcept
 #endif
 	}
 
+#if defined(BX_APP_GFX_OPENGL) || defined(BX_APP_GFX_OPENGLES)
+	gfx_end_frame();
+#endif
+
 	const bool close = glfwWindowShouldClose(g_window) || should_close;
 	glfwSetWindowShouldClose(g_window, close);
 }
@@ -421,6 +429,8 @@ static void gl_begin_frame()
 {
 	bx_profile(bx);
 
+	bx::gfx_begin_frame();
+
 	int w, h;
 	glfwGetFramebufferSize(g_window, &w, &h);
 	glViewport(0, 0, w, h);
@@ -436,6 +446,9 @@ static void gl_end_frame()
 
 #ifdef BX_APP_IMGUI
 	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+
+	// ImGui drives GL directly, the backend's shadow state can't be trusted
+	bx::gfx_invalidate_state();
 #endif
 	glfwSwapBuffers(g_window);
 }
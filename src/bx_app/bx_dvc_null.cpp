@@ -0,0 +1,109 @@
+#include <bx_app_impl.hpp>
+
+#include <chrono>
+
+// Headless device, no window and no input. Frames run as fast as the caller
+// drives them, which is what tests, benchmarks and CI machines want.
+
+static i32 g_width = 0;
+static i32 g_height = 0;
+
+static bool g_should_close = false;
+
+static f64 g_last_time = 0.0;
+static f64 g_delta_time = 0.0;
+
+static std::chrono::steady_clock::time_point g_start_time{};
+
+bool bx::dvc_init(const app_config_t& config) noexcept
+{
+	bx_profile(bx);
+
+	g_width = config.width;
+	g_height = config.height;
+	g_should_close = false;
+
+	g_start_time = std::chrono::steady_clock::now();
+	g_last_time = 0.0;
+	g_delta_time = 0.0;
+
+	return true;
+}
+
+void bx::dvc_shutdown() noexcept
+{
+	bx_profile(bx);
+}
+
+bool bx::app_begin_frame() noexcept
+{
+	bx_profile(bx);
+
+	if (g_should_close)
+		return false;
+
+	const f64 current_time = app_time_seconds();
+	g_delta_time = current_time - g_last_time;
+	g_last_time = current_time;
+
+	app_frame_allocator().reset();
+
+	file_watch_update();
+
+	gfx_begin_frame();
+
+	return true;
+}
+
+void bx::app_end_frame(const bool present, const bool should_close) noexcept
+{
+	bx_profile(bx);
+
+	(void)present;
+	gfx_end_frame();
+
+	g_should_close = g_should_close || should_close;
+}
+
+f64 bx::app_time_seconds() noexcept
+{
+	bx_profile(bx);
+
+	const auto elapsed = std::chrono::steady_clock::now() - g_start_time;
+	return std::chrono::duration<f64>(elapsed).count();
+}
+
+f64 bx::app_frame_time() noexcept
+{
+	bx_profile(bx);
+
+	return g_delta_time;
+}
+
+void bx::dvc_screen_size(i32* w, i32* h) noexcept
+{
+	if (w) *w = g_width;
+	if (h) *h = g_height;
+}
+
+bool bx::dvc_key_down(const i32 key) noexcept
+{
+	(void)key;
+	return false;
+}
+
+bx::dvc_key_state_t bx::dvc_key(const i32 key) noexcept
+{
+	(void)key;
+	return dvc_key_state_t{};
+}
+
+bx::dvc_mouse_state_t bx::dvc_mouse() noexcept
+{
+	return dvc_mouse_state_t{};
+}
+
+void bx::dvc_set_cursor_visible(const bool visible) noexcept
+{
+	(void)visible;
+}
@@ -0,0 +1,354 @@
+#include <bx_app_impl.hpp>
+
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Watches the file drives for changes on a background thread. Events are
+// merged per path and handed out once a frame, so nothing polls the disk.
+// Only Linux has a watcher so far, elsewhere subscribers are never called.
+
+// Events keep coming while an editor writes, wait this long for them to settle
+#define BX_FILE_WATCH_SETTLE_MS 50
+
+struct file_watch_drive_t
+{
+	bx::string drive{};
+	bx::string root{};
+};
+
+struct file_watch_dir_t
+{
+	bx::string path;		// on disk
+	bx::string logical;		// "[drive]/dir/"
+};
+
+struct file_watch_subscriber_t
+{
+	bx::file_watch_fn callback{ nullptr };
+	vptr user{ nullptr };
+};
+
+struct file_watch_t
+{
+	bx::array<file_watch_drive_t> drives{}; // kept across init and shutdown, like the drives themselves
+	bx::handle_map<file_watch_subscriber_t> subscribers{};
+
+	// Filled by the watcher thread
+	std::mutex mutex{};
+	bx::array<bx::string> pending{};
+	bx::hash_map<u64, u8> pending_set{};
+
+	// Handed to subscribers, valid for the frame
+	bx::array<bx::string> changed{};
+	bx::array<cstring> changed_paths{};
+	bx::array<bx::handle_id> notify{};		// subscribers at the start of the update
+
+#ifdef __linux__
+	int fd{ -1 };
+	int wake_fd{ -1 };
+	bx::hash_map<u64, file_watch_dir_t> dirs{}; // by watch descriptor
+	std::thread thread{};
+#endif
+};
+
+static file_watch_t g_watch{};
+
+#ifdef __linux__
+
+static void file_watch_add_dir(const bx::string& path, const bx::string& logical) noexcept
+{
+	const int wd = inotify_add_watch(g_watch.fd, path.c_str(),
+		IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_ONLYDIR);
+	if (wd < 0)
+	{
+		bx_warn(bx, "Failed to watch directory {}", path.c_str());
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(g_watch.mutex);
+		g_watch.dirs.insert(static_cast<u64>(wd), file_watch_dir_t{ path, logical });
+	}
+
+	// inotify is not recursive, every directory gets its own watch
+	DIR* dir = opendir(path.c_str());
+	if (!dir)
+		return;
+
+	while (const dirent* entry = readdir(dir))
+	{
+		if (entry->d_name[0] == '.' || (entry->d_type != DT_DIR && entry->d_type != DT_UNKNOWN))
+			continue;
+
+		bx::string child = path;
+		child.push_back('/');
+		child.append(entry->d_name);
+
+		struct stat info{};
+		if (entry->d_type == DT_UNKNOWN && (stat(child.c_str(), &info) != 0 || !S_ISDIR(info.st_mode)))
+			continue;
+
+		bx::string child_logical = logical;
+		child_logical.append(entry->d_name);
+		child_logical.push_back('/');
+
+		file_watch_add_dir(child, child_logical);
+	}
+	closedir(dir);
+}
+
+static void file_watch_add_root(const file_watch_drive_t& drive) noexcept
+{
+	bx::string logical = drive.drive;
+	logical.push_back('/');
+	file_watch_add_dir(drive.root, logical);
+}
+
+// Paths written during the current burst, watcher thread only
+struct file_watch_burst_t
+{
+	bx::array<bx::string> paths{};
+	bx::hash_map<u64, u8> set{};
+};
+
+static void file_watch_collect(file_watch_burst_t& burst, const bx::string& path) noexcept
+{
+	const u64 hash = bx::hash_bytes(path.data(), path.size());
+	if (burst.set.contains(hash))
+		return;
+	burst.set.insert(hash, 1);
+	burst.paths.push_back(path);
+}
+
+// The burst settled, hand its paths to the next frame
+static void file_watch_push(file_watch_burst_t& burst) noexcept
+{
+	if (burst.paths.empty())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(g_watch.mutex);
+		for (auto& path : burst.paths)
+		{
+			const u64 hash = bx::hash_bytes(path.data(), path.size());
+			if (g_watch.pending_set.contains(hash))
+				continue;
+			g_watch.pending_set.insert(hash, 1);
+			g_watch.pending.push_back(std::move(path));
+		}
+	}
+	burst.paths.clear();
+	burst.set.clear();
+}
+
+static void file_watch_read_events(file_watch_burst_t& burst) noexcept
+{
+	alignas(inotify_event) char buffer[4096];
+	for (;;)
+	{
+		const ssize_t size = read(g_watch.fd, buffer, sizeof(buffer));
+		if (size <= 0)
+			return;
+
+		for (char* it = buffer; it < buffer + size; )
+		{
+			const inotify_event* event = reinterpret_cast<const inotify_event*>(it);
+			it += sizeof(inotify_event) + event->len;
+
+			bx::string path{};
+			bx::string disk_path{};
+			{
+				std::lock_guard<std::mutex> lock(g_watch.mutex);
+				if (event->mask & IN_IGNORED)
+				{
+					g_watch.dirs.erase(static_cast<u64>(event->wd));
+					continue;
+				}
+
+				auto dir = g_watch.dirs.find(static_cast<u64>(event->wd));
+				if (dir == g_watch.dirs.end() || event->len == 0)
+					continue;
+				path = dir->second.logical;
+				disk_path = dir->second.path;
+			}
+			path.append(event->name);
+
+			if (event->mask & IN_ISDIR)
+			{
+				// Directories moved or created inside a drive are watched from now on
+				if (event->mask & (IN_CREATE | IN_MOVED_TO))
+				{
+					disk_path.push_back('/');
+					disk_path.append(event->name);
+					path.push_back('/');
+					file_watch_add_dir(disk_path, path);
+				}
+				continue;
+			}
+
+			// Created files report again on IN_CLOSE_WRITE once written
+			if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+				file_watch_collect(burst, path);
+		}
+	}
+}
+
+static void file_watch_thread() noexcept
+{
+	pollfd fds[2]{};
+	fds[0].fd = g_watch.fd;
+	fds[0].events = POLLIN;
+	fds[1].fd = g_watch.wake_fd;
+	fds[1].events = POLLIN;
+
+	file_watch_burst_t burst{};
+	for (;;)
+	{
+		if (poll(fds, 2, -1) < 0)
+			continue;
+		if (fds[1].revents & POLLIN)
+			return;
+
+		// One batch per burst, the frame sees a file once however often it was
+		// written and only after no event came for BX_FILE_WATCH_SETTLE_MS
+		do
+		{
+			file_watch_read_events(burst);
+		} while (poll(fds, 1, BX_FILE_WATCH_SETTLE_MS) > 0 && (fds[0].revents & POLLIN));
+		file_watch_push(burst);
+	}
+}
+
+#endif
+
+void bx::file_watch_init(const app_config_t& config) noexcept
+{
+	bx_profile(bx);
+
+	if (!config.watch_files)
+		return;
+
+#ifdef __linux__
+	if (g_watch.fd >= 0)
+		return;
+
+	g_watch.fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	g_watch.wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (g_watch.fd < 0 || g_watch.wake_fd < 0)
+	{
+		bx_warn(bx, "File watcher disabled, inotify is not available");
+		if (g_watch.fd >= 0)
+			close(g_watch.fd);
+		if (g_watch.wake_fd >= 0)
+			close(g_watch.wake_fd);
+		g_watch.fd = g_watch.wake_fd = -1;
+		return;
+	}
+
+	for (const auto& drive : g_watch.drives)
+		file_watch_add_root(drive);
+
+	g_watch.thread = std::thread(file_watch_thread);
+#endif
+}
+
+void bx::file_watch_shutdown() noexcept
+{
+	bx_profile(bx);
+
+#ifdef __linux__
+	if (g_watch.fd >= 0)
+	{
+		const u64 one = 1;
+		if (write(g_watch.wake_fd, &one, sizeof(one)) == sizeof(one) && g_watch.thread.joinable())
+			g_watch.thread.join();
+
+		close(g_watch.fd);
+		close(g_watch.wake_fd);
+		g_watch.fd = g_watch.wake_fd = -1;
+	}
+	g_watch.dirs.clear();
+#endif
+
+	g_watch.pending = bx::array<bx::string>{};
+	g_watch.pending_set.clear();
+	g_watch.changed = bx::array<bx::string>{};
+	g_watch.changed_paths = bx::array<cstring>{};
+	g_watch.notify = bx::array<bx::handle_id>{};
+	g_watch.subscribers.clear();
+}
+
+void bx::file_watch_add_drive(cstring drive, cstring root) noexcept
+{
+	file_watch_drive_t entry{};
+	entry.drive = drive;
+	entry.root = root;
+
+	// Strip trailing separators, watched paths are built as root + '/' + name
+	while (entry.root.size() > 1 && (entry.root[entry.root.size() - 1] == '/' || entry.root[entry.root.size() - 1] == '\\'))
+		entry.root.pop_back();
+
+#ifdef __linux__
+	if (g_watch.fd >= 0)
+		file_watch_add_root(entry);
+#endif
+
+	g_watch.drives.push_back(std::move(entry));
+}
+
+void bx::file_watch_update() noexcept
+{
+	bx_profile(bx);
+
+	g_watch.changed.clear();
+	g_watch.changed_paths.clear();
+	{
+		std::lock_guard<std::mutex> lock(g_watch.mutex);
+		if (g_watch.pending.empty())
+			return;
+		std::swap(g_watch.changed, g_watch.pending);
+		g_watch.pending_set.clear();
+	}
+
+	for (const auto& path : g_watch.changed)
+		g_watch.changed_paths.push_back(path.c_str());
+
+	// Callbacks may subscribe or unsubscribe, walk the handles taken beforehand
+	g_watch.notify.clear();
+	for (usize i = 0; i < g_watch.subscribers.size(); ++i)
+		g_watch.notify.push_back(g_watch.subscribers.handle_at(i));
+
+	const array_view<cstring> paths{ g_watch.changed_paths.data(), g_watch.changed_paths.size() };
+	for (const handle_id handle : g_watch.notify)
+	{
+		const file_watch_subscriber_t* subscriber = g_watch.subscribers.get(handle);
+		if (subscriber)
+			subscriber->callback(subscriber->user, paths);
+	}
+}
+
+bx::handle_id bx::file_watch_subscribe(file_watch_fn callback, vptr user) noexcept
+{
+	if (!callback)
+		return invalid_handle;
+
+	file_watch_subscriber_t subscriber{};
+	subscriber.callback = callback;
+	subscriber.user = user;
+	return g_watch.subscribers.insert(subscriber);
+}
+
+void bx::file_watch_unsubscribe(handle_id subscription) noexcept
+{
+	g_watch.subscribers.remove(subscription);
+}
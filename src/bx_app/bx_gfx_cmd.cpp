@@ -0,0 +1,268 @@
+#include <bx_gfx_cmd.hpp>
+
+#include <atomic>
+#include <cstring>
+
+// Backend independent command buffers. Memory is kept when a buffer goes back
+// to the pool, after a few frames recording no longer allocates.
+
+struct gfx_cmd_buffer_t
+{
+	std::atomic<bool> in_use{ false };
+	std::atomic<u32> generation{ 0 };
+	bx::array<u64> words{};
+	bool failed{ false };
+};
+
+static gfx_cmd_buffer_t g_cmd_buffers[BX_GFX_MAX_COMMAND_BUFFERS]{};
+
+static gfx_cmd_buffer_t* gfx_cmd_get(bx::handle_id cb) noexcept
+{
+	const bx::handle_t handle{ cb };
+	if (handle.data >= BX_GFX_MAX_COMMAND_BUFFERS)
+		return nullptr;
+
+	gfx_cmd_buffer_t& buffer = g_cmd_buffers[handle.data];
+	if (!buffer.in_use.load(std::memory_order_acquire)
+		|| buffer.generation.load(std::memory_order_relaxed) != handle.meta)
+		return nullptr;
+	return &buffer;
+}
+
+static void gfx_cmd_release(gfx_cmd_buffer_t& buffer) noexcept
+{
+	buffer.words.clear();
+	buffer.failed = false;
+	buffer.in_use.store(false, std::memory_order_release);
+}
+
+bx::handle_id bx::gfx_begin_command_buffer() noexcept
+{
+	bx_profile(bx);
+
+	for (u32 i = 0; i < BX_GFX_MAX_COMMAND_BUFFERS; ++i)
+	{
+		gfx_cmd_buffer_t& buffer = g_cmd_buffers[i];
+		bool expected = false;
+		if (!buffer.in_use.compare_exchange_strong(expected, true, std::memory_order_acquire))
+			continue;
+
+		// Generation 0 is never handed out so a valid handle is never 0
+		u32 generation = buffer.generation.load(std::memory_order_relaxed) + 1;
+		if (generation == 0)
+			generation = 1;
+		buffer.generation.store(generation, std::memory_order_relaxed);
+		return handle_t(i, generation).id;
+	}
+
+	bx_error(bx, "gfx_begin_command_buffer: all {} command buffers are in use", BX_GFX_MAX_COMMAND_BUFFERS);
+	return invalid_handle;
+}
+
+void bx::gfx_discard_command_buffer(handle_id cb) noexcept
+{
+	bx_profile(bx);
+
+	gfx_cmd_buffer_t* buffer = gfx_cmd_get(cb);
+	if (buffer)
+		gfx_cmd_release(*buffer);
+}
+
+vptr bx::gfx_cmd_alloc(handle_id cb, gfx_cmd_type_t type, u32 payload_size) noexcept
+{
+	gfx_cmd_buffer_t* buffer = gfx_cmd_get(cb);
+	if (!buffer)
+	{
+		bx_warn(bx, "gfx_cmd_alloc: invalid command buffer handle");
+		return nullptr;
+	}
+
+	const u32 size = static_cast<u32>(align_up(sizeof(gfx_cmd_header_t) + payload_size, sizeof(u64)));
+	const usize offset = buffer->words.size();
+	const usize words = offset + size / sizeof(u64);
+
+	// resize only reserves what it needs, grow geometrically so recording stays linear
+	const usize capacity = buffer->words.capacity();
+	if (words > capacity)
+		buffer->words.reserve(words > capacity * 2 ? words : capacity * 2);
+	buffer->words.resize(words);
+	if (buffer->words.size() != words)
+	{
+		buffer->failed = true;
+		return nullptr;
+	}
+
+	u8* record = reinterpret_cast<u8*>(buffer->words.data() + offset);
+	new (record) gfx_cmd_header_t{ type, 0, size };
+	return record + sizeof(gfx_cmd_header_t);
+}
+
+bool bx::gfx_cmd_record_vertex_buffers(handle_id cb, u32 first_binding, u32 binding_count, const handle_id* vertex_buffers, const u64* offsets) noexcept
+{
+	const u32 arrays_size = binding_count * static_cast<u32>(sizeof(handle_id) + sizeof(u64));
+	u8* payload = static_cast<u8*>(gfx_cmd_alloc(cb, gfx_cmd_type_t::BIND_VERTEX_BUFFERS, sizeof(gfx_cmd_bind_vertex_buffers_t) + arrays_size));
+	if (!payload)
+		return false;
+
+	new (payload) gfx_cmd_bind_vertex_buffers_t{ first_binding, binding_count };
+
+	u8* dst_buffers = payload + sizeof(gfx_cmd_bind_vertex_buffers_t);
+	u8* dst_offsets = dst_buffers + binding_count * sizeof(handle_id);
+	std::memcpy(dst_buffers, vertex_buffers, binding_count * sizeof(handle_id));
+	if (offsets)
+		std::memcpy(dst_offsets, offsets, binding_count * sizeof(u64));
+	else
+		std::memset(dst_offsets, 0, binding_count * sizeof(u64));
+	return true;
+}
+
+bool bx::gfx_cmd_record_copy_buffer_to_texture(handle_id cb, handle_id buffer, handle_id texture, u32 region_count, const gfx_texture_region_t* regions) noexcept
+{
+	const u32 regions_size = region_count * static_cast<u32>(sizeof(gfx_texture_region_t));
+	u8* payload = static_cast<u8*>(gfx_cmd_alloc(cb, gfx_cmd_type_t::COPY_BUFFER_TO_TEXTURE, sizeof(gfx_cmd_copy_buffer_to_texture_t) + regions_size));
+	if (!payload)
+		return false;
+
+	new (payload) gfx_cmd_copy_buffer_to_texture_t{ buffer, texture, region_count };
+	std::memcpy(payload + sizeof(gfx_cmd_copy_buffer_to_texture_t), regions, regions_size);
+	return true;
+}
+
+template <typename T>
+static inline const T& gfx_cmd_payload(const u8* record) noexcept
+{
+	return *reinterpret_cast<const T*>(record + sizeof(bx::gfx_cmd_header_t));
+}
+
+void bx::gfx_cmd_execute(handle_id cb) noexcept
+{
+	bx_profile(bx);
+
+	gfx_cmd_buffer_t* buffer = gfx_cmd_get(cb);
+	if (!buffer)
+	{
+		bx_warn(bx, "gfx_submit: invalid command buffer handle");
+		return;
+	}
+
+	// A partial stream could draw with the wrong state, drop all of it
+	if (buffer->failed)
+	{
+		bx_error(bx, "gfx_submit: command buffer ran out of memory while recording, skipped");
+		gfx_cmd_release(*buffer);
+		return;
+	}
+
+	const u8* it = reinterpret_cast<const u8*>(buffer->words.data());
+	const u8* end = it + buffer->words.size() * sizeof(u64);
+	while (it < end)
+	{
+		const gfx_cmd_header_t& header = *reinterpret_cast<const gfx_cmd_header_t*>(it);
+		switch (header.type)
+		{
+		case gfx_cmd_type_t::BIND_PIPELINE:
+		{
+			const auto& cmd = gfx_cmd_payload<gfx_cmd_bind_pipeline_t>(it);
+			gfx_bind_pipeline(invalid_handle, cmd.pipeline);
+			break;
+		}
+		case gfx_cmd_type_t::BIND_VERTEX_BUFFERS:
+		{
+			const auto& cmd = gfx_cmd_payload<gfx_cmd_bind_vertex_buffers_t>(it);
+			const u8* extra = it + sizeof(gfx_cmd_header_t) + sizeof(gfx_cmd_bind_vertex_buffers_t);
+			const handle_id* buffers = reinterpret_cast<const handle_id*>(extra);
+			const u64* offsets = reinterpret_cast<const u64*>(extra + cmd.binding_count * sizeof(handle_id));
+			gfx_bind_vertex_buffers(invalid_handle, cmd.first_binding, cmd.binding_count, buffers, offsets);
+			break;
+		}
+		case gfx_cmd_type_t::BIND_INDEX_BUFFER:
+		{
+			const auto& cmd = gfx_cmd_payload<gfx_cmd_bind_index_buffer_t>(it);
+			gfx_bind_index_buffer(invalid_handle, cmd.index_buffer, cmd.index_type);
+			break;
+		}
+		case gfx_cmd_type_t::BIND_RESOURCE_SET:
+		{
+			const auto& cmd = gfx_cmd_payload<gfx_cmd_bind_resource_set_t>(it);
+			gfx_bind_resource_set(invalid_handle, cmd.pipeline, cmd.set, cmd.set_index);
+			break;
+		}
+		case gfx_cmd_type_t::DRAW:
+		{
+			const auto& cmd = gfx_cmd_payload<gfx_cmd_draw_t>(it);
+			gfx_draw(invalid_handle, cmd.vertex_count, cmd.instance_count, cmd.first_vertex, cmd.first_instance);
+			break;
+		}
+		case gfx_cmd_type_t::DRAW_INDEXED:
+		{
+			const auto& cmd = gfx_cmd_payload<gfx_cmd_draw_indexed_t>(it);
+			gfx_draw_indexed(invalid_handle, cmd.index_count, cmd.instance_count, cmd.first_index, cmd.vertex_offset, cmd.first_instance);
+			break;
+		}
+		case gfx_cmd_type_t::DRAW_INDIRECT:
+		{
+			const auto& cmd = gfx_cmd_payload<gfx_cmd_draw_indirect_t>(it);
+			gfx_draw_indirect(invalid_handle, cmd.buffer, cmd.offset, cmd.draw_count, cmd.stride);
+			break;
+		}
+		case gfx_cmd_type_t::DRAW_INDEXED_INDIRECT:
+		{
+			const auto& cmd = gfx_cmd_payload<gfx_cmd_draw_indirect_t>(it);
+			gfx_draw_indexed_indirect(invalid_handle, cmd.buffer, cmd.offset, cmd.draw_count, cmd.stride);
+			break;
+		}
+		case gfx_cmd_type_t::DRAW_INDEXED_INDIRECT_COUNT:
+		{
+			const auto& cmd = gfx_cmd_payload<gfx_cmd_draw_indexed_indirect_count_t>(it);
+			gfx_draw_indexed_indirect_count(invalid_handle, cmd.buffer, cmd.offset, cmd.count_buffer, cmd.count_offset, cmd.max_draw_count, cmd.stride);
+			break;
+		}
+		case gfx_cmd_type_t::COPY_BUFFER:
+		{
+			const auto& cmd = gfx_cmd_payload<gfx_cmd_copy_buffer_t>(it);
+			gfx_copy_buffer(invalid_handle, cmd.src, cmd.dst, cmd.src_offset, cmd.dst_offset, cmd.size);
+			break;
+		}
+		case gfx_cmd_type_t::COPY_BUFFER_TO_TEXTURE:
+		{
+			const auto& cmd = gfx_cmd_payload<gfx_cmd_copy_buffer_to_texture_t>(it);
+			const u8* extra = it + sizeof(gfx_cmd_header_t) + sizeof(gfx_cmd_copy_buffer_to_texture_t);
+			gfx_copy_buffer_to_texture(invalid_handle, cmd.buffer, cmd.texture, cmd.region_count, reinterpret_cast<const gfx_texture_region_t*>(extra));
+			break;
+		}
+		case gfx_cmd_type_t::DISPATCH:
+		{
+			const auto& cmd = gfx_cmd_payload<gfx_cmd_dispatch_t>(it);
+			gfx_dispatch(invalid_handle, cmd.x, cmd.y, cmd.z);
+			break;
+		}
+		case gfx_cmd_type_t::PIPELINE_BARRIER:
+		{
+			const auto& cmd = gfx_cmd_payload<gfx_cmd_pipeline_barrier_t>(it);
+			gfx_pipeline_barrier(invalid_handle, cmd.barrier);
+			break;
+		}
+		case gfx_cmd_type_t::CULL_INSTANCES:
+		{
+			const auto& cmd = gfx_cmd_payload<gfx_cmd_cull_instances_t>(it);
+			gfx_cull_instances(invalid_handle, cmd.desc);
+			break;
+		}
+		}
+		it += header.size;
+	}
+
+	gfx_cmd_release(*buffer);
+}
+
+void bx::gfx_cmd_shutdown() noexcept
+{
+	bx_profile(bx);
+
+	for (auto& buffer : g_cmd_buffers)
+	{
+		buffer.words = bx::array<u64>{};
+		buffer.failed = false;
+		buffer.in_use.store(false, std::memory_order_relaxed);
+	}
+}
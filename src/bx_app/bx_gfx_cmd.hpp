@@ -0,0 +1,157 @@
+#ifndef BX_GFX_CMD
+#define BX_GFX_CMD
+
+#include <bx_app_impl.hpp>
+
+#define BX_GFX_MAX_COMMAND_BUFFERS 64
+
+namespace bx
+{
+	// Commands are stored back to back as [header][payload][trailing data],
+	// every record padded to 8 bytes so payloads can be read in place.
+	enum struct gfx_cmd_type_t : u16
+	{
+		BIND_PIPELINE,
+		BIND_VERTEX_BUFFERS,
+		BIND_INDEX_BUFFER,
+		BIND_RESOURCE_SET,
+		DRAW,
+		DRAW_INDEXED,
+		DRAW_INDIRECT,
+		DRAW_INDEXED_INDIRECT,
+		DRAW_INDEXED_INDIRECT_COUNT,
+		COPY_BUFFER,
+		COPY_BUFFER_TO_TEXTURE,
+		DISPATCH,
+		PIPELINE_BARRIER,
+		CULL_INSTANCES
+	};
+
+	struct gfx_cmd_header_t
+	{
+		gfx_cmd_type_t type;
+		u16 reserved;
+		u32 size; // whole record in bytes, header included
+	};
+
+	struct gfx_cmd_bind_pipeline_t
+	{
+		handle_id pipeline;
+	};
+
+	// Followed by binding_count handle_ids, then binding_count u64 offsets
+	struct gfx_cmd_bind_vertex_buffers_t
+	{
+		u32 first_binding;
+		u32 binding_count;
+	};
+
+	struct gfx_cmd_bind_index_buffer_t
+	{
+		handle_id index_buffer;
+		gfx_index_type_t index_type;
+	};
+
+	struct gfx_cmd_bind_resource_set_t
+	{
+		handle_id pipeline;
+		handle_id set;
+		u32 set_index;
+	};
+
+	struct gfx_cmd_draw_t
+	{
+		u32 vertex_count;
+		u32 instance_count;
+		u32 first_vertex;
+		u32 first_instance;
+	};
+
+	struct gfx_cmd_draw_indexed_t
+	{
+		u32 index_count;
+		u32 instance_count;
+		u32 first_index;
+		i32 vertex_offset;
+		u32 first_instance;
+	};
+
+	// Shared by DRAW_INDIRECT and DRAW_INDEXED_INDIRECT
+	struct gfx_cmd_draw_indirect_t
+	{
+		handle_id buffer;
+		u64 offset;
+		u32 draw_count;
+		u32 stride;
+	};
+
+	struct gfx_cmd_draw_indexed_indirect_count_t
+	{
+		handle_id buffer;
+		u64 offset;
+		handle_id count_buffer;
+		u64 count_offset;
+		u32 max_draw_count;
+		u32 stride;
+	};
+
+	struct gfx_cmd_copy_buffer_t
+	{
+		handle_id src;
+		handle_id dst;
+		u64 src_offset;
+		u64 dst_offset;
+		u64 size;
+	};
+
+	// Followed by region_count gfx_texture_region_t
+	struct gfx_cmd_copy_buffer_to_texture_t
+	{
+		handle_id buffer;
+		handle_id texture;
+		u32 region_count;
+	};
+
+	struct gfx_cmd_dispatch_t
+	{
+		u32 x, y, z;
+	};
+
+	struct gfx_cmd_pipeline_barrier_t
+	{
+		gfx_memory_barrier_t barrier;
+	};
+
+	struct gfx_cmd_cull_instances_t
+	{
+		gfx_cull_desc_t desc;
+	};
+
+	// Reserves one command in a recording command buffer and returns its payload,
+	// 8 byte aligned. nullptr for unknown handles or when out of memory.
+	bx_api vptr gfx_cmd_alloc(handle_id cb, gfx_cmd_type_t type, u32 payload_size) noexcept;
+
+	template <typename T>
+	inline bool gfx_cmd_record(handle_id cb, gfx_cmd_type_t type, const T& cmd) noexcept
+	{
+		vptr payload = gfx_cmd_alloc(cb, type, sizeof(T));
+		if (!payload)
+			return false;
+		new (payload) T(cmd);
+		return true;
+	}
+
+	// Copies the buffer and offset arrays into the stream, missing offsets are zero
+	bx_api bool gfx_cmd_record_vertex_buffers(handle_id cb, u32 first_binding, u32 binding_count, const handle_id* vertex_buffers, const u64* offsets) noexcept;
+
+	bx_api bool gfx_cmd_record_copy_buffer_to_texture(handle_id cb, handle_id buffer, handle_id texture, u32 region_count, const gfx_texture_region_t* regions) noexcept;
+
+	// Replays every command through the immediate (cb = 0) gfx functions and
+	// gives the command buffer back to the pool. Graphics thread only.
+	bx_api void gfx_cmd_execute(handle_id cb) noexcept;
+
+	// Frees the memory kept by pooled command buffers
+	bx_api void gfx_cmd_shutdown() noexcept;
+}
+
+#endif // BX_GFX_CMD
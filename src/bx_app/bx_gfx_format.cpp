@@ -0,0 +1,231 @@
+#include <bx_app_impl.hpp>
+
+#include <cstring>
+
+// Texture and vertex attribute format sizes and the CPU decoder used when the
+// device can't sample BC formats. Decoding follows the D3D10 block layouts, little endian.
+
+static u32 format_block_bytes(const bx::gfx_texture_format_t format)
+{
+	switch (format)
+	{
+	case bx::gfx_texture_format_t::BC1U_NORM:
+	case bx::gfx_texture_format_t::BC4U_NORM:
+	case bx::gfx_texture_format_t::ETC2_RGB8U_NORM:
+		return 8;
+	case bx::gfx_texture_format_t::BC3U_NORM:
+	case bx::gfx_texture_format_t::BC5U_NORM:
+	case bx::gfx_texture_format_t::BC7U_NORM:
+	case bx::gfx_texture_format_t::ETC2_RGBA8U_NORM:
+	case bx::gfx_texture_format_t::ASTC_4X4U_NORM:
+		return 16;
+	default:
+		return 0;
+	}
+}
+
+bool bx::gfx_texture_format_is_compressed(gfx_texture_format_t format) noexcept
+{
+	return format_block_bytes(format) != 0;
+}
+
+u64 bx::gfx_texture_size(gfx_texture_format_t format, u32 width, u32 height, u32 depth) noexcept
+{
+	const u64 block = format_block_bytes(format);
+	if (block != 0)
+		return block * ((width + 3) / 4) * ((height + 3) / 4) * depth;
+
+	u64 texel = 4;
+	switch (format)
+	{
+	case gfx_texture_format_t::R8U_NORM:			texel = 1; break;
+	case gfx_texture_format_t::RG8U_NORM:			texel = 2; break;
+	case gfx_texture_format_t::RGBA8U_NORM:			texel = 4; break;
+	case gfx_texture_format_t::RGBA16F:				texel = 8; break;
+	case gfx_texture_format_t::DEPTH24_STENCIL8:	texel = 4; break;
+	default: break;
+	}
+
+	return texel * width * height * depth;
+}
+
+static u32 format_extent(const u32 extent, const u32 mip)
+{
+	const u32 value = extent >> mip;
+	return value > 0 ? value : 1;
+}
+
+u32 bx::gfx_attribute_size(gfx_attribute_format_t format, u32 count) noexcept
+{
+	if (count == 0 || count > 4)
+		return 0;
+
+	switch (format)
+	{
+	case gfx_attribute_format_t::FLOAT32:
+		return 4 * count;
+	case gfx_attribute_format_t::FLOAT16:
+	case gfx_attribute_format_t::SNORM16:
+	case gfx_attribute_format_t::UNORM16:
+	case gfx_attribute_format_t::UINT16:
+		return 2 * count;
+	case gfx_attribute_format_t::SNORM8:
+	case gfx_attribute_format_t::UNORM8:
+	case gfx_attribute_format_t::UINT8:
+		return count;
+	case gfx_attribute_format_t::INT_2_10_10_10_REV:
+		return count == 4 ? 4 : 0;
+	default:
+		return 0;
+	}
+}
+
+u64 bx::gfx_texture_mip_size(const gfx_texture_desc_t& desc, u32 mip) noexcept
+{
+	const u32 depth = desc.type == gfx_texture_type_t::TEX3D ? format_extent(desc.depth, mip) : 1;
+	const u32 layers = desc.type == gfx_texture_type_t::TEX_CUBE ? 6 : 1;
+	return gfx_texture_size(desc.format, format_extent(desc.width, mip), format_extent(desc.height, mip), depth) * layers;
+}
+
+u64 bx::gfx_texture_storage_size(const gfx_texture_desc_t& desc, u32 first_mip) noexcept
+{
+	u64 size = 0;
+	for (u32 mip = first_mip; mip < desc.mip_levels; ++mip)
+		size += gfx_texture_mip_size(desc, mip);
+	return size;
+}
+
+// Writes the 16 texels of a 4x4 block, 4 bytes apart, to out
+static void bc_decode_color(const u8* block, u8* out, const bool four_colors)
+{
+	const u32 c0 = block[0] | (block[1] << 8);
+	const u32 c1 = block[2] | (block[3] << 8);
+
+	u8 palette[4][4]{};
+	const u32 colors[2] = { c0, c1 };
+	for (u32 i = 0; i < 2; ++i)
+	{
+		const u32 r = (colors[i] >> 11) & 31;
+		const u32 g = (colors[i] >> 5) & 63;
+		const u32 b = colors[i] & 31;
+		palette[i][0] = static_cast<u8>((r << 3) | (r >> 2));
+		palette[i][1] = static_cast<u8>((g << 2) | (g >> 4));
+		palette[i][2] = static_cast<u8>((b << 3) | (b >> 2));
+		palette[i][3] = 255;
+	}
+
+	// BC1 switches to 3 colors and transparent black when c0 <= c1
+	for (u32 c = 0; c < 3; ++c)
+	{
+		if (four_colors || c0 > c1)
+		{
+			palette[2][c] = static_cast<u8>((2 * palette[0][c] + palette[1][c] + 1) / 3);
+			palette[3][c] = static_cast<u8>((palette[0][c] + 2 * palette[1][c] + 1) / 3);
+		}
+		else
+		{
+			palette[2][c] = static_cast<u8>((palette[0][c] + palette[1][c] + 1) / 2);
+			palette[3][c] = 0;
+		}
+	}
+	palette[2][3] = 255;
+	palette[3][3] = (four_colors || c0 > c1) ? 255 : 0;
+
+	const u32 indices = block[4] | (block[5] << 8) | (block[6] << 16) | (static_cast<u32>(block[7]) << 24);
+	for (u32 i = 0; i < 16; ++i)
+		std::memcpy(out + i * 4, palette[(indices >> (i * 2)) & 3], 4);
+}
+
+// BC4 block, one channel of the 16 texels, 4 bytes apart
+static void bc_decode_channel(const u8* block, u8* out)
+{
+	const u32 v0 = block[0];
+	const u32 v1 = block[1];
+
+	u8 palette[8]{};
+	palette[0] = static_cast<u8>(v0);
+	palette[1] = static_cast<u8>(v1);
+	if (v0 > v1)
+	{
+		for (u32 i = 2; i < 8; ++i)
+			palette[i] = static_cast<u8>(((8 - i) * v0 + (i - 1) * v1 + 3) / 7);
+	}
+	else
+	{
+		for (u32 i = 2; i < 6; ++i)
+			palette[i] = static_cast<u8>(((6 - i) * v0 + (i - 1) * v1 + 2) / 5);
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+
+	u64 indices = 0;
+	for (u32 i = 0; i < 6; ++i)
+		indices |= static_cast<u64>(block[2 + i]) << (i * 8);
+
+	for (u32 i = 0; i < 16; ++i)
+		out[i * 4] = palette[(indices >> (i * 3)) & 7];
+}
+
+bool bx::gfx_decode_texture(gfx_texture_format_t format, u32 width, u32 height, const u8* src, u8* dst) noexcept
+{
+	bx_profile(bx);
+
+	switch (format)
+	{
+	case gfx_texture_format_t::BC1U_NORM:
+	case gfx_texture_format_t::BC3U_NORM:
+	case gfx_texture_format_t::BC4U_NORM:
+	case gfx_texture_format_t::BC5U_NORM:
+		break;
+	default:
+		return false;
+	}
+
+	const u32 block_bytes = format_block_bytes(format);
+	const u32 blocks_x = (width + 3) / 4;
+	const u32 blocks_y = (height + 3) / 4;
+
+	u8 texels[16 * 4];
+	for (u32 block_y = 0; block_y < blocks_y; ++block_y)
+	{
+		for (u32 block_x = 0; block_x < blocks_x; ++block_x)
+		{
+			const u8* block = src + (static_cast<usize>(block_y) * blocks_x + block_x) * block_bytes;
+			switch (format)
+			{
+			case gfx_texture_format_t::BC1U_NORM:
+				bc_decode_color(block, texels, false);
+				break;
+			case gfx_texture_format_t::BC3U_NORM:
+				bc_decode_color(block + 8, texels, true);
+				bc_decode_channel(block, texels + 3);
+				break;
+			case gfx_texture_format_t::BC4U_NORM:
+				std::memset(texels, 0, sizeof(texels));
+				bc_decode_channel(block, texels);
+				for (u32 i = 0; i < 16; ++i)
+					texels[i * 4 + 3] = 255;
+				break;
+			case gfx_texture_format_t::BC5U_NORM:
+				std::memset(texels, 0, sizeof(texels));
+				bc_decode_channel(block, texels);
+				bc_decode_channel(block + 8, texels + 1);
+				for (u32 i = 0; i < 16; ++i)
+					texels[i * 4 + 3] = 255;
+				break;
+			default:
+				break;
+			}
+
+			// Edge blocks hang over the image
+			for (u32 y = 0; y < 4 && block_y * 4 + y < height; ++y)
+			{
+				const u32 columns = width - block_x * 4 < 4 ? width - block_x * 4 : 4;
+				u8* row = dst + ((static_cast<usize>(block_y) * 4 + y) * width + block_x * 4) * 4;
+				std::memcpy(row, texels + y * 16, columns * 4);
+			}
+		}
+	}
+
+	return true;
+}
@@ -1,18 +1,51 @@
 #include <bx_app_impl.hpp>
+#include <bx_gfx_cmd.hpp>
 
 #include <glad/glad.h>
 
 #include <string>
 #include <vector>
 #include <fstream>
+#include <algorithm>
 
 #define MAX_BOUND_VERTEX_BUFFERS 16
+#define MAX_VERTEX_ATTRIBUTES 16
+#define MAX_PIPELINE_SHADERS 6
+
+// Compressed formats come from extensions, not every loader defines them
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_RED_RGTC1
+#define GL_COMPRESSED_RED_RGTC1 0x8DBB
+#endif
+#ifndef GL_COMPRESSED_RG_RGTC2
+#define GL_COMPRESSED_RG_RGTC2 0x8DBD
+#endif
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM
+#define GL_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
+#endif
+#ifndef GL_COMPRESSED_RGB8_ETC2
+#define GL_COMPRESSED_RGB8_ETC2 0x9274
+#endif
+#ifndef GL_COMPRESSED_RGBA8_ETC2_EAC
+#define GL_COMPRESSED_RGBA8_ETC2_EAC 0x9278
+#endif
+#ifndef GL_COMPRESSED_RGBA_ASTC_4x4_KHR
+#define GL_COMPRESSED_RGBA_ASTC_4x4_KHR 0x93B0
+#endif
 
 struct gl_shader_t
 {
 	cstring name{ nullptr };
 	GLuint shader{ 0 };
 	GLenum stage{ 0 };
+	u64 key{ 0 };			// program binary cache key
+	bx::string source{};	// kept until first linked when compiling is deferred
+	bx::gfx_shader_reload_t reload{}; // for shaders from desc.filepath
 };
 
 struct gl_buffer_t
@@ -37,6 +70,22 @@ struct gl_texture_t
 	u32 height{ 0 };
 	u32 depth{ 1 };
 	u8 mip_levels{ 1 };
+	u8 first_mip{ 0 };	// level 0 of the GL storage
+	u8 min_mip{ 0 };	// finest mip sampled
+	bool decode{ false };	// BC format the device can't sample, stored as RGBA8
+	u64 bytes{ 0 };		// resident mips, for the frame stats
+
+	// Bindless handle, resident while a resource set references it. The texture
+	// parameters are frozen for good once it was created.
+	GLuint64 handle{ 0 };
+	u32 handle_refs{ 0 };
+
+	// Kept to rebuild the texture when its storage is resized
+	GLint min_filter{ GL_LINEAR_MIPMAP_LINEAR };
+	GLint mag_filter{ GL_LINEAR };
+	GLint wrap_s{ GL_CLAMP_TO_EDGE };
+	GLint wrap_t{ GL_CLAMP_TO_EDGE };
+	GLint wrap_r{ GL_CLAMP_TO_EDGE };
 };
 
 struct gl_framebuffer_t
@@ -49,6 +98,56 @@ struct gl_framebuffer_t
 	u32 height{ 0 };
 };
 
+// Consecutive bindings of one type, bound with a single multi-bind call
+struct gl_bind_run_t
+{
+	GLuint first{ 0 };	// binding point or unit
+	u32 start{ 0 };		// into the gl_bind_range_t arrays
+	u32 count{ 0 };
+};
+
+// One resource type of a set, sorted by binding
+struct gl_bind_range_t
+{
+	std::vector<gl_bind_run_t> runs;
+	std::vector<GLuint> names;
+	std::vector<GLintptr> offsets;	// buffers
+	std::vector<GLsizeiptr> sizes;	// buffers
+	std::vector<GLenum> kinds;		// texture target or image format
+};
+
+struct gl_resource_set_t
+{
+	cstring name{ nullptr };
+	std::vector<bx::gfx_resource_binding_t> bindings;	// baked again when a resource changed
+	bool dirty{ false };								// one of the bound resources changed since the bake
+
+	gl_bind_range_t uniform_buffers;
+	gl_bind_range_t storage_buffers;
+	gl_bind_range_t textures;
+	gl_bind_range_t images;
+
+	// Bindless, textures are a table of handles instead
+	bool bindless{ false };
+	GLuint table_binding{ 0 };
+	GLuint table{ 0 };
+	u64 table_size{ 0 };
+	std::vector<bx::handle_id> resident;	// textures this set holds a handle reference on
+};
+
+// Attribute resolved to GL enums once, at pipeline creation
+struct gl_vertex_attrib_t
+{
+	GLuint location{ 0 };
+	GLuint binding{ 0 };
+	GLint count{ 0 };
+	GLenum type{ GL_FLOAT };
+	GLboolean normalized{ GL_FALSE };
+	GLboolean integer{ GL_FALSE };	// read as integers, bound through the I entry points
+	GLuint offset{ 0 };
+	GLuint divisor{ 0 };
+};
+
 struct gl_pipeline_t
 {
 	cstring name{ nullptr };
@@ -56,8 +155,16 @@ struct gl_pipeline_t
 	GLuint vao{ 0 };
 	bx::gfx_topology_t topology{};
 	bx::gfx_raster_state_t raster{};
-	std::vector<bx::gfx_vertex_attribute_t> attributes{};
-	std::vector<bx::gfx_color_blend_attachment_t> blend_attachments{};
+	bool blend_enable{ false };
+
+	// Vertex input baked per binding, binding vertex buffers only copies these
+	gl_vertex_attrib_t attributes[MAX_VERTEX_ATTRIBUTES]{};
+	u32 attribute_count{ 0 };
+	GLsizei strides[MAX_BOUND_VERTEX_BUFFERS]{};
+
+	// Linked again when one of them is reloaded
+	bx::handle_id shaders[MAX_PIPELINE_SHADERS]{};
+	u32 shader_count{ 0 };
 };
 
 struct gl_features_t
@@ -79,12 +186,15 @@ struct gl_features_t
 	bool draw_indirect{ false };					// ARB_draw_indirect
 	bool multi_draw_indirect{ false };				// ARB_multi_draw_indirect
 	bool indirect_count{ false };					// ARB_indirect_parameters (DrawIndirectCountARB)
+	bool base_instance{ false };					// ARB_base_instance, first_instance on direct draws and indirect records
 
 	// Textures
 	bool texture_storage{ false };					// ARB_texture_storage
 	bool texture_view{ false };						// ARB_texture_view
 	bool bindless_textures{ false };				// NV_bindless_texture
 	bool sparse_texture{ false };					// ARB_sparse_texture
+	bool copy_image{ false };						// ARB_copy_image, texture to texture copies
+	bool program_binary{ false };					// ARB_get_program_binary with at least one format
 
 	// Vertex / pipeline state
 	bool vertex_attrib_binding{ false };			// ARB_vertex_attrib_binding (core 4.3)
@@ -95,6 +205,7 @@ struct gl_features_t
 	bool tessellation_shader{ false };				// ARB_tessellation_shader
 	bool geometry_shader{ false };					// ARB_geometry_shader4
 	bool shader_texture_lod{ false };				// ARB_shader_texture_lod (important for PBR)
+	bool gl_spirv{ false };							// ARB_gl_spirv, SPIR-V modules through glShaderBinary
 
 	// Blending / framebuffer
 	bool advanced_blend{ false };					// KHR_blend_equation_advanced
@@ -110,6 +221,7 @@ struct gl_features_t
 
 	// Compression formats
 	bool tex_compression_bptc{ false };				// BC7 / BC6H
+	bool tex_compression_rgtc{ false };				// BC4 / BC5
 	bool tex_compression_s3tc{ false };				// BC1�BC5 (DXT)
 	bool tex_compression_astc{ false };				// ASTC
 	bool tex_compression_etc2{ false };				// ETC2/EAC
@@ -117,11 +229,25 @@ struct gl_features_t
 
 static gl_features_t g_features{};
 
-static bx::handlemap<gl_shader_t> g_shaders{};
-static bx::handlemap<gl_buffer_t> g_buffers{};
-static bx::handlemap<gl_texture_t> g_textures{};
-static bx::handlemap<gl_framebuffer_t> g_framebuffers{};
-static bx::handlemap<gl_pipeline_t> g_pipelines{};
+// Program binaries only load on the driver that wrote them
+static u64 g_device_hash = 0;
+static bool g_program_cache = false;
+
+static bx::handle_id g_file_watch = bx::invalid_handle;
+
+static bx::handle_map<gl_shader_t> g_shaders{};
+static bx::handle_map<gl_buffer_t> g_buffers{};
+static bx::handle_map<gl_texture_t> g_textures{};
+static bx::handle_map<gl_framebuffer_t> g_framebuffers{};
+static bx::handle_map<gl_pipeline_t> g_pipelines{};
+static bx::handle_map<gl_resource_set_t> g_resource_sets{};
+
+// Sets binding each buffer or texture, a resource destroyed or given new storage
+// marks only these dirty, they look their resources up again when bound next.
+// Buffers and textures may share a handle value, that costs a spurious bake.
+static bx::hash_map<bx::handle_id, std::vector<bx::handle_id>> g_resource_users{};
+static GLint g_uniform_alignment = 1;
+static GLint g_storage_alignment = 1;
 
 // Current bound immediate state
 static bx::handle_id g_current_framebuffer = 0;
@@ -134,6 +260,24 @@ static GLenum g_current_index_type = GL_UNSIGNED_INT;
 // Backend info
 static bx::gfx_info_t g_info{};
 
+// Upload ring, one CPU_TO_GPU buffer cut in a slice per frame in flight. A slice
+// is handed out again once the fence of the frame that last used it signalled.
+// Without persistent mapping writes go to shadow memory, flushed before the next
+// GPU command.
+struct gl_upload_ring_t
+{
+	bx::handle_id buffer{ bx::invalid_handle };
+	u8* data{ nullptr };
+	bx::array<u8> shadow{};
+	u64 slice_size{ 0 };
+	u64 head{ 0 };
+	u64 flushed{ 0 };
+	u32 frame{ 0 };
+	GLsync fences[BX_GFX_FRAMES_IN_FLIGHT]{};
+};
+
+static gl_upload_ring_t g_upload{};
+
 // Extension independent OpenGL
 
 static void glGenVertexArraysX(GLsizei n, GLuint* arrays)
@@ -190,6 +334,438 @@ static vptr glMapNamedBufferRangeX(GLuint buffer, GLintptr offset, GLsizeiptr le
 	return nullptr;
 }
 
+static void glCopyImageSubDataX(GLuint srcName, GLenum srcTarget, GLint srcLevel, GLint srcX, GLint srcY, GLint srcZ,
+	GLuint dstName, GLenum dstTarget, GLint dstLevel, GLint dstX, GLint dstY, GLint dstZ, GLsizei width, GLsizei height, GLsizei depth)
+{
+	if (glCopyImageSubData) return glCopyImageSubData(srcName, srcTarget, srcLevel, srcX, srcY, srcZ, dstName, dstTarget, dstLevel, dstX, dstY, dstZ, width, height, depth);
+	if (glCopyImageSubDataEXT) return glCopyImageSubDataEXT(srcName, srcTarget, srcLevel, srcX, srcY, srcZ, dstName, dstTarget, dstLevel, dstX, dstY, dstZ, width, height, depth);
+	if (glCopyImageSubDataOES) return glCopyImageSubDataOES(srcName, srcTarget, srcLevel, srcX, srcY, srcZ, dstName, dstTarget, dstLevel, dstX, dstY, dstZ, width, height, depth);
+	bx_assert(false, "glCopyImageSubData unsupported!");
+}
+
+static void glSpecializeShaderX(GLuint shader, cstring entry, GLuint count, const GLuint* indices, const GLuint* values)
+{
+	if (glSpecializeShader) return glSpecializeShader(shader, entry, count, indices, values);
+	if (glSpecializeShaderARB) return glSpecializeShaderARB(shader, entry, count, indices, values);
+	bx_assert(false, "glSpecializeShader unsupported!");
+}
+
+// Multi draw indirect entry points differ per vendor extension. These report
+// false when none is loaded so callers can fall back to one draw per record.
+
+static bool glMultiDrawArraysIndirectX(GLenum mode, cvptr indirect, GLsizei drawcount, GLsizei stride)
+{
+	if (glMultiDrawArraysIndirect) { glMultiDrawArraysIndirect(mode, indirect, drawcount, stride); return true; }
+	if (glMultiDrawArraysIndirectEXT) { glMultiDrawArraysIndirectEXT(mode, indirect, drawcount, stride); return true; }
+	if (glMultiDrawArraysIndirectAMD) { glMultiDrawArraysIndirectAMD(mode, indirect, drawcount, stride); return true; }
+	return false;
+}
+
+static bool glMultiDrawElementsIndirectX(GLenum mode, GLenum type, cvptr indirect, GLsizei drawcount, GLsizei stride)
+{
+	if (glMultiDrawElementsIndirect) { glMultiDrawElementsIndirect(mode, type, indirect, drawcount, stride); return true; }
+	if (glMultiDrawElementsIndirectEXT) { glMultiDrawElementsIndirectEXT(mode, type, indirect, drawcount, stride); return true; }
+	if (glMultiDrawElementsIndirectAMD) { glMultiDrawElementsIndirectAMD(mode, type, indirect, drawcount, stride); return true; }
+	return false;
+}
+
+static bool glMultiDrawElementsIndirectCountX(GLenum mode, GLenum type, cvptr indirect, GLintptr drawcount, GLsizei maxdrawcount, GLsizei stride)
+{
+	if (glMultiDrawElementsIndirectCount) { glMultiDrawElementsIndirectCount(mode, type, indirect, drawcount, maxdrawcount, stride); return true; }
+	if (glMultiDrawElementsIndirectCountARB) { glMultiDrawElementsIndirectCountARB(mode, type, indirect, drawcount, maxdrawcount, stride); return true; }
+	return false;
+}
+
+// Base instance draws, false when neither the core nor the ES entry point is
+// loaded so the caller can draw from instance 0 instead.
+
+static bool glDrawArraysInstancedBaseInstanceX(GLenum mode, GLint first, GLsizei count, GLsizei instancecount, GLuint baseinstance)
+{
+	if (glDrawArraysInstancedBaseInstance) { glDrawArraysInstancedBaseInstance(mode, first, count, instancecount, baseinstance); return true; }
+	if (glDrawArraysInstancedBaseInstanceEXT) { glDrawArraysInstancedBaseInstanceEXT(mode, first, count, instancecount, baseinstance); return true; }
+	return false;
+}
+
+static bool glDrawElementsInstancedBaseVertexBaseInstanceX(GLenum mode, GLsizei count, GLenum type, cvptr indices, GLsizei instancecount, GLint basevertex, GLuint baseinstance)
+{
+	if (glDrawElementsInstancedBaseVertexBaseInstance) { glDrawElementsInstancedBaseVertexBaseInstance(mode, count, type, indices, instancecount, basevertex, baseinstance); return true; }
+	if (glDrawElementsInstancedBaseVertexBaseInstanceEXT) { glDrawElementsInstancedBaseVertexBaseInstanceEXT(mode, count, type, indices, instancecount, basevertex, baseinstance); return true; }
+	return false;
+}
+
+// The resource was destroyed or got new storage, sets binding it bake again
+static void gl_resource_changed(const bx::handle_id resource)
+{
+	const auto users = g_resource_users.get(resource);
+	if (!users)
+		return;
+
+	for (const bx::handle_id set_handle : *users)
+	{
+		auto set = g_resource_sets.get(set_handle);
+		if (set)
+			set->dirty = true;
+	}
+}
+
+static bool gl_has_texture_handles()
+{
+	return glGetTextureHandleARB || glGetTextureHandleNV;
+}
+
+static GLuint64 glGetTextureHandleX(GLuint texture)
+{
+	if (glGetTextureHandleARB) return glGetTextureHandleARB(texture);
+	if (glGetTextureHandleNV) return glGetTextureHandleNV(texture);
+	return 0;
+}
+
+static void glMakeTextureHandleResidentX(GLuint64 handle)
+{
+	if (glMakeTextureHandleResidentARB) glMakeTextureHandleResidentARB(handle);
+	else if (glMakeTextureHandleResidentNV) glMakeTextureHandleResidentNV(handle);
+}
+
+static void glMakeTextureHandleNonResidentX(GLuint64 handle)
+{
+	if (glMakeTextureHandleNonResidentARB) glMakeTextureHandleNonResidentARB(handle);
+	else if (glMakeTextureHandleNonResidentNV) glMakeTextureHandleNonResidentNV(handle);
+}
+
+// Shadow state, skips GL calls that would not change anything
+
+#define GL_STATE_UNKNOWN 0xFFFFFFFFu
+#define GL_STATE_TEXTURE_UNITS 32
+
+enum gl_state_buffer_t : u8
+{
+	GL_STATE_ARRAY_BUFFER,
+	GL_STATE_ELEMENT_ARRAY_BUFFER,
+	GL_STATE_UNIFORM_BUFFER,
+	GL_STATE_SHADER_STORAGE_BUFFER,
+	GL_STATE_DRAW_INDIRECT_BUFFER,
+	GL_STATE_DISPATCH_INDIRECT_BUFFER,
+	GL_STATE_COPY_READ_BUFFER,
+	GL_STATE_COPY_WRITE_BUFFER,
+	GL_STATE_PIXEL_PACK_BUFFER,
+	GL_STATE_PIXEL_UNPACK_BUFFER,
+	GL_STATE_PARAMETER_BUFFER,
+	GL_STATE_BUFFER_COUNT
+};
+
+enum gl_state_texture_t : u8
+{
+	GL_STATE_TEXTURE_2D,
+	GL_STATE_TEXTURE_3D,
+	GL_STATE_TEXTURE_CUBE_MAP,
+	GL_STATE_TEXTURE_COUNT
+};
+
+enum gl_state_cap_t : u8
+{
+	GL_STATE_CULL_FACE,
+	GL_STATE_DEPTH_TEST,
+	GL_STATE_BLEND,
+	GL_STATE_CAP_COUNT
+};
+
+// GL_STATE_UNKNOWN marks values we can't vouch for, the next set always goes through
+struct gl_state_t
+{
+	GLuint program{ GL_STATE_UNKNOWN };
+	GLuint program_pipeline{ GL_STATE_UNKNOWN };
+	GLuint vao{ GL_STATE_UNKNOWN };
+	GLuint framebuffer{ GL_STATE_UNKNOWN };
+	GLuint buffers[GL_STATE_BUFFER_COUNT]{};
+	GLuint active_unit{ GL_STATE_UNKNOWN };
+	GLuint textures[GL_STATE_TEXTURE_UNITS][GL_STATE_TEXTURE_COUNT]{};
+	GLuint caps[GL_STATE_CAP_COUNT]{};
+	GLuint depth_mask{ GL_STATE_UNKNOWN };
+
+	u64 issued{ 0 };
+	u64 skipped{ 0 };
+	u32 frame_skipped{ 0 };	// folded into the frame stats as redundant binds
+};
+
+static gl_state_t g_state{};
+
+static void gl_state_invalidate()
+{
+	const u64 issued = g_state.issued;
+	const u64 skipped = g_state.skipped;
+	const u32 frame_skipped = g_state.frame_skipped;
+	g_state = gl_state_t{};
+	g_state.issued = issued;
+	g_state.skipped = skipped;
+	g_state.frame_skipped = frame_skipped;
+
+	std::fill_n(g_state.buffers, GL_STATE_BUFFER_COUNT, GL_STATE_UNKNOWN);
+	std::fill_n(&g_state.textures[0][0], GL_STATE_TEXTURE_UNITS * GL_STATE_TEXTURE_COUNT, GL_STATE_UNKNOWN);
+	std::fill_n(g_state.caps, GL_STATE_CAP_COUNT, GL_STATE_UNKNOWN);
+}
+
+// Returns true when the GL call has to be issued, value is then cached
+static inline bool gl_state_set(GLuint& cached, const GLuint value)
+{
+	if (cached == value)
+	{
+		++g_state.skipped;
+		++g_state.frame_skipped;
+		return false;
+	}
+	cached = value;
+	++g_state.issued;
+	return true;
+}
+
+static inline u32 gl_state_buffer_index(const GLenum target)
+{
+	switch (target)
+	{
+	case GL_ARRAY_BUFFER:				return GL_STATE_ARRAY_BUFFER;
+	case GL_ELEMENT_ARRAY_BUFFER:		return GL_STATE_ELEMENT_ARRAY_BUFFER;
+	case GL_UNIFORM_BUFFER:				return GL_STATE_UNIFORM_BUFFER;
+	case GL_SHADER_STORAGE_BUFFER:		return GL_STATE_SHADER_STORAGE_BUFFER;
+	case GL_DRAW_INDIRECT_BUFFER:		return GL_STATE_DRAW_INDIRECT_BUFFER;
+	case GL_DISPATCH_INDIRECT_BUFFER:	return GL_STATE_DISPATCH_INDIRECT_BUFFER;
+	case GL_COPY_READ_BUFFER:			return GL_STATE_COPY_READ_BUFFER;
+	case GL_COPY_WRITE_BUFFER:			return GL_STATE_COPY_WRITE_BUFFER;
+	case GL_PIXEL_PACK_BUFFER:			return GL_STATE_PIXEL_PACK_BUFFER;
+	case GL_PIXEL_UNPACK_BUFFER:		return GL_STATE_PIXEL_UNPACK_BUFFER;
+	case GL_PARAMETER_BUFFER:			return GL_STATE_PARAMETER_BUFFER;
+	default:							return GL_STATE_BUFFER_COUNT;
+	}
+}
+
+static inline u32 gl_state_texture_index(const GLenum target)
+{
+	switch (target)
+	{
+	case GL_TEXTURE_2D:			return GL_STATE_TEXTURE_2D;
+	case GL_TEXTURE_3D:			return GL_STATE_TEXTURE_3D;
+	case GL_TEXTURE_CUBE_MAP:	return GL_STATE_TEXTURE_CUBE_MAP;
+	default:					return GL_STATE_TEXTURE_COUNT;
+	}
+}
+
+static inline u32 gl_state_cap_index(const GLenum cap)
+{
+	switch (cap)
+	{
+	case GL_CULL_FACE:	return GL_STATE_CULL_FACE;
+	case GL_DEPTH_TEST:	return GL_STATE_DEPTH_TEST;
+	case GL_BLEND:		return GL_STATE_BLEND;
+	default:			return GL_STATE_CAP_COUNT;
+	}
+}
+
+static void gl_use_program(const GLuint program)
+{
+	if (gl_state_set(g_state.program, program))
+		glUseProgram(program);
+}
+
+static void gl_bind_program_pipeline(const GLuint pipeline)
+{
+	if (gl_state_set(g_state.program_pipeline, pipeline))
+		glBindProgramPipeline(pipeline);
+}
+
+static void gl_bind_vertex_array(const GLuint vao)
+{
+	if (!gl_state_set(g_state.vao, vao))
+		return;
+
+	glBindVertexArrayX(vao);
+
+	// The element array binding lives in the VAO
+	g_state.buffers[GL_STATE_ELEMENT_ARRAY_BUFFER] = GL_STATE_UNKNOWN;
+}
+
+static void gl_bind_buffer(const GLenum target, const GLuint buffer)
+{
+	const u32 index = gl_state_buffer_index(target);
+	if (index < GL_STATE_BUFFER_COUNT && !gl_state_set(g_state.buffers[index], buffer))
+		return;
+
+	if (index == GL_STATE_BUFFER_COUNT)
+		++g_state.issued;
+	glBindBuffer(target, buffer);
+}
+
+// Indexed bindings are not cached, but they also replace the generic binding
+static void gl_bind_buffer_base(const GLenum target, const GLuint slot, const GLuint buffer)
+{
+	glBindBufferBase(target, slot, buffer);
+	++g_state.issued;
+
+	const u32 index = gl_state_buffer_index(target);
+	if (index < GL_STATE_BUFFER_COUNT)
+		g_state.buffers[index] = buffer;
+}
+
+static void gl_active_texture(const GLuint unit)
+{
+	if (gl_state_set(g_state.active_unit, unit))
+		glActiveTexture(GL_TEXTURE0 + unit);
+}
+
+// Binds to the active unit, like glBindTexture
+static void gl_bind_texture(const GLenum target, const GLuint texture)
+{
+	const u32 unit = g_state.active_unit;
+	const u32 index = gl_state_texture_index(target);
+	if (unit < GL_STATE_TEXTURE_UNITS && index < GL_STATE_TEXTURE_COUNT)
+	{
+		if (!gl_state_set(g_state.textures[unit][index], texture))
+			return;
+	}
+	else
+	{
+		++g_state.issued;
+	}
+	glBindTexture(target, texture);
+}
+
+static void gl_bind_framebuffer(const GLuint framebuffer)
+{
+	if (gl_state_set(g_state.framebuffer, framebuffer))
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+}
+
+static void gl_set_capability(const GLenum cap, const bool enabled)
+{
+	const u32 index = gl_state_cap_index(cap);
+	if (index < GL_STATE_CAP_COUNT && !gl_state_set(g_state.caps[index], enabled ? 1u : 0u))
+		return;
+
+	if (index == GL_STATE_CAP_COUNT)
+		++g_state.issued;
+	if (enabled)
+		glEnable(cap);
+	else
+		glDisable(cap);
+}
+
+static void gl_depth_mask(const bool enabled)
+{
+	if (gl_state_set(g_state.depth_mask, enabled ? 1u : 0u))
+		glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+}
+
+// Multi-bind leaves the generic binding alone, glBindBufferRange replaces it
+static void gl_bind_buffer_runs(const GLenum target, const gl_bind_range_t& range)
+{
+	for (const gl_bind_run_t& run : range.runs)
+	{
+		if (g_features.multi_bind)
+		{
+			glBindBuffersRange(target, run.first, static_cast<GLsizei>(run.count),
+				&range.names[run.start], &range.offsets[run.start], &range.sizes[run.start]);
+			++g_state.issued;
+			continue;
+		}
+
+		for (u32 i = run.start; i < run.start + run.count; ++i)
+			glBindBufferRange(target, run.first + (i - run.start), range.names[i], range.offsets[i], range.sizes[i]);
+		g_state.issued += run.count;
+
+		const u32 index = gl_state_buffer_index(target);
+		if (index < GL_STATE_BUFFER_COUNT)
+			g_state.buffers[index] = range.names[run.start + run.count - 1];
+	}
+}
+
+// Units the set doesn't use keep what they had
+static void gl_bind_texture_runs(const gl_bind_range_t& range)
+{
+	for (const gl_bind_run_t& run : range.runs)
+	{
+		if (!g_features.multi_bind)
+		{
+			for (u32 i = run.start; i < run.start + run.count; ++i)
+			{
+				gl_active_texture(run.first + (i - run.start));
+				gl_bind_texture(range.kinds[i], range.names[i]);
+			}
+			continue;
+		}
+
+		glBindTextures(run.first, static_cast<GLsizei>(run.count), &range.names[run.start]);
+		++g_state.issued;
+
+		for (u32 i = run.start; i < run.start + run.count; ++i)
+		{
+			const u32 unit = run.first + (i - run.start);
+			const u32 index = gl_state_texture_index(range.kinds[i]);
+			if (unit < GL_STATE_TEXTURE_UNITS && index < GL_STATE_TEXTURE_COUNT)
+				g_state.textures[unit][index] = range.names[i];
+		}
+	}
+}
+
+// Images bind level 0 of the storage, all layers, read and write
+static void gl_bind_image_runs(const gl_bind_range_t& range)
+{
+	for (const gl_bind_run_t& run : range.runs)
+	{
+		if (g_features.multi_bind)
+		{
+			glBindImageTextures(run.first, static_cast<GLsizei>(run.count), &range.names[run.start]);
+			++g_state.issued;
+			continue;
+		}
+
+		for (u32 i = run.start; i < run.start + run.count; ++i)
+			glBindImageTexture(run.first + (i - run.start), range.names[i], 0, GL_TRUE, 0, GL_READ_WRITE, range.kinds[i]);
+		g_state.issued += run.count;
+	}
+}
+
+// Deleting an object unbinds it, names can be handed out again afterwards
+static void gl_state_forget_buffer(const GLuint buffer)
+{
+	for (auto& bound : g_state.buffers)
+		if (bound == buffer)
+			bound = 0;
+}
+
+static void gl_state_forget_texture(const GLuint texture)
+{
+	for (auto& unit : g_state.textures)
+		for (auto& bound : unit)
+			if (bound == texture)
+				bound = 0;
+}
+
+static void gl_state_forget_vertex_array(const GLuint vao)
+{
+	if (g_state.vao == vao)
+	{
+		g_state.vao = 0;
+		g_state.buffers[GL_STATE_ELEMENT_ARRAY_BUFFER] = GL_STATE_UNKNOWN;
+	}
+}
+
+static void gl_state_forget_framebuffer(const GLuint framebuffer)
+{
+	if (g_state.framebuffer == framebuffer)
+		g_state.framebuffer = 0;
+}
+
+// A program deleted while in use stays current until replaced
+static void gl_state_forget_program(const GLuint program)
+{
+	if (g_state.program == program)
+		g_state.program = GL_STATE_UNKNOWN;
+}
+
+static void gl_state_forget_program_pipeline(const GLuint pipeline)
+{
+	if (g_state.program_pipeline == pipeline)
+		g_state.program_pipeline = 0;
+}
+
 static void gl_print_info()
 {
 	bx_profile(bx);
@@ -453,6 +1029,10 @@ static void gl_check_features()
 		|| GLAD_GL_ARB_indirect_parameters
 		|| GLAD_GL_NV_bindless_multi_draw_indirect;
 
+	g_features.base_instance = GLAD_GL_VERSION_4_2
+		|| GLAD_GL_ARB_base_instance
+		|| GLAD_GL_EXT_base_instance;
+
 	// Textures
 	g_features.texture_storage = GLAD_GL_VERSION_4_5
 		|| GLAD_GL_ARB_direct_state_access
@@ -474,6 +1054,21 @@ static void gl_check_features()
 		|| GLAD_GL_EXT_sparse_texture
 		|| GLAD_GL_NV_memory_object_sparse;
 
+	// Drivers may expose the API with zero formats, which means no binaries
+	g_features.program_binary = GLAD_GL_VERSION_4_1 || GLAD_GL_ES_VERSION_3_0
+		|| GLAD_GL_ARB_get_program_binary;
+	if (g_features.program_binary)
+	{
+		GLint formats = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+		g_features.program_binary = formats > 0;
+	}
+
+	g_features.copy_image = GLAD_GL_VERSION_4_3 || GLAD_GL_ES_VERSION_3_2
+		|| GLAD_GL_ARB_copy_image
+		|| GLAD_GL_EXT_copy_image
+		|| GLAD_GL_OES_copy_image;
+
 	// Vertex / pipeline
 	g_features.vertex_attrib_binding = GLAD_GL_VERSION_4_5 || GLAD_GL_ES_VERSION_3_1
 		|| GLAD_GL_ARB_vertex_attrib_binding;
@@ -500,6 +1095,8 @@ static void gl_check_features()
 		GLAD_GL_ARB_shader_texture_lod
 		|| GLAD_GL_EXT_shader_texture_lod;
 
+	g_features.gl_spirv = GLAD_GL_VERSION_4_6 || GLAD_GL_ARB_gl_spirv;
+
 	// Blending / framebuffer
 	g_features.advanced_blend = GLAD_GL_ES_VERSION_3_2
 		|| GLAD_GL_KHR_blend_equation_advanced
@@ -525,21 +1122,26 @@ static void gl_check_features()
 		|| GLAD_GL_OES_viewport_array;
 
 	// Texture compression (extension only, no API calls)
-	g_features.tex_compression_bptc = GLAD_GL_ARB_texture_compression_bptc
+	g_features.tex_compression_bptc = GLAD_GL_VERSION_4_2
+		|| GLAD_GL_ARB_texture_compression_bptc
 		|| GLAD_GL_EXT_texture_compression_bptc;
 
+	g_features.tex_compression_rgtc = GLAD_GL_VERSION_3_0
+		|| GLAD_GL_ARB_texture_compression_rgtc
+		|| GLAD_GL_EXT_texture_compression_rgtc;
+
 	g_features.tex_compression_s3tc = GLAD_GL_EXT_texture_compression_s3tc
 		|| GLAD_GL_NV_texture_compression_s3tc_update;
 
 	g_features.tex_compression_astc = GLAD_GL_KHR_texture_compression_astc_ldr
 		|| GLAD_GL_KHR_texture_compression_astc_hdr;
 
-	g_features.tex_compression_etc2 = GLAD_GL_ARB_ES3_compatibility;
+	g_features.tex_compression_etc2 = GLAD_GL_VERSION_4_3 || GLAD_GL_ES_VERSION_3_0
+		|| GLAD_GL_ARB_ES3_compatibility;
 
 	//GL_ANGLE_texture_compression_dxt3
 	//GL_ANGLE_texture_compression_dxt5
 	//GL_ARB_texture_compression
-	//GL_ARB_texture_compression_rgtc
 	//GL_EXT_texture_compression_dxt1
 	//GL_EXT_texture_compression_latc
 	//GL_EXT_texture_compression_rgtc
@@ -584,16 +1186,20 @@ static void gl_check_features()
 	bx_verbose(bx, "    Draw Indirect                  : {}", g_features.draw_indirect ? "YES" : "NO");
 	bx_verbose(bx, "    Multi Draw Indirect            : {}", g_features.multi_draw_indirect ? "YES" : "NO");
 	bx_verbose(bx, "    Indirect Count                 : {}", g_features.indirect_count ? "YES" : "NO");
+	bx_verbose(bx, "    Base Instance                  : {}", g_features.base_instance ? "YES" : "NO");
 	bx_verbose(bx, "    Texture Storage                : {}", g_features.texture_storage ? "YES" : "NO");
 	bx_verbose(bx, "    Texture View                   : {}", g_features.texture_view ? "YES" : "NO");
 	bx_verbose(bx, "    Bindless Textures              : {}", g_features.bindless_textures ? "YES" : "NO");
 	bx_verbose(bx, "    Sparse Texture                 : {}", g_features.sparse_texture ? "YES" : "NO");
+	bx_verbose(bx, "    Copy Image                     : {}", g_features.copy_image ? "YES" : "NO");
+	bx_verbose(bx, "    Program Binary                 : {}", g_features.program_binary ? "YES" : "NO");
 	bx_verbose(bx, "    Vertex Attrib Binding          : {}", g_features.vertex_attrib_binding ? "YES" : "NO");
 	bx_verbose(bx, "    Vertex Array Object            : {}", g_features.vertex_array_object ? "YES" : "NO");
 	bx_verbose(bx, "    Multi Bind                     : {}", g_features.multi_bind ? "YES" : "NO");
 	bx_verbose(bx, "    Tessellation Shader            : {}", g_features.tessellation_shader ? "YES" : "NO");
 	bx_verbose(bx, "    Geometry Shader                : {}", g_features.geometry_shader ? "YES" : "NO");
 	bx_verbose(bx, "    Shader Texture LOD             : {}", g_features.shader_texture_lod ? "YES" : "NO");
+	bx_verbose(bx, "    SPIR-V Shaders                 : {}", g_features.gl_spirv ? "YES" : "NO");
 	bx_verbose(bx, "    Advanced Blend                 : {}", g_features.advanced_blend ? "YES" : "NO");
 	bx_verbose(bx, "    Framebuffer No Attachments     : {}", g_features.framebuffer_no_attachments ? "YES" : "NO");
 	bx_verbose(bx, "    Debug Output                   : {}", g_features.debug_output ? "YES" : "NO");
@@ -602,6 +1208,7 @@ static void gl_check_features()
 	bx_verbose(bx, "    Viewport Array                 : {}", g_features.viewport_array ? "YES" : "NO");
 	bx_verbose(bx, "    Texture Compression BPTC       : {}", g_features.tex_compression_bptc ? "YES" : "NO");
 	bx_verbose(bx, "    Texture Compression S3TC       : {}", g_features.tex_compression_s3tc ? "YES" : "NO");
+	bx_verbose(bx, "    Texture Compression RGTC       : {}", g_features.tex_compression_rgtc ? "YES" : "NO");
 	bx_verbose(bx, "    Texture Compression ASTC       : {}", g_features.tex_compression_astc ? "YES" : "NO");
 	bx_verbose(bx, "    Texture Compression ETC2       : {}", g_features.tex_compression_etc2 ? "YES" : "NO");
 }
@@ -678,6 +1285,73 @@ static void gl_setup_debug_callback()
 #endif
 }
 
+static void gl_create_upload_ring(const usize upload_memory)
+{
+	bx_profile(bx);
+
+	g_upload.slice_size = (upload_memory / BX_GFX_FRAMES_IN_FLIGHT) & ~u64(255);
+	if (g_upload.slice_size == 0)
+		return;
+
+	bx::gfx_buffer_desc_t desc{};
+	desc.name = "bx_upload_ring";
+	desc.usage = bx::gfx_buffer_usage_t::VERTEX;
+	desc.memory_usage = bx::gfx_memory_usage_t::CPU_TO_GPU;
+	desc.size = g_upload.slice_size * BX_GFX_FRAMES_IN_FLIGHT;
+
+	g_upload.buffer = bx::gfx_create_buffer(desc);
+	const auto glbuffer = g_buffers.get(g_upload.buffer);
+	if (!glbuffer)
+	{
+		bx_error(bx, "Failed to create the {} byte upload ring", desc.size);
+		g_upload.buffer = bx::invalid_handle;
+		return;
+	}
+
+	if (glbuffer->persistentPtr)
+	{
+		g_upload.data = static_cast<u8*>(glbuffer->persistentPtr);
+		return;
+	}
+
+	g_upload.shadow.resize(static_cast<usize>(desc.size));
+	g_upload.data = g_upload.shadow.data();
+	bx_verbose(bx, "Persistent mapping unavailable, upload ring goes through glBufferSubData");
+}
+
+static void gl_destroy_upload_ring()
+{
+	for (auto& fence : g_upload.fences)
+	{
+		if (fence)
+			glDeleteSync(fence);
+	}
+
+	if (g_upload.buffer != bx::invalid_handle)
+		bx::gfx_destroy_buffer(g_upload.buffer);
+
+	g_upload = gl_upload_ring_t{};
+}
+
+// Sends shadow memory written since the last flush, a no-op with persistent mapping
+static void gl_upload_flush()
+{
+	if (g_upload.flushed == g_upload.head)
+		return;
+
+	bx_profile(bx);
+
+	const auto glbuffer = g_buffers.get(g_upload.buffer);
+	const u64 offset = g_upload.frame * g_upload.slice_size + g_upload.flushed;
+	gl_bind_buffer(GL_COPY_WRITE_BUFFER, glbuffer->bo);
+	glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(offset),
+		static_cast<GLsizeiptr>(g_upload.head - g_upload.flushed), g_upload.data + offset);
+
+	g_upload.flushed = g_upload.head;
+}
+
+static void gl_reload_files(vptr user, bx::array_view<cstring> paths);
+
 bool bx::gfx_init(const bx::app_config_t& config) noexcept
 {
 	bx_profile(bx);
@@ -693,16 +1367,112 @@ bool bx::gfx_init(const bx::app_config_t& config) noexcept
 	g_info.api_version = (cstring)glGetString(GL_VERSION);
 	g_info.shader_version = (cstring)glGetString(GL_SHADING_LANGUAGE_VERSION);
 
+	gfx_stats_init(config);
+
 	gl_print_info();
 	gl_check_features();
 	gl_setup_debug_callback();
 
-	return true;
-}
+	g_info.features.supports_compute = g_features.compute_shader && g_features.shader_storage_buffer_object;
+	g_info.features.supports_geometry_shader = g_features.geometry_shader;
+	g_info.features.supports_copy_image = g_features.copy_image;
+	g_info.features.supports_bc = g_features.tex_compression_s3tc && g_features.tex_compression_rgtc;
+	g_info.features.supports_bc7 = g_features.tex_compression_bptc;
+	g_info.features.supports_persistent_mapping = g_features.persistent_mapping;
+	g_info.features.supports_base_instance = g_features.base_instance;
+	g_info.features.supports_etc2 = g_features.tex_compression_etc2;
+	g_info.features.supports_astc = g_features.tex_compression_astc;
+	g_info.features.supports_bindless_textures = g_features.bindless_textures
+		&& g_features.shader_storage_buffer_object && gl_has_texture_handles();
 
-void bx::gfx_shutdown() noexcept
-{
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &g_uniform_alignment);
+	if (g_features.shader_storage_buffer_object)
+		glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &g_storage_alignment);
+
+	const cstring device_strings[] = { g_info.adapter, g_info.device, g_info.api_version };
+	g_device_hash = 0;
+	for (const cstring str : device_strings)
+		g_device_hash = hash_combine(g_device_hash, str ? hash_bytes(str, std::strlen(str)) : 0);
+
+	// Also holds SPIR-V from the compile service when program binaries are missing
+	g_program_cache = g_features.program_binary && config.shader_cache;
+	gfx_shader_cache_init(config);
+	gfx_pipeline_cache_init();
+
+	g_file_watch = file_watch_subscribe(gl_reload_files, nullptr);
+
+	gl_create_upload_ring(config.upload_memory);
+
+	gl_state_invalidate();
+
+	return true;
+}
+
+static void gl_destroy_cull_program();
+
+void bx::gfx_shutdown() noexcept
+{
+	bx_profile(bx);
+
+	gfx_cmd_shutdown();
+
+	file_watch_unsubscribe(g_file_watch);
+	g_file_watch = invalid_handle;
+
+	gfx_stream_shutdown();
+	gfx_shader_compiler_shutdown();
+	gfx_shader_cache_shutdown();
+	gfx_pipeline_cache_shutdown();
+
+	gl_destroy_cull_program();
+	gl_destroy_upload_ring();
+
+	gfx_stats_shutdown();
+}
+
+void bx::gfx_begin_frame() noexcept
+{
+	bx_profile(bx);
+
+	// Wait for the GPU to be done with the slice this frame writes to
+	GLsync& fence = g_upload.fences[g_upload.frame];
+	if (fence)
+	{
+		GLenum status = glClientWaitSync(fence, 0, 0);
+		while (status == GL_TIMEOUT_EXPIRED)
+			status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+
+		glDeleteSync(fence);
+		fence = nullptr;
+	}
+
+	g_upload.head = 0;
+	g_upload.flushed = 0;
+
+	gfx_stream_update();
+}
+
+void bx::gfx_end_frame() noexcept
+{
 	bx_profile(bx);
+
+	if (g_upload.buffer != invalid_handle)
+	{
+		gl_upload_flush();
+
+		GLsync& fence = g_upload.fences[g_upload.frame];
+		if (fence)
+			glDeleteSync(fence);
+		fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+		g_upload.frame = (g_upload.frame + 1) % BX_GFX_FRAMES_IN_FLIGHT;
+		g_upload.head = 0;
+		g_upload.flushed = 0;
+	}
+
+	gfx_stats().redundant_binds += g_state.frame_skipped;
+	g_state.frame_skipped = 0;
+	gfx_stats_end_frame();
 }
 
 const bx::gfx_info_t& bx::gfx_get_info() noexcept
@@ -711,6 +1481,27 @@ const bx::gfx_info_t& bx::gfx_get_info() noexcept
 	return g_info;
 }
 
+bx::gfx_state_stats_t bx::gfx_get_state_stats() noexcept
+{
+	gfx_state_stats_t stats{};
+	stats.issued = g_state.issued;
+	stats.skipped = g_state.skipped;
+	return stats;
+}
+
+void bx::gfx_reset_state_stats() noexcept
+{
+	g_state.issued = 0;
+	g_state.skipped = 0;
+}
+
+void bx::gfx_invalidate_state() noexcept
+{
+	bx_profile(bx);
+
+	gl_state_invalidate();
+}
+
 static void gl_set_debug_name(GLenum identifier, GLuint name, GLsizei length, cstring label) noexcept
 {
 	bx_profile(bx);
@@ -762,40 +1553,199 @@ static GLenum gl_get_stage(bx::gfx_shader_stage_t stage)
 		return 0;
 	}
 }
-#include <iostream>
-bx::handle_id bx::gfx_create_shader(const gfx_shader_desc_t& desc) noexcept
+
+// Macros and includes are already part of the code, preprocessed or compiled
+static u64 gl_shader_key(const GLenum stage, cvptr code, const usize size, cstring entrypoint)
+{
+	u64 key = bx::hash_combine(g_device_hash, stage);
+	key = bx::hash_combine(key, bx::hash_bytes(code, size));
+	if (entrypoint)
+		key = bx::hash_combine(key, bx::hash_bytes(entrypoint, std::strlen(entrypoint)));
+	return key;
+}
+
+// Links the program from the cache, false leaves it unlinked. Binaries from an
+// older driver are rejected here and the caller compiles instead.
+static bool gl_program_load(const GLuint program, const u64 key)
+{
+	bx_profile(bx);
+
+	if (!g_program_cache)
+		return false;
+
+	u32 format = 0;
+	bx::array<u8> binary{};
+	if (!bx::gfx_shader_cache_load(key, format, binary))
+		return false;
+
+	glProgramBinary(program, format, binary.data(), static_cast<GLsizei>(binary.size()));
+
+	GLint linked = GL_FALSE;
+	glGetProgramiv(program, GL_LINK_STATUS, &linked);
+	return linked == GL_TRUE;
+}
+
+static void gl_program_store(const GLuint program, const u64 key)
+{
+	bx_profile(bx);
+
+	if (!g_program_cache)
+		return;
+
+	GLint length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0)
+		return;
+
+	bx::array<u8> binary{};
+	binary.resize(static_cast<usize>(length));
+	if (binary.size() != static_cast<usize>(length))
+		return;
+
+	GLenum format = 0;
+	glGetProgramBinary(program, length, &length, &format, binary.data());
+	bx::gfx_shader_cache_store(key, format, binary.data(), static_cast<usize>(length));
+}
+
+static bool gl_program_linked(const GLuint program, cstring what)
+{
+	GLint linked = GL_FALSE;
+	glGetProgramiv(program, GL_LINK_STATUS, &linked);
+	if (linked)
+		return true;
+
+	GLint len = 0;
+	glGetProgramiv(program, GL_INFO_LOG_LENGTH, &len);
+	std::string log(len, '\0');
+	glGetProgramInfoLog(program, len, &len, &log[0]);
+	bx_error(bx, "{} link error: {}", what, log);
+	return false;
+}
+
+// Compile time is counted by the caller, a separable program counts its link with it
+static GLuint gl_compile_shader(const GLenum stage, cstring source, cstring name)
+{
+	bx_profile(bx);
+
+	const GLuint shader = glCreateShader(stage);
+	if (!shader)
+	{
+		bx_debug(bx, "gfx_create_shader: Failed to create GL shader object.");
+		return 0;
+	}
+
+	glShaderSource(shader, 1, &source, nullptr);
+	glCompileShader(shader);
+
+	GLint ok = GL_FALSE;
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+	if (!ok)
+	{
+		GLint len = 0;
+		glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &len);
+		std::string log(len, '\0');
+		glGetShaderInfoLog(shader, len, &len, &log[0]);
+		bx_error(bx, "Shader '{}' compile error: {}", name ? name : "unnamed", log);
+		glDeleteShader(shader);
+		return 0;
+	}
+
+	gl_set_debug_name(GL_SHADER, shader, -1, name);
+	return shader;
+}
+
+// Compiles a shader whose compile was deferred to the first pipeline missing the cache
+static bool gl_shader_compile_deferred(gl_shader_t& glshader)
+{
+	if (glshader.shader == 0 && !glshader.source.empty())
+	{
+		const u64 start = bx::app_timestamp_ns();
+		glshader.shader = gl_compile_shader(glshader.stage, glshader.source.c_str(), glshader.name);
+		bx::gfx_stats_shader_compiled(bx::app_timestamp_ns() - start);
+		if (glshader.shader)
+			glshader.source = bx::string{};
+	}
+	return glshader.shader != 0;
+}
+
+// SPIR-V modules are specialized on their entry point, main unless named
+static GLuint gl_load_spirv(const GLenum stage, const bx::array_view<u8> code, cstring entrypoint, cstring name)
 {
 	bx_profile(bx);
 
+	const GLuint shader = glCreateShader(stage);
+	if (!shader)
+	{
+		bx_debug(bx, "gfx_create_shader: Failed to create GL shader object.");
+		return 0;
+	}
+
+	glShaderBinary(1, &shader, GL_SHADER_BINARY_FORMAT_SPIR_V_ARB, code.data(), static_cast<GLsizei>(code.size()));
+	glSpecializeShaderX(shader, entrypoint ? entrypoint : "main", 0, nullptr, nullptr);
+
+	GLint ok = GL_FALSE;
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+	if (!ok)
+	{
+		bx_error(bx, "gfx_create_shader: SPIR-V shader '{}' failed to specialize", name ? name : "unnamed");
+		glDeleteShader(shader);
+		return 0;
+	}
+
+	gl_set_debug_name(GL_SHADER, shader, -1, name);
+	return shader;
+}
+
+// Always a new shader, hot reload builds the replacement of a cached one
+static bx::handle_id gl_create_shader(const bx::gfx_shader_desc_t& desc) noexcept
+{
+	using namespace bx;
+
 	const GLenum stage = gl_get_stage(desc.stage);
 	if (stage == 0)
 		return bx::invalid_handle;
 
-	std::string source_code;
-	if (!desc.source && desc.filepath)
+	// SPIR-V is either given or compiled from GLSL by the compile service, without
+	// ARB_gl_spirv the GLSL goes to the driver instead
+	bx::array<u8> spirv{};
+	bx::array<u64> files{};
+	array_view<u8> code = desc.src_bin;
+	bx::string source_code{};
+	if (desc.src_bin)
 	{
-		bx::string filepath = file_get_path(desc.filepath);
-		std::ifstream file(filepath.c_str());
-		if (!file.is_open())
+		if (desc.lang != gfx_shader_lang_t::SPIR_V || !g_features.gl_spirv)
 		{
-			bx_error(bx, "Failed to open file {}", filepath.c_str());
+			bx_error(bx, "gfx_create_shader: Binary shaders require SPIR-V and GL_ARB_gl_spirv.");
 			return bx::invalid_handle;
 		}
-		source_code += std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
 	}
-	else
+	else if (desc.lang == gfx_shader_lang_t::SPIR_V && g_features.gl_spirv)
 	{
-		source_code += desc.source;
+		if (!gfx_compile_shader_wait(gfx_compile_shader(desc), spirv, &files))
+			return bx::invalid_handle;
+		code = array_view<u8>{ spirv.data(), spirv.size() };
 	}
+	else if (!gfx_preprocess_glsl(desc, source_code, &files))
+		return bx::invalid_handle;
+
+	gl_shader_t glshader{};
+	glshader.name = desc.name;
+	glshader.stage = stage;
+	glshader.key = code
+		? gl_shader_key(stage, code.data(), code.size(), desc.entrypoint)
+		: gl_shader_key(stage, source_code.data(), source_code.size(), nullptr);
 
-	source_code = bx::gfx_compile_glsl(source_code.c_str());
-	std::cout << source_code.c_str() << std::endl;
-	const char* src_ptr = source_code.c_str();
-	GLuint program = 0;
+	if (!desc.src_bin && !desc.source && desc.filepath)
+	{
+		gfx_shader_reload_init(glshader.reload, desc);
+		glshader.reload.files = std::move(files);
+	}
 
 	if (g_features.separate_shader_objects)
 	{
-		program = glCreateShaderProgramv(stage, 1, &src_ptr);
+		// Compiled and linked by hand, glCreateShaderProgramv links before the
+		// binary retrievable hint could be set
+		const GLuint program = glCreateProgram();
 		if (!program)
 		{
 			bx_error(bx, "gfx_create_shader: Failed to create shader program");
@@ -803,83 +1753,77 @@ bx::handle_id bx::gfx_create_shader(const gfx_shader_desc_t& desc) noexcept
 		}
 		glProgramParameteri(program, GL_PROGRAM_SEPARABLE, GL_TRUE);
 
-		GLint linked = GL_FALSE;
-		glGetProgramiv(program, GL_LINK_STATUS, &linked);
-		if (!linked)
-		{
-			GLint len = 0;
-			glGetProgramiv(program, GL_INFO_LOG_LENGTH, &len);
-			std::string log(len, '\0');
-			glGetProgramInfoLog(program, len, &len, &log[0]);
-			bx_error(bx, "Shader program link error: {}", log);
-			glDeleteProgram(program);
-			return bx::invalid_handle;
-		}
-
-		gl_set_debug_name(stage, program, -1, desc.name);
-	}
-	else
-	{
-		const GLuint shader = glCreateShader(stage);
-		if (!shader)
-		{
-			bx_debug(bx, "gfx_create_shader: Failed to create GL shader object.");
-			return bx::invalid_handle;
-		}
-
-		if (desc.src_bin)
+		if (!gl_program_load(program, glshader.key))
 		{
-#ifdef GL_ARB_gl_spirv
-			if (desc.lang == bx::gfx_shader_lang_t::SPIR_V)
-			{
-				glShaderBinary(
-					1, &shader, GL_SHADER_BINARY_FORMAT_SPIR_V_ARB,
-					desc.src_bin.data(), static_cast<GLsizei>(desc.src_bin.size()));
-				glSpecializeShaderARB(shader, desc.entrypoint, 0, nullptr, nullptr);
-			}
-			else
-#endif
+			// Compile and link are one program build, counted once
+			const u64 start = bx::app_timestamp_ns();
+			const GLuint shader = code
+				? gl_load_spirv(stage, code, desc.entrypoint, desc.name)
+				: gl_compile_shader(stage, source_code.c_str(), desc.name);
+			if (!shader)
 			{
-				bx_error(bx, "gfx_create_shader: Binary shaders require SPIR-V and GL_ARB_gl_spirv.");
-				glDeleteShader(shader);
+				bx::gfx_stats_shader_compiled(bx::app_timestamp_ns() - start);
+				glDeleteProgram(program);
 				return bx::invalid_handle;
 			}
-		}
-		else
-		{
-			if (!src_ptr)
+
+			if (g_program_cache)
+				glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+			glAttachShader(program, shader);
+			glLinkProgram(program);
+			glDetachShader(program, shader);
+			glDeleteShader(shader);
+
+			const bool linked = gl_program_linked(program, "Shader program");
+			bx::gfx_stats_shader_compiled(bx::app_timestamp_ns() - start);
+			if (!linked)
 			{
-				bx_error(bx, "gfx_create_shader: No source or binary provided.");
-				glDeleteShader(shader);
+				glDeleteProgram(program);
 				return bx::invalid_handle;
 			}
 
-			glShaderSource(shader, 1, &src_ptr, nullptr);
-			glCompileShader(shader);
+			gl_program_store(program, glshader.key);
 		}
 
-		GLint ok = GL_FALSE;
-		glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
-		if (!ok)
-		{
-			GLint len = 0;
-			glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &len);
-			std::string log(len, '\0');
-			glGetShaderInfoLog(shader, len, &len, &log[0]);
-			bx_error(bx, "Shader compile error: {}", log);
-			glDeleteShader(shader);
+		gl_set_debug_name(GL_PROGRAM, program, -1, desc.name);
+		glshader.shader = program;
+	}
+	else if (code)
+	{
+		glshader.shader = gl_load_spirv(stage, code, desc.entrypoint, desc.name);
+		if (!glshader.shader)
+			return bx::invalid_handle;
+	}
+	else if (g_program_cache)
+	{
+		// Pipelines found in the cache never need the shader object
+		glshader.source = std::move(source_code);
+	}
+	else
+	{
+		const u64 start = app_timestamp_ns();
+		glshader.shader = gl_compile_shader(stage, source_code.c_str(), desc.name);
+		gfx_stats_shader_compiled(app_timestamp_ns() - start);
+		if (!glshader.shader)
 			return bx::invalid_handle;
-		}
-
-		gl_set_debug_name(stage, shader, -1, desc.name);
-		program = shader;
 	}
 
-	gl_shader_t glshader{};
-	glshader.shader = program;
-	glshader.stage = stage;
+	gfx_stats_created(gfx_stats().shaders);
+	return g_shaders.insert(std::move(glshader));
+}
+
+bx::handle_id bx::gfx_create_shader(const gfx_shader_desc_t& desc) noexcept
+{
+	bx_profile(bx);
 
-	return g_shaders.insert(glshader);
+	const handle_id shared = gfx_pipeline_cache_find(desc);
+	if (shared != invalid_handle)
+		return shared;
+
+	const handle_id handle = gl_create_shader(desc);
+	gfx_pipeline_cache_add(desc, handle);
+	return handle;
 }
 
 void bx::gfx_destroy_shader(const handle_id handle) noexcept
@@ -887,13 +1831,17 @@ void bx::gfx_destroy_shader(const handle_id handle) noexcept
 	bx_profile(bx);
 
 	auto glsh = g_shaders.get(handle);
-	if (!glsh) return;
+	if (!glsh || !gfx_pipeline_cache_release_shader(handle)) return;
 
 	if (g_features.separate_shader_objects)
+	{
+		gl_state_forget_program(glsh->shader);
 		glDeleteProgram(glsh->shader);
-	else
+	}
+	else if (glsh->shader)
 		glDeleteShader(glsh->shader);
 	
+	gfx_stats_destroyed(gfx_stats().shaders);
 	g_shaders.remove(handle);
 }
 
@@ -907,6 +1855,8 @@ static GLenum gl_buffer_target_from_usage(const bx::gfx_buffer_usage_t usage)
 	case bx::gfx_buffer_usage_t::INDEX: return GL_ELEMENT_ARRAY_BUFFER;
 	case bx::gfx_buffer_usage_t::UNIFORM: return GL_UNIFORM_BUFFER;
 	case bx::gfx_buffer_usage_t::STORAGE: return GL_SHADER_STORAGE_BUFFER;
+	case bx::gfx_buffer_usage_t::INDIRECT: return GL_DRAW_INDIRECT_BUFFER;
+	case bx::gfx_buffer_usage_t::STAGING: return GL_PIXEL_UNPACK_BUFFER;
 	default:
 		return GL_ARRAY_BUFFER;
 	}
@@ -1021,7 +1971,7 @@ bx::handle_id bx::gfx_create_buffer(const gfx_buffer_desc_t& desc) noexcept
 	else
 	{
 		glGenBuffers(1, &bo);
-		glBindBuffer(target, bo);
+		gl_bind_buffer(target, bo);
 
 		if (g_features.buffer_storage)
 		{
@@ -1063,19 +2013,21 @@ bx::handle_id bx::gfx_create_buffer(const gfx_buffer_desc_t& desc) noexcept
 			}
 		}
 
-		glBindBuffer(target, 0);
+		gl_bind_buffer(target, 0);
 	}
 
 	gl_buffer_t glbuffer{};
 	glbuffer.bo = bo;
 	glbuffer.target = target;
 	glbuffer.usage = usage;
+	glbuffer.name = desc.name;
 	glbuffer.access = gl_access_flags_from_memory(desc.memory_usage);
 	glbuffer.size = desc.size;
 	glbuffer.persistentPtr = persistentPtr;
 
 	gl_set_debug_name(target, bo, -1, desc.name);
 
+	gfx_stats_created(gfx_stats().buffers, desc.size);
 	return g_buffers.insert(glbuffer);
 }
 
@@ -1086,8 +2038,11 @@ void bx::gfx_destroy_buffer(const handle_id handle) noexcept
 	auto glbuff = g_buffers.get(handle);
 	if (!glbuff) return;
 
+	gl_state_forget_buffer(glbuff->bo);
 	glDeleteBuffers(1, &glbuff->bo);
+	gfx_stats_destroyed(gfx_stats().buffers, glbuff->size);
 	g_buffers.remove(handle);
+	gl_resource_changed(handle);
 }
 
 u8* bx::gfx_map_buffer(const handle_id handle, const u64 offset, const u64 size) noexcept
@@ -1097,6 +2052,9 @@ u8* bx::gfx_map_buffer(const handle_id handle, const u64 offset, const u64 size)
 	auto glbuffer = g_buffers.get(handle);
 	if (!glbuffer) return nullptr;
 
+	if (glbuffer->persistentPtr)
+		return static_cast<u8*>(glbuffer->persistentPtr) + offset;
+
 	if (g_features.direct_state_access)
 	{
 		if (glbuffer->access == 0)
@@ -1114,9 +2072,6 @@ u8* bx::gfx_map_buffer(const handle_id handle, const u64 offset, const u64 size)
 	}
 	else
 	{
-		if (glbuffer->persistentPtr)
-			return static_cast<u8*>(glbuffer->persistentPtr) + offset;
-
 		if (glbuffer->access == 0)
 		{
 			bx_error(bx, "Attempted to map GPU-only buffer '{}' (ID: {}, Target: 0x{:X}, Size: {} bytes). Mapping is not allowed.",
@@ -1125,7 +2080,7 @@ u8* bx::gfx_map_buffer(const handle_id handle, const u64 offset, const u64 size)
 			return nullptr;
 		}
 
-		glBindBuffer(glbuffer->target, glbuffer->bo);
+		gl_bind_buffer(glbuffer->target, glbuffer->bo);
 
 		vptr ptr = nullptr;
 		//if (g_features.has_map_buffer_range)
@@ -1139,7 +2094,7 @@ u8* bx::gfx_map_buffer(const handle_id handle, const u64 offset, const u64 size)
 		//	if (ptr) ptr = static_cast<u8*>(ptr) + offset;
 		//}
 
-		glBindBuffer(glbuffer->target, 0);
+		gl_bind_buffer(glbuffer->target, 0);
 		return reinterpret_cast<u8*>(ptr);
 	}
 }
@@ -1152,9 +2107,9 @@ static void gl33_unmap_buffer(const bx::handle_id handle)
 	if (!glbuffer || glbuffer->persistentPtr)
 		return;
 
-	glBindBuffer(glbuffer->target, glbuffer->bo);
+	gl_bind_buffer(glbuffer->target, glbuffer->bo);
 	glUnmapBuffer(glbuffer->target);
-	glBindBuffer(glbuffer->target, 0);
+	gl_bind_buffer(glbuffer->target, 0);
 }
 
 static void gl46_unmap_buffer(const bx::handle_id handle)
@@ -1168,6 +2123,29 @@ static void gl46_unmap_buffer(const bx::handle_id handle)
 	glUnmapNamedBuffer(glbuffer->bo);
 }
 
+bx::gfx_upload_t bx::gfx_upload_alloc(const u64 size, const u64 alignment) noexcept
+{
+	const u64 offset = align_up(g_upload.head, alignment);
+	if (!g_upload.data || size == 0 || offset + size > g_upload.slice_size)
+	{
+		if (g_upload.data && size != 0)
+			bx_warn(bx, "gfx_upload_alloc: {} bytes do not fit this frame's {} byte upload slice", size, g_upload.slice_size);
+		return gfx_upload_t{};
+	}
+
+	// Persistent memory needs no flush, keep flushed in step with head
+	g_upload.head = offset + size;
+	if (g_upload.shadow.size() == 0)
+		g_upload.flushed = g_upload.head;
+
+	gfx_upload_t upload{};
+	upload.buffer = g_upload.buffer;
+	upload.offset = g_upload.frame * g_upload.slice_size + offset;
+	upload.data = g_upload.data + upload.offset;
+	upload.size = size;
+	return upload;
+}
+
 void bx::gfx_unmap_buffer(const handle_id handle) noexcept
 {
 	bx_profile(bx);
@@ -1192,10 +2170,10 @@ static void gl33_update_buffer(const bx::handle_id handle, const u64 dst_offset,
 		return;
 	}
 
-	glBindBuffer(glbuffer->target, glbuffer->bo);
+	gl_bind_buffer(glbuffer->target, glbuffer->bo);
 	glBufferSubData(
 		glbuffer->target, static_cast<GLintptr>(dst_offset), static_cast<GLsizeiptr>(size), src);
-	glBindBuffer(glbuffer->target, 0);
+	gl_bind_buffer(glbuffer->target, 0);
 }
 
 static void gl46_update_buffer(const bx::handle_id handle, const u64 dst_offset, cvptr src, const u64 size)
@@ -1215,10 +2193,42 @@ static void gl46_update_buffer(const bx::handle_id handle, const u64 dst_offset,
 		glbuffer->bo, static_cast<GLintptr>(dst_offset), static_cast<GLsizeiptr>(size), src);
 }
 
+// GPU_ONLY storage may be immutable, and glBufferSubData would wait for draws
+// still reading the buffer. Copying from the ring keeps the update on the GPU.
+static bool gl_stage_buffer_update(const bx::handle_id handle, const u64 dst_offset, cvptr src, const u64 size)
+{
+	bx_profile(bx);
+
+	const bx::gfx_upload_t staging = bx::gfx_upload_alloc(size, 16);
+	if (!staging.data)
+		return false;
+
+	std::memcpy(staging.data, src, static_cast<usize>(size));
+	bx::gfx_copy_buffer(bx::invalid_handle, staging.buffer, handle, staging.offset, dst_offset, size);
+	return true;
+}
+
 void bx::gfx_update_buffer(const handle_id handle, const u64 dst_offset, cvptr src, const u64 size) noexcept
 {
 	bx_profile(bx);
 
+	const auto glbuffer = g_buffers.get(handle);
+	if (glbuffer)
+		gfx_stats().upload_bytes += size;
+
+	if (glbuffer && glbuffer->access == 0)
+	{
+		if (gl_stage_buffer_update(handle, dst_offset, src, size))
+			return;
+
+		if (g_features.buffer_storage)
+		{
+			bx_error(bx, "gfx_update_buffer: {} bytes do not fit the upload ring, GPU-only buffer '{}' not updated",
+				size, glbuffer->name ? glbuffer->name : "unnamed");
+			return;
+		}
+	}
+
 #ifdef BX_APP_GFX_OPENGLES
 	return gl33_update_buffer(handle, dst_offset, src, size);
 #else
@@ -1266,6 +2276,40 @@ static GLenum gl_format_from_texture_format(bx::gfx_texture_format_t fmt, GLenum
 		internal = GL_DEPTH24_STENCIL8;
 		type = GL_UNSIGNED_INT_24_8;
 		return GL_DEPTH_STENCIL;
+
+	// Compressed uploads only take the internal format
+	case bx::gfx_texture_format_t::BC1U_NORM:
+		internal = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+		type = 0;
+		return internal;
+	case bx::gfx_texture_format_t::BC3U_NORM:
+		internal = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+		type = 0;
+		return internal;
+	case bx::gfx_texture_format_t::BC4U_NORM:
+		internal = GL_COMPRESSED_RED_RGTC1;
+		type = 0;
+		return internal;
+	case bx::gfx_texture_format_t::BC5U_NORM:
+		internal = GL_COMPRESSED_RG_RGTC2;
+		type = 0;
+		return internal;
+	case bx::gfx_texture_format_t::BC7U_NORM:
+		internal = GL_COMPRESSED_RGBA_BPTC_UNORM;
+		type = 0;
+		return internal;
+	case bx::gfx_texture_format_t::ETC2_RGB8U_NORM:
+		internal = GL_COMPRESSED_RGB8_ETC2;
+		type = 0;
+		return internal;
+	case bx::gfx_texture_format_t::ETC2_RGBA8U_NORM:
+		internal = GL_COMPRESSED_RGBA8_ETC2_EAC;
+		type = 0;
+		return internal;
+	case bx::gfx_texture_format_t::ASTC_4X4U_NORM:
+		internal = GL_COMPRESSED_RGBA_ASTC_4x4_KHR;
+		type = 0;
+		return internal;
 	default:
 		internal = GL_RGBA8;
 		type = GL_UNSIGNED_BYTE;
@@ -1273,52 +2317,101 @@ static GLenum gl_format_from_texture_format(bx::gfx_texture_format_t fmt, GLenum
 	}
 }
 
-bx::handle_id bx::gfx_create_texture(const gfx_texture_desc_t& desc) noexcept
+static bool gl_format_supported(const bx::gfx_texture_format_t fmt)
 {
-	bx_profile(bx);
+	switch (fmt)
+	{
+	case bx::gfx_texture_format_t::BC1U_NORM:
+	case bx::gfx_texture_format_t::BC3U_NORM:
+		return g_features.tex_compression_s3tc;
+	case bx::gfx_texture_format_t::BC4U_NORM:
+	case bx::gfx_texture_format_t::BC5U_NORM:
+		return g_features.tex_compression_rgtc;
+	case bx::gfx_texture_format_t::BC7U_NORM:
+		return g_features.tex_compression_bptc;
+	case bx::gfx_texture_format_t::ETC2_RGB8U_NORM:
+	case bx::gfx_texture_format_t::ETC2_RGBA8U_NORM:
+		return g_features.tex_compression_etc2;
+	case bx::gfx_texture_format_t::ASTC_4X4U_NORM:
+		return g_features.tex_compression_astc;
+	default:
+		return true;
+	}
+}
+
+// Format the GL storage actually has
+static bx::gfx_texture_format_t gl_storage_format(const gl_texture_t& gltexture)
+{
+	return gltexture.decode ? bx::gfx_texture_format_t::RGBA8U_NORM : gltexture.format;
+}
 
-	GLuint tex = 0;
-	glGenTextures(1, &tex);
+static u32 gl_mip_extent(const u32 extent, const u32 mip)
+{
+	const u32 value = extent >> mip;
+	return value > 0 ? value : 1;
+}
 
-	const GLenum target = gl_target_from_type(desc.type);
-	glBindTexture(target, tex);
+// Bytes of the GL storage, decoded BC textures take their RGBA8 size
+static u64 gl_texture_bytes(const gl_texture_t& gltexture)
+{
+	bx::gfx_texture_desc_t desc{};
+	desc.type = gltexture.type;
+	desc.format = gl_storage_format(gltexture);
+	desc.width = gltexture.width;
+	desc.height = gltexture.height;
+	desc.depth = gltexture.depth;
+	desc.mip_levels = gltexture.mip_levels;
+	return bx::gfx_texture_storage_size(desc, gltexture.first_mip);
+}
+
+// Immutable storage for first_mip and the coarser mips, bound to target
+static void gl_texture_storage(const gl_texture_t& gltexture, const GLenum target)
+{
+	bx_profile(bx);
+
+	GLenum internal_fmt = 0, type = 0;
+	gl_format_from_texture_format(gl_storage_format(gltexture), internal_fmt, type);
 
-	// Determine GL formats
-	GLenum internal_fmt = 0, pixel_fmt = 0, type = 0;
-	pixel_fmt = gl_format_from_texture_format(desc.format, internal_fmt, type);
+	const GLsizei levels = gltexture.mip_levels - gltexture.first_mip;
+	const GLsizei width = static_cast<GLsizei>(gl_mip_extent(gltexture.width, gltexture.first_mip));
+	const GLsizei height = static_cast<GLsizei>(gl_mip_extent(gltexture.height, gltexture.first_mip));
 
-	// Allocate immutable storage
 	switch (target)
 	{
 	case GL_TEXTURE_2D:
-		glTexStorage2D(
-			target, desc.mip_levels, internal_fmt, static_cast<GLsizei>(desc.width),
-			static_cast<GLsizei>(desc.height));
+	case GL_TEXTURE_CUBE_MAP:
+		glTexStorage2D(target, levels, internal_fmt, width, height);
 		break;
 	case GL_TEXTURE_3D:
-		glTexStorage3D(
-			target, desc.mip_levels, internal_fmt, static_cast<GLsizei>(desc.width),
-			static_cast<GLsizei>(desc.height), static_cast<GLsizei>(desc.depth));
-		break;
-	case GL_TEXTURE_CUBE_MAP:
-		glTexStorage2D(
-			GL_TEXTURE_CUBE_MAP, desc.mip_levels, internal_fmt, static_cast<GLsizei>(desc.width),
-			static_cast<GLsizei>(desc.height));
+		glTexStorage3D(target, levels, internal_fmt, width, height,
+			static_cast<GLsizei>(gl_mip_extent(gltexture.depth, gltexture.first_mip)));
 		break;
 	default:
 		break;
 	}
+}
 
-	// Sampler/filter settings
-	const GLint gl_min = (desc.min_filter == gfx_texture_filter_t::NEAREST)
-		? GL_NEAREST_MIPMAP_NEAREST
-		: GL_LINEAR_MIPMAP_LINEAR;
-	const GLint gl_mag = (desc.mag_filter == gfx_texture_filter_t::NEAREST)
-		? GL_NEAREST
-		: GL_LINEAR;
+static void gl_texture_parameters(const gl_texture_t& gltexture, const GLenum target)
+{
+	bx_profile(bx);
+
+	glTexParameteri(target, GL_TEXTURE_MIN_FILTER, gltexture.min_filter);
+	glTexParameteri(target, GL_TEXTURE_MAG_FILTER, gltexture.mag_filter);
+	glTexParameteri(target, GL_TEXTURE_WRAP_S, gltexture.wrap_s);
+	glTexParameteri(target, GL_TEXTURE_WRAP_T, gltexture.wrap_t);
+	glTexParameteri(target, GL_TEXTURE_WRAP_R, gltexture.wrap_r);
+	glTexParameteri(target, GL_TEXTURE_BASE_LEVEL, gltexture.min_mip - gltexture.first_mip);
+}
+
+bx::handle_id bx::gfx_create_texture(const gfx_texture_desc_t& desc) noexcept
+{
+	bx_profile(bx);
 
-	glTexParameteri(target, GL_TEXTURE_MIN_FILTER, gl_min);
-	glTexParameteri(target, GL_TEXTURE_MAG_FILTER, gl_mag);
+	if (desc.mip_levels == 0 || desc.first_mip >= desc.mip_levels)
+	{
+		bx_error(bx, "gfx_create_texture: first mip {} out of {} mip levels", desc.first_mip, desc.mip_levels);
+		return invalid_handle;
+	}
 
 	const auto wrap_to_gl = [](const gfx_texture_wrap_t w)
 		{
@@ -1333,21 +2426,55 @@ bx::handle_id bx::gfx_create_texture(const gfx_texture_desc_t& desc) noexcept
 			}
 		};
 
-	glTexParameteri(target, GL_TEXTURE_WRAP_S, wrap_to_gl(desc.wrap_u));
-	glTexParameteri(target, GL_TEXTURE_WRAP_T, wrap_to_gl(desc.wrap_v));
-	glTexParameteri(target, GL_TEXTURE_WRAP_R, wrap_to_gl(desc.wrap_w));
-
-	glBindTexture(target, 0);
-
 	gl_texture_t gltexture{};
-	gltexture.id = tex;
+	gltexture.name = desc.name;
 	gltexture.type = desc.type;
 	gltexture.format = desc.format;
 	gltexture.width = desc.width;
 	gltexture.height = desc.height;
 	gltexture.depth = desc.depth;
 	gltexture.mip_levels = desc.mip_levels;
+	gltexture.first_mip = desc.first_mip;
+	gltexture.min_mip = desc.first_mip;
+
+	// Sampler/filter settings
+	gltexture.min_filter = (desc.min_filter == gfx_texture_filter_t::NEAREST)
+		? GL_NEAREST_MIPMAP_NEAREST
+		: GL_LINEAR_MIPMAP_LINEAR;
+	gltexture.mag_filter = (desc.mag_filter == gfx_texture_filter_t::NEAREST)
+		? GL_NEAREST
+		: GL_LINEAR;
+	gltexture.wrap_s = wrap_to_gl(desc.wrap_u);
+	gltexture.wrap_t = wrap_to_gl(desc.wrap_v);
+	gltexture.wrap_r = wrap_to_gl(desc.wrap_w);
+
+	if (!gl_format_supported(desc.format))
+	{
+		gltexture.decode = desc.format == gfx_texture_format_t::BC1U_NORM
+			|| desc.format == gfx_texture_format_t::BC3U_NORM
+			|| desc.format == gfx_texture_format_t::BC4U_NORM
+			|| desc.format == gfx_texture_format_t::BC5U_NORM;
 
+		if (!gltexture.decode)
+		{
+			bx_error(bx, "gfx_create_texture: format {} of texture '{}' is not supported by the device",
+				static_cast<u32>(desc.format), desc.name ? desc.name : "unnamed");
+			return invalid_handle;
+		}
+
+		bx_warn(bx, "Texture '{}' is decoded to RGBA8, the device can't sample its BC format", desc.name ? desc.name : "unnamed");
+	}
+
+	glGenTextures(1, &gltexture.id);
+
+	const GLenum target = gl_target_from_type(desc.type);
+	gl_bind_texture(target, gltexture.id);
+	gl_texture_storage(gltexture, target);
+	gl_texture_parameters(gltexture, target);
+	gl_bind_texture(target, 0);
+
+	gltexture.bytes = gl_texture_bytes(gltexture);
+	gfx_stats_created(gfx_stats().textures, gltexture.bytes);
 	return g_textures.insert(gltexture);
 }
 
@@ -1358,74 +2485,258 @@ void bx::gfx_destroy_texture(const handle_id handle) noexcept
 	auto gltex = g_textures.get(handle);
 	if (!gltex) return;
 
+	if (gltex->handle_refs > 0)
+		glMakeTextureHandleNonResidentX(gltex->handle);
+
+	gl_state_forget_texture(gltex->id);
 	glDeleteTextures(1, &gltex->id);
 	
+	gfx_stats_destroyed(gfx_stats().textures, gltex->bytes);
 	g_textures.remove(handle);
+	gl_resource_changed(handle);
 }
 
-void bx::gfx_upload_texture_data(const handle_id texture, const u8* data, const u32 region_count, const gfx_texture_region_t* regions) noexcept
+static bx::array<u8> g_decode_scratch{};
+
+// Decodes the region's slices into g_decode_scratch, nullptr on failure
+static const u8* gl_decode_region(const bx::gfx_texture_format_t fmt, const bx::gfx_texture_region_t& r, const u8* src)
 {
 	bx_profile(bx);
 
-	auto gltexture = g_textures.get(texture);
-	if (!gltexture || !data || !regions)
-		return;
-
-	const GLenum target = gl_target_from_type(gltexture->type);
+	const u64 slice_size = static_cast<u64>(r.width) * r.height * 4;
+	const u64 src_slice_size = bx::gfx_texture_size(fmt, r.width, r.height, 1);
+	g_decode_scratch.resize(static_cast<usize>(slice_size * r.depth));
+	if (g_decode_scratch.size() != slice_size * r.depth)
+		return nullptr;
+
+	for (u32 z = 0; z < r.depth; ++z)
+	{
+		if (!bx::gfx_decode_texture(fmt, r.width, r.height, src + z * src_slice_size, g_decode_scratch.data() + z * slice_size))
+			return nullptr;
+	}
+	return g_decode_scratch.data();
+}
+
+// Compressed when image_size isn't 0
+static void gl_tex_sub_image(const GLenum target, const GLint level, const bx::gfx_texture_region_t& r,
+	const GLenum internal, const GLenum pixel_fmt, const GLenum type, const GLsizei image_size, cvptr src)
+{
+	const GLsizei width = static_cast<GLsizei>(r.width);
+	const GLsizei height = static_cast<GLsizei>(r.height);
+
+	if (target == GL_TEXTURE_3D)
+	{
+		const GLsizei depth = static_cast<GLsizei>(r.depth);
+		if (image_size)
+			glCompressedTexSubImage3D(target, level, r.x, r.y, r.z, width, height, depth, internal, image_size, src);
+		else
+			glTexSubImage3D(target, level, r.x, r.y, r.z, width, height, depth, pixel_fmt, type, src);
+		return;
+	}
+
+	if (image_size)
+		glCompressedTexSubImage2D(target, level, r.x, r.y, width, height, internal, image_size, src);
+	else
+		glTexSubImage2D(target, level, r.x, r.y, width, height, pixel_fmt, type, src);
+}
+
+// Regions read from base + region.offset, base is null when a PIXEL_UNPACK
+// buffer is bound and the offsets are into that buffer
+static void gl_upload_regions(const gl_texture_t& gltexture, const u8* base, const u32 region_count, const bx::gfx_texture_region_t* regions)
+{
+	bx_profile(bx);
+
+	const GLenum target = gl_target_from_type(gltexture.type);
+	const bx::gfx_texture_format_t format = gl_storage_format(gltexture);
+	const bool compressed = bx::gfx_texture_format_is_compressed(format);
 
 	GLenum internal = 0, pixel_fmt = 0, type = 0;
-	pixel_fmt = gl_format_from_texture_format(gltexture->format, internal, type);
+	pixel_fmt = gl_format_from_texture_format(format, internal, type);
+	const u64 texel_size = bx::gfx_texture_size(format, 1, 1, 1);
 
-	glBindTexture(target, gltexture->id);
+	gl_bind_texture(target, gltexture.id);
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
 	for (u32 i = 0; i < region_count; ++i)
 	{
 		const auto& r = regions[i];
-		const u8* src = data;
+		if (r.mip_level < gltexture.first_mip || r.mip_level >= gltexture.mip_levels)
+		{
+			bx_warn(bx, "Skipped upload to mip {} of texture '{}', storage holds mips {} to {}",
+				r.mip_level, gltexture.name ? gltexture.name : "unnamed", gltexture.first_mip, gltexture.mip_levels - 1);
+			continue;
+		}
 
-		if (r.row_stride != 0)
-			glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(r.row_stride / 4));
-		else
-			glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+		if (target == GL_TEXTURE_CUBE_MAP && r.layer >= 6)
+			continue;
 
-		switch (target)
+		const GLint level = r.mip_level - gltexture.first_mip;
+		const GLenum image_target = target == GL_TEXTURE_CUBE_MAP ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + r.layer : target;
+		const u32 depth = target == GL_TEXTURE_3D ? r.depth : 1;
+		cvptr src = reinterpret_cast<cvptr>(reinterpret_cast<uptr>(base) + r.offset);
+
+		if (gltexture.decode)
 		{
-		case GL_TEXTURE_2D:
-			glTexSubImage2D(
-				target, r.mip_level,
-				r.x, r.y,
-				static_cast<GLsizei>(r.width),
-				static_cast<GLsizei>(r.height),
-				pixel_fmt, type, src
-			);
-			break;
-		case GL_TEXTURE_CUBE_MAP:
-			// Cube faces would need to be specified as regions (you can expand later)
-			glTexSubImage2D(
-				GL_TEXTURE_CUBE_MAP_POSITIVE_X, r.mip_level,
-				r.x, r.y,
-				static_cast<GLsizei>(r.width),
-				static_cast<GLsizei>(r.height),
-				pixel_fmt, type, src
-			);
-			break;
-		case GL_TEXTURE_3D:
-			glTexSubImage3D(
-				target, r.mip_level,
-				r.x, r.y, 0,
-				static_cast<GLsizei>(r.width),
-				static_cast<GLsizei>(r.height),
-				static_cast<GLsizei>(gltexture->depth),
-				pixel_fmt, type, src
-			);
-			break;
-		default:
-			break;
+			src = gl_decode_region(gltexture.format, r, static_cast<const u8*>(src));
+			if (!src)
+				continue;
+		}
+
+		// Block rows are always tightly packed
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, compressed || gltexture.decode ? 0 : static_cast<GLint>(r.row_stride / texel_size));
+
+		const GLsizei image_size = compressed ? static_cast<GLsizei>(bx::gfx_texture_size(format, r.width, r.height, depth)) : 0;
+		gl_tex_sub_image(image_target, level, r, internal, pixel_fmt, type, image_size, src);
+	}
+
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+	gl_bind_texture(target, 0);
+}
+
+void bx::gfx_upload_texture_data(const handle_id texture, const u8* data, const u32 region_count, const gfx_texture_region_t* regions) noexcept
+{
+	bx_profile(bx);
+
+	auto gltexture = g_textures.get(texture);
+	if (!gltexture || !data || !regions)
+		return;
+
+	for (u32 i = 0; i < region_count; ++i)
+		gfx_stats().upload_bytes += gfx_texture_size(gltexture->format, regions[i].width, regions[i].height, regions[i].depth);
+
+	// Client memory, a bound unpack buffer would turn data into an offset
+	gl_bind_buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	gl_upload_regions(*gltexture, data, region_count, regions);
+}
+
+void bx::gfx_copy_buffer_to_texture(handle_id cb, handle_id buffer, handle_id texture, u32 region_count, const gfx_texture_region_t* regions) noexcept
+{
+	bx_profile(bx);
+
+	if (cb)
+	{
+		gfx_cmd_record_copy_buffer_to_texture(cb, buffer, texture, region_count, regions);
+		return;
+	}
+
+	const auto glbuffer = g_buffers.get(buffer);
+	const auto gltexture = g_textures.get(texture);
+	if (!glbuffer || !gltexture || !regions)
+	{
+		bx_error(bx, "gfx_copy_buffer_to_texture: invalid buffer or texture");
+		return;
+	}
+
+	// Decoding reads the staged blocks on the CPU, only mapped memory allows it
+	if (gltexture->decode)
+	{
+		if (!glbuffer->persistentPtr)
+		{
+			bx_error(bx, "gfx_copy_buffer_to_texture: texture '{}' is decoded on the CPU, buffer '{}' must stay mapped",
+				gltexture->name ? gltexture->name : "unnamed", glbuffer->name ? glbuffer->name : "unnamed");
+			return;
 		}
+
+		gl_bind_buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		gl_upload_regions(*gltexture, static_cast<const u8*>(glbuffer->persistentPtr), region_count, regions);
+		return;
+	}
+
+	gl_bind_buffer(GL_PIXEL_UNPACK_BUFFER, glbuffer->bo);
+	gl_upload_regions(*gltexture, nullptr, region_count, regions);
+	gl_bind_buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+bool bx::gfx_set_texture_resident_mips(handle_id texture, u32 first_mip) noexcept
+{
+	bx_profile(bx);
+
+	auto gltexture = g_textures.get(texture);
+	if (!gltexture || first_mip >= gltexture->mip_levels)
+		return false;
+
+	if (first_mip == gltexture->first_mip)
+		return true;
+
+	if (!g_features.copy_image)
+		return false;
+
+	gl_texture_t resized = *gltexture;
+	resized.first_mip = static_cast<u8>(first_mip);
+	if (resized.min_mip < resized.first_mip)
+		resized.min_mip = resized.first_mip;
+
+	glGenTextures(1, &resized.id);
+
+	const GLenum target = gl_target_from_type(resized.type);
+	gl_bind_texture(target, resized.id);
+	gl_texture_storage(resized, target);
+	gl_texture_parameters(resized, target);
+	gl_bind_texture(target, 0);
+
+	// Mips present in both storages move on the GPU, the rest is uploaded later
+	const u32 shared_mip = first_mip > gltexture->first_mip ? first_mip : gltexture->first_mip;
+	for (u32 mip = shared_mip; mip < resized.mip_levels; ++mip)
+	{
+		const GLsizei depth = resized.type == gfx_texture_type_t::TEX3D
+			? static_cast<GLsizei>(gl_mip_extent(resized.depth, mip))
+			: resized.type == gfx_texture_type_t::TEX_CUBE ? 6 : 1;
+
+		glCopyImageSubDataX(
+			gltexture->id, target, mip - gltexture->first_mip, 0, 0, 0,
+			resized.id, target, mip - resized.first_mip, 0, 0, 0,
+			static_cast<GLsizei>(gl_mip_extent(resized.width, mip)),
+			static_cast<GLsizei>(gl_mip_extent(resized.height, mip)),
+			depth);
 	}
 
-	glBindTexture(target, 0);
+	// Sets holding the old handle take the new one when bound next
+	resized.handle = 0;
+	if (gltexture->handle_refs > 0)
+	{
+		glMakeTextureHandleNonResidentX(gltexture->handle);
+		resized.handle = glGetTextureHandleX(resized.id);
+		glMakeTextureHandleResidentX(resized.handle);
+	}
+	gl_resource_changed(texture);
+
+	gl_state_forget_texture(gltexture->id);
+	glDeleteTextures(1, &gltexture->id);
+
+	// Storage changed size, the count stays
+	resized.bytes = gl_texture_bytes(resized);
+	gfx_stats().textures.bytes += resized.bytes;
+	gfx_stats().textures.bytes -= gltexture->bytes;
+
+	*gltexture = resized;
+	return true;
+}
+
+void bx::gfx_set_texture_min_mip(handle_id texture, u32 mip) noexcept
+{
+	bx_profile(bx);
+
+	auto gltexture = g_textures.get(texture);
+	if (!gltexture)
+		return;
+
+	if (mip < gltexture->first_mip)
+		mip = gltexture->first_mip;
+	if (mip >= gltexture->mip_levels)
+		mip = gltexture->mip_levels - 1u;
+	if (mip == gltexture->min_mip)
+		return;
+
+	gltexture->min_mip = static_cast<u8>(mip);
+
+	// Parameters are frozen once there is a bindless handle, every resident mip stays sampled
+	if (gltexture->handle)
+		return;
+
+	const GLenum target = gl_target_from_type(gltexture->type);
+	gl_bind_texture(target, gltexture->id);
+	glTexParameteri(target, GL_TEXTURE_BASE_LEVEL, gltexture->min_mip - gltexture->first_mip);
+	gl_bind_texture(target, 0);
 }
 
 bx::handle_id bx::gfx_create_framebuffer(const gfx_framebuffer_desc_t& desc) noexcept
@@ -1434,7 +2745,7 @@ bx::handle_id bx::gfx_create_framebuffer(const gfx_framebuffer_desc_t& desc) noe
 
 	GLuint fbo = 0;
 	glGenFramebuffers(1, &fbo);
-	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	gl_bind_framebuffer(fbo);
 
 	for (u32 i = 0; i < desc.color_textures.size(); ++i)
 	{
@@ -1463,12 +2774,12 @@ bx::handle_id bx::gfx_create_framebuffer(const gfx_framebuffer_desc_t& desc) noe
 	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
 	{
 		bx_error(bx, "Framebuffer incomplete");
+		gl_bind_framebuffer(0);
 		glDeleteFramebuffers(1, &fbo);
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
 		return invalid_handle;
 	}
 
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	gl_bind_framebuffer(0);
 
 	gl_framebuffer_t glfb{};
 	glfb.id = fbo;
@@ -1477,6 +2788,7 @@ bx::handle_id bx::gfx_create_framebuffer(const gfx_framebuffer_desc_t& desc) noe
 	glfb.color_textures.assign(desc.color_textures.data(), desc.color_textures.data() + desc.color_textures.size());
 	glfb.depth_texture = desc.depth_texture;
 
+	gfx_stats_created(gfx_stats().framebuffers);
 	return g_framebuffers.insert(glfb);
 }
 
@@ -1487,8 +2799,10 @@ void bx::gfx_destroy_framebuffer(handle_id fb) noexcept
 	auto glfb = g_framebuffers.get(fb);
 	if (!glfb) return;
 
+	gl_state_forget_framebuffer(glfb->id);
 	glDeleteFramebuffers(1, &glfb->id);
 
+	gfx_stats_destroyed(gfx_stats().framebuffers);
 	g_framebuffers.remove(fb);
 }
 
@@ -1499,35 +2813,188 @@ bx::handle_id bx::gfx_default_framebuffer() noexcept
 	return handle_id{ 0 };
 }
 
-static void gl_vattrib_info(bx::gfx_attribute_format_t fmt, GLenum& type, GLint& sizebytes)
+static void gl_vattrib_info(const bx::gfx_vertex_attribute_t& attr, gl_vertex_attrib_t& baked)
 {
 	bx_profile(bx);
 
-	switch (fmt)
+	baked.normalized = GL_FALSE;
+	baked.integer = GL_FALSE;
+	switch (attr.format)
 	{
 	case bx::gfx_attribute_format_t::FLOAT32:
-		type = GL_FLOAT;
-		sizebytes = sizeof(f32);
+		baked.type = GL_FLOAT;
+		baked.normalized = attr.normalized ? GL_TRUE : GL_FALSE;
+		break;
+	case bx::gfx_attribute_format_t::FLOAT16:
+		baked.type = GL_HALF_FLOAT;
+		break;
+	case bx::gfx_attribute_format_t::SNORM8:
+		baked.type = GL_BYTE;
+		baked.normalized = GL_TRUE;
+		break;
+	case bx::gfx_attribute_format_t::UNORM8:
+		baked.type = GL_UNSIGNED_BYTE;
+		baked.normalized = GL_TRUE;
+		break;
+	case bx::gfx_attribute_format_t::SNORM16:
+		baked.type = GL_SHORT;
+		baked.normalized = GL_TRUE;
+		break;
+	case bx::gfx_attribute_format_t::UNORM16:
+		baked.type = GL_UNSIGNED_SHORT;
+		baked.normalized = GL_TRUE;
+		break;
+	case bx::gfx_attribute_format_t::UINT8:
+		baked.type = GL_UNSIGNED_BYTE;
+		baked.integer = GL_TRUE;
+		break;
+	case bx::gfx_attribute_format_t::UINT16:
+		baked.type = GL_UNSIGNED_SHORT;
+		baked.integer = GL_TRUE;
+		break;
+	case bx::gfx_attribute_format_t::INT_2_10_10_10_REV:
+		baked.type = GL_INT_2_10_10_10_REV;
+		baked.normalized = attr.normalized ? GL_TRUE : GL_FALSE;
 		break;
-		//case gfx_attribute_format_t::UINT8_4_NORM:
-		//	type = GL_UNSIGNED_BYTE;
-		//	normalized = GL_TRUE;
-		//	break;
 	default:
 		break;
 	}
 }
 
+// Resolves formats, implicit offsets (packed per binding), strides and divisors
+static bool gl_bake_vertex_input(const bx::gfx_vertex_input_layout_t& layout, gl_pipeline_t& glpipeline)
+{
+	bx_profile(bx);
+
+	if (layout.attributes.size() > MAX_VERTEX_ATTRIBUTES)
+	{
+		bx_error(bx, "gfx_create_pipeline: {} vertex attributes, at most {} are supported", layout.attributes.size(), MAX_VERTEX_ATTRIBUTES);
+		return false;
+	}
+
+	GLuint relative_offsets[MAX_BOUND_VERTEX_BUFFERS]{};
+	for (u32 i = 0; i < layout.attributes.size(); ++i)
+	{
+		const auto& attr = layout.attributes[i];
+		if (attr.binding >= MAX_BOUND_VERTEX_BUFFERS)
+		{
+			bx_error(bx, "gfx_create_pipeline: vertex binding {} out of range", attr.binding);
+			return false;
+		}
+
+		const GLuint size = bx::gfx_attribute_size(attr.format, attr.count);
+		if (size == 0)
+		{
+			bx_error(bx, "gfx_create_pipeline: vertex attribute {} can't have {} components of its format", attr.location, attr.count);
+			return false;
+		}
+
+		gl_vertex_attrib_t& baked = glpipeline.attributes[i];
+		gl_vattrib_info(attr, baked);
+		baked.location = attr.location;
+		baked.binding = attr.binding;
+		baked.count = attr.count;
+		baked.offset = attr.offset != 0 ? attr.offset : relative_offsets[attr.binding];
+		baked.divisor = attr.input_rate_per_vertex_or_instance;
+
+		relative_offsets[attr.binding] += size;
+		glpipeline.strides[attr.binding] += static_cast<GLsizei>(size);
+	}
+	glpipeline.attribute_count = static_cast<u32>(layout.attributes.size());
+	return true;
+}
+
+static GLbitfield gl_stage_bit(const GLenum stage)
+{
+	switch (stage)
+	{
+	case GL_VERTEX_SHADER:          return GL_VERTEX_SHADER_BIT;
+	case GL_FRAGMENT_SHADER:        return GL_FRAGMENT_SHADER_BIT;
+	case GL_GEOMETRY_SHADER:        return GL_GEOMETRY_SHADER_BIT;
+	case GL_TESS_CONTROL_SHADER:    return GL_TESS_CONTROL_SHADER_BIT;
+	case GL_TESS_EVALUATION_SHADER: return GL_TESS_EVALUATION_SHADER_BIT;
+	case GL_COMPUTE_SHADER:         return GL_COMPUTE_SHADER_BIT;
+	default:                        return 0;
+	}
+}
+
+// Links the program of a pipeline without separate shader objects, 0 on failure
+static GLuint gl_link_pipeline(const bx::handle_id* shaders, const u32 shader_count, cstring name)
+{
+	bx_profile(bx);
+
+	u64 key = g_device_hash;
+	for (u32 i = 0; i < shader_count; ++i)
+	{
+		const auto glsh = g_shaders.get(shaders[i]);
+		if (glsh)
+			key = bx::hash_combine(key, glsh->key);
+	}
+
+	const GLuint program = glCreateProgram();
+	if (!gl_program_load(program, key))
+	{
+		for (u32 i = 0; i < shader_count; ++i)
+		{
+			const auto glsh = g_shaders.get(shaders[i]);
+			if (!glsh) continue;
+			if (!gl_shader_compile_deferred(*glsh))
+			{
+				glDeleteProgram(program);
+				return 0;
+			}
+			glAttachShader(program, glsh->shader);
+		}
+
+		if (g_program_cache)
+			glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+		const u64 start = bx::app_timestamp_ns();
+		glLinkProgram(program);
+
+		for (u32 i = 0; i < shader_count; ++i)
+		{
+			const auto glsh = g_shaders.get(shaders[i]);
+			if (!glsh) continue;
+			glDetachShader(program, glsh->shader);
+		}
+
+		const bool linked = gl_program_linked(program, "Pipeline");
+		bx::gfx_stats_shader_compiled(bx::app_timestamp_ns() - start);
+		if (!linked)
+		{
+			glDeleteProgram(program);
+			return 0;
+		}
+
+		gl_program_store(program, key);
+	}
+
+	gl_set_debug_name(GL_PROGRAM, program, -1, name);
+	return program;
+}
+
 bx::handle_id bx::gfx_create_pipeline(const gfx_pipeline_desc_t& desc) noexcept
 {
 	bx_profile(bx);
 
-	if (!desc.shaders)
+	if (!desc.shaders || desc.shaders.size() > MAX_PIPELINE_SHADERS)
 	{
-		bx_error(bx, "gfx_create_pipeline: no shaders provided");
+		bx_error(bx, "gfx_create_pipeline: expected 1 to {} shaders", MAX_PIPELINE_SHADERS);
 		return bx::invalid_handle;
 	}
 
+	const handle_id shared = gfx_pipeline_cache_find(desc);
+	if (shared != bx::invalid_handle)
+		return shared;
+
+	gl_pipeline_t glpipeline{};
+	if (!gl_bake_vertex_input(desc.input_layout, glpipeline))
+		return bx::invalid_handle;
+
+	for (const auto sh : desc.shaders)
+		glpipeline.shaders[glpipeline.shader_count++] = sh;
+
 	GLuint pipeline = 0;
 
 	if (g_features.separate_shader_objects)
@@ -1543,16 +3010,9 @@ bx::handle_id bx::gfx_create_pipeline(const gfx_pipeline_desc_t& desc) noexcept
 			if (!glsh) continue;
 			bx_ensure(glsh->shader != 0);
 
-			GLbitfield stagebit = 0;
-			switch (glsh->stage)
+			const GLbitfield stagebit = gl_stage_bit(glsh->stage);
+			if (stagebit == 0)
 			{
-			case GL_VERTEX_SHADER:          stagebit = GL_VERTEX_SHADER_BIT; break;
-			case GL_FRAGMENT_SHADER:        stagebit = GL_FRAGMENT_SHADER_BIT; break;
-			case GL_GEOMETRY_SHADER:        stagebit = GL_GEOMETRY_SHADER_BIT; break;
-			case GL_TESS_CONTROL_SHADER:    stagebit = GL_TESS_CONTROL_SHADER_BIT; break;
-			case GL_TESS_EVALUATION_SHADER: stagebit = GL_TESS_EVALUATION_SHADER_BIT; break;
-			case GL_COMPUTE_SHADER:         stagebit = GL_COMPUTE_SHADER_BIT; break;
-			default:
 				bx_error(bx, "gfx_create_pipeline: unknown shader stage");
 				if (glDeleteProgramPipelines)
 					glDeleteProgramPipelines(1, &pipeline);
@@ -1566,36 +3026,9 @@ bx::handle_id bx::gfx_create_pipeline(const gfx_pipeline_desc_t& desc) noexcept
 	}
 	else
 	{
-		const GLuint program = glCreateProgram();
-		for (const auto sh : desc.shaders)
-		{
-			const auto shader = bx::handle_t{ sh }.get_data<GLuint>();
-			glAttachShader(program, shader);
-		}
-		glLinkProgram(program);
-
-		GLint linked = GL_FALSE;
-		glGetProgramiv(program, GL_LINK_STATUS, &linked);
-		if (!linked)
-		{
-			GLint logLen = 0;
-			glGetProgramiv(program, GL_INFO_LOG_LENGTH, &logLen);
-			std::string log(logLen, '\0');
-			glGetProgramInfoLog(program, logLen, &logLen, &log[0]);
-			log = "Pipeline link error: " + log;
-			bx_error(bx, log.c_str());
-			glDeleteProgram(program);
+		pipeline = gl_link_pipeline(glpipeline.shaders, glpipeline.shader_count, desc.name);
+		if (!pipeline)
 			return bx::invalid_handle;
-		}
-
-		for (const auto sh : desc.shaders)
-		{
-			const auto shader = bx::handle_t{ sh }.get_data<GLuint>();
-			glDetachShader(program, shader);
-		}
-
-		gl_set_debug_name(GL_PROGRAM, program, -1, desc.name);
-		pipeline = program;
 	}
 
 	// TODO: For older GL, after shader program creation we should explicity set: glBindAttribLocation(program, loc, attrib_name);
@@ -1611,7 +3044,7 @@ bx::handle_id bx::gfx_create_pipeline(const gfx_pipeline_desc_t& desc) noexcept
 	if (g_features.separate_shader_objects)
 	{
 		if (!g_features.direct_state_access && g_features.vertex_array_object)
-			glBindVertexArrayX(vao);
+			gl_bind_vertex_array(vao);
 
 		GLint status = 0;
 		glValidateProgramPipeline(pipeline);
@@ -1626,86 +3059,60 @@ bx::handle_id bx::gfx_create_pipeline(const gfx_pipeline_desc_t& desc) noexcept
 		}
 
 		if (!g_features.direct_state_access && g_features.vertex_array_object)
-			glBindVertexArrayX(0);
+			gl_bind_vertex_array(0);
 	}
 
 	if (glVertexArrayAttribFormat || glVertexAttribFormat)
 	{
 		if (!glCreateVertexArrays)
-			glBindVertexArrayX(vao);
+			gl_bind_vertex_array(vao);
 
-		GLsizei stride = 0;
-		for (u32 i = 0; i < desc.input_layout.attributes.size(); ++i)
+		for (u32 i = 0; i < glpipeline.attribute_count; ++i)
 		{
-			const auto& attr = desc.input_layout.attributes[i];
-			GLenum type = GL_FLOAT;
-			GLint sizebytes = 0;
-			gl_vattrib_info(attr.format, type, sizebytes);
-			stride += sizebytes * attr.count;
-		}
-
-		GLuint relative_offset = 0;
-		for (u32 i = 0; i < desc.input_layout.attributes.size(); ++i)
-		{
-			const auto& attr = desc.input_layout.attributes[i];
-
-			const GLuint attrib_index = attr.location;
-			const GLuint binding_index = attr.binding;
-			const GLint count = attr.count;
-			GLenum type = GL_FLOAT;
-			GLint sizebytes = 0;
-			gl_vattrib_info(attr.format, type, sizebytes);
-
-			const GLboolean normalized = attr.normalized;
-			const GLuint offset = attr.offset != 0 ? attr.offset : relative_offset;
-		
+			const auto& attr = glpipeline.attributes[i];
 			if (glCreateVertexArrays)
 			{
-				glEnableVertexArrayAttrib(vao, attrib_index);
-				glVertexArrayAttribFormat(vao, attrib_index, count, type, normalized, offset);
-				glVertexArrayAttribBinding(vao, attrib_index, binding_index);
-				if (attr.input_rate_per_vertex_or_instance != 0)
-					glVertexArrayBindingDivisor(vao, binding_index, attr.input_rate_per_vertex_or_instance);
+				glEnableVertexArrayAttrib(vao, attr.location);
+				if (attr.integer)
+					glVertexArrayAttribIFormat(vao, attr.location, attr.count, attr.type, attr.offset);
+				else
+					glVertexArrayAttribFormat(vao, attr.location, attr.count, attr.type, attr.normalized, attr.offset);
+				glVertexArrayAttribBinding(vao, attr.location, attr.binding);
+				if (attr.divisor != 0)
+					glVertexArrayBindingDivisor(vao, attr.binding, attr.divisor);
 			}
 			else
 			{
-				glEnableVertexAttribArray(attrib_index);
-				glVertexAttribFormat(attrib_index, count, type, normalized, offset);
-				glVertexAttribBinding(attrib_index, binding_index);
-				if (attr.input_rate_per_vertex_or_instance != 0)
-					glVertexAttribDivisor(attrib_index, attr.input_rate_per_vertex_or_instance);
-			}	
-
-			relative_offset += sizebytes * count;
+				glEnableVertexAttribArray(attr.location);
+				if (attr.integer)
+					glVertexAttribIFormat(attr.location, attr.count, attr.type, attr.offset);
+				else
+					glVertexAttribFormat(attr.location, attr.count, attr.type, attr.normalized, attr.offset);
+				glVertexAttribBinding(attr.location, attr.binding);
+				if (attr.divisor != 0)
+					glVertexAttribDivisor(attr.location, attr.divisor);
+			}
 		}
 
 		if (!glCreateVertexArrays)
-			glBindVertexArrayX(0);
+			gl_bind_vertex_array(0);
 	}
 
 	gl_set_debug_name(GL_VERTEX_ARRAY, vao, -1, desc.name);
 
-	gl_pipeline_t glpipeline{};
+	glpipeline.name = desc.name;
 	glpipeline.pipeline = pipeline;
 	glpipeline.vao = vao;
 	glpipeline.topology = desc.topology;
 	glpipeline.raster = desc.raster;
 
-	if (desc.input_layout.attributes)
-	{
-		glpipeline.attributes.assign(
-			desc.input_layout.attributes.data(),
-			desc.input_layout.attributes.data() + desc.input_layout.attributes.size());
-	}
-
-	if (desc.color_attachments)
-	{
-		glpipeline.blend_attachments.assign(
-			desc.color_attachments.data(),
-			desc.color_attachments.data() + desc.color_attachments.size());
-	}
+	for (const auto& attachment : desc.color_attachments)
+		glpipeline.blend_enable = glpipeline.blend_enable || attachment.blend_enable;
 
-	return g_pipelines.insert(glpipeline);
+	gfx_stats_created(gfx_stats().pipelines);
+	const handle_id handle = g_pipelines.insert(glpipeline);
+	gfx_pipeline_cache_add(desc, handle);
+	return handle;
 }
 
 void bx::gfx_destroy_pipeline(const handle_id handle) noexcept
@@ -1713,166 +3120,474 @@ void bx::gfx_destroy_pipeline(const handle_id handle) noexcept
 	bx_profile(bx);
 
 	auto glpipeline = g_pipelines.get(handle);
-	if (!glpipeline) return;
+	if (!glpipeline || !gfx_pipeline_cache_release_pipeline(handle)) return;
 
 	if (g_features.separate_shader_objects)
 	{
+		gl_state_forget_program_pipeline(glpipeline->pipeline);
 		if (glDeleteProgramPipelines)
 			glDeleteProgramPipelines(1, &glpipeline->pipeline);
 	}
 	else
 	{
+		gl_state_forget_program(glpipeline->pipeline);
 		glDeleteProgram(glpipeline->pipeline);
 	}
 
 	if (glpipeline->vao)
+	{
+		gl_state_forget_vertex_array(glpipeline->vao);
 		glDeleteVertexArraysX(1, &glpipeline->vao);
+	}
 
+	gfx_stats_destroyed(gfx_stats().pipelines);
 	g_pipelines.remove(handle);
 }
 
-bx::handle_id bx::gfx_create_resource_set(const gfx_resource_set_desc_t& desc) noexcept
+// Compiles shaders whose file or includes changed into new objects that take
+// over the old handles, then relinks only the pipelines using them. A shader
+// or pipeline failing to build keeps its previous version.
+static void gl_reload_files(vptr user, bx::array_view<cstring> paths)
 {
 	bx_profile(bx);
 
-	return handle_id{0};
-}
+	(void)user;
 
-//void bx::gfx_update_resource_set(handle_id set_handle, u32 binding_count, const gfx_resource_binding_t* bindings) noexcept {}
+	bx::array<bx::handle_id> reloaded{};
+	for (usize i = 0; i < g_shaders.size(); ++i)
+	{
+		const gl_shader_t& glsh = g_shaders.data()[i];
+		if (!glsh.reload.filepath.empty() && bx::gfx_shader_reload_matches(glsh.reload, paths))
+			reloaded.push_back(g_shaders.handle_at(i));
+	}
 
-void bx::gfx_destroy_resource_set(handle_id set_handle) noexcept
-{
-	bx_profile(bx);
-}
+	if (reloaded.empty())
+		return;
 
-void bx::gfx_clear_rt(handle_id rt, f32 cv[4]) noexcept
-{
-	bx_profile(bx);
+	// The replaced objects stay alive until the pipelines moved off them
+	bx::array<bx::handle_id> replaced{};
+	for (usize i = 0; i < reloaded.size(); )
+	{
+		const bx::handle_id handle = reloaded[i];
 
-	glClearColor(cv[0], cv[1], cv[2], cv[3]);
-	glClear(GL_COLOR_BUFFER_BIT);
-}
+		// Moved out as creating the shader may move the slots around
+		bx::gfx_shader_reload_t reload = std::move(g_shaders.get(handle)->reload);
 
-void bx::gfx_clear_ds(handle_id ds)
-{
-	bx_profile(bx);
+		bx::array<bx::gfx_shader_macro_t> macros{};
+		bx::gfx_shader_desc_t desc = bx::gfx_shader_reload_desc(reload, macros);
+		desc.name = g_shaders.get(handle)->name;
 
-	glClear(GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
-}
+		const bx::handle_id fresh = gl_create_shader(desc);
+		if (fresh == bx::invalid_handle)
+		{
+			bx_warn(bx, "Shader '{}' failed to reload, keeping the previous version", reload.filepath.c_str());
+			g_shaders.get(handle)->reload = std::move(reload);
+			reloaded[i] = reloaded.back();
+			reloaded.pop_back();
+			continue;
+		}
 
-void bx::gfx_bind_pipeline(handle_id cb, handle_id pipeline) noexcept
-{
-	bx_profile(bx);
+		std::swap(*g_shaders.get(handle), *g_shaders.get(fresh));
+		replaced.push_back(fresh);
+		++i;
+	}
 
-	auto glpipeline = g_pipelines.get(pipeline);
-	if (!glpipeline)
+	for (auto& glpipeline : g_pipelines)
 	{
-		bx_warn(bx, "Attempted to bind pipeline with non-existent handle.");
-		return;
-	}
+		bool affected = false;
+		for (u32 i = 0; i < glpipeline.shader_count; ++i)
+			affected = affected || std::find(reloaded.begin(), reloaded.end(), glpipeline.shaders[i]) != reloaded.end();
 
-	g_current_pipeline = pipeline;
+		if (!affected)
+			continue;
 
-	if (g_features.separate_shader_objects)
-		glBindProgramPipeline(glpipeline->pipeline);
-	else
-		glUseProgram(glpipeline->pipeline);
+		if (g_features.separate_shader_objects)
+		{
+			for (u32 i = 0; i < glpipeline.shader_count; ++i)
+			{
+				const auto glsh = g_shaders.get(glpipeline.shaders[i]);
+				if (glsh && std::find(reloaded.begin(), reloaded.end(), glpipeline.shaders[i]) != reloaded.end())
+					glUseProgramStages(glpipeline.pipeline, gl_stage_bit(glsh->stage), glsh->shader);
+			}
+			continue;
+		}
 
-	if (glpipeline->vao)
-		glBindVertexArrayX(glpipeline->vao);
-	else
-		glBindVertexArrayX(0);
+		const GLuint program = gl_link_pipeline(glpipeline.shaders, glpipeline.shader_count, glpipeline.name);
+		if (!program)
+		{
+			bx_warn(bx, "Pipeline '{}' failed to relink, keeping the previous version", glpipeline.name ? glpipeline.name : "unnamed");
+			continue;
+		}
 
-	if (glpipeline->raster.cull_enable)
-		glEnable(GL_CULL_FACE);
-	else
-		glDisable(GL_CULL_FACE);
+		gl_state_forget_program(glpipeline.pipeline);
+		glDeleteProgram(glpipeline.pipeline);
+		glpipeline.pipeline = program;
+	}
 
-	if (glpipeline->raster.depth_test)
-		glEnable(GL_DEPTH_TEST);
-	else
-		glDisable(GL_DEPTH_TEST);
+	for (const bx::handle_id handle : replaced)
+		bx::gfx_destroy_shader(handle);
 
-	glDepthMask(glpipeline->raster.depth_write ? GL_TRUE : GL_FALSE);
+	bx_info(bx, "Reloaded {} shader(s)", reloaded.size());
+}
 
-	glDisable(GL_BLEND);
-	for (auto& a : glpipeline->blend_attachments)
+static GLuint64 gl_texture_acquire_handle(gl_texture_t& gltexture)
+{
+	if (gltexture.handle_refs++ == 0)
 	{
-		if (a.blend_enable)
+		if (!gltexture.handle)
+			gltexture.handle = glGetTextureHandleX(gltexture.id);
+		glMakeTextureHandleResidentX(gltexture.handle);
+	}
+	return gltexture.handle;
+}
+
+static void gl_texture_release_handle(gl_texture_t& gltexture)
+{
+	if (gltexture.handle_refs > 0 && --gltexture.handle_refs == 0)
+		glMakeTextureHandleNonResidentX(gltexture.handle);
+}
+
+// Adds or removes the set from the users of every resource it binds
+static void gl_resource_set_track(bx::handle_id set_handle, bool add)
+{
+	const auto set = g_resource_sets.get(set_handle);
+	if (!set)
+		return;
+
+	for (const bx::gfx_resource_binding_t& binding : set->bindings)
+	{
+		if (add)
 		{
-			glEnable(GL_BLEND);
-			break;
+			auto users = g_resource_users.get(binding.resource);
+			if (!users)
+			{
+				const auto it = g_resource_users.emplace(binding.resource);
+				if (it == g_resource_users.end())
+					continue;
+				users = &it->second;
+			}
+			if (std::find(users->begin(), users->end(), set_handle) == users->end())
+				users->push_back(set_handle);
+			continue;
 		}
+
+		auto users = g_resource_users.get(binding.resource);
+		if (!users)
+			continue;
+		users->erase(std::remove(users->begin(), users->end(), set_handle), users->end());
+		if (users->empty())
+			g_resource_users.erase(binding.resource);
 	}
 }
 
-void bx::gfx_bind_vertex_buffers(handle_id cmd, u32 first_binding, u32 binding_count, const handle_id* vertex_buffers, const u64* offsets) noexcept
+static void gl_resource_set_release(gl_resource_set_t& set)
 {
-	bx_profile(bx);
-
-	auto glpipeline = g_pipelines.get(g_current_pipeline);
-	if (!glpipeline)
+	for (const bx::handle_id handle : set.resident)
 	{
-		bx_error(bx, "Attemping to bind vertex buffers without a bound pipeline!");
-		return;
+		auto gltexture = g_textures.get(handle);
+		if (gltexture)
+			gl_texture_release_handle(*gltexture);
 	}
+	set.resident.clear();
+}
+
+struct gl_bind_entry_t
+{
+	GLuint binding;
+	GLuint name;
+	GLintptr offset;
+	GLsizeiptr size;
+	GLenum kind;
+};
+
+// Sorts the entries into runs of consecutive bindings, false on a duplicate
+static bool gl_bind_range_build(gl_bind_range_t& range, std::vector<gl_bind_entry_t>& entries)
+{
+	range = gl_bind_range_t{};
+	std::sort(entries.begin(), entries.end(),
+		[](const gl_bind_entry_t& a, const gl_bind_entry_t& b) { return a.binding < b.binding; });
 
-	if (glBindVertexBuffers || glBindVertexBuffer)
+	for (usize i = 0; i < entries.size(); ++i)
 	{
-		if (glBindVertexBuffers)
+		const gl_bind_entry_t& entry = entries[i];
+		if (i > 0 && entries[i - 1].binding == entry.binding)
+			return false;
+
+		if (range.runs.empty() || range.runs.back().first + range.runs.back().count != entry.binding)
 		{
-			static GLuint tmp_buffers[MAX_BOUND_VERTEX_BUFFERS]{};
-			static GLintptr tmp_offset[MAX_BOUND_VERTEX_BUFFERS]{};
-			static GLsizei tmp_strides[MAX_BOUND_VERTEX_BUFFERS]{};
-			for (i32 i = 0; i < binding_count; i++)
-			{
-				const auto glbuff = g_buffers.get(vertex_buffers[i]);
-				if (!glbuff) continue;
+			gl_bind_run_t run{};
+			run.first = entry.binding;
+			run.start = static_cast<u32>(range.names.size());
+			range.runs.push_back(run);
+		}
+		++range.runs.back().count;
 
-				// Compute stride
-				GLsizei stride = 0;
-				for (const auto& attr : glpipeline->attributes)
-				{
-					if (attr.binding != i) continue;
+		range.names.push_back(entry.name);
+		range.offsets.push_back(entry.offset);
+		range.sizes.push_back(entry.size);
+		range.kinds.push_back(entry.kind);
+	}
+	return true;
+}
 
-					GLenum type = GL_FLOAT;
-					GLint sizebytes = 0;
-					gl_vattrib_info(attr.format, type, sizebytes);
-					stride += sizebytes * attr.count;
-				}
+// Looks every resource up and fills the arrays the bind calls take. Missing
+// resources fail the bake, the set then binds what is left.
+static bool gl_resource_set_bake(gl_resource_set_t& set)
+{
+	bx_profile(bx);
+
+	using namespace bx;
 
-				tmp_buffers[i] = glbuff->bo;
-				tmp_offset[i] = static_cast<GLintptr>(offsets ? offsets[i] : 0);
-				tmp_strides[i] = stride;
+	gl_resource_set_release(set);
+	set.dirty = false;
+
+	bool valid = true;
+	std::vector<gl_bind_entry_t> uniforms, storages, textures, images;
+	std::vector<GLuint64> table;
+
+	for (const gfx_resource_binding_t& binding : set.bindings)
+	{
+		switch (binding.type)
+		{
+		case gfx_resource_type_t::UNIFORM_BUFFER:
+		case gfx_resource_type_t::STORAGE_BUFFER:
+		{
+			const bool uniform = binding.type == gfx_resource_type_t::UNIFORM_BUFFER;
+			const GLint alignment = uniform ? g_uniform_alignment : g_storage_alignment;
+			const auto glbuffer = g_buffers.get(binding.resource);
+			const u64 rest = glbuffer && binding.offset < glbuffer->size ? glbuffer->size - binding.offset : 0;
+			const u64 size = binding.size ? binding.size : rest;
+			if (!glbuffer || size == 0 || size > rest || (alignment > 0 && binding.offset % alignment != 0))
+			{
+				bx_error(bx, "Resource set '{}': buffer binding {} is invalid, out of range or not aligned to {} bytes",
+					set.name ? set.name : "unnamed", binding.binding, alignment);
+				valid = false;
+				break;
 			}
 
-			// Bind buffers
-			glBindVertexBuffers(first_binding, binding_count, tmp_buffers, tmp_offset, tmp_strides);
+			gl_bind_entry_t entry{ binding.binding, glbuffer->bo,
+				static_cast<GLintptr>(binding.offset), static_cast<GLsizeiptr>(size), 0 };
+			(uniform ? uniforms : storages).push_back(entry);
+			break;
 		}
-		else
+		case gfx_resource_type_t::TEXTURE:
+		case gfx_resource_type_t::COMBINED_IMAGE_SAMPLER:
+		case gfx_resource_type_t::STORAGE_IMAGE:
 		{
-			for (u32 i = 0; i < binding_count; ++i)
+			const bool image = binding.type == gfx_resource_type_t::STORAGE_IMAGE;
+			const auto gltexture = g_textures.get(binding.resource);
+			if (!gltexture || (image && !g_info.features.supports_compute))
 			{
-				const auto glbuff = g_buffers.get(vertex_buffers[i]);
-				if (!glbuff) continue;
+				bx_error(bx, "Resource set '{}': texture binding {} is invalid or the device has no storage images",
+					set.name ? set.name : "unnamed", binding.binding);
+				valid = false;
+				break;
+			}
 
-				// Compute stride
-				GLsizei stride = 0;
-				for (const auto& attr : glpipeline->attributes)
+			if (image)
+			{
+				GLenum internal = 0, type = 0;
+				gl_format_from_texture_format(gl_storage_format(*gltexture), internal, type);
+				images.push_back(gl_bind_entry_t{ binding.binding, gltexture->id, 0, 0, internal });
+			}
+			else if (set.bindless)
+			{
+				if (table.size() <= binding.binding)
+					table.resize(binding.binding + 1, 0);
+				if (table[binding.binding])
 				{
-					if (attr.binding != i) continue;
-
-					GLenum type = GL_FLOAT;
-					GLint sizebytes = 0;
-					gl_vattrib_info(attr.format, type, sizebytes);
-					stride += sizebytes * attr.count;
+					bx_error(bx, "Resource set '{}' binds texture {} twice", set.name ? set.name : "unnamed", binding.binding);
+					valid = false;
+					break;
 				}
-
-				// Bind buffer
-				const GLuint binding_index = first_binding + i;
-				const GLintptr offset = static_cast<GLintptr>(offsets ? offsets[i] : 0);
-				glBindVertexBuffer(binding_index, glbuff->bo, offset, stride);
+				table[binding.binding] = gl_texture_acquire_handle(*gltexture);
+				set.resident.push_back(binding.resource);
+			}
+			else
+			{
+				textures.push_back(gl_bind_entry_t{ binding.binding, gltexture->id, 0, 0, gl_target_from_type(gltexture->type) });
 			}
+			break;
+		}
+		default:
+			bx_error(bx, "Resource set '{}': binding {} has a type GL can't bind, textures carry their own sampler",
+				set.name ? set.name : "unnamed", binding.binding);
+			valid = false;
+			break;
+		}
+	}
+
+	if (!gl_bind_range_build(set.uniform_buffers, uniforms) || !gl_bind_range_build(set.storage_buffers, storages)
+		|| !gl_bind_range_build(set.textures, textures) || !gl_bind_range_build(set.images, images))
+	{
+		bx_error(bx, "Resource set '{}' binds the same binding twice", set.name ? set.name : "unnamed");
+		valid = false;
+	}
+
+	if (!set.bindless)
+		return valid;
+
+	// Written again only when a texture changed, GL_STATIC_DRAW is fine
+	const u64 size = table.size() * sizeof(GLuint64);
+	if (!set.table)
+		glGenBuffers(1, &set.table);
+	gl_bind_buffer(GL_SHADER_STORAGE_BUFFER, set.table);
+	if (size == set.table_size)
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, static_cast<GLsizeiptr>(size), table.data());
+	else
+		glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(size), table.data(), GL_STATIC_DRAW);
+	set.table_size = size;
+	return valid;
+}
+
+bx::handle_id bx::gfx_create_resource_set(const gfx_resource_set_desc_t& desc) noexcept
+{
+	bx_profile(bx);
+
+	gl_resource_set_t set{};
+	set.name = desc.name;
+	set.bindings.assign(desc.bindings.begin(), desc.bindings.end());
+	set.bindless = desc.bindless && g_info.features.supports_bindless_textures;
+	set.table_binding = desc.table_binding;
+
+	if (!gl_resource_set_bake(set))
+	{
+		gl_resource_set_release(set);
+		if (set.table)
+		{
+			gl_state_forget_buffer(set.table);
+			glDeleteBuffers(1, &set.table);
+		}
+		return invalid_handle;
+	}
+
+	if (set.table)
+		gl_set_debug_name(GL_BUFFER, set.table, -1, desc.name);
+
+	gfx_stats_created(gfx_stats().resource_sets, set.table_size);
+	const handle_id handle = g_resource_sets.insert(std::move(set));
+	gl_resource_set_track(handle, true);
+	return handle;
+}
+
+//void bx::gfx_update_resource_set(handle_id set_handle, u32 binding_count, const gfx_resource_binding_t* bindings) noexcept {}
+
+void bx::gfx_destroy_resource_set(handle_id set_handle) noexcept
+{
+	bx_profile(bx);
+
+	auto set = g_resource_sets.get(set_handle);
+	if (!set) return;
+
+	gl_resource_set_release(*set);
+	if (set->table)
+	{
+		gl_state_forget_buffer(set->table);
+		glDeleteBuffers(1, &set->table);
+	}
+
+	gfx_stats_destroyed(gfx_stats().resource_sets, set->table_size);
+	gl_resource_set_track(set_handle, false);
+	g_resource_sets.remove(set_handle);
+}
+
+void bx::gfx_clear_rt(handle_id rt, f32 cv[4]) noexcept
+{
+	bx_profile(bx);
+
+	glClearColor(cv[0], cv[1], cv[2], cv[3]);
+	glClear(GL_COLOR_BUFFER_BIT);
+}
+
+void bx::gfx_clear_ds(handle_id ds)
+{
+	bx_profile(bx);
+
+	glClear(GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+}
+
+void bx::gfx_bind_pipeline(handle_id cb, handle_id pipeline) noexcept
+{
+	bx_profile(bx);
+
+	if (cb)
+	{
+		gfx_cmd_record(cb, gfx_cmd_type_t::BIND_PIPELINE, gfx_cmd_bind_pipeline_t{ pipeline });
+		return;
+	}
+
+	auto glpipeline = g_pipelines.get(pipeline);
+	if (!glpipeline)
+	{
+		bx_warn(bx, "Attempted to bind pipeline with non-existent handle.");
+		return;
+	}
+
+	g_current_pipeline = pipeline;
+	++gfx_stats().pipeline_binds;
+
+	if (g_features.separate_shader_objects)
+		gl_bind_program_pipeline(glpipeline->pipeline);
+	else
+		gl_use_program(glpipeline->pipeline);
+
+	gl_bind_vertex_array(glpipeline->vao);
+
+	gl_set_capability(GL_CULL_FACE, glpipeline->raster.cull_enable);
+	gl_set_capability(GL_DEPTH_TEST, glpipeline->raster.depth_test);
+	gl_depth_mask(glpipeline->raster.depth_write);
+
+	gl_set_capability(GL_BLEND, glpipeline->blend_enable);
+}
+
+void bx::gfx_bind_vertex_buffers(handle_id cb, u32 first_binding, u32 binding_count, const handle_id* vertex_buffers, const u64* offsets) noexcept
+{
+	bx_profile(bx);
+
+	if (cb)
+	{
+		gfx_cmd_record_vertex_buffers(cb, first_binding, binding_count, vertex_buffers, offsets);
+		return;
+	}
+
+	auto glpipeline = g_pipelines.get(g_current_pipeline);
+	if (!glpipeline)
+	{
+		bx_error(bx, "Attemping to bind vertex buffers without a bound pipeline!");
+		return;
+	}
+
+	if (first_binding + binding_count > MAX_BOUND_VERTEX_BUFFERS)
+	{
+		bx_error(bx, "gfx_bind_vertex_buffers: bindings {}..{} out of range", first_binding, first_binding + binding_count);
+		return;
+	}
+
+	gfx_stats().buffer_binds += binding_count;
+
+	if (glBindVertexBuffers)
+	{
+		GLuint buffers[MAX_BOUND_VERTEX_BUFFERS];
+		GLintptr buffer_offsets[MAX_BOUND_VERTEX_BUFFERS];
+		for (u32 i = 0; i < binding_count; ++i)
+		{
+			const auto glbuff = g_buffers.get(vertex_buffers[i]);
+			buffers[i] = glbuff ? glbuff->bo : 0;
+			buffer_offsets[i] = static_cast<GLintptr>(offsets ? offsets[i] : 0);
+		}
+
+		glBindVertexBuffers(first_binding, binding_count, buffers, buffer_offsets, glpipeline->strides + first_binding);
+	}
+	else if (glBindVertexBuffer)
+	{
+		for (u32 i = 0; i < binding_count; ++i)
+		{
+			const auto glbuff = g_buffers.get(vertex_buffers[i]);
+			if (!glbuff) continue;
+
+			const GLuint binding = first_binding + i;
+			const GLintptr offset = static_cast<GLintptr>(offsets ? offsets[i] : 0);
+			glBindVertexBuffer(binding, glbuff->bo, offset, glpipeline->strides[binding]);
 		}
 	}
 	else
@@ -1887,56 +3602,80 @@ void bx::gfx_bind_vertex_buffers(handle_id cmd, u32 first_binding, u32 binding_c
 				continue;
 			glbuff->vao = glpipeline->vao;
 
-			glBindBuffer(glbuff->target, glbuff->bo);
-
-			// Compute stride
-			GLsizei stride = 0;
-			for (const auto& attr : glpipeline->attributes)
-			{
-				if (attr.binding != i) continue;
-
-				GLenum type = GL_FLOAT;
-				GLint sizebytes = 0;
-				gl_vattrib_info(attr.format, type, sizebytes);
-				stride += sizebytes * attr.count;
-			}
+			gl_bind_buffer(glbuff->target, glbuff->bo);
 
-			// Setup attributes
-			GLuint relative_offset = 0;
-			for (const auto& attr : glpipeline->attributes)
+			const GLuint binding = first_binding + i;
+			const GLsizei stride = glpipeline->strides[binding];
+			const uptr base = static_cast<uptr>(offsets ? offsets[i] : 0);
+			for (u32 a = 0; a < glpipeline->attribute_count; ++a)
 			{
-				if (attr.binding != i) continue;
-
-				const GLuint attrib_index = attr.location;
-				const GLint count = attr.count;
-				GLenum type = GL_FLOAT;
-				GLint sizebytes = 0;
-				gl_vattrib_info(attr.format, type, sizebytes);
-
-				const GLboolean normalized = attr.normalized;
-				const GLuint offset = attr.offset != 0 ? attr.offset : relative_offset;
-				cvptr offset_ptr = reinterpret_cast<vptr>(offset);
-
-				glEnableVertexAttribArray(attrib_index);
-				glVertexAttribPointer(attrib_index, count, type, normalized, stride, offset_ptr);
-
-				if (attr.input_rate_per_vertex_or_instance != 0)
-					glVertexAttribDivisor(attrib_index, attr.input_rate_per_vertex_or_instance);
-
-				relative_offset += sizebytes * count;
+				const auto& attr = glpipeline->attributes[a];
+				if (attr.binding != binding) continue;
+
+				glEnableVertexAttribArray(attr.location);
+				if (attr.integer)
+					glVertexAttribIPointer(attr.location, attr.count, attr.type, stride, reinterpret_cast<cvptr>(base + attr.offset));
+				else
+					glVertexAttribPointer(attr.location, attr.count, attr.type, attr.normalized, stride, reinterpret_cast<cvptr>(base + attr.offset));
+				if (attr.divisor != 0)
+					glVertexAttribDivisor(attr.location, attr.divisor);
 			}
 		}
 	}
 }
 
-void bx::gfx_bind_index_buffer(handle_id cb, handle_id index_buffer, u32 index_type) noexcept
+void bx::gfx_bind_index_buffer(handle_id cb, handle_id index_buffer, gfx_index_type_t index_type) noexcept
 {
 	bx_profile(bx);
+
+	if (cb)
+	{
+		gfx_cmd_record(cb, gfx_cmd_type_t::BIND_INDEX_BUFFER, gfx_cmd_bind_index_buffer_t{ index_buffer, index_type });
+		return;
+	}
+
+	// The element array binding is VAO state, binding a pipeline would lose it,
+	// so it is only applied when an indexed draw is issued
+	++gfx_stats().buffer_binds;
+	g_current_index_buffer = index_buffer;
+	g_current_index_type = index_type == gfx_index_type_t::UINT16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
 }
 
 void bx::gfx_bind_resource_set(handle_id cb, handle_id pipeline_handle, handle_id set_handle, u32 set_index) noexcept
 {
 	bx_profile(bx);
+
+	if (cb)
+	{
+		gfx_cmd_record(cb, gfx_cmd_type_t::BIND_RESOURCE_SET, gfx_cmd_bind_resource_set_t{ pipeline_handle, set_handle, set_index });
+		return;
+	}
+
+	// GL bindings are global, the pipeline and set index only matter to the layout
+	auto set = g_resource_sets.get(set_handle);
+	if (!set)
+	{
+		bx_warn(bx, "gfx_bind_resource_set: invalid set {:#x}", set_handle);
+		return;
+	}
+
+	if (set->dirty)
+	{
+		// A bindless table may change size, the stats follow it
+		const u64 table_size = set->table_size;
+		if (!gl_resource_set_bake(*set))
+			bx_warn(bx, "gfx_bind_resource_set: set '{}' lost some of its resources", set->name ? set->name : "unnamed");
+		gfx_stats().resource_sets.bytes += set->table_size;
+		gfx_stats().resource_sets.bytes -= table_size;
+	}
+
+	gl_bind_buffer_runs(GL_UNIFORM_BUFFER, set->uniform_buffers);
+	gl_bind_buffer_runs(GL_SHADER_STORAGE_BUFFER, set->storage_buffers);
+	gl_bind_texture_runs(set->textures);
+	gl_bind_image_runs(set->images);
+
+	if (set->table)
+		gl_bind_buffer_base(GL_SHADER_STORAGE_BUFFER, set->table_binding, set->table);
 }
 
 static GLenum gl_enum_from_topology(bx::gfx_topology_t t)
@@ -1960,15 +3699,112 @@ static GLenum gl_enum_from_topology(bx::gfx_topology_t t)
 	}
 }
 
+// Topology of the current pipeline
+static GLenum gl_current_mode()
+{
+	const auto glpipeline = g_pipelines.get(g_current_pipeline);
+	return glpipeline ? gl_enum_from_topology(glpipeline->topology) : GL_TRIANGLES;
+}
+
+static GLsizeiptr gl_index_size(const GLenum type)
+{
+	return type == GL_UNSIGNED_SHORT ? 2 : 4;
+}
+
+// Binds the current index buffer to the current VAO, redundant binds are
+// dropped by the shadow state
+static bool gl_apply_index_buffer()
+{
+	const auto glbuffer = g_buffers.get(g_current_index_buffer);
+	if (!glbuffer)
+	{
+		bx_error(bx, "Indexed draw without a valid index buffer bound (ID: {})", g_current_index_buffer);
+		return false;
+	}
+
+	gl_bind_buffer(GL_ELEMENT_ARRAY_BUFFER, glbuffer->bo);
+	return true;
+}
+
+// Checks that draw_count records fit in the buffer. GL reads them straight
+// from the buffer, an overrun is undefined behaviour on some drivers.
+static const gl_buffer_t* gl_get_indirect_buffer(const bx::handle_id buffer, const u64 offset, const u32 draw_count, const u32 stride, const u32 record_size)
+{
+	const auto glbuffer = g_buffers.get(buffer);
+	if (!glbuffer)
+	{
+		bx_error(bx, "Indirect draw with an invalid buffer (ID: {})", buffer);
+		return nullptr;
+	}
+
+	const u64 end = offset + static_cast<u64>(draw_count - 1) * stride + record_size;
+	if (offset % 4 != 0 || stride % 4 != 0 || end > glbuffer->size)
+	{
+		bx_error(bx, "Indirect draw of {} records at offset {} (stride {}) does not fit buffer '{}' ({} bytes)",
+			draw_count, offset, stride, glbuffer->name ? glbuffer->name : "unnamed", glbuffer->size);
+		return nullptr;
+	}
+
+	return glbuffer;
+}
+
+// Reads GPU written data back, waits for the GPU to get there first
+static bool gl_read_buffer(const gl_buffer_t& glbuffer, const u64 offset, vptr dst, const u64 size)
+{
+	bx_profile(bx);
+
+	if (offset + size > glbuffer.size)
+		return false;
+
+	gl_bind_buffer(GL_COPY_READ_BUFFER, glbuffer.bo);
+
+	// Not in GLES, which has to map the buffer instead
+	if (glGetBufferSubData)
+	{
+		glGetBufferSubData(GL_COPY_READ_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), dst);
+		return true;
+	}
+
+	cvptr src = glMapBufferRangeX(GL_COPY_READ_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), GL_MAP_READ_BIT);
+	if (!src)
+		return false;
+
+	std::memcpy(dst, src, static_cast<usize>(size));
+	glUnmapBuffer(GL_COPY_READ_BUFFER);
+	return true;
+}
+
+static cvptr gl_buffer_offset(const u64 offset)
+{
+	return reinterpret_cast<cvptr>(static_cast<uptr>(offset));
+}
+
 void bx::gfx_draw(handle_id cb, u32 vertex_count, u32 instance_count, u32 first_vertex, u32 first_instance) noexcept
 {
 	bx_profile(bx);
 
-	// pick topology from current pipeline
-	GLenum mode = GL_TRIANGLES;
-	const auto glpipeline = g_pipelines.get(g_current_pipeline);
-	if (glpipeline)
-		mode = gl_enum_from_topology(glpipeline->topology);
+	if (cb)
+	{
+		gfx_cmd_record(cb, gfx_cmd_type_t::DRAW, gfx_cmd_draw_t{ vertex_count, instance_count, first_vertex, first_instance });
+		return;
+	}
+
+	++gfx_stats().draws;
+	gl_upload_flush();
+
+	const GLenum mode = gl_current_mode();
+
+	if (first_instance != 0 && glDrawArraysInstancedBaseInstanceX(
+		mode, static_cast<GLint>(first_vertex), static_cast<GLsizei>(vertex_count),
+		static_cast<GLsizei>(instance_count > 1 ? instance_count : 1), static_cast<GLuint>(first_instance)))
+		return;
+
+	static bool warned = false;
+	if (first_instance != 0 && !warned)
+	{
+		bx_warn(bx, "gfx_draw: base instance unsupported, drawing from instance 0");
+		warned = true;
+	}
 
 	if (instance_count <= 1)
 	{
@@ -1984,24 +3820,309 @@ void bx::gfx_draw(handle_id cb, u32 vertex_count, u32 instance_count, u32 first_
 	}
 }
 
-void bx::gfx_draw_indexed(handle_id cb, u32 index_count, u32 instance_count, u32 first_index, i32 vertex_offset) noexcept
+void bx::gfx_draw_indexed(handle_id cb, u32 index_count, u32 instance_count, u32 first_index, i32 vertex_offset, u32 first_instance) noexcept
+{
+	bx_profile(bx);
+
+	if (cb)
+	{
+		gfx_cmd_record(cb, gfx_cmd_type_t::DRAW_INDEXED, gfx_cmd_draw_indexed_t{ index_count, instance_count, first_index, vertex_offset, first_instance });
+		return;
+	}
+
+	if (!gl_apply_index_buffer())
+		return;
+
+	++gfx_stats().draws;
+	gl_upload_flush();
+
+	const GLenum mode = gl_current_mode();
+	const GLsizei count = static_cast<GLsizei>(index_count);
+	const GLsizei instances = static_cast<GLsizei>(instance_count > 1 ? instance_count : 1);
+	cvptr indices = gl_buffer_offset(static_cast<u64>(first_index) * gl_index_size(g_current_index_type));
+
+	if (first_instance != 0 && glDrawElementsInstancedBaseVertexBaseInstanceX(
+		mode, count, g_current_index_type, indices, instances, static_cast<GLint>(vertex_offset), static_cast<GLuint>(first_instance)))
+		return;
+
+	static bool warned = false;
+	if (first_instance != 0 && !warned)
+	{
+		bx_warn(bx, "gfx_draw_indexed: base instance unsupported, drawing from instance 0");
+		warned = true;
+	}
+
+	if (vertex_offset != 0)
+		glDrawElementsInstancedBaseVertex(mode, count, g_current_index_type, indices, instances, static_cast<GLint>(vertex_offset));
+	else if (instances == 1)
+		glDrawElements(mode, count, g_current_index_type, indices);
+	else
+		glDrawElementsInstanced(mode, count, g_current_index_type, indices, instances);
+}
+
+void bx::gfx_draw_indirect(handle_id cb, handle_id buffer, u64 offset, u32 draw_count, u32 stride) noexcept
+{
+	bx_profile(bx);
+
+	if (cb)
+	{
+		gfx_cmd_record(cb, gfx_cmd_type_t::DRAW_INDIRECT, gfx_cmd_draw_indirect_t{ buffer, offset, draw_count, stride });
+		return;
+	}
+
+	if (draw_count == 0)
+		return;
+
+	const u32 record_size = sizeof(gfx_draw_indirect_command_t);
+	const u32 record_stride = stride != 0 ? stride : record_size;
+	const auto glbuffer = gl_get_indirect_buffer(buffer, offset, draw_count, record_stride, record_size);
+	if (!glbuffer)
+		return;
+
+	const GLenum mode = gl_current_mode();
+
+	if (g_features.draw_indirect)
+	{
+		++gfx_stats().draws;
+		gl_upload_flush();
+		gl_bind_buffer(GL_DRAW_INDIRECT_BUFFER, glbuffer->bo);
+
+		if (g_features.multi_draw_indirect
+			&& glMultiDrawArraysIndirectX(mode, gl_buffer_offset(offset), static_cast<GLsizei>(draw_count), static_cast<GLsizei>(stride)))
+			return;
+
+		for (u32 i = 0; i < draw_count; ++i)
+			glDrawArraysIndirect(mode, gl_buffer_offset(offset + static_cast<u64>(i) * record_stride));
+		return;
+	}
+
+	// No indirect draws at all, the records come back to the CPU
+	for (u32 i = 0; i < draw_count; ++i)
+	{
+		gfx_draw_indirect_command_t record{};
+		if (!gl_read_buffer(*glbuffer, offset + static_cast<u64>(i) * record_stride, &record, record_size))
+		{
+			bx_error(bx, "gfx_draw_indirect: failed to read back buffer '{}'", glbuffer->name ? glbuffer->name : "unnamed");
+			return;
+		}
+
+		if (record.instance_count > 0)
+			gfx_draw(invalid_handle, record.vertex_count, record.instance_count, record.first_vertex, record.first_instance);
+	}
+}
+
+void bx::gfx_draw_indexed_indirect(handle_id cb, handle_id buffer, u64 offset, u32 draw_count, u32 stride) noexcept
 {
 	bx_profile(bx);
+
+	if (cb)
+	{
+		gfx_cmd_record(cb, gfx_cmd_type_t::DRAW_INDEXED_INDIRECT, gfx_cmd_draw_indirect_t{ buffer, offset, draw_count, stride });
+		return;
+	}
+
+	if (draw_count == 0)
+		return;
+
+	const u32 record_size = sizeof(gfx_draw_indexed_indirect_command_t);
+	const u32 record_stride = stride != 0 ? stride : record_size;
+	const auto glbuffer = gl_get_indirect_buffer(buffer, offset, draw_count, record_stride, record_size);
+	if (!glbuffer)
+		return;
+
+	if (g_features.draw_indirect)
+	{
+		if (!gl_apply_index_buffer())
+			return;
+
+		++gfx_stats().draws;
+		gl_upload_flush();
+
+		const GLenum mode = gl_current_mode();
+		gl_bind_buffer(GL_DRAW_INDIRECT_BUFFER, glbuffer->bo);
+
+		if (g_features.multi_draw_indirect
+			&& glMultiDrawElementsIndirectX(mode, g_current_index_type, gl_buffer_offset(offset), static_cast<GLsizei>(draw_count), static_cast<GLsizei>(stride)))
+			return;
+
+		for (u32 i = 0; i < draw_count; ++i)
+			glDrawElementsIndirect(mode, g_current_index_type, gl_buffer_offset(offset + static_cast<u64>(i) * record_stride));
+		return;
+	}
+
+	// No indirect draws at all, the records come back to the CPU
+	for (u32 i = 0; i < draw_count; ++i)
+	{
+		gfx_draw_indexed_indirect_command_t record{};
+		if (!gl_read_buffer(*glbuffer, offset + static_cast<u64>(i) * record_stride, &record, record_size))
+		{
+			bx_error(bx, "gfx_draw_indexed_indirect: failed to read back buffer '{}'", glbuffer->name ? glbuffer->name : "unnamed");
+			return;
+		}
+
+		if (record.instance_count > 0)
+			gfx_draw_indexed(invalid_handle, record.index_count, record.instance_count, record.first_index, record.vertex_offset, record.first_instance);
+	}
+}
+
+void bx::gfx_draw_indexed_indirect_count(handle_id cb, handle_id buffer, u64 offset, handle_id count_buffer, u64 count_offset, u32 max_draw_count, u32 stride) noexcept
+{
+	bx_profile(bx);
+
+	if (cb)
+	{
+		gfx_cmd_record(cb, gfx_cmd_type_t::DRAW_INDEXED_INDIRECT_COUNT,
+			gfx_cmd_draw_indexed_indirect_count_t{ buffer, offset, count_buffer, count_offset, max_draw_count, stride });
+		return;
+	}
+
+	if (max_draw_count == 0)
+		return;
+
+	const auto glcount = g_buffers.get(count_buffer);
+	if (!glcount || count_offset % 4 != 0 || count_offset + sizeof(u32) > glcount->size)
+	{
+		bx_error(bx, "gfx_draw_indexed_indirect_count: invalid count buffer (ID: {}) or offset {}", count_buffer, count_offset);
+		return;
+	}
+
+	if (g_features.indirect_count && g_features.draw_indirect)
+	{
+		const u32 record_size = sizeof(gfx_draw_indexed_indirect_command_t);
+		const auto glbuffer = gl_get_indirect_buffer(buffer, offset, max_draw_count, stride != 0 ? stride : record_size, record_size);
+		if (!glbuffer || !gl_apply_index_buffer())
+			return;
+
+		gl_upload_flush();
+		gl_bind_buffer(GL_DRAW_INDIRECT_BUFFER, glbuffer->bo);
+		gl_bind_buffer(GL_PARAMETER_BUFFER, glcount->bo);
+
+		if (glMultiDrawElementsIndirectCountX(gl_current_mode(), g_current_index_type, gl_buffer_offset(offset),
+			static_cast<GLintptr>(count_offset), static_cast<GLsizei>(max_draw_count), static_cast<GLsizei>(stride)))
+		{
+			++gfx_stats().draws;
+			return;
+		}
+	}
+
+	// The count has to come back to the CPU, which stalls until the GPU wrote it
+	static bool warned = false;
+	if (!warned)
+	{
+		bx_warn(bx, "gfx_draw_indexed_indirect_count: indirect parameters unsupported, reading the draw count back");
+		warned = true;
+	}
+
+	u32 draw_count = 0;
+	if (!gl_read_buffer(*glcount, count_offset, &draw_count, sizeof(u32)))
+	{
+		bx_error(bx, "gfx_draw_indexed_indirect_count: failed to read back count buffer '{}'", glcount->name ? glcount->name : "unnamed");
+		return;
+	}
+
+	gfx_draw_indexed_indirect(invalid_handle, buffer, offset, draw_count < max_draw_count ? draw_count : max_draw_count, stride);
 }
 
 void bx::gfx_copy_buffer(handle_id cb, handle_id src, handle_id dst, u64 src_offset, u64 dst_offset, u64 size) noexcept
 {
 	bx_profile(bx);
+
+	if (cb)
+	{
+		gfx_cmd_record(cb, gfx_cmd_type_t::COPY_BUFFER, gfx_cmd_copy_buffer_t{ src, dst, src_offset, dst_offset, size });
+		return;
+	}
+
+	const auto glsrc = g_buffers.get(src);
+	const auto gldst = g_buffers.get(dst);
+	if (!glsrc || !gldst || src_offset + size > glsrc->size || dst_offset + size > gldst->size)
+	{
+		bx_error(bx, "gfx_copy_buffer: invalid buffers or {} bytes out of range", size);
+		return;
+	}
+
+	if (size == 0)
+		return;
+
+	gl_upload_flush();
+
+	if (g_features.direct_state_access)
+	{
+		glCopyNamedBufferSubData(glsrc->bo, gldst->bo,
+			static_cast<GLintptr>(src_offset), static_cast<GLintptr>(dst_offset), static_cast<GLsizeiptr>(size));
+		return;
+	}
+
+	gl_bind_buffer(GL_COPY_READ_BUFFER, glsrc->bo);
+	gl_bind_buffer(GL_COPY_WRITE_BUFFER, gldst->bo);
+	glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+		static_cast<GLintptr>(src_offset), static_cast<GLintptr>(dst_offset), static_cast<GLsizeiptr>(size));
 }
 
 void bx::gfx_dispatch(handle_id cb, u32 x, u32 y, u32 z) noexcept
 {
 	bx_profile(bx);
+
+	if (cb)
+	{
+		gfx_cmd_record(cb, gfx_cmd_type_t::DISPATCH, gfx_cmd_dispatch_t{ x, y, z });
+		return;
+	}
+
+	if (!g_features.compute_shader)
+	{
+		bx_error(bx, "gfx_dispatch: compute shaders are not supported by this device");
+		return;
+	}
+
+	if (x == 0 || y == 0 || z == 0)
+		return;
+
+	++gfx_stats().dispatches;
+	gl_upload_flush();
+	glDispatchCompute(x, y, z);
+}
+
+// GL orders everything but incoherent shader writes by itself, so only barriers
+// that follow shader writes need a glMemoryBarrier, for every consumer of dst
+static GLbitfield gl_barrier_bits(const bx::gfx_memory_barrier_t& barrier)
+{
+	const u32 src = static_cast<u32>(barrier.src_access);
+	const u32 dst = static_cast<u32>(barrier.dst_access);
+	if ((src & static_cast<u32>(bx::gfx_shader_access_t::WRITE)) == 0)
+		return 0;
+
+	GLbitfield bits = 0;
+	if (dst & static_cast<u32>(bx::gfx_shader_access_t::READ))
+	{
+		bits |= GL_SHADER_STORAGE_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT
+			| GL_UNIFORM_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_ELEMENT_ARRAY_BARRIER_BIT
+			| GL_COMMAND_BARRIER_BIT;
+	}
+	if (dst & static_cast<u32>(bx::gfx_shader_access_t::WRITE))
+	{
+		bits |= GL_SHADER_STORAGE_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_FRAMEBUFFER_BARRIER_BIT
+			| GL_ATOMIC_COUNTER_BARRIER_BIT;
+	}
+	if (dst & static_cast<u32>(bx::gfx_shader_access_t::TRANSFER))
+	{
+		bits |= GL_BUFFER_UPDATE_BARRIER_BIT | GL_PIXEL_BUFFER_BARRIER_BIT | GL_TEXTURE_UPDATE_BARRIER_BIT
+			| GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT;
+	}
+
+	// No access given, assume the next pass may use the data in any way
+	if (dst == 0)
+		bits = GL_ALL_BARRIER_BITS;
+
+	return bits;
 }
 
 void bx::gfx_submit(handle_id cb) noexcept
 {
 	bx_profile(bx);
+
+	if (cb)
+		gfx_cmd_execute(cb);
 }
 
 void bx::gfx_wait_idle() noexcept
@@ -2012,4 +4133,213 @@ void bx::gfx_wait_idle() noexcept
 void bx::gfx_pipeline_barrier(handle_id cb, const gfx_memory_barrier_t& barrier) noexcept
 {
 	bx_profile(bx);
+
+	if (cb)
+	{
+		gfx_cmd_record(cb, gfx_cmd_type_t::PIPELINE_BARRIER, gfx_cmd_pipeline_barrier_t{ barrier });
+		return;
+	}
+
+	const GLbitfield bits = gl_barrier_bits(barrier);
+	if (bits != 0)
+		glMemoryBarrier(bits);
+}
+
+// GPU culling stage, a single compute program created on first use
+
+#define GL_CULL_GROUP_SIZE 64
+
+static const char* g_cull_source =
+	"layout(local_size_x = 64) in;\n"
+	"struct instance_t { vec4 sphere; uint index_count; uint first_index; int vertex_offset; uint reserved; };\n"
+	"struct command_t { uint index_count; uint instance_count; uint first_index; int vertex_offset; uint first_instance; };\n"
+	"layout(std430, binding = 0) readonly buffer instances_b { instance_t instances[]; };\n"
+	"layout(std430, binding = 1) writeonly buffer commands_b { command_t commands[]; };\n"
+	"layout(std430, binding = 2) buffer count_b { uint draw_count; };\n"
+	"layout(std430, binding = 3) writeonly buffer visible_b { uint visible[]; };\n"
+	"layout(location = 0) uniform vec4 u_planes[6];\n"
+	"layout(location = 6) uniform uint u_instance_count;\n"
+	"layout(location = 7) uniform uint u_flags;\n"
+	"void main()\n"
+	"{\n"
+	"	uint i = gl_GlobalInvocationID.x;\n"
+	"	if (i >= u_instance_count) return;\n"
+	"	vec4 sphere = instances[i].sphere;\n"
+	"	for (int p = 0; p < 6; ++p)\n"
+	"		if (dot(u_planes[p].xyz, sphere.xyz) + u_planes[p].w < -sphere.w) return;\n"
+	"	uint slot = atomicAdd(draw_count, 1u);\n"
+	"	uint first_instance = (u_flags & 1u) != 0u ? i : 0u;\n"
+	"	commands[slot] = command_t(instances[i].index_count, 1u, instances[i].first_index, instances[i].vertex_offset, first_instance);\n"
+	"	if ((u_flags & 2u) != 0u) visible[slot] = i;\n"
+	"}\n";
+
+// u_flags of the cull program
+#define GL_CULL_BASE_INSTANCE 1u	// first_instance may be nonzero, reserved and zero on ES without EXT_base_instance
+#define GL_CULL_VISIBLE 2u			// desc.visible is bound
+
+static GLuint g_cull_program = 0;
+static bool g_cull_failed = false;
+
+static bool gl_create_cull_program()
+{
+	bx_profile(bx);
+
+	if (g_cull_program != 0)
+		return true;
+
+	// Do not retry a broken compile every frame
+	if (g_cull_failed)
+		return false;
+	g_cull_failed = true;
+
+#ifdef BX_APP_GFX_OPENGLES
+	const char* sources[] = { "#version 310 es\nprecision highp float;\n", g_cull_source };
+#else
+	const char* sources[] = { "#version 430\n", g_cull_source };
+#endif
+
+	const GLuint shader = glCreateShader(GL_COMPUTE_SHADER);
+	glShaderSource(shader, 2, sources, nullptr);
+	glCompileShader(shader);
+
+	GLint ok = GL_FALSE;
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+	if (!ok)
+	{
+		GLint len = 0;
+		glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &len);
+		std::string log(len, '\0');
+		glGetShaderInfoLog(shader, len, &len, &log[0]);
+		bx_error(bx, "Cull shader compile error: {}", log);
+		glDeleteShader(shader);
+		return false;
+	}
+
+	const GLuint program = glCreateProgram();
+	glAttachShader(program, shader);
+	glLinkProgram(program);
+	glDetachShader(program, shader);
+	glDeleteShader(shader);
+
+	glGetProgramiv(program, GL_LINK_STATUS, &ok);
+	if (!ok)
+	{
+		GLint len = 0;
+		glGetProgramiv(program, GL_INFO_LOG_LENGTH, &len);
+		std::string log(len, '\0');
+		glGetProgramInfoLog(program, len, &len, &log[0]);
+		bx_error(bx, "Cull program link error: {}", log);
+		glDeleteProgram(program);
+		return false;
+	}
+
+	gl_set_debug_name(GL_PROGRAM, program, -1, "bx_cull_instances");
+
+	g_cull_program = program;
+	g_cull_failed = false;
+	return true;
+}
+
+static void gl_destroy_cull_program()
+{
+	if (g_cull_program != 0)
+	{
+		gl_state_forget_program(g_cull_program);
+		glDeleteProgram(g_cull_program);
+	}
+
+	g_cull_program = 0;
+	g_cull_failed = false;
+}
+
+// glUseProgram overrides a bound program pipeline, give the current pipeline
+// its program back after running one of our own
+static void gl_restore_program()
+{
+	const auto glpipeline = g_pipelines.get(g_current_pipeline);
+	gl_use_program(glpipeline && !g_features.separate_shader_objects ? glpipeline->pipeline : 0);
+}
+
+static void gl_clear_count(const gl_buffer_t& glbuffer)
+{
+	const u32 zero = 0;
+	gl_bind_buffer(GL_COPY_WRITE_BUFFER, glbuffer.bo);
+
+	// Immutable storage only accepts glBufferSubData with GL_DYNAMIC_STORAGE_BIT
+	if (glClearBufferSubData)
+		glClearBufferSubData(GL_COPY_WRITE_BUFFER, GL_R32UI, 0, sizeof(u32), GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+	else
+		glBufferSubData(GL_COPY_WRITE_BUFFER, 0, sizeof(u32), &zero);
+}
+
+void bx::gfx_cull_instances(handle_id cb, const gfx_cull_desc_t& desc) noexcept
+{
+	bx_profile(bx);
+
+	if (cb)
+	{
+		gfx_cmd_record(cb, gfx_cmd_type_t::CULL_INSTANCES, gfx_cmd_cull_instances_t{ desc });
+		return;
+	}
+
+	if (!g_info.features.supports_compute)
+	{
+		bx_error(bx, "gfx_cull_instances: compute shaders are not supported by this device");
+		return;
+	}
+
+	const auto instances = g_buffers.get(desc.instances);
+	const auto commands = g_buffers.get(desc.commands);
+	const auto count = g_buffers.get(desc.count);
+	const auto visible = desc.visible ? g_buffers.get(desc.visible) : nullptr;
+	if (!instances || !commands || !count || (desc.visible && !visible))
+	{
+		bx_error(bx, "gfx_cull_instances: invalid instance, command, count or visible buffer");
+		return;
+	}
+
+	const u64 instance_count = desc.instance_count;
+	if (instances->size < instance_count * sizeof(gfx_cull_instance_t)
+		|| commands->size < instance_count * sizeof(gfx_draw_indexed_indirect_command_t)
+		|| count->size < sizeof(u32)
+		|| (visible && visible->size < instance_count * sizeof(u32)))
+	{
+		bx_error(bx, "gfx_cull_instances: buffers too small for {} instances", desc.instance_count);
+		return;
+	}
+
+	const u64 groups = (instance_count + GL_CULL_GROUP_SIZE - 1) / GL_CULL_GROUP_SIZE;
+	if (groups > 65535)
+	{
+		bx_error(bx, "gfx_cull_instances: {} instances exceed one dispatch", desc.instance_count);
+		return;
+	}
+
+	if (!gl_create_cull_program())
+		return;
+
+	gl_upload_flush();
+	gl_clear_count(*count);
+
+	if (groups > 0)
+	{
+		gl_use_program(g_cull_program);
+		glUniform4fv(0, 6, &desc.planes[0][0]);
+		glUniform1ui(6, desc.instance_count);
+		glUniform1ui(7, (g_features.base_instance ? GL_CULL_BASE_INSTANCE : 0u) | (visible ? GL_CULL_VISIBLE : 0u));
+
+		gl_bind_buffer_base(GL_SHADER_STORAGE_BUFFER, 0, instances->bo);
+		gl_bind_buffer_base(GL_SHADER_STORAGE_BUFFER, 1, commands->bo);
+		gl_bind_buffer_base(GL_SHADER_STORAGE_BUFFER, 2, count->bo);
+		if (visible)
+			gl_bind_buffer_base(GL_SHADER_STORAGE_BUFFER, 3, visible->bo);
+
+		++gfx_stats().dispatches;
+		glDispatchCompute(static_cast<GLuint>(groups), 1, 1);
+
+		gl_restore_program();
+	}
+
+	// Indirect draws, storage reads and read backs all see the results
+	glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
 }
\ No newline at end of file
@@ -3,85 +3,588 @@
 #include <glslang/Include/glslang_c_interface.h>
 #include <glslang/Public/resource_limits_c.h>
 
-struct SpirVBinary
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+// GLSL preprocessing and the SPIR-V compile service. Includes and macros are
+// resolved here so the source hashed for the cache is exactly what glslang sees.
+
+#define BX_GLSL_MAX_INCLUDE_DEPTH 16
+#define BX_GLSL_MAX_WORKERS 8
+#define BX_GLSL_SPIRV_FORMAT 0x31565053u // "SPV1"
+
+#if defined(BX_APP_GFX_VULKAN)
+#define BX_GLSL_CLIENT GLSLANG_CLIENT_VULKAN
+#define BX_GLSL_CLIENT_VERSION GLSLANG_TARGET_VULKAN_1_2
+#define BX_GLSL_SPV_VERSION GLSLANG_TARGET_SPV_1_5
+#define BX_GLSL_MESSAGES (GLSLANG_MSG_SPV_RULES_BIT | GLSLANG_MSG_VULKAN_RULES_BIT)
+#else
+// ARB_gl_spirv consumes SPIR-V 1.0
+#define BX_GLSL_CLIENT GLSLANG_CLIENT_OPENGL
+#define BX_GLSL_CLIENT_VERSION GLSLANG_TARGET_OPENGL_450
+#define BX_GLSL_SPV_VERSION GLSLANG_TARGET_SPV_1_0
+#define BX_GLSL_MESSAGES GLSLANG_MSG_SPV_RULES_BIT
+#endif
+
+static bool glsl_read_file(cstring filepath, bx::string& text) noexcept
+{
+	const auto path = bx::file_get_path(filepath);
+	std::ifstream file(path.c_str(), std::ios::binary | std::ios::ate);
+	if (!file.is_open())
+		return false;
+
+	text.resize(static_cast<usize>(file.tellg()));
+	file.seekg(0);
+	return static_cast<bool>(file.read(text.data(), static_cast<std::streamsize>(text.size())));
+}
+
+static cstring glsl_skip_spaces(cstring it, cstring end) noexcept
+{
+	while (it < end && (*it == ' ' || *it == '\t'))
+		++it;
+	return it;
+}
+
+static bool glsl_is_directive(cstring it, cstring end, cstring name) noexcept
+{
+	it = glsl_skip_spaces(it, end);
+	if (it == end || *it != '#')
+		return false;
+	it = glsl_skip_spaces(it + 1, end);
+	const usize len = std::strlen(name);
+	return static_cast<usize>(end - it) >= len && std::strncmp(it, name, len) == 0;
+}
+
+static void glsl_append_line_directive(bx::string& out, const u32 line, const u32 file) noexcept
+{
+	char directive[48];
+	std::snprintf(directive, sizeof(directive), "#line %u %u\n", line, file);
+	out.append(directive);
+}
+
+// Folds "./", "dir/../", repeated and back slashes after the drive so a file
+// always hashes the same however it was spelled
+static void glsl_normalize(bx::string_fixed<512>& path) noexcept
+{
+	cstring const begin = path.c_str();
+	cstring const drive = std::strchr(begin, ']');
+	if (!drive)
+		return;
+
+	bx::string_fixed<512> out(begin, drive + 1 - begin);
+	usize segments[64];
+	u32 depth = 0;
+
+	cstring it = drive + 1;
+	while (*it)
+	{
+		while (*it == '/' || *it == '\\')
+			++it;
+		cstring end = it;
+		while (*end && *end != '/' && *end != '\\')
+			++end;
+
+		const usize len = end - it;
+		if (len == 2 && it[0] == '.' && it[1] == '.')
+		{
+			if (depth > 0)
+			{
+				const bx::string_fixed<512> parent(out.c_str(), segments[--depth]);
+				out = parent;
+			}
+		}
+		else if (len > 0 && !(len == 1 && it[0] == '.') && depth < 64)
+		{
+			segments[depth++] = out.size();
+			out.push_back('/');
+			out.append(it, len);
+		}
+		it = end;
+	}
+
+	path = out;
+}
+
+struct glsl_preprocess_t
+{
+	explicit glsl_preprocess_t(bx::string& out) noexcept : out(out) {}
+
+	bx::string& out;
+	bx::array<u64> included{};
+	u32 files{ 0 };
+};
+
+// Appends text with every #include replaced by the file it names. Paths that
+// start with a drive are logical, others are relative to the including file.
+// #line directives number files in the order they are first included.
+static bool glsl_expand(glsl_preprocess_t& pp, const bx::string& text, cstring filepath, const u32 file, const u32 depth) noexcept
+{
+	if (depth > BX_GLSL_MAX_INCLUDE_DEPTH)
+	{
+		bx_error(bx, "GLSL includes nested deeper than {} in {}", BX_GLSL_MAX_INCLUDE_DEPTH, filepath ? filepath : "source");
+		return false;
+	}
+
+	u32 line = 1;
+	cstring it = text.data();
+	cstring const end = it + text.size();
+	while (it < end)
+	{
+		cstring eol = static_cast<cstring>(std::memchr(it, '\n', end - it));
+		if (!eol)
+			eol = end;
+
+		if (!glsl_is_directive(it, eol, "include"))
+		{
+			pp.out.append(it, eol - it);
+			pp.out.push_back('\n');
+			it = eol + 1;
+			++line;
+			continue;
+		}
+
+		cstring open = static_cast<cstring>(std::memchr(it, '"', eol - it));
+		cstring close = open ? static_cast<cstring>(std::memchr(open + 1, '"', eol - open - 1)) : nullptr;
+		if (!close)
+		{
+			bx_error(bx, "{}({}): #include expects a quoted path", filepath ? filepath : "source", line);
+			return false;
+		}
+
+		bx::string_fixed<512> include{};
+		if (open[1] == '[')
+		{
+			include.append(open + 1, close - open - 1);
+			glsl_normalize(include);
+		}
+		else if (filepath)
+		{
+			// Keep "[drive]/dir/" of the including file
+			cstring slash = std::strrchr(filepath, '/');
+			cstring drive = std::strchr(filepath, ']');
+			if (slash && drive && slash > drive)
+				include.append(filepath, slash + 1 - filepath);
+			else if (drive)
+			{
+				include.append(filepath, drive + 1 - filepath);
+				include.push_back('/');
+			}
+			include.append(open + 1, close - open - 1);
+			glsl_normalize(include);
+		}
+		else
+		{
+			bx_error(bx, "source({}): relative #include without a filepath, name a drive", line);
+			return false;
+		}
+
+		// Every file is included once, like #pragma once
+		const u64 hash = bx::hash_bytes(include.c_str(), include.size());
+		bool seen = false;
+		for (const u64 h : pp.included)
+			seen = seen || h == hash;
+
+		if (!seen)
+		{
+			pp.included.push_back(hash);
+
+			bx::string contents{};
+			if (!glsl_read_file(include.c_str(), contents))
+			{
+				bx_error(bx, "{}({}): cannot open include {}", filepath ? filepath : "source", line, include.c_str());
+				return false;
+			}
+
+			const u32 included_file = ++pp.files;
+			glsl_append_line_directive(pp.out, 1, included_file);
+			if (!glsl_expand(pp, contents, include.c_str(), included_file, depth + 1))
+				return false;
+		}
+
+		it = eol + 1;
+		++line;
+		glsl_append_line_directive(pp.out, line, file);
+	}
+
+	return true;
+}
+
+bool bx::gfx_preprocess_glsl(const gfx_shader_desc_t& desc, bx::string& source, bx::array<u64>* files) noexcept
+{
+	bx_profile(bx);
+
+	// Relative includes and reload matching both start from the normalized path
+	bx::string_fixed<512> filepath{};
+	if (desc.filepath)
+	{
+		filepath = desc.filepath;
+		glsl_normalize(filepath);
+	}
+
+	bx::string text{};
+	if (desc.source)
+		text = desc.source;
+	else if (!desc.filepath || !glsl_read_file(filepath.c_str(), text))
+	{
+		bx_error(bx, "Failed to open file {}", desc.filepath ? desc.filepath : "(null)");
+		return false;
+	}
+
+	// Macros go right after #version, which has to stay the first statement
+	cstring body = text.data();
+	u32 body_line = 1;
+	cstring const end = text.data() + text.size();
+	for (cstring it = body; it < end; )
+	{
+		cstring eol = static_cast<cstring>(std::memchr(it, '\n', end - it));
+		eol = eol ? eol + 1 : end;
+		if (glsl_is_directive(it, eol, "version"))
+		{
+			body = eol;
+			break;
+		}
+		it = eol;
+		++body_line;
+	}
+
+	source.clear();
+	if (body != text.data())
+		source.append(text.data(), body - text.data());
+	else
+		body_line = 0;
+
+	for (const auto& macro : desc.macros)
+	{
+		if (!macro.name)
+			continue;
+		source.append("#define ");
+		source.append(macro.name);
+		source.push_back(' ');
+		source.append(macro.value ? macro.value : "1");
+		source.push_back('\n');
+	}
+	glsl_append_line_directive(source, body_line + 1, 0);
+
+	glsl_preprocess_t pp(source);
+	const bx::string rest(body, end - body);
+	if (!glsl_expand(pp, rest, desc.source ? nullptr : filepath.c_str(), 0, 0))
+		return false;
+
+	if (files)
+	{
+		*files = std::move(pp.included);
+		if (!desc.source)
+			files->push_back(hash_bytes(filepath.c_str(), filepath.size()));
+	}
+	return true;
+}
+
+void bx::gfx_shader_reload_init(gfx_shader_reload_t& reload, const gfx_shader_desc_t& desc) noexcept
+{
+	reload.stage = desc.stage;
+	reload.lang = desc.lang;
+	reload.filepath = desc.filepath;
+	reload.entrypoint = desc.entrypoint;
+	reload.macros.clear();
+	for (const auto& macro : desc.macros)
+	{
+		reload.macros.push_back(bx::string(macro.name));
+		reload.macros.push_back(bx::string(macro.value));
+	}
+}
+
+bx::gfx_shader_desc_t bx::gfx_shader_reload_desc(const gfx_shader_reload_t& reload, bx::array<gfx_shader_macro_t>& macros) noexcept
+{
+	macros.clear();
+	for (usize i = 0; i + 1 < reload.macros.size(); i += 2)
+	{
+		gfx_shader_macro_t macro{};
+		macro.name = reload.macros[i].c_str();
+		macro.value = reload.macros[i + 1].empty() ? nullptr : reload.macros[i + 1].c_str();
+		macros.push_back(macro);
+	}
+
+	gfx_shader_desc_t desc{};
+	desc.stage = reload.stage;
+	desc.lang = reload.lang;
+	desc.filepath = reload.filepath.c_str();
+	desc.entrypoint = reload.entrypoint.empty() ? nullptr : reload.entrypoint.c_str();
+	desc.macros = array_view<gfx_shader_macro_t>{ macros.data(), macros.size() };
+	return desc;
+}
+
+bool bx::gfx_shader_reload_matches(const gfx_shader_reload_t& reload, array_view<cstring> paths) noexcept
+{
+	for (const cstring path : paths)
+	{
+		const u64 hash = hash_bytes(path, std::strlen(path));
+		for (const u64 file : reload.files)
+		{
+			if (file == hash)
+				return true;
+		}
+	}
+	return false;
+}
+
+static glslang_stage_t glsl_stage(const bx::gfx_shader_stage_t stage) noexcept
+{
+	switch (stage)
+	{
+	case bx::gfx_shader_stage_t::VERTEX:		return GLSLANG_STAGE_VERTEX;
+	case bx::gfx_shader_stage_t::TESS_CONTROL:	return GLSLANG_STAGE_TESSCONTROL;
+	case bx::gfx_shader_stage_t::TESS_EVAL:		return GLSLANG_STAGE_TESSEVALUATION;
+	case bx::gfx_shader_stage_t::GEOMETRY:		return GLSLANG_STAGE_GEOMETRY;
+	case bx::gfx_shader_stage_t::FRAGMENT:		return GLSLANG_STAGE_FRAGMENT;
+	case bx::gfx_shader_stage_t::COMPUTE:		return GLSLANG_STAGE_COMPUTE;
+	default:									return GLSLANG_STAGE_COUNT;
+	}
+}
+
+static bool glsl_compile_spirv(const glslang_stage_t stage, cstring source, cstring name, bx::array<u8>& spirv) noexcept
+{
+	bx_profile(bx);
+
+	glslang_input_t input{};
+	input.language = GLSLANG_SOURCE_GLSL;
+	input.stage = stage;
+	input.client = BX_GLSL_CLIENT;
+	input.client_version = BX_GLSL_CLIENT_VERSION;
+	input.target_language = GLSLANG_TARGET_SPV;
+	input.target_language_version = BX_GLSL_SPV_VERSION;
+	input.code = source;
+	input.default_version = 100;
+	input.default_profile = GLSLANG_NO_PROFILE;
+	input.force_default_version_and_profile = false;
+	input.forward_compatible = false;
+	input.messages = GLSLANG_MSG_DEFAULT_BIT;
+	input.resource = glslang_default_resource();
+
+	glslang_shader_t* shader = glslang_shader_create(&input);
+	if (!shader)
+		return false;
+
+	if (!glslang_shader_preprocess(shader, &input) || !glslang_shader_parse(shader, &input))
+	{
+		bx_error(bx, "Shader '{}' compile error: {}", name, glslang_shader_get_info_log(shader));
+		glslang_shader_delete(shader);
+		return false;
+	}
+
+	glslang_program_t* program = glslang_program_create();
+	glslang_program_add_shader(program, shader);
+
+	bool ok = glslang_program_link(program, BX_GLSL_MESSAGES) != 0;
+	if (!ok)
+		bx_error(bx, "Shader '{}' link error: {}", name, glslang_program_get_info_log(program));
+	else
+	{
+		glslang_program_SPIRV_generate(program, stage);
+
+		const usize words = glslang_program_SPIRV_get_size(program);
+		spirv.resize(words * sizeof(u32));
+		ok = spirv.size() == words * sizeof(u32);
+		if (ok)
+			glslang_program_SPIRV_get(program, reinterpret_cast<u32*>(spirv.data()));
+
+		const char* messages = glslang_program_SPIRV_get_messages(program);
+		if (messages && *messages)
+			bx_warn(bx, "Shader '{}': {}", name, messages);
+	}
+
+	glslang_program_delete(program);
+	glslang_shader_delete(shader);
+	return ok;
+}
+
+struct glsl_job_t
 {
-    u32* words;
-    i32 size;
+	glslang_stage_t stage{};
+	bx::string name{};
+	bx::string source{};	// preprocessed, freed once compiled
+	u64 key{ 0 };
+	bx::array<u8> spirv{};
+	bx::array<u64> files{};	// include hashes, for hot reload
+	bool ok{ false };
+	bool done{ false };
 };
 
-SpirVBinary compileShaderToSPIRV_Vulkan(glslang_stage_t stage, cstring shaderSource, cstring fileName)
-{
-    glslang_input_t input{};
-    input.language = GLSLANG_SOURCE_GLSL;
-    input.stage = stage;
-    input.client = GLSLANG_CLIENT_VULKAN;
-    input.client_version = GLSLANG_TARGET_VULKAN_1_2;
-    input.target_language = GLSLANG_TARGET_SPV;
-    input.target_language_version = GLSLANG_TARGET_SPV_1_5;
-    input.code = shaderSource;
-    input.default_version = 100;
-    input.default_profile = GLSLANG_NO_PROFILE;
-    input.force_default_version_and_profile = false;
-    input.forward_compatible = false;
-    input.messages = GLSLANG_MSG_DEFAULT_BIT;
-    input.resource = glslang_default_resource();
-
-    glslang_shader_t* shader = glslang_shader_create(&input);
-
-    SpirVBinary bin{};
-    bin.words = NULL;
-    bin.size = 0;
-
-    if (!glslang_shader_preprocess(shader, &input))
-    {
-        printf("GLSL preprocessing failed %s\n", fileName);
-        printf("%s\n", glslang_shader_get_info_log(shader));
-        printf("%s\n", glslang_shader_get_info_debug_log(shader));
-        printf("%s\n", input.code);
-        glslang_shader_delete(shader);
-        return bin;
-    }
-
-    if (!glslang_shader_parse(shader, &input))
-    {
-        printf("GLSL parsing failed %s\n", fileName);
-        printf("%s\n", glslang_shader_get_info_log(shader));
-        printf("%s\n", glslang_shader_get_info_debug_log(shader));
-        printf("%s\n", glslang_shader_get_preprocessed_code(shader));
-        glslang_shader_delete(shader);
-        return bin;
-    }
-
-    glslang_program_t* program = glslang_program_create();
-    glslang_program_add_shader(program, shader);
-
-    if (!glslang_program_link(program, GLSLANG_MSG_SPV_RULES_BIT | GLSLANG_MSG_VULKAN_RULES_BIT))
-    {
-        printf("GLSL linking failed %s\n", fileName);
-        printf("%s\n", glslang_program_get_info_log(program));
-        printf("%s\n", glslang_program_get_info_debug_log(program));
-        glslang_program_delete(program);
-        glslang_shader_delete(shader);
-        return bin;
-    }
-
-    glslang_program_SPIRV_generate(program, stage);
-
-    bin.size = glslang_program_SPIRV_get_size(program);
-    bin.words = (u32*)malloc(bin.size * sizeof(u32));
-    glslang_program_SPIRV_get(program, bin.words);
-
-    const char* spirv_messages = glslang_program_SPIRV_get_messages(program);
-    if (spirv_messages)
-        printf("(%s) %s\b", fileName, spirv_messages);
-
-    glslang_program_delete(program);
-    glslang_shader_delete(shader);
-
-    return bin;
-}
-
-bx::string bx::gfx_compile_glsl(cstring src) noexcept
-{
-    return src;
-}
\ No newline at end of file
+struct glsl_service_t
+{
+	std::mutex mutex{};
+	std::condition_variable wake{};
+	std::condition_variable done{};
+	std::deque<glsl_job_t*> queue{};		// compiled in submission order
+	bx::handle_map<glsl_job_t*> jobs{};
+
+	std::thread workers[BX_GLSL_MAX_WORKERS]{};
+	u32 worker_count{ 0 };
+	bool stop{ false };
+};
+
+static glsl_service_t g_glsl{};
+
+static void glsl_run_job(glsl_job_t& job) noexcept
+{
+	u32 format = 0;
+	if (bx::gfx_shader_cache_load(job.key, format, job.spirv) && format == BX_GLSL_SPIRV_FORMAT)
+	{
+		job.ok = true;
+		return;
+	}
+
+	const u64 start = bx::app_timestamp_ns();
+	job.ok = glsl_compile_spirv(job.stage, job.source.c_str(), job.name.c_str(), job.spirv);
+	bx::gfx_stats_shader_compiled(bx::app_timestamp_ns() - start);
+	if (job.ok)
+		bx::gfx_shader_cache_store(job.key, BX_GLSL_SPIRV_FORMAT, job.spirv.data(), job.spirv.size());
+	else
+		job.spirv = bx::array<u8>{};
+}
+
+static void glsl_worker() noexcept
+{
+	glslang_initialize_process();
+
+	std::unique_lock<std::mutex> lock(g_glsl.mutex);
+	for (;;)
+	{
+		g_glsl.wake.wait(lock, [] { return g_glsl.stop || !g_glsl.queue.empty(); });
+		if (g_glsl.stop)
+			break;
+
+		glsl_job_t* job = g_glsl.queue.front();
+		g_glsl.queue.pop_front();
+
+		lock.unlock();
+		glsl_run_job(*job);
+		job->source = bx::string{};
+		lock.lock();
+
+		job->done = true;
+		g_glsl.done.notify_all();
+	}
+
+	lock.unlock();
+	glslang_finalize_process();
+}
+
+// Workers start with the first job so apps that never compile pay nothing
+static void glsl_start_workers() noexcept
+{
+	if (g_glsl.worker_count != 0)
+		return;
+
+	u32 count = std::thread::hardware_concurrency();
+	count = count > 1 ? count - 1 : 1;
+	count = count < BX_GLSL_MAX_WORKERS ? count : BX_GLSL_MAX_WORKERS;
+
+	g_glsl.stop = false;
+	for (u32 i = 0; i < count; ++i)
+		g_glsl.workers[i] = std::thread(glsl_worker);
+	g_glsl.worker_count = count;
+}
+
+bx::handle_id bx::gfx_compile_shader(const gfx_shader_desc_t& desc) noexcept
+{
+	bx_profile(bx);
+
+	if (desc.lang != gfx_shader_lang_t::GLSL && desc.lang != gfx_shader_lang_t::SPIR_V)
+	{
+		bx_error(bx, "gfx_compile_shader: only GLSL sources compile to SPIR-V");
+		return invalid_handle;
+	}
+
+	const glslang_stage_t stage = glsl_stage(desc.stage);
+	if (stage == GLSLANG_STAGE_COUNT)
+	{
+		bx_error(bx, "gfx_compile_shader: unknown shader stage");
+		return invalid_handle;
+	}
+
+	glsl_job_t* job = new (std::nothrow) glsl_job_t();
+	if (!job)
+		return invalid_handle;
+
+	if (!gfx_preprocess_glsl(desc, job->source, &job->files))
+	{
+		delete job;
+		return invalid_handle;
+	}
+
+	job->stage = stage;
+	job->name = desc.name ? desc.name : (desc.filepath ? desc.filepath : "unnamed");
+
+	// The target is part of the key, a GL and a Vulkan build never share entries
+	u64 key = hash_combine(BX_GLSL_SPIRV_FORMAT, static_cast<u64>(stage));
+	key = hash_combine(key, static_cast<u64>(BX_GLSL_CLIENT) << 32 | static_cast<u64>(BX_GLSL_CLIENT_VERSION));
+	job->key = hash_combine(key, hash_bytes(job->source.data(), job->source.size()));
+
+	std::lock_guard<std::mutex> lock(g_glsl.mutex);
+	glsl_start_workers();
+	const handle_id handle = g_glsl.jobs.insert(job);
+	g_glsl.queue.push_back(job);
+	g_glsl.wake.notify_one();
+	return handle;
+}
+
+bool bx::gfx_compile_shader_ready(handle_id job) noexcept
+{
+	std::lock_guard<std::mutex> lock(g_glsl.mutex);
+	glsl_job_t** entry = g_glsl.jobs.get(job);
+	return entry && (*entry)->done;
+}
+
+bool bx::gfx_compile_shader_wait(handle_id job, array<u8>& spirv) noexcept
+{
+	return gfx_compile_shader_wait(job, spirv, nullptr);
+}
+
+bool bx::gfx_compile_shader_wait(handle_id job, array<u8>& spirv, bx::array<u64>* files) noexcept
+{
+	bx_profile(bx);
+
+	glsl_job_t* result = nullptr;
+	{
+		std::unique_lock<std::mutex> lock(g_glsl.mutex);
+		glsl_job_t** entry = g_glsl.jobs.get(job);
+		if (!entry)
+			return false;
+
+		result = *entry;
+		g_glsl.done.wait(lock, [result] { return result->done; });
+		g_glsl.jobs.remove(job);
+	}
+
+	const bool ok = result->ok;
+	spirv = std::move(result->spirv);
+	if (files)
+		*files = std::move(result->files);
+	delete result;
+	return ok;
+}
+
+void bx::gfx_shader_compiler_shutdown() noexcept
+{
+	bx_profile(bx);
+
+	{
+		std::lock_guard<std::mutex> lock(g_glsl.mutex);
+		g_glsl.stop = true;
+	}
+	g_glsl.wake.notify_all();
+
+	for (u32 i = 0; i < g_glsl.worker_count; ++i)
+		g_glsl.workers[i].join();
+	g_glsl.worker_count = 0;
+
+	// Jobs nobody waited for
+	for (glsl_job_t* job : g_glsl.jobs)
+		delete job;
+	g_glsl.jobs.clear();
+	g_glsl.queue.clear();
+}
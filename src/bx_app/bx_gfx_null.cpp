@@ -0,0 +1,1180 @@
+#include <bx_app_impl.hpp>
+#include <bx_gfx_cmd.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+
+// Graphics backend that talks to no GPU. Resources get real handles and
+// buffers are backed by system memory so mapping and updates behave. Every
+// call is validated the way a debug layer would, counted per frame and
+// optionally logged, so the gfx layer can be tested and benchmarked headless.
+
+struct null_buffer_t
+{
+	cstring name{ nullptr };
+	bx::gfx_buffer_usage_t usage{};
+	bx::array<u8> data{};
+};
+
+struct null_texture_t
+{
+	cstring name{ nullptr };
+	bx::gfx_texture_format_t format{};
+	u32 width{ 0 };
+	u32 height{ 0 };
+	u32 depth{ 1 };
+	u32 mip_levels{ 1 };
+	u64 bytes{ 0 };
+};
+
+struct null_pipeline_t
+{
+	cstring name{ nullptr };
+	bx::gfx_topology_t topology{};
+	bx::array<bx::gfx_resource_layout_binding_t> layout{};
+};
+
+struct null_resource_set_t
+{
+	cstring name{ nullptr };
+	bx::array<bx::gfx_resource_binding_t> bindings{};
+};
+
+struct null_resource_t
+{
+	cstring name;
+};
+
+static bx::handle_map<null_resource_t> g_shaders{};
+static bx::handle_map<null_buffer_t> g_buffers{};
+static bx::handle_map<null_texture_t> g_textures{};
+static bx::handle_map<null_resource_t> g_framebuffers{};
+static bx::handle_map<null_pipeline_t> g_pipelines{};
+static bx::handle_map<null_resource_set_t> g_resource_sets{};
+
+static bx::gfx_info_t g_info{};
+
+// Upload ring, a plain buffer cut in one slice per frame in flight
+struct null_upload_ring_t
+{
+	bx::handle_id buffer{ bx::invalid_handle };
+	u64 slice_size{ 0 };
+	u64 head{ 0 };
+	u32 frame{ 0 };
+};
+
+static null_upload_ring_t g_upload{};
+
+// What the immediate commands see, draws are checked against it
+struct null_bound_t
+{
+	bx::handle_id pipeline{ bx::invalid_handle };
+	bx::handle_id index_buffer{ bx::invalid_handle };
+};
+
+struct null_recorder_t
+{
+	bool logging{ false };
+	u32 frame{ 0 };
+	bx::array<bx::gfx_null_command_t> log{};
+	bx::gfx_null_stats_t current{};
+	bx::gfx_null_stats_t last{};
+};
+
+static null_bound_t g_bound{};
+static null_recorder_t g_recorder{};
+
+static cstring null_cmd_name(const bx::gfx_null_cmd_t type) noexcept
+{
+	static const cstring names[] =
+	{
+		"BEGIN_FRAME", "END_FRAME", "SUBMIT",
+		"CREATE_SHADER", "DESTROY_SHADER",
+		"CREATE_BUFFER", "DESTROY_BUFFER", "MAP_BUFFER", "UNMAP_BUFFER", "UPDATE_BUFFER",
+		"CREATE_TEXTURE", "DESTROY_TEXTURE", "UPLOAD_TEXTURE",
+		"CREATE_FRAMEBUFFER", "DESTROY_FRAMEBUFFER",
+		"CREATE_PIPELINE", "DESTROY_PIPELINE",
+		"CREATE_RESOURCE_SET", "DESTROY_RESOURCE_SET",
+		"CLEAR_RT", "CLEAR_DS",
+		"BIND_PIPELINE", "BIND_VERTEX_BUFFER", "BIND_INDEX_BUFFER", "BIND_RESOURCE_SET",
+		"DRAW", "DRAW_INDEXED", "DRAW_INDIRECT", "DRAW_INDEXED_INDIRECT", "DRAW_INDEXED_INDIRECT_COUNT",
+		"COPY_BUFFER", "COPY_BUFFER_TO_TEXTURE", "DISPATCH", "PIPELINE_BARRIER", "CULL_INSTANCES"
+	};
+	static_assert(sizeof(names) / sizeof(names[0]) == static_cast<usize>(bx::gfx_null_cmd_t::CULL_INSTANCES) + 1,
+		"null_cmd_name is missing a gfx_null_cmd_t");
+
+	return names[static_cast<usize>(type)];
+}
+
+// Counts a call and appends it to the log. Rejected calls only count as errors.
+static void null_record(const bx::gfx_null_cmd_t type, const bool error,
+	std::initializer_list<bx::handle_id> handles = {}, std::initializer_list<u64> args = {}) noexcept
+{
+	using namespace bx;
+
+	gfx_null_stats_t& stats = g_recorder.current;
+	++stats.commands;
+
+	if (error)
+	{
+		++stats.errors;
+	}
+	else
+	{
+		// The frame stats every backend keeps, next to the Null backend's own
+		gfx_frame_stats_t& frame = gfx_stats();
+		const u64* arg = args.begin();
+		switch (type)
+		{
+		case gfx_null_cmd_t::SUBMIT:					++stats.submits; break;
+		case gfx_null_cmd_t::UPDATE_BUFFER:				++stats.uploads; stats.upload_bytes += arg[1]; frame.upload_bytes += arg[1]; break;
+		case gfx_null_cmd_t::UPLOAD_TEXTURE:			++stats.uploads; break;
+		case gfx_null_cmd_t::BIND_PIPELINE:				++stats.pipeline_binds; ++frame.pipeline_binds; break;
+		case gfx_null_cmd_t::BIND_VERTEX_BUFFER:
+		case gfx_null_cmd_t::BIND_INDEX_BUFFER:			++stats.buffer_binds; ++frame.buffer_binds; break;
+		case gfx_null_cmd_t::BIND_RESOURCE_SET:			++stats.resource_set_binds; break;
+		case gfx_null_cmd_t::DRAW:
+		case gfx_null_cmd_t::DRAW_INDEXED:				++stats.draws; ++frame.draws; stats.vertices += arg[0] * arg[1]; break;
+		case gfx_null_cmd_t::DRAW_INDIRECT:
+		case gfx_null_cmd_t::DRAW_INDEXED_INDIRECT:
+		case gfx_null_cmd_t::DRAW_INDEXED_INDIRECT_COUNT:	++stats.draws; ++frame.draws; break;
+		case gfx_null_cmd_t::COPY_BUFFER:
+		case gfx_null_cmd_t::COPY_BUFFER_TO_TEXTURE:	++stats.copies; break;
+		case gfx_null_cmd_t::DISPATCH:
+		case gfx_null_cmd_t::CULL_INSTANCES:			++stats.dispatches; ++frame.dispatches; break;
+		case gfx_null_cmd_t::PIPELINE_BARRIER:			++stats.barriers; break;
+		default: break;
+		}
+	}
+
+	if (!g_recorder.logging)
+		return;
+
+	gfx_null_command_t command{};
+	command.type = type;
+	command.error = error;
+	command.frame = g_recorder.frame;
+
+	u32 i = 0;
+	for (const handle_id handle : handles)
+		command.handles[i++] = handle;
+	i = 0;
+	for (const u64 arg : args)
+		command.args[i++] = arg;
+
+	g_recorder.log.push_back(command);
+}
+
+// Zero handles are accepted as "nothing", like destroying invalid_handle
+static bool null_check_destroy(const bool found, const bx::handle_id handle, cstring func) noexcept
+{
+	if (found || handle == bx::invalid_handle)
+		return true;
+
+	bx_warn(bx, "{}: invalid handle {:#x}", func, handle);
+	return false;
+}
+
+static bool null_check_range(const null_buffer_t* buffer, const u64 offset, const u64 size) noexcept
+{
+	return buffer && offset <= buffer->data.size() && size <= buffer->data.size() - offset;
+}
+
+static bool null_check_draw(cstring func, const bool indexed) noexcept
+{
+	if (!g_pipelines.contains(g_bound.pipeline))
+	{
+		bx_warn(bx, "{}: no pipeline bound", func);
+		return false;
+	}
+	if (indexed && !g_buffers.contains(g_bound.index_buffer))
+	{
+		bx_warn(bx, "{}: no index buffer bound", func);
+		return false;
+	}
+	return true;
+}
+
+static bool null_check_indirect(cstring func, const bx::handle_id handle, const u64 offset, const u32 draw_count, const u32 stride, const u64 record_size) noexcept
+{
+	auto buffer = g_buffers.get(handle);
+	if (!buffer)
+	{
+		bx_warn(bx, "{}: invalid buffer handle {:#x}", func, handle);
+		return false;
+	}
+
+	const u64 step = stride ? stride : record_size;
+	const u64 size = draw_count ? (draw_count - 1) * step + record_size : 0;
+	if (!null_check_range(buffer, offset, size))
+	{
+		bx_warn(bx, "{}: {} records at offset {} overrun buffer '{}' of {} bytes",
+			func, draw_count, offset, buffer->name ? buffer->name : "", buffer->data.size());
+		return false;
+	}
+	return true;
+}
+
+bool bx::gfx_init(const app_config_t& config) noexcept
+{
+	bx_profile(bx);
+
+	g_info.backend = "null";
+	g_info.device = "null";
+	g_info.adapter = "null";
+	g_info.api_version = "0";
+	g_info.shader_version = "0";
+	g_info.features.max_texture_size = 16384;
+	g_info.features.supports_compute = true;
+	g_info.features.supports_geometry_shader = true;
+	g_info.features.supports_copy_image = true;
+	g_info.features.supports_bc = true;
+	g_info.features.supports_bc7 = true;
+	g_info.features.supports_persistent_mapping = true;
+	g_info.features.supports_base_instance = true;
+	g_info.features.supports_etc2 = true;
+	g_info.features.supports_astc = true;
+	g_info.features.supports_bindless_textures = true;
+
+	gfx_stats_init(config);
+
+	g_bound = null_bound_t{};
+	g_recorder.frame = 0;
+	g_recorder.current = gfx_null_stats_t{};
+	g_recorder.last = gfx_null_stats_t{};
+
+	g_upload = null_upload_ring_t{};
+	g_upload.slice_size = (config.upload_memory / BX_GFX_FRAMES_IN_FLIGHT) & ~u64(255);
+	if (g_upload.slice_size > 0)
+	{
+		gfx_buffer_desc_t desc{};
+		desc.name = "bx_upload_ring";
+		desc.usage = gfx_buffer_usage_t::VERTEX;
+		desc.memory_usage = gfx_memory_usage_t::CPU_TO_GPU;
+		desc.size = g_upload.slice_size * BX_GFX_FRAMES_IN_FLIGHT;
+		g_upload.buffer = gfx_create_buffer(desc);
+	}
+
+	gfx_shader_cache_init(config);
+	gfx_pipeline_cache_init();
+
+	return true;
+}
+
+void bx::gfx_shutdown() noexcept
+{
+	bx_profile(bx);
+
+	gfx_stream_shutdown();
+	gfx_cmd_shutdown();
+	gfx_shader_compiler_shutdown();
+	gfx_shader_cache_shutdown();
+	gfx_pipeline_cache_shutdown();
+
+	g_upload = null_upload_ring_t{};
+	g_bound = null_bound_t{};
+
+	g_shaders.clear();
+	g_buffers.clear();
+	g_textures.clear();
+	g_framebuffers.clear();
+	g_pipelines.clear();
+	g_resource_sets.clear();
+
+	gfx_stats_shutdown();
+
+	// Kept until the next gfx_init so tests can look at the last frames
+	g_recorder.logging = false;
+}
+
+void bx::gfx_begin_frame() noexcept
+{
+	null_record(gfx_null_cmd_t::BEGIN_FRAME, false, {}, { g_recorder.frame });
+
+	gfx_stream_update();
+}
+
+void bx::gfx_end_frame() noexcept
+{
+	null_record(gfx_null_cmd_t::END_FRAME, false, {}, { g_recorder.frame });
+
+	g_recorder.last = g_recorder.current;
+	g_recorder.current = gfx_null_stats_t{};
+	++g_recorder.frame;
+
+	g_upload.frame = (g_upload.frame + 1) % BX_GFX_FRAMES_IN_FLIGHT;
+	g_upload.head = 0;
+
+	gfx_stats_end_frame();
+}
+
+const bx::gfx_info_t& bx::gfx_get_info() noexcept
+{
+	return g_info;
+}
+
+bx::gfx_state_stats_t bx::gfx_get_state_stats() noexcept
+{
+	return gfx_state_stats_t{};
+}
+
+void bx::gfx_reset_state_stats() noexcept
+{
+}
+
+void bx::gfx_invalidate_state() noexcept
+{
+}
+
+void bx::gfx_push_debug_group(cstring name) noexcept
+{
+	(void)name;
+}
+
+void bx::gfx_pop_debug_group() noexcept
+{
+}
+
+void bx::gfx_insert_debug_marker(cstring name) noexcept
+{
+	(void)name;
+}
+
+bx::handle_id bx::gfx_create_shader(const gfx_shader_desc_t& desc) noexcept
+{
+	bx_profile(bx);
+
+	handle_id handle = gfx_pipeline_cache_find(desc);
+	if (handle == invalid_handle)
+	{
+		handle = g_shaders.insert(null_resource_t{ desc.name });
+		gfx_stats_created(gfx_stats().shaders);
+		gfx_pipeline_cache_add(desc, handle);
+	}
+	null_record(gfx_null_cmd_t::CREATE_SHADER, false, { handle });
+	return handle;
+}
+
+void bx::gfx_destroy_shader(const handle_id handle) noexcept
+{
+	// Dropping a shared reference leaves the shader alive
+	if (g_shaders.contains(handle) && !gfx_pipeline_cache_release_shader(handle))
+	{
+		null_record(gfx_null_cmd_t::DESTROY_SHADER, false, { handle });
+		return;
+	}
+
+	const bool valid = null_check_destroy(g_shaders.contains(handle), handle, "gfx_destroy_shader");
+	if (g_shaders.remove(handle))
+		gfx_stats_destroyed(gfx_stats().shaders);
+	null_record(gfx_null_cmd_t::DESTROY_SHADER, !valid, { handle });
+}
+
+bx::handle_id bx::gfx_create_buffer(const gfx_buffer_desc_t& desc) noexcept
+{
+	bx_profile(bx);
+
+	null_buffer_t buffer{};
+	buffer.name = desc.name;
+	buffer.usage = desc.usage;
+	buffer.data.resize(static_cast<usize>(desc.size));
+	if (buffer.data.size() != desc.size)
+	{
+		bx_error(bx, "Out of memory for '{}' ({} bytes)", desc.name ? desc.name : "", desc.size);
+		null_record(gfx_null_cmd_t::CREATE_BUFFER, true, { invalid_handle }, { desc.size });
+		return invalid_handle;
+	}
+
+	if (desc.data && desc.size > 0)
+		std::memcpy(buffer.data.data(), desc.data, static_cast<usize>(desc.size));
+
+	const handle_id handle = g_buffers.insert(static_cast<null_buffer_t&&>(buffer));
+	gfx_stats_created(gfx_stats().buffers, desc.size);
+	null_record(gfx_null_cmd_t::CREATE_BUFFER, false, { handle }, { desc.size });
+	return handle;
+}
+
+void bx::gfx_destroy_buffer(const handle_id handle) noexcept
+{
+	auto buffer = g_buffers.get(handle);
+	const bool valid = null_check_destroy(buffer != nullptr, handle, "gfx_destroy_buffer");
+	if (g_bound.index_buffer == handle)
+		g_bound.index_buffer = invalid_handle;
+
+	if (buffer)
+	{
+		gfx_stats_destroyed(gfx_stats().buffers, buffer->data.size());
+		g_buffers.remove(handle);
+	}
+	null_record(gfx_null_cmd_t::DESTROY_BUFFER, !valid, { handle });
+}
+
+u8* bx::gfx_map_buffer(const handle_id handle, const u64 offset, const u64 size) noexcept
+{
+	bx_profile(bx);
+
+	auto buffer = g_buffers.get(handle);
+	if (!null_check_range(buffer, offset, size))
+	{
+		if (buffer)
+			bx_warn(bx, "Range {}+{} is outside buffer '{}' of {} bytes", offset, size, buffer->name ? buffer->name : "", buffer->data.size());
+		else
+			bx_warn(bx, "Invalid handle {:#x}", handle);
+		null_record(gfx_null_cmd_t::MAP_BUFFER, true, { handle }, { offset, size });
+		return nullptr;
+	}
+
+	null_record(gfx_null_cmd_t::MAP_BUFFER, false, { handle }, { offset, size });
+	return buffer->data.data() + offset;
+}
+
+void bx::gfx_unmap_buffer(const handle_id handle) noexcept
+{
+	const bool valid = g_buffers.contains(handle);
+	if (!valid)
+		bx_warn(bx, "Invalid handle {:#x}", handle);
+
+	null_record(gfx_null_cmd_t::UNMAP_BUFFER, !valid, { handle });
+}
+
+void bx::gfx_update_buffer(const handle_id handle, const u64 dst_offset, cvptr src, const u64 size) noexcept
+{
+	bx_profile(bx);
+
+	auto buffer = g_buffers.get(handle);
+	if (!buffer || !src || !null_check_range(buffer, dst_offset, size))
+	{
+		if (!buffer)
+			bx_warn(bx, "Invalid handle {:#x}", handle);
+		else if (!src)
+			bx_warn(bx, "No source data for buffer '{}'", buffer->name ? buffer->name : "");
+		else
+			bx_warn(bx, "Range {}+{} is outside buffer '{}' of {} bytes", dst_offset, size, buffer->name ? buffer->name : "", buffer->data.size());
+		null_record(gfx_null_cmd_t::UPDATE_BUFFER, true, { handle }, { dst_offset, size });
+		return;
+	}
+
+	std::memcpy(buffer->data.data() + dst_offset, src, static_cast<usize>(size));
+	null_record(gfx_null_cmd_t::UPDATE_BUFFER, false, { handle }, { dst_offset, size });
+}
+
+bx::gfx_upload_t bx::gfx_upload_alloc(const u64 size, const u64 alignment) noexcept
+{
+	auto buffer = g_buffers.get(g_upload.buffer);
+	const u64 offset = align_up(g_upload.head, alignment);
+	if (!buffer || size == 0 || offset + size > g_upload.slice_size)
+		return gfx_upload_t{};
+
+	g_upload.head = offset + size;
+
+	gfx_upload_t upload{};
+	upload.buffer = g_upload.buffer;
+	upload.offset = g_upload.frame * g_upload.slice_size + offset;
+	upload.data = buffer->data.data() + upload.offset;
+	upload.size = size;
+	return upload;
+}
+
+bx::handle_id bx::gfx_create_texture(const gfx_texture_desc_t& desc) noexcept
+{
+	bx_profile(bx);
+
+	if (desc.width == 0 || desc.height == 0 || desc.depth == 0 || desc.mip_levels == 0
+		|| desc.width > g_info.features.max_texture_size || desc.height > g_info.features.max_texture_size)
+	{
+		bx_warn(bx, "Invalid size {}x{}x{} with {} mips for '{}'",
+			desc.width, desc.height, desc.depth, desc.mip_levels, desc.name ? desc.name : "");
+		null_record(gfx_null_cmd_t::CREATE_TEXTURE, true, { invalid_handle }, { desc.width, desc.height, desc.depth, desc.mip_levels });
+		return invalid_handle;
+	}
+
+	null_texture_t texture{};
+	texture.name = desc.name;
+	texture.format = desc.format;
+	texture.width = desc.width;
+	texture.height = desc.height;
+	texture.depth = desc.depth;
+	texture.mip_levels = desc.mip_levels;
+	texture.bytes = gfx_texture_storage_size(desc, desc.first_mip);
+
+	const handle_id handle = g_textures.insert(texture);
+	gfx_stats_created(gfx_stats().textures, texture.bytes);
+	null_record(gfx_null_cmd_t::CREATE_TEXTURE, false, { handle }, { desc.width, desc.height, desc.depth, desc.mip_levels });
+	return handle;
+}
+
+void bx::gfx_destroy_texture(const handle_id texture) noexcept
+{
+	auto nulltexture = g_textures.get(texture);
+	const bool valid = null_check_destroy(nulltexture != nullptr, texture, "gfx_destroy_texture");
+	if (nulltexture)
+	{
+		gfx_stats_destroyed(gfx_stats().textures, nulltexture->bytes);
+		g_textures.remove(texture);
+	}
+	null_record(gfx_null_cmd_t::DESTROY_TEXTURE, !valid, { texture });
+}
+
+static bool null_check_regions(cstring func, const null_texture_t& texture, const u32 region_count, const bx::gfx_texture_region_t* regions) noexcept
+{
+	if (region_count > 0 && !regions)
+	{
+		bx_warn(bx, "{}: {} regions without region data", func, region_count);
+		return false;
+	}
+
+	for (u32 i = 0; i < region_count; ++i)
+	{
+		const bx::gfx_texture_region_t& region = regions[i];
+		const u32 width = texture.width >> region.mip_level ? texture.width >> region.mip_level : 1;
+		const u32 height = texture.height >> region.mip_level ? texture.height >> region.mip_level : 1;
+		if (region.mip_level >= texture.mip_levels || region.x < 0 || region.y < 0 || region.z < 0
+			|| region.x + region.width > width || region.y + region.height > height)
+		{
+			bx_warn(bx, "{}: region {} is outside mip {} of texture '{}'", func, i, region.mip_level, texture.name ? texture.name : "");
+			return false;
+		}
+	}
+	return true;
+}
+
+void bx::gfx_upload_texture_data(const handle_id texture, const u8* data, const u32 region_count, const gfx_texture_region_t* regions) noexcept
+{
+	auto nulltexture = g_textures.get(texture);
+	bool valid = nulltexture != nullptr && data != nullptr;
+	if (!nulltexture)
+		bx_warn(bx, "Invalid handle {:#x}", texture);
+	else if (!data)
+		bx_warn(bx, "No source data for texture '{}'", nulltexture->name ? nulltexture->name : "");
+	else
+		valid = null_check_regions("gfx_upload_texture_data", *nulltexture, region_count, regions);
+
+	for (u32 i = 0; valid && i < region_count; ++i)
+		gfx_stats().upload_bytes += gfx_texture_size(nulltexture->format, regions[i].width, regions[i].height, regions[i].depth);
+
+	null_record(gfx_null_cmd_t::UPLOAD_TEXTURE, !valid, { texture }, { region_count });
+}
+
+void bx::gfx_copy_buffer_to_texture(handle_id cb, handle_id buffer, handle_id texture, u32 region_count, const gfx_texture_region_t* regions) noexcept
+{
+	if (cb)
+	{
+		gfx_cmd_record_copy_buffer_to_texture(cb, buffer, texture, region_count, regions);
+		return;
+	}
+
+	auto nullbuffer = g_buffers.get(buffer);
+	auto nulltexture = g_textures.get(texture);
+	bool valid = nullbuffer != nullptr && nulltexture != nullptr;
+	if (!nullbuffer)
+		bx_warn(bx, "Invalid buffer handle {:#x}", buffer);
+	else if (!nulltexture)
+		bx_warn(bx, "Invalid texture handle {:#x}", texture);
+	else
+		valid = null_check_regions("gfx_copy_buffer_to_texture", *nulltexture, region_count, regions);
+
+	for (u32 i = 0; valid && i < region_count; ++i)
+	{
+		if (regions[i].offset >= nullbuffer->data.size())
+		{
+			bx_warn(bx, "Region {} starts past the end of buffer '{}'", i, nullbuffer->name ? nullbuffer->name : "");
+			valid = false;
+		}
+	}
+
+	null_record(gfx_null_cmd_t::COPY_BUFFER_TO_TEXTURE, !valid, { buffer, texture }, { region_count });
+}
+
+bool bx::gfx_set_texture_resident_mips(handle_id texture, u32 first_mip) noexcept
+{
+	(void)first_mip;
+	return g_textures.get(texture) != nullptr;
+}
+
+void bx::gfx_set_texture_min_mip(handle_id texture, u32 mip) noexcept
+{
+	(void)texture; (void)mip;
+}
+
+bx::handle_id bx::gfx_create_framebuffer(const gfx_framebuffer_desc_t& desc) noexcept
+{
+	bx_profile(bx);
+
+	bool valid = desc.depth_texture == invalid_handle || g_textures.contains(desc.depth_texture);
+	for (const handle_id color : desc.color_textures)
+		valid = valid && g_textures.contains(color);
+
+	if (!valid)
+	{
+		bx_warn(bx, "Invalid attachment for '{}'", desc.name ? desc.name : "");
+		null_record(gfx_null_cmd_t::CREATE_FRAMEBUFFER, true, { invalid_handle });
+		return invalid_handle;
+	}
+
+	const handle_id handle = g_framebuffers.insert(null_resource_t{ desc.name });
+	gfx_stats_created(gfx_stats().framebuffers);
+	null_record(gfx_null_cmd_t::CREATE_FRAMEBUFFER, false, { handle });
+	return handle;
+}
+
+void bx::gfx_destroy_framebuffer(const handle_id fb) noexcept
+{
+	const bool valid = null_check_destroy(g_framebuffers.contains(fb), fb, "gfx_destroy_framebuffer");
+	if (g_framebuffers.remove(fb))
+		gfx_stats_destroyed(gfx_stats().framebuffers);
+	null_record(gfx_null_cmd_t::DESTROY_FRAMEBUFFER, !valid, { fb });
+}
+
+bx::handle_id bx::gfx_default_framebuffer() noexcept
+{
+	return handle_id{ 0 };
+}
+
+bx::handle_id bx::gfx_create_pipeline(const gfx_pipeline_desc_t& desc) noexcept
+{
+	bx_profile(bx);
+
+	bool valid = !desc.shaders.empty();
+	for (const handle_id shader : desc.shaders)
+		valid = valid && g_shaders.contains(shader);
+
+	if (!valid)
+	{
+		bx_warn(bx, "Missing or invalid shaders for '{}'", desc.name ? desc.name : "");
+		null_record(gfx_null_cmd_t::CREATE_PIPELINE, true, { invalid_handle });
+		return invalid_handle;
+	}
+
+	for (const auto& attribute : desc.input_layout.attributes)
+	{
+		if (gfx_attribute_size(attribute.format, attribute.count) == 0)
+		{
+			bx_warn(bx, "Vertex attribute {} of '{}' can't have {} components of its format",
+				attribute.location, desc.name ? desc.name : "", attribute.count);
+			null_record(gfx_null_cmd_t::CREATE_PIPELINE, true, { invalid_handle });
+			return invalid_handle;
+		}
+	}
+
+	const handle_id shared = gfx_pipeline_cache_find(desc);
+	if (shared != invalid_handle)
+	{
+		null_record(gfx_null_cmd_t::CREATE_PIPELINE, false, { shared });
+		return shared;
+	}
+
+	null_pipeline_t pipeline{};
+	pipeline.name = desc.name;
+	pipeline.topology = desc.topology;
+	for (const auto& binding : desc.resource_layout.bindings)
+		pipeline.layout.push_back(binding);
+
+	const handle_id handle = g_pipelines.insert(static_cast<null_pipeline_t&&>(pipeline));
+	gfx_stats_created(gfx_stats().pipelines);
+	gfx_pipeline_cache_add(desc, handle);
+	null_record(gfx_null_cmd_t::CREATE_PIPELINE, false, { handle });
+	return handle;
+}
+
+void bx::gfx_destroy_pipeline(const handle_id handle) noexcept
+{
+	if (g_pipelines.contains(handle) && !gfx_pipeline_cache_release_pipeline(handle))
+	{
+		null_record(gfx_null_cmd_t::DESTROY_PIPELINE, false, { handle });
+		return;
+	}
+
+	const bool valid = null_check_destroy(g_pipelines.contains(handle), handle, "gfx_destroy_pipeline");
+	if (g_bound.pipeline == handle)
+		g_bound.pipeline = invalid_handle;
+
+	if (g_pipelines.remove(handle))
+		gfx_stats_destroyed(gfx_stats().pipelines);
+	null_record(gfx_null_cmd_t::DESTROY_PIPELINE, !valid, { handle });
+}
+
+static bool null_check_binding(const bx::gfx_resource_binding_t& binding) noexcept
+{
+	using namespace bx;
+
+	switch (binding.type)
+	{
+	case gfx_resource_type_t::TEXTURE:
+	case gfx_resource_type_t::COMBINED_IMAGE_SAMPLER:
+	case gfx_resource_type_t::STORAGE_IMAGE:
+		return g_textures.contains(binding.resource);
+	case gfx_resource_type_t::SAMPLER:
+		return false;	// no separate samplers, textures carry their own
+	default:
+		break;
+	}
+
+	auto buffer = g_buffers.get(binding.resource);
+	if (!buffer || (binding.type == gfx_resource_type_t::UNIFORM_BUFFER && buffer->usage != gfx_buffer_usage_t::UNIFORM))
+		return false;
+
+	const u64 rest = binding.offset < buffer->data.size() ? buffer->data.size() - binding.offset : 0;
+	const u64 size = binding.size ? binding.size : rest;
+	return size > 0 && null_check_range(buffer, binding.offset, size);
+}
+
+bx::handle_id bx::gfx_create_resource_set(const gfx_resource_set_desc_t& desc) noexcept
+{
+	bx_profile(bx);
+
+	null_resource_set_t set{};
+	set.name = desc.name;
+	for (const auto& binding : desc.bindings)
+	{
+		bool valid = null_check_binding(binding);
+		for (const auto& other : set.bindings)
+			valid = valid && !(other.type == binding.type && other.binding == binding.binding);
+
+		if (!valid)
+		{
+			bx_warn(bx, "Binding {} of '{}' is a duplicate or names an invalid resource {:#x}",
+				binding.binding, desc.name ? desc.name : "", binding.resource);
+			null_record(gfx_null_cmd_t::CREATE_RESOURCE_SET, true, { invalid_handle }, { desc.bindings.size() });
+			return invalid_handle;
+		}
+		set.bindings.push_back(binding);
+	}
+
+	const handle_id handle = g_resource_sets.insert(static_cast<null_resource_set_t&&>(set));
+	gfx_stats_created(gfx_stats().resource_sets);
+	null_record(gfx_null_cmd_t::CREATE_RESOURCE_SET, false, { handle }, { desc.bindings.size() });
+	return handle;
+}
+
+void bx::gfx_destroy_resource_set(const handle_id set_handle) noexcept
+{
+	const bool valid = null_check_destroy(g_resource_sets.contains(set_handle), set_handle, "gfx_destroy_resource_set");
+	if (g_resource_sets.remove(set_handle))
+		gfx_stats_destroyed(gfx_stats().resource_sets);
+	null_record(gfx_null_cmd_t::DESTROY_RESOURCE_SET, !valid, { set_handle });
+}
+
+void bx::gfx_clear_rt(handle_id rt, f32 cv[4]) noexcept
+{
+	(void)cv;
+	null_record(gfx_null_cmd_t::CLEAR_RT, false, { rt });
+}
+
+void bx::gfx_clear_ds(handle_id ds)
+{
+	null_record(gfx_null_cmd_t::CLEAR_DS, false, { ds });
+}
+
+void bx::gfx_bind_pipeline(handle_id cb, handle_id pipeline) noexcept
+{
+	if (cb)
+	{
+		gfx_cmd_record(cb, gfx_cmd_type_t::BIND_PIPELINE, gfx_cmd_bind_pipeline_t{ pipeline });
+		return;
+	}
+
+	const bool valid = g_pipelines.contains(pipeline);
+	if (valid && g_bound.pipeline == pipeline)
+		++gfx_stats().redundant_binds;
+	if (valid)
+		g_bound.pipeline = pipeline;
+	else
+		bx_warn(bx, "Invalid handle {:#x}", pipeline);
+
+	null_record(gfx_null_cmd_t::BIND_PIPELINE, !valid, { pipeline });
+}
+
+void bx::gfx_bind_vertex_buffers(handle_id cb, u32 first_binding, u32 binding_count, const handle_id* vertex_buffers, const u64* offsets) noexcept
+{
+	if (cb)
+	{
+		gfx_cmd_record_vertex_buffers(cb, first_binding, binding_count, vertex_buffers, offsets);
+		return;
+	}
+
+	if (binding_count > 0 && !vertex_buffers)
+	{
+		bx_warn(bx, "{} bindings without buffers", binding_count);
+		null_record(gfx_null_cmd_t::BIND_VERTEX_BUFFER, true, {}, { first_binding });
+		return;
+	}
+
+	for (u32 i = 0; i < binding_count; ++i)
+	{
+		const u64 offset = offsets ? offsets[i] : 0;
+		auto buffer = g_buffers.get(vertex_buffers[i]);
+		const bool valid = null_check_range(buffer, offset, 0);
+		if (!valid)
+			bx_warn(bx, "Binding {} has an invalid buffer {:#x} or offset {}", first_binding + i, vertex_buffers[i], offset);
+
+		null_record(gfx_null_cmd_t::BIND_VERTEX_BUFFER, !valid, { vertex_buffers[i] }, { first_binding + i, offset });
+	}
+}
+
+void bx::gfx_bind_index_buffer(handle_id cb, handle_id index_buffer, gfx_index_type_t index_type) noexcept
+{
+	if (cb)
+	{
+		gfx_cmd_record(cb, gfx_cmd_type_t::BIND_INDEX_BUFFER, gfx_cmd_bind_index_buffer_t{ index_buffer, index_type });
+		return;
+	}
+
+	const bool valid = g_buffers.contains(index_buffer);
+	if (valid && g_bound.index_buffer == index_buffer)
+		++gfx_stats().redundant_binds;
+	if (valid)
+		g_bound.index_buffer = index_buffer;
+	else
+		bx_warn(bx, "Invalid handle {:#x}", index_buffer);
+
+	null_record(gfx_null_cmd_t::BIND_INDEX_BUFFER, !valid, { index_buffer }, { static_cast<u64>(index_type) });
+}
+
+void bx::gfx_bind_resource_set(handle_id cb, handle_id pipeline, handle_id set, u32 set_index) noexcept
+{
+	if (cb)
+	{
+		gfx_cmd_record(cb, gfx_cmd_type_t::BIND_RESOURCE_SET, gfx_cmd_bind_resource_set_t{ pipeline, set, set_index });
+		return;
+	}
+
+	auto nullpipeline = g_pipelines.get(pipeline);
+	auto nullset = g_resource_sets.get(set);
+	bool valid = nullpipeline && nullset;
+	if (!valid)
+		bx_warn(bx, "Invalid pipeline {:#x} or set {:#x}", pipeline, set);
+
+	// Resources may have been destroyed since, the layout is only checked when given
+	for (u32 i = 0; valid && i < nullset->bindings.size(); ++i)
+	{
+		const auto& binding = nullset->bindings[i];
+		bool declared = nullpipeline->layout.empty();
+		for (const auto& entry : nullpipeline->layout)
+			declared = declared || (entry.set == set_index && entry.binding == binding.binding && entry.type == binding.type);
+
+		valid = declared && null_check_binding(binding);
+		if (!valid)
+			bx_warn(bx, "Binding {} of set '{}' is not in the layout of '{}' or its resource is gone",
+				binding.binding, nullset->name ? nullset->name : "", nullpipeline->name ? nullpipeline->name : "");
+	}
+
+	null_record(gfx_null_cmd_t::BIND_RESOURCE_SET, !valid, { pipeline, set }, { set_index });
+}
+
+void bx::gfx_draw(handle_id cb, u32 vertex_count, u32 instance_count, u32 first_vertex, u32 first_instance) noexcept
+{
+	if (cb)
+	{
+		gfx_cmd_record(cb, gfx_cmd_type_t::DRAW, gfx_cmd_draw_t{ vertex_count, instance_count, first_vertex, first_instance });
+		return;
+	}
+
+	const bool valid = null_check_draw("gfx_draw", false);
+	null_record(gfx_null_cmd_t::DRAW, !valid, {}, { vertex_count, instance_count, first_vertex, first_instance });
+}
+
+void bx::gfx_draw_indexed(handle_id cb, u32 index_count, u32 instance_count, u32 first_index, i32 vertex_offset, u32 first_instance) noexcept
+{
+	if (cb)
+	{
+		gfx_cmd_record(cb, gfx_cmd_type_t::DRAW_INDEXED, gfx_cmd_draw_indexed_t{ index_count, instance_count, first_index, vertex_offset, first_instance });
+		return;
+	}
+
+	const bool valid = null_check_draw("gfx_draw_indexed", true);
+	null_record(gfx_null_cmd_t::DRAW_INDEXED, !valid, {},
+		{ index_count, instance_count, first_index, static_cast<u64>(static_cast<i64>(vertex_offset)), first_instance });
+}
+
+void bx::gfx_draw_indirect(handle_id cb, handle_id buffer, u64 offset, u32 draw_count, u32 stride) noexcept
+{
+	if (cb)
+	{
+		gfx_cmd_record(cb, gfx_cmd_type_t::DRAW_INDIRECT, gfx_cmd_draw_indirect_t{ buffer, offset, draw_count, stride });
+		return;
+	}
+
+	const bool valid = null_check_draw("gfx_draw_indirect", false)
+		&& null_check_indirect("gfx_draw_indirect", buffer, offset, draw_count, stride, sizeof(gfx_draw_indirect_command_t));
+	null_record(gfx_null_cmd_t::DRAW_INDIRECT, !valid, { buffer }, { offset, draw_count, stride });
+}
+
+void bx::gfx_draw_indexed_indirect(handle_id cb, handle_id buffer, u64 offset, u32 draw_count, u32 stride) noexcept
+{
+	if (cb)
+	{
+		gfx_cmd_record(cb, gfx_cmd_type_t::DRAW_INDEXED_INDIRECT, gfx_cmd_draw_indirect_t{ buffer, offset, draw_count, stride });
+		return;
+	}
+
+	const bool valid = null_check_draw("gfx_draw_indexed_indirect", true)
+		&& null_check_indirect("gfx_draw_indexed_indirect", buffer, offset, draw_count, stride, sizeof(gfx_draw_indexed_indirect_command_t));
+	null_record(gfx_null_cmd_t::DRAW_INDEXED_INDIRECT, !valid, { buffer }, { offset, draw_count, stride });
+}
+
+void bx::gfx_draw_indexed_indirect_count(handle_id cb, handle_id buffer, u64 offset, handle_id count_buffer, u64 count_offset, u32 max_draw_count, u32 stride) noexcept
+{
+	if (cb)
+	{
+		gfx_cmd_record(cb, gfx_cmd_type_t::DRAW_INDEXED_INDIRECT_COUNT,
+			gfx_cmd_draw_indexed_indirect_count_t{ buffer, offset, count_buffer, count_offset, max_draw_count, stride });
+		return;
+	}
+
+	bool valid = null_check_draw("gfx_draw_indexed_indirect_count", true)
+		&& null_check_indirect("gfx_draw_indexed_indirect_count", buffer, offset, max_draw_count, stride, sizeof(gfx_draw_indexed_indirect_command_t));
+	if (valid && !null_check_range(g_buffers.get(count_buffer), count_offset, sizeof(u32)))
+	{
+		bx_warn(bx, "Invalid count buffer {:#x} or offset {}", count_buffer, count_offset);
+		valid = false;
+	}
+
+	null_record(gfx_null_cmd_t::DRAW_INDEXED_INDIRECT_COUNT, !valid, { buffer, count_buffer }, { offset, count_offset, max_draw_count, stride });
+}
+
+void bx::gfx_copy_buffer(handle_id cb, handle_id src, handle_id dst, u64 src_offset, u64 dst_offset, u64 size) noexcept
+{
+	if (cb)
+	{
+		gfx_cmd_record(cb, gfx_cmd_type_t::COPY_BUFFER, gfx_cmd_copy_buffer_t{ src, dst, src_offset, dst_offset, size });
+		return;
+	}
+
+	bx_profile(bx);
+
+	auto src_buffer = g_buffers.get(src);
+	auto dst_buffer = g_buffers.get(dst);
+	if (!null_check_range(src_buffer, src_offset, size) || !null_check_range(dst_buffer, dst_offset, size))
+	{
+		bx_warn(bx, "Invalid buffers {:#x} -> {:#x} or range {}+{} -> {}+{}", src, dst, src_offset, size, dst_offset, size);
+		null_record(gfx_null_cmd_t::COPY_BUFFER, true, { src, dst }, { src_offset, dst_offset, size });
+		return;
+	}
+
+	std::memmove(dst_buffer->data.data() + dst_offset, src_buffer->data.data() + src_offset, static_cast<usize>(size));
+	null_record(gfx_null_cmd_t::COPY_BUFFER, false, { src, dst }, { src_offset, dst_offset, size });
+}
+
+void bx::gfx_dispatch(handle_id cb, u32 x, u32 y, u32 z) noexcept
+{
+	if (cb)
+	{
+		gfx_cmd_record(cb, gfx_cmd_type_t::DISPATCH, gfx_cmd_dispatch_t{ x, y, z });
+		return;
+	}
+
+	const bool valid = g_pipelines.contains(g_bound.pipeline);
+	if (!valid)
+		bx_warn(bx, "No pipeline bound");
+
+	null_record(gfx_null_cmd_t::DISPATCH, !valid, {}, { x, y, z });
+}
+
+void bx::gfx_submit(handle_id cb) noexcept
+{
+	bx_profile(bx);
+
+	null_record(gfx_null_cmd_t::SUBMIT, false, { cb });
+
+	if (cb)
+		gfx_cmd_execute(cb);
+}
+
+void bx::gfx_wait_idle() noexcept
+{
+}
+
+void bx::gfx_pipeline_barrier(handle_id cb, const gfx_memory_barrier_t& barrier) noexcept
+{
+	if (cb)
+	{
+		gfx_cmd_record(cb, gfx_cmd_type_t::PIPELINE_BARRIER, gfx_cmd_pipeline_barrier_t{ barrier });
+		return;
+	}
+
+	null_record(gfx_null_cmd_t::PIPELINE_BARRIER, false, {}, {
+		static_cast<u64>(barrier.src_access), static_cast<u64>(barrier.dst_access),
+		static_cast<u64>(barrier.src_stage), static_cast<u64>(barrier.dst_stage) });
+}
+
+// Same results as the GPU stage, in instance order, so code built on it can be
+// checked without a device
+void bx::gfx_cull_instances(handle_id cb, const gfx_cull_desc_t& desc) noexcept
+{
+	if (cb)
+	{
+		gfx_cmd_record(cb, gfx_cmd_type_t::CULL_INSTANCES, gfx_cmd_cull_instances_t{ desc });
+		return;
+	}
+
+	bx_profile(bx);
+
+	auto instances = g_buffers.get(desc.instances);
+	auto commands = g_buffers.get(desc.commands);
+	auto count = g_buffers.get(desc.count);
+	auto visible = desc.visible ? g_buffers.get(desc.visible) : nullptr;
+	if (!null_check_range(instances, 0, desc.instance_count * sizeof(gfx_cull_instance_t))
+		|| !null_check_range(commands, 0, desc.instance_count * sizeof(gfx_draw_indexed_indirect_command_t))
+		|| !null_check_range(count, 0, sizeof(u32))
+		|| (desc.visible && !null_check_range(visible, 0, desc.instance_count * sizeof(u32))))
+	{
+		bx_warn(bx, "Invalid buffers or too small for {} instances", desc.instance_count);
+		null_record(gfx_null_cmd_t::CULL_INSTANCES, true, { desc.instances, desc.commands, desc.count }, { desc.instance_count });
+		return;
+	}
+
+	u32 draw_count = 0;
+	for (u32 i = 0; i < desc.instance_count; ++i)
+	{
+		gfx_cull_instance_t instance;
+		std::memcpy(&instance, instances->data.data() + i * sizeof(gfx_cull_instance_t), sizeof(instance));
+
+		bool inside = true;
+		for (u32 p = 0; p < 6 && inside; ++p)
+		{
+			const f32* plane = desc.planes[p];
+			const f32 distance = plane[0] * instance.center[0] + plane[1] * instance.center[1] + plane[2] * instance.center[2] + plane[3];
+			inside = distance >= -instance.radius;
+		}
+
+		if (!inside)
+			continue;
+
+		const gfx_draw_indexed_indirect_command_t command{ instance.index_count, 1, instance.first_index, instance.vertex_offset, i };
+		std::memcpy(commands->data.data() + draw_count * sizeof(command), &command, sizeof(command));
+		if (visible)
+			std::memcpy(visible->data.data() + draw_count * sizeof(u32), &i, sizeof(u32));
+		++draw_count;
+	}
+
+	std::memcpy(count->data.data(), &draw_count, sizeof(draw_count));
+	null_record(gfx_null_cmd_t::CULL_INSTANCES, false, { desc.instances, desc.commands, desc.count }, { desc.instance_count });
+}
+
+void bx::gfx_null_set_logging(bool enabled) noexcept
+{
+	g_recorder.logging = enabled;
+}
+
+bx::array_view<bx::gfx_null_command_t> bx::gfx_null_get_log() noexcept
+{
+	return array_view<gfx_null_command_t>{ g_recorder.log };
+}
+
+void bx::gfx_null_clear_log() noexcept
+{
+	g_recorder.log.clear();
+}
+
+bx::gfx_null_stats_t bx::gfx_null_get_frame_stats() noexcept
+{
+	return g_recorder.last;
+}
+
+bx::gfx_null_stats_t bx::gfx_null_get_current_stats() noexcept
+{
+	return g_recorder.current;
+}
+
+bool bx::gfx_null_dump_log(cstring filepath) noexcept
+{
+	bx_profile(bx);
+
+	const auto path = filepath[0] == '[' ? file_get_path(filepath) : string_fixed<512>(filepath);
+	std::ofstream file(path.c_str(), std::ios::trunc);
+	if (!file.is_open())
+	{
+		bx_warn(bx, "Failed to open {}", path.c_str());
+		return false;
+	}
+
+	// frame command handles... args...
+	char line[256];
+	for (const auto& command : g_recorder.log)
+	{
+		std::snprintf(line, sizeof(line), "%u %s %llx %llx %llx %llu %llu %llu %llu %llu%s\n",
+			command.frame, null_cmd_name(command.type),
+			static_cast<unsigned long long>(command.handles[0]),
+			static_cast<unsigned long long>(command.handles[1]),
+			static_cast<unsigned long long>(command.handles[2]),
+			static_cast<unsigned long long>(command.args[0]),
+			static_cast<unsigned long long>(command.args[1]),
+			static_cast<unsigned long long>(command.args[2]),
+			static_cast<unsigned long long>(command.args[3]),
+			static_cast<unsigned long long>(command.args[4]),
+			command.error ? " error" : "");
+		file << line;
+	}
+
+	return static_cast<bool>(file);
+}
+
+void bx::gfx_null_replay(array_view<gfx_null_command_t> commands, handle_id cb) noexcept
+{
+	bx_profile(bx);
+
+	// Replaying the live log would append to it while it is read
+	array<gfx_null_command_t> copy{};
+	if (g_recorder.logging && !commands.empty() && commands.data() == g_recorder.log.data())
+	{
+		copy.resize(commands.size());
+		std::memcpy(copy.data(), commands.data(), commands.size() * sizeof(gfx_null_command_t));
+		commands = array_view<gfx_null_command_t>{ copy };
+	}
+
+	for (const auto& command : commands)
+	{
+		const handle_id* h = command.handles;
+		const u64* a = command.args;
+		switch (command.type)
+		{
+		case gfx_null_cmd_t::BIND_PIPELINE:
+			gfx_bind_pipeline(cb, h[0]);
+			break;
+		case gfx_null_cmd_t::BIND_VERTEX_BUFFER:
+			gfx_bind_vertex_buffers(cb, static_cast<u32>(a[0]), 1, &h[0], &a[1]);
+			break;
+		case gfx_null_cmd_t::BIND_INDEX_BUFFER:
+			gfx_bind_index_buffer(cb, h[0], static_cast<gfx_index_type_t>(a[0]));
+			break;
+		case gfx_null_cmd_t::BIND_RESOURCE_SET:
+			gfx_bind_resource_set(cb, h[0], h[1], static_cast<u32>(a[0]));
+			break;
+		case gfx_null_cmd_t::DRAW:
+			gfx_draw(cb, static_cast<u32>(a[0]), static_cast<u32>(a[1]), static_cast<u32>(a[2]), static_cast<u32>(a[3]));
+			break;
+		case gfx_null_cmd_t::DRAW_INDEXED:
+			gfx_draw_indexed(cb, static_cast<u32>(a[0]), static_cast<u32>(a[1]), static_cast<u32>(a[2]), static_cast<i32>(static_cast<i64>(a[3])), static_cast<u32>(a[4]));
+			break;
+		case gfx_null_cmd_t::DRAW_INDIRECT:
+			gfx_draw_indirect(cb, h[0], a[0], static_cast<u32>(a[1]), static_cast<u32>(a[2]));
+			break;
+		case gfx_null_cmd_t::DRAW_INDEXED_INDIRECT:
+			gfx_draw_indexed_indirect(cb, h[0], a[0], static_cast<u32>(a[1]), static_cast<u32>(a[2]));
+			break;
+		case gfx_null_cmd_t::DRAW_INDEXED_INDIRECT_COUNT:
+			gfx_draw_indexed_indirect_count(cb, h[0], a[0], h[1], a[1], static_cast<u32>(a[2]), static_cast<u32>(a[3]));
+			break;
+		case gfx_null_cmd_t::COPY_BUFFER:
+			gfx_copy_buffer(cb, h[0], h[1], a[0], a[1], a[2]);
+			break;
+		case gfx_null_cmd_t::DISPATCH:
+			gfx_dispatch(cb, static_cast<u32>(a[0]), static_cast<u32>(a[1]), static_cast<u32>(a[2]));
+			break;
+		case gfx_null_cmd_t::PIPELINE_BARRIER:
+		{
+			gfx_memory_barrier_t barrier{};
+			barrier.src_access = static_cast<gfx_shader_access_t>(a[0]);
+			barrier.dst_access = static_cast<gfx_shader_access_t>(a[1]);
+			barrier.src_stage = static_cast<gfx_shader_stage_t>(a[2]);
+			barrier.dst_stage = static_cast<gfx_shader_stage_t>(a[3]);
+			gfx_pipeline_barrier(cb, barrier);
+			break;
+		}
+		default:
+			break;
+		}
+	}
+}
@@ -0,0 +1,554 @@
+#include <bx_app_impl.hpp>
+
+#include <bx/hash.hpp>
+
+#include <cstring>
+#include <fstream>
+
+// Shaders and pipelines keyed by their desc, names left out. A key is the desc
+// written out field by field, its hash finds the entry and the bytes confirm
+// it, a collision simply creates another object. Pipeline keys refer to their
+// shaders by handle, deduplicated shaders keep those stable. The keys are also
+// what gfx_save_pipeline_list writes, with shader handles turned into indices.
+
+#define BX_PIPELINE_LIST_MAGIC 0x4c505842u // "BXPL"
+#define BX_PIPELINE_LIST_VERSION 1u
+
+struct pipeline_cache_entry_t
+{
+	u64 hash{ 0 };
+	bx::array<u8> key{};
+	bx::string name{};
+	u32 refs{ 0 };
+};
+
+struct pipeline_cache_table_t
+{
+	bx::hash_map<u64, bx::handle_id> by_hash{};
+	bx::hash_map<bx::handle_id, pipeline_cache_entry_t> entries{};
+};
+
+struct pipeline_cache_t
+{
+	pipeline_cache_table_t shaders{};
+	pipeline_cache_table_t pipelines{};
+
+	// Warmed up objects keep a reference, their descs point into the files
+	bx::array<bx::handle_id> warm_shaders{};
+	bx::array<bx::handle_id> warm_pipelines{};
+	bx::array<bx::array<u8>> files{};
+};
+
+static pipeline_cache_t g_pipeline_cache{};
+
+static void key_write(bx::array<u8>& key, cvptr data, usize size) noexcept
+{
+	const usize at = key.size();
+	key.resize(at + size);
+	if (size > 0)
+		std::memcpy(key.data() + at, data, size);
+}
+
+template <typename T>
+static void key_write(bx::array<u8>& key, const T& value) noexcept
+{
+	key_write(key, &value, sizeof(T));
+}
+
+// Present flag, then the characters with their terminator so a read can point into the key
+static void key_write_string(bx::array<u8>& key, cstring str) noexcept
+{
+	key_write(key, static_cast<u8>(str != nullptr));
+	if (str)
+		key_write(key, str, std::strlen(str) + 1);
+}
+
+struct key_reader_t
+{
+	key_reader_t() noexcept = default;
+	key_reader_t(const u8* first, const u8* last) noexcept : it(first), end(last) {}
+
+	const u8* it{ nullptr };
+	const u8* end{ nullptr };
+	bool ok{ true };
+
+	bool read(vptr data, usize size) noexcept
+	{
+		if (!ok || static_cast<usize>(end - it) < size)
+			return ok = false;
+		if (size > 0)
+			std::memcpy(data, it, size);
+		it += size;
+		return true;
+	}
+
+	template <typename T>
+	T read() noexcept
+	{
+		T value{};
+		read(&value, sizeof(T));
+		return value;
+	}
+
+	cstring read_string() noexcept
+	{
+		if (read<u8>() == 0 || !ok)
+			return nullptr;
+		const vptr nul = std::memchr(const_cast<u8*>(it), 0, static_cast<usize>(end - it));
+		if (!nul)
+		{
+			ok = false;
+			return nullptr;
+		}
+		cstring str = reinterpret_cast<cstring>(it);
+		it = static_cast<const u8*>(nul) + 1;
+		return str;
+	}
+};
+
+static void shader_key(const bx::gfx_shader_desc_t& desc, bx::array<u8>& key) noexcept
+{
+	key_write(key, desc.stage);
+	key_write(key, desc.lang);
+	key_write_string(key, desc.entrypoint);
+	key_write_string(key, desc.filepath);
+	key_write_string(key, desc.source);
+
+	key_write(key, static_cast<u32>(desc.macros.size()));
+	for (const auto& macro : desc.macros)
+	{
+		key_write_string(key, macro.name);
+		key_write_string(key, macro.value);
+	}
+
+	key_write(key, static_cast<u64>(desc.src_bin.size()));
+	key_write(key, desc.src_bin.data(), desc.src_bin.size());
+}
+
+// Shader handles come first, the saved list swaps them for indices
+static void pipeline_key(const bx::gfx_pipeline_desc_t& desc, bx::array<u8>& key) noexcept
+{
+	key_write(key, static_cast<u32>(desc.shaders.size()));
+	for (const bx::handle_id shader : desc.shaders)
+		key_write(key, static_cast<u64>(shader));
+
+	key_write(key, desc.topology);
+
+	key_write(key, static_cast<u32>(desc.input_layout.attributes.size()));
+	for (const auto& attribute : desc.input_layout.attributes)
+	{
+		key_write(key, attribute.location);
+		key_write(key, attribute.binding);
+		key_write(key, attribute.count);
+		key_write(key, attribute.format);
+		key_write(key, static_cast<u8>(attribute.normalized));
+		key_write(key, attribute.offset);
+		key_write(key, attribute.input_rate_per_vertex_or_instance);
+	}
+
+	key_write(key, static_cast<u32>(desc.resource_layout.bindings.size()));
+	for (const auto& binding : desc.resource_layout.bindings)
+	{
+		key_write(key, binding.set);
+		key_write(key, binding.binding);
+		key_write(key, binding.type);
+	}
+
+	key_write(key, static_cast<u8>(desc.raster.cull_enable));
+	key_write(key, static_cast<u8>(desc.raster.depth_test));
+	key_write(key, static_cast<u8>(desc.raster.depth_write));
+
+	key_write(key, static_cast<u32>(desc.color_attachments.size()));
+	for (const auto& attachment : desc.color_attachments)
+		key_write(key, static_cast<u8>(attachment.blend_enable));
+}
+
+static u64 key_hash(const bx::array<u8>& key) noexcept
+{
+	return bx::hash_bytes(key.data(), key.size());
+}
+
+static bx::handle_id cache_find(pipeline_cache_table_t& table, const bx::array<u8>& key) noexcept
+{
+	const u64 hash = key_hash(key);
+	const bx::handle_id* handle = table.by_hash.get(hash);
+	if (!handle)
+		return bx::invalid_handle;
+
+	pipeline_cache_entry_t* entry = table.entries.get(*handle);
+	if (!entry || entry->key.size() != key.size()
+		|| std::memcmp(entry->key.data(), key.data(), key.size()) != 0)
+		return bx::invalid_handle;
+
+	++entry->refs;
+	return *handle;
+}
+
+static void cache_add(pipeline_cache_table_t& table, bx::array<u8>& key, cstring name, bx::handle_id handle) noexcept
+{
+	if (handle == bx::invalid_handle)
+		return;
+
+	pipeline_cache_entry_t entry{};
+	entry.hash = key_hash(key);
+	entry.key = static_cast<bx::array<u8>&&>(key);
+	entry.name = bx::string(name ? name : "");
+	entry.refs = 1;
+
+	// An older entry under the same hash stays reachable by handle only
+	if (!table.by_hash.contains(entry.hash))
+		table.by_hash.insert(entry.hash, handle);
+	table.entries.insert(handle, static_cast<pipeline_cache_entry_t&&>(entry));
+}
+
+static bool cache_release(pipeline_cache_table_t& table, bx::handle_id handle) noexcept
+{
+	pipeline_cache_entry_t* entry = table.entries.get(handle);
+	if (!entry)
+		return true;
+
+	if (--entry->refs > 0)
+		return false;
+
+	const bx::handle_id* owner = table.by_hash.get(entry->hash);
+	if (owner && *owner == handle)
+		table.by_hash.erase(entry->hash);
+	table.entries.erase(handle);
+	return true;
+}
+
+static void cache_clear() noexcept
+{
+	g_pipeline_cache.shaders.by_hash.clear();
+	g_pipeline_cache.shaders.entries.clear();
+	g_pipeline_cache.pipelines.by_hash.clear();
+	g_pipeline_cache.pipelines.entries.clear();
+	g_pipeline_cache.warm_shaders = bx::array<bx::handle_id>{};
+	g_pipeline_cache.warm_pipelines = bx::array<bx::handle_id>{};
+	g_pipeline_cache.files = bx::array<bx::array<u8>>{};
+}
+
+void bx::gfx_pipeline_cache_init() noexcept
+{
+	cache_clear();
+}
+
+void bx::gfx_pipeline_cache_shutdown() noexcept
+{
+	// Drop the warm up references like any other owner, pipelines before their shaders
+	array<handle_id> pipelines = static_cast<array<handle_id>&&>(g_pipeline_cache.warm_pipelines);
+	array<handle_id> shaders = static_cast<array<handle_id>&&>(g_pipeline_cache.warm_shaders);
+	for (const handle_id pipeline : pipelines)
+		gfx_destroy_pipeline(pipeline);
+	for (const handle_id shader : shaders)
+		gfx_destroy_shader(shader);
+
+	cache_clear();
+}
+
+bx::handle_id bx::gfx_pipeline_cache_find(const gfx_shader_desc_t& desc) noexcept
+{
+	array<u8> key{};
+	shader_key(desc, key);
+	return cache_find(g_pipeline_cache.shaders, key);
+}
+
+bx::handle_id bx::gfx_pipeline_cache_find(const gfx_pipeline_desc_t& desc) noexcept
+{
+	array<u8> key{};
+	pipeline_key(desc, key);
+	return cache_find(g_pipeline_cache.pipelines, key);
+}
+
+void bx::gfx_pipeline_cache_add(const gfx_shader_desc_t& desc, handle_id shader) noexcept
+{
+	array<u8> key{};
+	shader_key(desc, key);
+	cache_add(g_pipeline_cache.shaders, key, desc.name, shader);
+}
+
+void bx::gfx_pipeline_cache_add(const gfx_pipeline_desc_t& desc, handle_id pipeline) noexcept
+{
+	array<u8> key{};
+	pipeline_key(desc, key);
+	cache_add(g_pipeline_cache.pipelines, key, desc.name, pipeline);
+}
+
+bool bx::gfx_pipeline_cache_release_shader(handle_id shader) noexcept
+{
+	return cache_release(g_pipeline_cache.shaders, shader);
+}
+
+bool bx::gfx_pipeline_cache_release_pipeline(handle_id pipeline) noexcept
+{
+	return cache_release(g_pipeline_cache.pipelines, pipeline);
+}
+
+// List layout: magic, version, shader count, then per shader its name and key,
+// pipeline count, then per pipeline its name and key with shader indices.
+// Every name and key is a u32 size followed by the bytes, names keep their
+// terminator so warmed up objects can point into the file.
+
+static void list_write_bytes(bx::array<u8>& out, const u8* data, usize size) noexcept
+{
+	key_write(out, static_cast<u32>(size));
+	key_write(out, data, size);
+}
+
+bool bx::gfx_save_pipeline_list(cstring filepath) noexcept
+{
+	bx_profile(bx);
+
+	if (!filepath)
+		return false;
+
+	array<u8> out{};
+	key_write(out, static_cast<u32>(BX_PIPELINE_LIST_MAGIC));
+	key_write(out, static_cast<u32>(BX_PIPELINE_LIST_VERSION));
+
+	// Only shaders some pipeline uses, in the order their indices refer to
+	hash_map<handle_id, u32> indices{};
+	array<handle_id> shaders{};
+	array<u8> pipelines{};
+	u32 pipeline_count = 0;
+
+	for (const auto& it : g_pipeline_cache.pipelines.entries)
+	{
+		key_reader_t reader{ it.second.key.data(), it.second.key.data() + it.second.key.size() };
+		const u32 shader_count = reader.read<u32>();
+
+		array<u8> key{};
+		key_write(key, shader_count);
+		bool known = true;
+		for (u32 i = 0; i < shader_count && reader.ok; ++i)
+		{
+			const handle_id shader = reader.read<u64>();
+			if (!g_pipeline_cache.shaders.entries.contains(shader))
+			{
+				known = false;
+				break;
+			}
+			if (!indices.contains(shader))
+			{
+				indices.insert(shader, static_cast<u32>(shaders.size()));
+				shaders.push_back(shader);
+			}
+			key_write(key, static_cast<u64>(*indices.get(shader)));
+		}
+
+		// A pipeline may outlive its shaders, it then has nothing to be rebuilt from
+		if (!known || !reader.ok)
+			continue;
+
+		key_write(key, reader.it, static_cast<usize>(reader.end - reader.it));
+		list_write_bytes(pipelines, reinterpret_cast<const u8*>(it.second.name.c_str()), it.second.name.size() + 1);
+		list_write_bytes(pipelines, key.data(), key.size());
+		++pipeline_count;
+	}
+
+	key_write(out, static_cast<u32>(shaders.size()));
+	for (const handle_id shader : shaders)
+	{
+		const pipeline_cache_entry_t& entry = *g_pipeline_cache.shaders.entries.get(shader);
+		list_write_bytes(out, reinterpret_cast<const u8*>(entry.name.c_str()), entry.name.size() + 1);
+		list_write_bytes(out, entry.key.data(), entry.key.size());
+	}
+
+	key_write(out, pipeline_count);
+	key_write(out, pipelines.data(), pipelines.size());
+
+	std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+	if (!file.write(reinterpret_cast<const char*>(out.data()), static_cast<std::streamsize>(out.size())))
+	{
+		bx_error(bx, "Failed to write pipeline list '{}'", filepath);
+		return false;
+	}
+
+	bx_info(bx, "Saved {} pipelines and {} shaders to '{}'", pipeline_count, shaders.size(), filepath);
+	return true;
+}
+
+static bool list_read_entry(key_reader_t& reader, cstring& name, key_reader_t& key) noexcept
+{
+	const u32 name_size = reader.read<u32>();
+	if (!reader.ok || name_size == 0 || static_cast<usize>(reader.end - reader.it) < name_size
+		|| reader.it[name_size - 1] != 0)
+		return reader.ok = false;
+	name = reinterpret_cast<cstring>(reader.it);
+	reader.it += name_size;
+
+	const u32 key_size = reader.read<u32>();
+	if (!reader.ok || static_cast<usize>(reader.end - reader.it) < key_size)
+		return reader.ok = false;
+	key = key_reader_t{ reader.it, reader.it + key_size };
+	reader.it += key_size;
+	return true;
+}
+
+static bx::handle_id warm_up_shader(key_reader_t& key, cstring name) noexcept
+{
+	bx::gfx_shader_desc_t desc{};
+	desc.name = name;
+	desc.stage = key.read<bx::gfx_shader_stage_t>();
+	desc.lang = key.read<bx::gfx_shader_lang_t>();
+	desc.entrypoint = key.read_string();
+	desc.filepath = key.read_string();
+	desc.source = key.read_string();
+
+	bx::array<bx::gfx_shader_macro_t> macros{};
+	const u32 macro_count = key.read<u32>();
+	for (u32 i = 0; i < macro_count && key.ok; ++i)
+	{
+		bx::gfx_shader_macro_t macro{};
+		macro.name = key.read_string();
+		macro.value = key.read_string();
+		macros.push_back(macro);
+	}
+	desc.macros = bx::array_view<bx::gfx_shader_macro_t>(macros.data(), macros.size());
+
+	const u64 bin_size = key.read<u64>();
+	if (!key.ok || static_cast<u64>(key.end - key.it) < bin_size)
+		return bx::invalid_handle;
+	desc.src_bin = bx::array_view<u8>(const_cast<u8*>(key.it), static_cast<usize>(bin_size));
+
+	return bx::gfx_create_shader(desc);
+}
+
+static bx::handle_id warm_up_pipeline(key_reader_t& key, cstring name, const bx::array<bx::handle_id>& shaders) noexcept
+{
+	bx::gfx_pipeline_desc_t desc{};
+	desc.name = name;
+
+	bx::array<bx::handle_id> stages{};
+	const u32 stage_count = key.read<u32>();
+	for (u32 i = 0; i < stage_count && key.ok; ++i)
+	{
+		const u64 index = key.read<u64>();
+		if (index >= shaders.size() || shaders[static_cast<usize>(index)] == bx::invalid_handle)
+			return bx::invalid_handle;
+		stages.push_back(shaders[static_cast<usize>(index)]);
+	}
+
+	desc.topology = key.read<bx::gfx_topology_t>();
+
+	bx::array<bx::gfx_vertex_attribute_t> attributes{};
+	const u32 attribute_count = key.read<u32>();
+	for (u32 i = 0; i < attribute_count && key.ok; ++i)
+	{
+		bx::gfx_vertex_attribute_t attribute{};
+		attribute.location = key.read<u8>();
+		attribute.binding = key.read<u8>();
+		attribute.count = key.read<u8>();
+		attribute.format = key.read<bx::gfx_attribute_format_t>();
+		attribute.normalized = key.read<u8>() != 0;
+		attribute.offset = key.read<u32>();
+		attribute.input_rate_per_vertex_or_instance = key.read<u8>();
+		attributes.push_back(attribute);
+	}
+
+	bx::array<bx::gfx_resource_layout_binding_t> bindings{};
+	const u32 binding_count = key.read<u32>();
+	for (u32 i = 0; i < binding_count && key.ok; ++i)
+	{
+		bx::gfx_resource_layout_binding_t binding{};
+		binding.set = key.read<u32>();
+		binding.binding = key.read<u32>();
+		binding.type = key.read<bx::gfx_resource_type_t>();
+		bindings.push_back(binding);
+	}
+
+	desc.raster.cull_enable = key.read<u8>() != 0;
+	desc.raster.depth_test = key.read<u8>() != 0;
+	desc.raster.depth_write = key.read<u8>() != 0;
+
+	bx::array<bx::gfx_color_blend_attachment_t> attachments{};
+	const u32 attachment_count = key.read<u32>();
+	for (u32 i = 0; i < attachment_count && key.ok; ++i)
+	{
+		bx::gfx_color_blend_attachment_t attachment{};
+		attachment.blend_enable = key.read<u8>() != 0;
+		attachments.push_back(attachment);
+	}
+
+	if (!key.ok)
+		return bx::invalid_handle;
+
+	desc.shaders = bx::array_view<bx::handle_id>(stages.data(), stages.size());
+	desc.input_layout.attributes = bx::array_view<bx::gfx_vertex_attribute_t>(attributes.data(), attributes.size());
+	desc.resource_layout.bindings = bx::array_view<bx::gfx_resource_layout_binding_t>(bindings.data(), bindings.size());
+	desc.color_attachments = bx::array_view<bx::gfx_color_blend_attachment_t>(attachments.data(), attachments.size());
+	return bx::gfx_create_pipeline(desc);
+}
+
+u32 bx::gfx_warm_up_pipelines(cstring filepath) noexcept
+{
+	bx_profile(bx);
+
+	if (!filepath)
+		return 0;
+
+	std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+	if (!file)
+	{
+		bx_warn(bx, "No pipeline list at '{}'", filepath);
+		return 0;
+	}
+
+	const std::streamsize size = file.tellg();
+	array<u8> data{};
+	data.resize(static_cast<usize>(size));
+	file.seekg(0);
+	if (size <= 0 || data.size() != static_cast<usize>(size)
+		|| !file.read(reinterpret_cast<char*>(data.data()), size))
+	{
+		bx_warn(bx, "Failed to read pipeline list '{}'", filepath);
+		return 0;
+	}
+
+	key_reader_t reader{ data.data(), data.data() + data.size() };
+	if (reader.read<u32>() != BX_PIPELINE_LIST_MAGIC || reader.read<u32>() != BX_PIPELINE_LIST_VERSION)
+	{
+		bx_warn(bx, "Ignoring pipeline list '{}', not written by this version", filepath);
+		return 0;
+	}
+
+	// Names, sources and macros in the descs point into the file, keep it with the objects
+	g_pipeline_cache.files.push_back(static_cast<array<u8>&&>(data));
+
+	array<handle_id> shaders{};
+	const u32 shader_count = reader.read<u32>();
+	for (u32 i = 0; i < shader_count && reader.ok; ++i)
+	{
+		cstring name = nullptr;
+		key_reader_t key{};
+		if (!list_read_entry(reader, name, key))
+			break;
+
+		const handle_id shader = warm_up_shader(key, name);
+		shaders.push_back(shader);
+		if (shader != invalid_handle)
+			g_pipeline_cache.warm_shaders.push_back(shader);
+	}
+
+	u32 created = 0;
+	const u32 pipeline_count = reader.read<u32>();
+	for (u32 i = 0; i < pipeline_count && reader.ok; ++i)
+	{
+		cstring name = nullptr;
+		key_reader_t key{};
+		if (!list_read_entry(reader, name, key))
+			break;
+
+		const handle_id pipeline = warm_up_pipeline(key, name, shaders);
+		if (pipeline == invalid_handle)
+			continue;
+		g_pipeline_cache.warm_pipelines.push_back(pipeline);
+		++created;
+	}
+
+	if (!reader.ok)
+		bx_warn(bx, "Pipeline list '{}' is truncated", filepath);
+
+	bx_info(bx, "Warmed up {} of {} pipelines from '{}'", created, pipeline_count, filepath);
+	return created;
+}
@@ -0,0 +1,382 @@
+#include <bx_app_impl.hpp>
+
+#include <cmath>
+#include <cstring>
+
+// Vertex stream quantization. SSE2 and NEON loops take the bulk, the scalar
+// versions do the tails and other targets, rounding the same way: to nearest
+// even, as the default float environment and the SIMD conversions do. NaN
+// clamps to the low end of a normalized range.
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BX_QUANTIZE_SSE2
+#include <emmintrin.h>
+#if defined(__F16C__)
+#include <immintrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+// ARMv8 only, for the round to nearest conversions and f16
+#define BX_QUANTIZE_NEON
+#include <arm_neon.h>
+#endif
+
+static inline f32 quantize_clamp(f32 value, f32 lo, f32 hi) noexcept
+{
+	return !(value >= lo) ? lo : (value > hi ? hi : value);
+}
+
+static inline i32 quantize_round(f32 value) noexcept
+{
+	return static_cast<i32>(std::lrint(value));
+}
+
+// Round to nearest even, overflow goes to infinity and NaN stays a quiet NaN
+static u16 quantize_f16(f32 value) noexcept
+{
+	const u32 f16_max = (127 + 16) << 23;
+	const u32 f32_inf = 255 << 23;
+	const u32 denorm_magic = ((127 - 15) + (23 - 10) + 1) << 23;
+
+	u32 bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	const u32 sign = bits & 0x80000000u;
+	bits ^= sign;
+
+	u32 half;
+	if (bits >= f16_max)
+		half = bits > f32_inf ? 0x7e00 : 0x7c00;
+	else if (bits < (113u << 23))
+	{
+		// Adding the magic lines the mantissa up for a half denormal, the FPU rounds
+		f32 magic, shifted;
+		std::memcpy(&magic, &denorm_magic, sizeof(magic));
+		std::memcpy(&shifted, &bits, sizeof(shifted));
+		shifted += magic;
+		std::memcpy(&bits, &shifted, sizeof(bits));
+		half = bits - denorm_magic;
+	}
+	else
+	{
+		const u32 mantissa_odd = (bits >> 13) & 1;
+		bits += (static_cast<u32>(15 - 127) << 23) + 0xfff + mantissa_odd;
+		half = bits >> 13;
+	}
+	return static_cast<u16>(half | (sign >> 16));
+}
+
+static inline u32 quantize_10_10_10_2(const f32* v) noexcept
+{
+	const i32 x = quantize_round(quantize_clamp(v[0], -1.0f, 1.0f) * 511.0f);
+	const i32 y = quantize_round(quantize_clamp(v[1], -1.0f, 1.0f) * 511.0f);
+	const i32 z = quantize_round(quantize_clamp(v[2], -1.0f, 1.0f) * 511.0f);
+	const i32 w = quantize_round(quantize_clamp(v[3], -1.0f, 1.0f));
+	return (static_cast<u32>(x) & 0x3ff)
+		| (static_cast<u32>(y) & 0x3ff) << 10
+		| (static_cast<u32>(z) & 0x3ff) << 20
+		| (static_cast<u32>(w) & 0x3) << 30;
+}
+
+#if defined(BX_QUANTIZE_SSE2)
+static inline __m128 quantize_clamp(__m128 value, __m128 lo, __m128 hi) noexcept
+{
+	// maxps returns its second operand for NaN
+	return _mm_min_ps(_mm_max_ps(value, lo), hi);
+}
+
+// 0 to 65535 through the signed pack
+static inline __m128i quantize_pack_u16(__m128i a, __m128i b) noexcept
+{
+	const __m128i bias = _mm_set1_epi32(32768);
+	const __m128i packed = _mm_packs_epi32(_mm_sub_epi32(a, bias), _mm_sub_epi32(b, bias));
+	return _mm_xor_si128(packed, _mm_set1_epi16(static_cast<short>(0x8000)));
+}
+
+#if !defined(__F16C__)
+static inline __m128i quantize_f16(__m128 value) noexcept
+{
+	const __m128i sign_mask = _mm_set1_epi32(static_cast<int>(0x80000000u));
+	const __m128i f16_max = _mm_set1_epi32((127 + 16) << 23);
+	const __m128i min_normal = _mm_set1_epi32((127 - 14) << 23);
+	const __m128i denorm_magic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+	const __m128i normal_bias = _mm_set1_epi32(0xfff - ((127 - 15) << 23));
+
+	const __m128i sign = _mm_and_si128(_mm_castps_si128(value), sign_mask);
+	const __m128i bits = _mm_xor_si128(_mm_castps_si128(value), sign);
+	const __m128 abs = _mm_castsi128_ps(bits);
+
+	const __m128i is_nan = _mm_castps_si128(_mm_cmpunord_ps(abs, abs));
+	const __m128i is_regular = _mm_cmpgt_epi32(f16_max, bits);
+	const __m128i is_denormal = _mm_cmpgt_epi32(min_normal, bits);
+	const __m128i inf_or_nan = _mm_or_si128(_mm_and_si128(is_nan, _mm_set1_epi32(0x200)), _mm_set1_epi32(0x7c00));
+
+	const __m128i denormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(abs, _mm_castsi128_ps(denorm_magic))), denorm_magic);
+	const __m128i mantissa_odd = _mm_srai_epi32(_mm_slli_epi32(bits, 31 - 13), 31);
+	const __m128i normal = _mm_srli_epi32(_mm_sub_epi32(_mm_add_epi32(bits, normal_bias), mantissa_odd), 13);
+
+	const __m128i finite = _mm_or_si128(_mm_and_si128(is_denormal, denormal), _mm_andnot_si128(is_denormal, normal));
+	const __m128i half = _mm_or_si128(_mm_and_si128(is_regular, finite), _mm_andnot_si128(is_regular, inf_or_nan));
+
+	// Arithmetic shift keeps negative halfs in range of the signed pack
+	return _mm_or_si128(half, _mm_srai_epi32(sign, 16));
+}
+#endif
+#endif
+
+void bx::gfx_quantize_f16(const f32* src, u16* dst, usize count) noexcept
+{
+	bx_profile(bx);
+
+	usize i = 0;
+#if defined(BX_QUANTIZE_SSE2) && defined(__F16C__)
+	for (; i + 8 <= count; i += 8)
+	{
+		const __m128i lo = _mm_cvtps_ph(_mm_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+		const __m128i hi = _mm_cvtps_ph(_mm_loadu_ps(src + i + 4), _MM_FROUND_TO_NEAREST_INT);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi64(lo, hi));
+	}
+#elif defined(BX_QUANTIZE_SSE2)
+	for (; i + 8 <= count; i += 8)
+	{
+		const __m128i lo = quantize_f16(_mm_loadu_ps(src + i));
+		const __m128i hi = quantize_f16(_mm_loadu_ps(src + i + 4));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packs_epi32(lo, hi));
+	}
+#elif defined(BX_QUANTIZE_NEON)
+	for (; i + 4 <= count; i += 4)
+		vst1_u16(dst + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(src + i))));
+#endif
+	for (; i < count; ++i)
+		dst[i] = quantize_f16(src[i]);
+}
+
+void bx::gfx_quantize_snorm8(const f32* src, i8* dst, usize count) noexcept
+{
+	bx_profile(bx);
+
+	usize i = 0;
+#if defined(BX_QUANTIZE_SSE2)
+	const __m128 lo = _mm_set1_ps(-1.0f);
+	const __m128 hi = _mm_set1_ps(1.0f);
+	const __m128 scale = _mm_set1_ps(127.0f);
+	for (; i + 16 <= count; i += 16)
+	{
+		__m128i v[4];
+		for (u32 j = 0; j < 4; ++j)
+			v[j] = _mm_cvtps_epi32(_mm_mul_ps(quantize_clamp(_mm_loadu_ps(src + i + j * 4), lo, hi), scale));
+		const __m128i packed = _mm_packs_epi16(_mm_packs_epi32(v[0], v[1]), _mm_packs_epi32(v[2], v[3]));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), packed);
+	}
+#elif defined(BX_QUANTIZE_NEON)
+	const float32x4_t lo = vdupq_n_f32(-1.0f);
+	const float32x4_t hi = vdupq_n_f32(1.0f);
+	for (; i + 16 <= count; i += 16)
+	{
+		int16x8_t v[2];
+		for (u32 j = 0; j < 2; ++j)
+		{
+			const int32x4_t a = vcvtnq_s32_f32(vmulq_n_f32(vminq_f32(vmaxnmq_f32(vld1q_f32(src + i + j * 8), lo), hi), 127.0f));
+			const int32x4_t b = vcvtnq_s32_f32(vmulq_n_f32(vminq_f32(vmaxnmq_f32(vld1q_f32(src + i + j * 8 + 4), lo), hi), 127.0f));
+			v[j] = vcombine_s16(vqmovn_s32(a), vqmovn_s32(b));
+		}
+		vst1q_s8(dst + i, vcombine_s8(vqmovn_s16(v[0]), vqmovn_s16(v[1])));
+	}
+#endif
+	for (; i < count; ++i)
+		dst[i] = static_cast<i8>(quantize_round(quantize_clamp(src[i], -1.0f, 1.0f) * 127.0f));
+}
+
+void bx::gfx_quantize_unorm8(const f32* src, u8* dst, usize count) noexcept
+{
+	bx_profile(bx);
+
+	usize i = 0;
+#if defined(BX_QUANTIZE_SSE2)
+	const __m128 lo = _mm_setzero_ps();
+	const __m128 hi = _mm_set1_ps(1.0f);
+	const __m128 scale = _mm_set1_ps(255.0f);
+	for (; i + 16 <= count; i += 16)
+	{
+		__m128i v[4];
+		for (u32 j = 0; j < 4; ++j)
+			v[j] = _mm_cvtps_epi32(_mm_mul_ps(quantize_clamp(_mm_loadu_ps(src + i + j * 4), lo, hi), scale));
+		const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(v[0], v[1]), _mm_packs_epi32(v[2], v[3]));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), packed);
+	}
+#elif defined(BX_QUANTIZE_NEON)
+	const float32x4_t lo = vdupq_n_f32(0.0f);
+	const float32x4_t hi = vdupq_n_f32(1.0f);
+	for (; i + 16 <= count; i += 16)
+	{
+		uint16x8_t v[2];
+		for (u32 j = 0; j < 2; ++j)
+		{
+			const uint32x4_t a = vcvtnq_u32_f32(vmulq_n_f32(vminq_f32(vmaxnmq_f32(vld1q_f32(src + i + j * 8), lo), hi), 255.0f));
+			const uint32x4_t b = vcvtnq_u32_f32(vmulq_n_f32(vminq_f32(vmaxnmq_f32(vld1q_f32(src + i + j * 8 + 4), lo), hi), 255.0f));
+			v[j] = vcombine_u16(vqmovn_u32(a), vqmovn_u32(b));
+		}
+		vst1q_u8(dst + i, vcombine_u8(vqmovn_u16(v[0]), vqmovn_u16(v[1])));
+	}
+#endif
+	for (; i < count; ++i)
+		dst[i] = static_cast<u8>(quantize_round(quantize_clamp(src[i], 0.0f, 1.0f) * 255.0f));
+}
+
+void bx::gfx_quantize_snorm16(const f32* src, i16* dst, usize count) noexcept
+{
+	bx_profile(bx);
+
+	usize i = 0;
+#if defined(BX_QUANTIZE_SSE2)
+	const __m128 lo = _mm_set1_ps(-1.0f);
+	const __m128 hi = _mm_set1_ps(1.0f);
+	const __m128 scale = _mm_set1_ps(32767.0f);
+	for (; i + 8 <= count; i += 8)
+	{
+		const __m128i a = _mm_cvtps_epi32(_mm_mul_ps(quantize_clamp(_mm_loadu_ps(src + i), lo, hi), scale));
+		const __m128i b = _mm_cvtps_epi32(_mm_mul_ps(quantize_clamp(_mm_loadu_ps(src + i + 4), lo, hi), scale));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packs_epi32(a, b));
+	}
+#elif defined(BX_QUANTIZE_NEON)
+	const float32x4_t lo = vdupq_n_f32(-1.0f);
+	const float32x4_t hi = vdupq_n_f32(1.0f);
+	for (; i + 4 <= count; i += 4)
+	{
+		const int32x4_t v = vcvtnq_s32_f32(vmulq_n_f32(vminq_f32(vmaxnmq_f32(vld1q_f32(src + i), lo), hi), 32767.0f));
+		vst1_s16(dst + i, vqmovn_s32(v));
+	}
+#endif
+	for (; i < count; ++i)
+		dst[i] = static_cast<i16>(quantize_round(quantize_clamp(src[i], -1.0f, 1.0f) * 32767.0f));
+}
+
+void bx::gfx_quantize_unorm16(const f32* src, u16* dst, usize count) noexcept
+{
+	bx_profile(bx);
+
+	usize i = 0;
+#if defined(BX_QUANTIZE_SSE2)
+	const __m128 lo = _mm_setzero_ps();
+	const __m128 hi = _mm_set1_ps(1.0f);
+	const __m128 scale = _mm_set1_ps(65535.0f);
+	for (; i + 8 <= count; i += 8)
+	{
+		const __m128i a = _mm_cvtps_epi32(_mm_mul_ps(quantize_clamp(_mm_loadu_ps(src + i), lo, hi), scale));
+		const __m128i b = _mm_cvtps_epi32(_mm_mul_ps(quantize_clamp(_mm_loadu_ps(src + i + 4), lo, hi), scale));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), quantize_pack_u16(a, b));
+	}
+#elif defined(BX_QUANTIZE_NEON)
+	const float32x4_t lo = vdupq_n_f32(0.0f);
+	const float32x4_t hi = vdupq_n_f32(1.0f);
+	for (; i + 4 <= count; i += 4)
+	{
+		const uint32x4_t v = vcvtnq_u32_f32(vmulq_n_f32(vminq_f32(vmaxnmq_f32(vld1q_f32(src + i), lo), hi), 65535.0f));
+		vst1_u16(dst + i, vqmovn_u32(v));
+	}
+#endif
+	for (; i < count; ++i)
+		dst[i] = static_cast<u16>(quantize_round(quantize_clamp(src[i], 0.0f, 1.0f) * 65535.0f));
+}
+
+void bx::gfx_quantize_snorm_10_10_10_2(const f32* src, u32* dst, usize count) noexcept
+{
+	bx_profile(bx);
+
+	usize i = 0;
+#if defined(BX_QUANTIZE_SSE2)
+	const __m128 lo = _mm_set1_ps(-1.0f);
+	const __m128 hi = _mm_set1_ps(1.0f);
+	const __m128 scale = _mm_set1_ps(511.0f);
+	const __m128i mask10 = _mm_set1_epi32(0x3ff);
+	const __m128i mask2 = _mm_set1_epi32(0x3);
+	for (; i + 4 <= count; i += 4)
+	{
+		// Four vertices transposed to one register per component
+		__m128 x = _mm_loadu_ps(src + i * 4);
+		__m128 y = _mm_loadu_ps(src + i * 4 + 4);
+		__m128 z = _mm_loadu_ps(src + i * 4 + 8);
+		__m128 w = _mm_loadu_ps(src + i * 4 + 12);
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+
+		const __m128i qx = _mm_and_si128(_mm_cvtps_epi32(_mm_mul_ps(quantize_clamp(x, lo, hi), scale)), mask10);
+		const __m128i qy = _mm_and_si128(_mm_cvtps_epi32(_mm_mul_ps(quantize_clamp(y, lo, hi), scale)), mask10);
+		const __m128i qz = _mm_and_si128(_mm_cvtps_epi32(_mm_mul_ps(quantize_clamp(z, lo, hi), scale)), mask10);
+		const __m128i qw = _mm_and_si128(_mm_cvtps_epi32(quantize_clamp(w, lo, hi)), mask2);
+
+		const __m128i packed = _mm_or_si128(_mm_or_si128(qx, _mm_slli_epi32(qy, 10)),
+			_mm_or_si128(_mm_slli_epi32(qz, 20), _mm_slli_epi32(qw, 30)));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), packed);
+	}
+#elif defined(BX_QUANTIZE_NEON)
+	const float32x4_t lo = vdupq_n_f32(-1.0f);
+	const float32x4_t hi = vdupq_n_f32(1.0f);
+	const uint32x4_t mask10 = vdupq_n_u32(0x3ff);
+	const uint32x4_t mask2 = vdupq_n_u32(0x3);
+	for (; i + 4 <= count; i += 4)
+	{
+		const float32x4x4_t v = vld4q_f32(src + i * 4);
+		const uint32x4_t qx = vandq_u32(vreinterpretq_u32_s32(vcvtnq_s32_f32(vmulq_n_f32(vminq_f32(vmaxnmq_f32(v.val[0], lo), hi), 511.0f))), mask10);
+		const uint32x4_t qy = vandq_u32(vreinterpretq_u32_s32(vcvtnq_s32_f32(vmulq_n_f32(vminq_f32(vmaxnmq_f32(v.val[1], lo), hi), 511.0f))), mask10);
+		const uint32x4_t qz = vandq_u32(vreinterpretq_u32_s32(vcvtnq_s32_f32(vmulq_n_f32(vminq_f32(vmaxnmq_f32(v.val[2], lo), hi), 511.0f))), mask10);
+		const uint32x4_t qw = vandq_u32(vreinterpretq_u32_s32(vcvtnq_s32_f32(vminq_f32(vmaxnmq_f32(v.val[3], lo), hi))), mask2);
+		vst1q_u32(dst + i, vorrq_u32(vorrq_u32(qx, vshlq_n_u32(qy, 10)), vorrq_u32(vshlq_n_u32(qz, 20), vshlq_n_u32(qw, 30))));
+	}
+#endif
+	for (; i < count; ++i)
+		dst[i] = quantize_10_10_10_2(src + i * 4);
+}
+
+void bx::gfx_quantize_positions(const f32* src, u16* dst, usize count, const f32 min[3], const f32 max[3]) noexcept
+{
+	bx_profile(bx);
+
+	// A flat axis quantizes to 0
+	f32 scale[3];
+	for (u32 c = 0; c < 3; ++c)
+	{
+		const f32 extent = max[c] - min[c];
+		scale[c] = extent > 0.0f ? 65535.0f / extent : 0.0f;
+	}
+
+	usize i = 0;
+#if defined(BX_QUANTIZE_SSE2)
+	const __m128 offset = _mm_setr_ps(min[0], min[1], min[2], 0.0f);
+	const __m128 factor = _mm_setr_ps(scale[0], scale[1], scale[2], 0.0f);
+	const __m128 lo = _mm_setzero_ps();
+	const __m128 hi = _mm_set1_ps(65535.0f);
+	const __m128 xyz = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+	const __m128 w = _mm_setr_ps(0.0f, 0.0f, 0.0f, 65535.0f);
+
+	// Each load takes the next vertex's x along, the last vertex is left to the tail
+	for (; i + 2 < count; i += 2)
+	{
+		__m128i v[2];
+		for (u32 j = 0; j < 2; ++j)
+		{
+			const __m128 p = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(src + (i + j) * 3), offset), factor);
+			v[j] = _mm_cvtps_epi32(_mm_or_ps(_mm_and_ps(quantize_clamp(p, lo, hi), xyz), w));
+		}
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), quantize_pack_u16(v[0], v[1]));
+	}
+#elif defined(BX_QUANTIZE_NEON)
+	const float32x4_t lo = vdupq_n_f32(0.0f);
+	const float32x4_t hi = vdupq_n_f32(65535.0f);
+	for (; i + 4 <= count; i += 4)
+	{
+		const float32x4x3_t p = vld3q_f32(src + i * 3);
+		uint16x4x4_t q;
+		for (u32 c = 0; c < 3; ++c)
+		{
+			const float32x4_t v = vmulq_n_f32(vsubq_f32(p.val[c], vdupq_n_f32(min[c])), scale[c]);
+			q.val[c] = vqmovn_u32(vcvtnq_u32_f32(vminq_f32(vmaxnmq_f32(v, lo), hi)));
+		}
+		q.val[3] = vdup_n_u16(65535);
+		vst4_u16(dst + i * 4, q);
+	}
+#endif
+	for (; i < count; ++i)
+	{
+		for (u32 c = 0; c < 3; ++c)
+			dst[i * 4 + c] = static_cast<u16>(quantize_round(quantize_clamp((src[i * 3 + c] - min[c]) * scale[c], 0.0f, 65535.0f)));
+		dst[i * 4 + 3] = 65535;
+	}
+}
@@ -0,0 +1,243 @@
+#include <bx_app_impl.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+// Shader binaries on disk, one file per key. The keys used by a run are written
+// to an index at shutdown so the next run can read them ahead on a thread.
+// Loads and stores may come from any thread, e.g. the SPIR-V compile workers.
+
+#define BX_SHADER_CACHE_MAGIC 0x42505842u // "BXPB"
+#define BX_SHADER_CACHE_VERSION 1u
+#define BX_SHADER_CACHE_MAX_SIZE (64u << 20) // larger entries are never written, nor trusted on read
+
+struct shader_cache_header_t
+{
+	u32 magic;
+	u32 version;
+	u64 key;
+	u32 format;
+	u32 size;
+};
+
+struct shader_cache_blob_t
+{
+	u32 format{ 0 };
+	bx::array<u8> binary{};
+};
+
+struct shader_cache_t
+{
+	bx::string_fixed<512> directory{};
+	bool enabled{ false };
+
+	// Filled by the warm up thread, entries move out on their first load
+	std::mutex mutex{};
+	bx::hash_map<u64, shader_cache_blob_t> warm{};
+	std::thread warmup{};
+	std::atomic<bool> stop{ false };
+
+	bx::array<u64> used{}; // guarded by mutex
+	std::atomic<u32> temp_id{ 0 };
+};
+
+static shader_cache_t g_cache{};
+
+static bx::string_fixed<512> shader_cache_path(cstring name) noexcept
+{
+	bx::string_fixed<512> path = g_cache.directory;
+	path.push_back('/');
+	path.append(name);
+	return path;
+}
+
+static bx::string_fixed<512> shader_cache_path(const u64 key) noexcept
+{
+	char name[32];
+	std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+	return shader_cache_path(name);
+}
+
+static bool shader_cache_read(const u64 key, shader_cache_blob_t& blob) noexcept
+{
+	bx_profile(bx);
+
+	std::ifstream file(shader_cache_path(key).c_str(), std::ios::binary | std::ios::ate);
+	if (!file.is_open())
+		return false;
+
+	// The size is only believed when the payload fills the rest of the file
+	const std::streamoff length = file.tellg();
+	shader_cache_header_t header{};
+	if (length < static_cast<std::streamoff>(sizeof(header))
+		|| !file.seekg(0)
+		|| !file.read(reinterpret_cast<char*>(&header), sizeof(header))
+		|| header.magic != BX_SHADER_CACHE_MAGIC
+		|| header.version != BX_SHADER_CACHE_VERSION
+		|| header.key != key
+		|| header.size == 0
+		|| header.size > BX_SHADER_CACHE_MAX_SIZE
+		|| static_cast<std::streamoff>(header.size) != length - static_cast<std::streamoff>(sizeof(header)))
+		return false;
+
+	blob.binary.resize(header.size);
+	if (blob.binary.size() != header.size
+		|| !file.read(reinterpret_cast<char*>(blob.binary.data()), static_cast<std::streamsize>(header.size)))
+		return false;
+
+	blob.format = header.format;
+	return true;
+}
+
+static void shader_cache_warmup() noexcept
+{
+	bx_profile(bx);
+
+	std::ifstream index(shader_cache_path("index").c_str());
+	u64 key = 0;
+	while (!g_cache.stop.load(std::memory_order_relaxed) && index >> std::hex >> key)
+	{
+		shader_cache_blob_t blob{};
+		if (!shader_cache_read(key, blob))
+			continue;
+
+		std::lock_guard<std::mutex> lock(g_cache.mutex);
+		g_cache.warm.insert(key, std::move(blob));
+	}
+}
+
+static void shader_cache_write_index() noexcept
+{
+	bx_profile(bx);
+
+	std::sort(g_cache.used.begin(), g_cache.used.end());
+	const auto last = std::unique(g_cache.used.begin(), g_cache.used.end());
+
+	std::ofstream index(shader_cache_path("index").c_str(), std::ios::trunc);
+	for (auto it = g_cache.used.begin(); it != last; ++it)
+		index << std::hex << *it << '\n';
+}
+
+void bx::gfx_shader_cache_init(const app_config_t& config) noexcept
+{
+	bx_profile(bx);
+
+	if (!config.shader_cache)
+		return;
+
+	g_cache.directory = config.shader_cache[0] == '[' ? file_get_path(config.shader_cache) : string_fixed<512>(config.shader_cache);
+	if (g_cache.directory.empty())
+	{
+		bx_warn(bx, "Shader cache disabled, '{}' does not resolve to a directory", config.shader_cache);
+		return;
+	}
+
+	// Only the last level is created, an existing directory is fine
+#ifdef _WIN32
+	_mkdir(g_cache.directory.c_str());
+#else
+	mkdir(g_cache.directory.c_str(), 0755);
+#endif
+
+	g_cache.enabled = true;
+	g_cache.stop.store(false, std::memory_order_relaxed);
+	if (config.shader_cache_warmup)
+		g_cache.warmup = std::thread(shader_cache_warmup);
+}
+
+void bx::gfx_shader_cache_shutdown() noexcept
+{
+	bx_profile(bx);
+
+	g_cache.stop.store(true, std::memory_order_relaxed);
+	if (g_cache.warmup.joinable())
+		g_cache.warmup.join();
+
+	if (g_cache.enabled && !g_cache.used.empty())
+		shader_cache_write_index();
+
+	g_cache.enabled = false;
+	g_cache.warm.clear();
+	g_cache.used = bx::array<u64>{};
+}
+
+bool bx::gfx_shader_cache_load(u64 key, u32& format, bx::array<u8>& binary) noexcept
+{
+	bx_profile(bx);
+
+	if (!g_cache.enabled)
+		return false;
+
+	shader_cache_blob_t blob{};
+	bool found = false;
+	{
+		std::lock_guard<std::mutex> lock(g_cache.mutex);
+		auto it = g_cache.warm.find(key);
+		if (it != g_cache.warm.end())
+		{
+			blob = std::move(it->second);
+			g_cache.warm.erase(key);
+			found = true;
+		}
+	}
+
+	if (!found && !shader_cache_read(key, blob))
+		return false;
+
+	format = blob.format;
+	binary = std::move(blob.binary);
+
+	std::lock_guard<std::mutex> lock(g_cache.mutex);
+	g_cache.used.push_back(key);
+	return true;
+}
+
+void bx::gfx_shader_cache_store(u64 key, u32 format, const u8* binary, usize size) noexcept
+{
+	bx_profile(bx);
+
+	if (!g_cache.enabled || !binary || size == 0 || size > BX_SHADER_CACHE_MAX_SIZE)
+		return;
+
+	// Written aside and renamed so a crash never leaves a truncated entry, the
+	// temp name is unique so threads storing the same key don't share a file
+	const auto path = shader_cache_path(key);
+	char suffix[24];
+	std::snprintf(suffix, sizeof(suffix), ".%u.tmp", g_cache.temp_id.fetch_add(1, std::memory_order_relaxed));
+	auto temp = path;
+	temp.append(suffix);
+
+	{
+		std::ofstream file(temp.c_str(), std::ios::binary | std::ios::trunc);
+		const shader_cache_header_t header{ BX_SHADER_CACHE_MAGIC, BX_SHADER_CACHE_VERSION, key, format, static_cast<u32>(size) };
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(binary), static_cast<std::streamsize>(size));
+		if (!file)
+		{
+			bx_warn(bx, "Failed to write shader cache entry {}", temp.c_str());
+			file.close();
+			std::remove(temp.c_str());
+			return;
+		}
+	}
+
+	std::remove(path.c_str());
+	if (std::rename(temp.c_str(), path.c_str()) != 0)
+	{
+		std::remove(temp.c_str());
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(g_cache.mutex);
+	g_cache.used.push_back(key);
+}
@@ -0,0 +1,192 @@
+#include <bx_app_impl.hpp>
+
+#include <atomic>
+
+#ifdef BX_APP_IMGUI
+#include <imgui.h>
+
+#include <cfloat>
+#include <cstdio>
+#endif
+
+// Per frame gfx counters and a ring of the last frames. Counting is a plain
+// increment on the graphics thread, compile times are added from the workers
+// through atomics and folded in when the frame closes.
+
+struct gfx_stats_state_t
+{
+	bx::gfx_frame_stats_t current{};
+	bx::gfx_frame_stats_t last{};
+
+	bx::array<bx::gfx_frame_stats_t> history{};
+	u32 head{ 0 };	// next slot written
+	u32 count{ 0 };
+
+	std::atomic<u64> compile_ns{ 0 };
+	std::atomic<u32> compiles{ 0 };
+};
+
+static gfx_stats_state_t g_stats{};
+
+void bx::gfx_stats_init(const app_config_t& config) noexcept
+{
+	g_stats.current = gfx_frame_stats_t{};
+	g_stats.last = gfx_frame_stats_t{};
+	g_stats.head = 0;
+	g_stats.count = 0;
+	g_stats.compile_ns.store(0, std::memory_order_relaxed);
+	g_stats.compiles.store(0, std::memory_order_relaxed);
+
+	g_stats.history = array<gfx_frame_stats_t>{};
+	g_stats.history.resize(config.gfx_stats_history);
+	if (g_stats.history.size() != config.gfx_stats_history)
+	{
+		bx_warn(bx, "gfx stats history disabled, out of memory for {} frames", config.gfx_stats_history);
+		g_stats.history = array<gfx_frame_stats_t>{};
+	}
+}
+
+void bx::gfx_stats_shutdown() noexcept
+{
+	g_stats.history = array<gfx_frame_stats_t>{};
+	g_stats.head = 0;
+	g_stats.count = 0;
+}
+
+void bx::gfx_stats_end_frame() noexcept
+{
+	bx_profile(bx);
+
+	gfx_frame_stats_t& frame = g_stats.current;
+	frame.frame_time = app_frame_time();
+	frame.shader_compiles += g_stats.compiles.exchange(0, std::memory_order_relaxed);
+	frame.shader_compile_time += static_cast<f64>(g_stats.compile_ns.exchange(0, std::memory_order_relaxed)) * 1e-9;
+
+	g_stats.last = frame;
+
+	const u32 capacity = static_cast<u32>(g_stats.history.size());
+	if (capacity > 0)
+	{
+		g_stats.history[g_stats.head] = frame;
+		g_stats.head = (g_stats.head + 1) % capacity;
+		if (g_stats.count < capacity)
+			++g_stats.count;
+	}
+
+	// Resources carry over, everything else counts from zero again
+	gfx_frame_stats_t next{};
+	next.frame = frame.frame + 1;
+	next.shaders = frame.shaders;
+	next.buffers = frame.buffers;
+	next.textures = frame.textures;
+	next.framebuffers = frame.framebuffers;
+	next.pipelines = frame.pipelines;
+	next.resource_sets = frame.resource_sets;
+	g_stats.current = next;
+}
+
+bx::gfx_frame_stats_t& bx::gfx_stats() noexcept
+{
+	return g_stats.current;
+}
+
+void bx::gfx_stats_shader_compiled(u64 ns) noexcept
+{
+	g_stats.compile_ns.fetch_add(ns, std::memory_order_relaxed);
+	g_stats.compiles.fetch_add(1, std::memory_order_relaxed);
+}
+
+const bx::gfx_frame_stats_t& bx::gfx_get_frame_stats() noexcept
+{
+	return g_stats.last;
+}
+
+u32 bx::gfx_get_frame_stats_history(gfx_frame_stats_t* stats, u32 count) noexcept
+{
+	if (!stats)
+		return 0;
+
+	const u32 capacity = static_cast<u32>(g_stats.history.size());
+	const u32 copied = count < g_stats.count ? count : g_stats.count;
+	u32 index = (g_stats.head + capacity - copied) % (capacity ? capacity : 1);
+	for (u32 i = 0; i < copied; ++i)
+	{
+		stats[i] = g_stats.history[index];
+		index = (index + 1) % capacity;
+	}
+	return copied;
+}
+
+#ifdef BX_APP_IMGUI
+
+// Reads the ring in place, oldest first
+template <typename F>
+static f32 gfx_stats_plot_value(vptr data, int idx)
+{
+	const u32 capacity = static_cast<u32>(g_stats.history.size());
+	const u32 index = (g_stats.head + capacity - g_stats.count + static_cast<u32>(idx)) % capacity;
+	return (*static_cast<F*>(data))(g_stats.history[index]);
+}
+
+template <typename F>
+static void gfx_stats_plot(cstring label, F value, cstring format, f32 scale = 1.0f)
+{
+	const f32 latest = value(g_stats.last) * scale;
+	char overlay[64];
+	std::snprintf(overlay, sizeof(overlay), format, latest);
+
+	auto scaled = [&](const bx::gfx_frame_stats_t& frame) { return value(frame) * scale; };
+	ImGui::PlotLines(label, gfx_stats_plot_value<decltype(scaled)>, &scaled,
+		static_cast<int>(g_stats.count), 0, overlay, 0.0f, FLT_MAX, ImVec2(0, 48));
+}
+
+static void gfx_stats_resource_row(cstring name, const bx::gfx_resource_stats_t& resource)
+{
+	ImGui::TableNextRow();
+	ImGui::TableNextColumn();
+	ImGui::TextUnformatted(name);
+	ImGui::TableNextColumn();
+	ImGui::Text("%u", resource.count);
+	ImGui::TableNextColumn();
+	ImGui::Text("%.2f MB", static_cast<f64>(resource.bytes) / (1024.0 * 1024.0));
+}
+
+void bx::gfx_stats_overlay(bool* open) noexcept
+{
+	bx_profile(bx);
+
+	ImGui::SetNextWindowSize(ImVec2(360, 0), ImGuiCond_FirstUseEver);
+	if (!ImGui::Begin("gfx stats", open))
+	{
+		ImGui::End();
+		return;
+	}
+
+	if (g_stats.count > 0)
+	{
+		using frame_t = const gfx_frame_stats_t&;
+		gfx_stats_plot("frame", [](frame_t f) { return static_cast<f32>(f.frame_time); }, "%.2f ms", 1000.0f);
+		gfx_stats_plot("draws", [](frame_t f) { return static_cast<f32>(f.draws); }, "%.0f");
+		gfx_stats_plot("dispatches", [](frame_t f) { return static_cast<f32>(f.dispatches); }, "%.0f");
+		gfx_stats_plot("binds", [](frame_t f) { return static_cast<f32>(f.pipeline_binds + f.buffer_binds); }, "%.0f");
+		gfx_stats_plot("redundant", [](frame_t f) { return static_cast<f32>(f.redundant_binds); }, "%.0f");
+		gfx_stats_plot("uploads", [](frame_t f) { return static_cast<f32>(f.upload_bytes); }, "%.1f KB", 1.0f / 1024.0f);
+		gfx_stats_plot("compile", [](frame_t f) { return static_cast<f32>(f.shader_compile_time); }, "%.2f ms", 1000.0f);
+	}
+
+	if (ImGui::BeginTable("resources", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp))
+	{
+		const gfx_frame_stats_t& frame = g_stats.last;
+		gfx_stats_resource_row("shaders", frame.shaders);
+		gfx_stats_resource_row("buffers", frame.buffers);
+		gfx_stats_resource_row("textures", frame.textures);
+		gfx_stats_resource_row("framebuffers", frame.framebuffers);
+		gfx_stats_resource_row("pipelines", frame.pipelines);
+		gfx_stats_resource_row("resource sets", frame.resource_sets);
+		ImGui::EndTable();
+	}
+
+	ImGui::End();
+}
+
+#endif // BX_APP_IMGUI
@@ -0,0 +1,591 @@
+#include <bx_app_impl.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+// Texture streaming on top of the public gfx API. Workers decode mips straight
+// into mapped staging buffers, the graphics thread uploads them within the
+// frame budget and trims the least recently used textures when over budget.
+
+#define BX_GFX_STREAM_WORKERS 2
+#define BX_GFX_STREAM_STAGING_ALIGN (64 * 1024)
+
+struct stream_texture_t
+{
+	bx::gfx_texture_desc_t desc{};
+	bx::gfx_stream_load_fn load{ nullptr };
+	vptr user{ nullptr };
+	u64 file{ 0 };			// path hash of desc.filepath, 0 when not watched
+	u32 generation{ 0 };	// bumped by reloads, older mips in flight are dropped
+
+	u32 storage_mip{ 0 };	// finest mip with storage
+	u32 loaded_mip{ 0 };	// finest uploaded mip, mip_levels when none
+	u32 wanted_mip{ 0 };
+	u64 resident_bytes{ 0 };
+	u64 last_used{ 0 };
+
+	// One mip in flight per texture keeps the uploads coarse to fine
+	bool loading{ false };
+};
+
+struct stream_staging_t
+{
+	bx::handle_id buffer{ bx::invalid_handle };
+	u64 size{ 0 };
+	u64 free_frame{ 0 };	// the GPU may read it until this frame, 0 while a worker writes
+	bool busy{ false };
+	bool mapped{ false };	// from issue until the upload, shutdown unmaps the rest
+};
+
+struct stream_job_t
+{
+	bx::handle_id texture;
+	u32 mip;
+	u32 staging;
+	u8* dst;
+	u64 size;
+	bx::gfx_stream_load_fn load;
+	vptr user;
+	u32 generation;
+	bool ok;
+};
+
+// Shared with the workers, everything else is graphics thread only
+struct stream_queue_t
+{
+	std::mutex mutex{};
+	std::condition_variable wake{};
+	std::deque<stream_job_t> queued{};		// highest priority in front
+	bx::array<stream_job_t> decoded{};
+	bool running{ false };
+	std::thread workers[BX_GFX_STREAM_WORKERS]{};
+};
+
+static stream_queue_t g_queue{};
+
+static bx::hash_map<bx::handle_id, stream_texture_t> g_textures{};
+static bx::array<stream_staging_t> g_staging{};
+static bx::array<stream_job_t> g_ready{};
+
+struct stream_candidate_t
+{
+	bx::handle_id handle;
+	stream_texture_t* texture;
+};
+
+static bx::array<stream_candidate_t> g_candidates{};
+
+static bx::gfx_stream_budget_t g_budget{};
+static bx::gfx_stream_stats_t g_stats{};
+static u64 g_frame = 1;
+
+static bx::handle_id g_file_watch = bx::invalid_handle;
+
+static u32 stream_extent(const u32 extent, const u32 mip)
+{
+	const u32 value = extent >> mip;
+	return value > 0 ? value : 1;
+}
+
+static u32 stream_layers(const bx::gfx_texture_desc_t& desc)
+{
+	return desc.type == bx::gfx_texture_type_t::TEX_CUBE ? 6 : 1;
+}
+
+static void stream_worker() noexcept
+{
+	std::unique_lock<std::mutex> lock(g_queue.mutex);
+	for (;;)
+	{
+		g_queue.wake.wait(lock, [] { return !g_queue.running || !g_queue.queued.empty(); });
+		if (!g_queue.running)
+			return;
+
+		stream_job_t job = g_queue.queued.front();
+		g_queue.queued.pop_front();
+
+		lock.unlock();
+		job.ok = job.load(job.user, job.mip, job.dst, job.size);
+		lock.lock();
+
+		g_queue.decoded.push_back(job);
+	}
+}
+
+static void stream_start_workers() noexcept
+{
+	std::lock_guard<std::mutex> lock(g_queue.mutex);
+	if (g_queue.running)
+		return;
+
+	g_queue.running = true;
+	for (auto& worker : g_queue.workers)
+		worker = std::thread(stream_worker);
+}
+
+// Smallest free buffer that fits, a new one when none does
+static u32 stream_acquire_staging(const u64 size) noexcept
+{
+	u32 best = static_cast<u32>(g_staging.size());
+	for (u32 i = 0; i < g_staging.size(); ++i)
+	{
+		const stream_staging_t& staging = g_staging[i];
+		if (staging.busy || staging.size < size)
+			continue;
+		if (best == g_staging.size() || staging.size < g_staging[best].size)
+			best = i;
+	}
+
+	if (best == g_staging.size())
+	{
+		bx::gfx_buffer_desc_t desc{};
+		desc.name = "bx_stream_staging";
+		desc.usage = bx::gfx_buffer_usage_t::STAGING;
+		desc.memory_usage = bx::gfx_memory_usage_t::CPU_TO_GPU;
+		desc.size = bx::align_up(size, BX_GFX_STREAM_STAGING_ALIGN);
+
+		stream_staging_t staging{};
+		staging.buffer = bx::gfx_create_buffer(desc);
+		staging.size = desc.size;
+		if (staging.buffer == bx::invalid_handle)
+			return static_cast<u32>(-1);
+
+		g_staging.push_back(staging);
+		if (g_staging.size() == best)
+		{
+			bx::gfx_destroy_buffer(staging.buffer);
+			return static_cast<u32>(-1);
+		}
+	}
+
+	g_staging[best].busy = true;
+	g_staging[best].free_frame = 0;
+	return best;
+}
+
+static u64 stream_staging_in_flight() noexcept
+{
+	u64 bytes = 0;
+	for (const auto& staging : g_staging)
+	{
+		if (staging.busy)
+			bytes += staging.size;
+	}
+	return bytes;
+}
+
+// BC textures the device can't sample are decoded on the CPU straight from the
+// staging buffer, which is only possible while it stays mapped
+static bool stream_can_copy(const bx::gfx_texture_desc_t& desc) noexcept
+{
+	const bx::gfx_info_t::features_t& features = bx::gfx_get_info().features;
+	if (features.supports_bc || features.supports_persistent_mapping)
+		return true;
+
+	switch (desc.format)
+	{
+	case bx::gfx_texture_format_t::BC1U_NORM:
+	case bx::gfx_texture_format_t::BC3U_NORM:
+	case bx::gfx_texture_format_t::BC4U_NORM:
+	case bx::gfx_texture_format_t::BC5U_NORM:
+		return false;
+	default:
+		return true;
+	}
+}
+
+static bool stream_resize_storage(bx::handle_id handle, stream_texture_t& texture, const u32 first_mip) noexcept
+{
+	if (!bx::gfx_set_texture_resident_mips(handle, first_mip))
+		return false;
+
+	const u64 resident = bx::gfx_texture_storage_size(texture.desc, first_mip);
+	g_stats.resident_bytes = g_stats.resident_bytes - texture.resident_bytes + resident;
+	texture.resident_bytes = resident;
+	texture.storage_mip = first_mip;
+	return true;
+}
+
+static void stream_upload(const stream_job_t& job) noexcept
+{
+	bx_profile(bx);
+
+	stream_staging_t& staging = g_staging[job.staging];
+	bx::gfx_unmap_buffer(staging.buffer);
+	staging.mapped = false;
+	staging.free_frame = g_frame + BX_GFX_FRAMES_IN_FLIGHT;
+
+	// Released while loading
+	auto it = g_textures.find(job.texture);
+	if (it == g_textures.end())
+		return;
+
+	stream_texture_t& texture = it->second;
+	texture.loading = false;
+	--g_stats.loading;
+
+	if (!job.ok)
+	{
+		bx_warn(bx, "Streaming mip {} of texture '{}' failed to load", job.mip, texture.desc.name ? texture.desc.name : "unnamed");
+		texture.wanted_mip = texture.loaded_mip;
+		return;
+	}
+
+	if (!stream_can_copy(texture.desc))
+	{
+		bx_warn(bx, "Streaming mip {} of texture '{}' failed, its BC format is decoded on the CPU and staging buffers can't stay mapped",
+			job.mip, texture.desc.name ? texture.desc.name : "unnamed");
+		texture.wanted_mip = texture.loaded_mip;
+		return;
+	}
+
+	// Evicted or reloaded while loading, the chain has to grow back from the coarse end
+	if (job.mip + 1 != texture.loaded_mip || job.generation != texture.generation)
+		return;
+
+	if (job.mip < texture.storage_mip && !stream_resize_storage(job.texture, texture, job.mip))
+		return;
+
+	const bx::gfx_texture_desc_t& desc = texture.desc;
+	const u32 layers = stream_layers(desc);
+	const u64 layer_size = job.size / layers;
+
+	bx::gfx_texture_region_t regions[6]{};
+	for (u32 layer = 0; layer < layers; ++layer)
+	{
+		bx::gfx_texture_region_t& region = regions[layer];
+		region.mip_level = static_cast<u8>(job.mip);
+		region.width = stream_extent(desc.width, job.mip);
+		region.height = stream_extent(desc.height, job.mip);
+		region.depth = desc.type == bx::gfx_texture_type_t::TEX3D ? stream_extent(desc.depth, job.mip) : 1;
+		region.layer = layer;
+		region.offset = layer * layer_size;
+	}
+
+	bx::gfx_copy_buffer_to_texture(bx::invalid_handle, staging.buffer, job.texture, layers, regions);
+	bx::gfx_set_texture_min_mip(job.texture, job.mip);
+
+	texture.loaded_mip = job.mip;
+	g_stats.uploaded_bytes += job.size;
+}
+
+// Drops the finest mip of textures not requested last frame, oldest first,
+// until at most target bytes are resident. False when nothing is left to drop.
+static bool stream_evict(const u64 target) noexcept
+{
+	bx_profile(bx);
+
+	if (!bx::gfx_get_info().features.supports_copy_image)
+		return g_stats.resident_bytes <= target;
+
+	while (g_stats.resident_bytes > target)
+	{
+		bx::handle_id victim_handle = bx::invalid_handle;
+		stream_texture_t* victim = nullptr;
+		for (auto& entry : g_textures)
+		{
+			stream_texture_t& texture = entry.second;
+			if (texture.loading || texture.last_used + 1 >= g_frame || texture.storage_mip + 1 >= texture.desc.mip_levels)
+				continue;
+			if (!victim || texture.last_used < victim->last_used)
+			{
+				victim = &texture;
+				victim_handle = entry.first;
+			}
+		}
+
+		if (!victim)
+			return false;
+
+		const u32 first_mip = victim->storage_mip + 1;
+		if (victim->loaded_mip < first_mip)
+		{
+			bx::gfx_set_texture_min_mip(victim_handle, first_mip);
+			victim->loaded_mip = first_mip;
+		}
+		if (victim->wanted_mip < first_mip)
+			victim->wanted_mip = first_mip;
+
+		if (!stream_resize_storage(victim_handle, *victim, first_mip))
+			return false;
+
+		++g_stats.evicted_mips;
+	}
+	return true;
+}
+
+// Changed textures stream in again coarse to fine over the storage they have,
+// a mip still loading from the old file is dropped when it arrives
+static void stream_reload_files(vptr user, bx::array_view<cstring> paths)
+{
+	bx_profile(bx);
+
+	(void)user;
+
+	for (const cstring path : paths)
+	{
+		const u64 hash = bx::hash_bytes(path, std::strlen(path));
+		for (auto& entry : g_textures)
+		{
+			stream_texture_t& texture = entry.second;
+			if (texture.file != hash)
+				continue;
+
+			const u32 coarsest = texture.desc.mip_levels - 1u;
+			texture.loaded_mip = texture.desc.mip_levels;
+			++texture.generation;
+			if (texture.wanted_mip > coarsest)
+				texture.wanted_mip = coarsest;
+		}
+	}
+}
+
+static void stream_issue_jobs() noexcept
+{
+	bx_profile(bx);
+
+	g_candidates.clear();
+	for (auto& entry : g_textures)
+	{
+		stream_texture_t& texture = entry.second;
+		if (!texture.loading && texture.loaded_mip > texture.wanted_mip)
+			g_candidates.push_back(stream_candidate_t{ entry.first, &texture });
+	}
+
+	if (g_candidates.empty())
+		return;
+
+	// Coarse mips of every texture first, then the most recently requested
+	std::sort(g_candidates.begin(), g_candidates.end(), [](const stream_candidate_t& a, const stream_candidate_t& b)
+		{
+			if (a.texture->loaded_mip != b.texture->loaded_mip)
+				return a.texture->loaded_mip > b.texture->loaded_mip;
+			return a.texture->last_used > b.texture->last_used;
+		});
+
+	u64 staging_bytes = stream_staging_in_flight();
+	u64 reserved_bytes = 0;	// storage growth of the mips issued below
+	bool issued = false;
+
+	std::unique_lock<std::mutex> lock(g_queue.mutex, std::defer_lock);
+	for (const auto& candidate : g_candidates)
+	{
+		stream_texture_t* texture = candidate.texture;
+
+		// Trimmed to make room for an earlier candidate
+		if (texture->loaded_mip <= texture->wanted_mip)
+			continue;
+
+		const u32 mip = texture->loaded_mip - 1;
+		const u64 size = bx::gfx_texture_mip_size(texture->desc, mip);
+
+		if (staging_bytes > 0 && staging_bytes + size > g_budget.staging_bytes)
+			break;
+
+		if (mip < texture->storage_mip)
+		{
+			const u64 needed = reserved_bytes + size;
+			if (needed > g_budget.resident_bytes || !stream_evict(g_budget.resident_bytes - needed))
+				continue;
+			reserved_bytes += size;
+		}
+
+		const u32 staging = stream_acquire_staging(size);
+		if (staging == static_cast<u32>(-1))
+			break;
+
+		u8* dst = bx::gfx_map_buffer(g_staging[staging].buffer, 0, size);
+		if (!dst)
+		{
+			g_staging[staging].busy = false;
+			break;
+		}
+		g_staging[staging].mapped = true;
+
+		staging_bytes += g_staging[staging].size;
+		texture->loading = true;
+		++g_stats.loading;
+
+		// Candidates come in priority order, workers take from the front
+		lock.lock();
+		g_queue.queued.push_back(stream_job_t{ candidate.handle, mip, staging, dst, size, texture->load, texture->user, texture->generation, false });
+		lock.unlock();
+		issued = true;
+	}
+
+	if (issued)
+		g_queue.wake.notify_all();
+}
+
+void bx::gfx_stream_update() noexcept
+{
+	bx_profile(bx);
+
+	++g_frame;
+	g_stats.uploaded_bytes = 0;
+
+	for (auto& staging : g_staging)
+	{
+		if (staging.busy && staging.free_frame != 0 && staging.free_frame <= g_frame)
+			staging.busy = false;
+	}
+
+	if (g_textures.size() == 0 && g_ready.empty())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(g_queue.mutex);
+		for (const auto& job : g_queue.decoded)
+			g_ready.push_back(job);
+		g_queue.decoded.clear();
+	}
+
+	// In completion order, at least one mip per frame so large mips get through
+	usize uploaded = 0;
+	for (; uploaded < g_ready.size(); ++uploaded)
+	{
+		const stream_job_t& job = g_ready[uploaded];
+		if (g_stats.uploaded_bytes > 0 && g_stats.uploaded_bytes + job.size > g_budget.upload_bytes_per_frame)
+			break;
+		stream_upload(job);
+	}
+
+	if (uploaded > 0)
+	{
+		std::move(g_ready.begin() + uploaded, g_ready.end(), g_ready.begin());
+		g_ready.resize(g_ready.size() - uploaded);
+	}
+
+	stream_evict(g_budget.resident_bytes);
+
+	stream_issue_jobs();
+}
+
+void bx::gfx_stream_shutdown() noexcept
+{
+	bx_profile(bx);
+
+	{
+		std::lock_guard<std::mutex> lock(g_queue.mutex);
+		g_queue.running = false;
+	}
+	g_queue.wake.notify_all();
+
+	for (auto& worker : g_queue.workers)
+	{
+		if (worker.joinable())
+			worker.join();
+	}
+
+	file_watch_unsubscribe(g_file_watch);
+	g_file_watch = invalid_handle;
+
+	for (const auto& entry : g_textures)
+		gfx_destroy_texture(entry.first);
+
+	for (const auto& staging : g_staging)
+	{
+		if (staging.mapped)
+			gfx_unmap_buffer(staging.buffer);
+		gfx_destroy_buffer(staging.buffer);
+	}
+
+	std::deque<stream_job_t>().swap(g_queue.queued);
+	g_queue.decoded = bx::array<stream_job_t>{};
+	g_textures.clear();
+	g_staging = bx::array<stream_staging_t>{};
+	g_ready = bx::array<stream_job_t>{};
+	g_candidates = bx::array<stream_candidate_t>{};
+	g_stats = gfx_stream_stats_t{};
+}
+
+bx::handle_id bx::gfx_stream_texture(const gfx_stream_texture_desc_t& desc) noexcept
+{
+	bx_profile(bx);
+
+	if (!desc.load || desc.texture.mip_levels == 0)
+	{
+		bx_error(bx, "gfx_stream_texture: a load callback and at least one mip are required");
+		return invalid_handle;
+	}
+
+	// Without copies between textures the storage can't shrink, allocate it all
+	const bool resizable = gfx_get_info().features.supports_copy_image;
+	const u32 coarsest = desc.texture.mip_levels - 1u;
+
+	stream_texture_t texture{};
+	texture.desc = desc.texture;
+	texture.desc.first_mip = static_cast<u8>(resizable ? coarsest : 0);
+	texture.load = desc.load;
+	texture.user = desc.user;
+	texture.file = desc.filepath ? hash_bytes(desc.filepath, std::strlen(desc.filepath)) : 0;
+	texture.storage_mip = texture.desc.first_mip;
+	texture.loaded_mip = desc.texture.mip_levels;
+	texture.wanted_mip = coarsest;
+	texture.resident_bytes = bx::gfx_texture_storage_size(texture.desc, texture.storage_mip);
+	texture.last_used = g_frame;
+
+	const handle_id handle = gfx_create_texture(texture.desc);
+	if (handle == invalid_handle)
+		return invalid_handle;
+
+	if (g_textures.insert(handle, texture) == g_textures.end())
+	{
+		gfx_destroy_texture(handle);
+		return invalid_handle;
+	}
+
+	gfx_set_texture_min_mip(handle, coarsest);
+	g_stats.resident_bytes += texture.resident_bytes;
+
+	if (desc.filepath && g_file_watch == invalid_handle)
+		g_file_watch = file_watch_subscribe(stream_reload_files, nullptr);
+
+	stream_start_workers();
+	return handle;
+}
+
+void bx::gfx_stream_release(handle_id texture) noexcept
+{
+	bx_profile(bx);
+
+	auto it = g_textures.find(texture);
+	if (it == g_textures.end())
+		return;
+
+	g_stats.resident_bytes -= it->second.resident_bytes;
+	if (it->second.loading)
+		--g_stats.loading;
+
+	// A mip still loading finds the texture gone and only frees its staging buffer
+	g_textures.erase(texture);
+	gfx_destroy_texture(texture);
+}
+
+void bx::gfx_stream_request(handle_id texture, u32 mip) noexcept
+{
+	auto it = g_textures.find(texture);
+	if (it == g_textures.end())
+		return;
+
+	stream_texture_t& entry = it->second;
+	const u32 coarsest = entry.desc.mip_levels - 1u;
+	if (mip > coarsest)
+		mip = coarsest;
+	entry.wanted_mip = mip;
+	entry.last_used = g_frame;
+}
+
+void bx::gfx_stream_set_budget(const gfx_stream_budget_t& budget) noexcept
+{
+	g_budget = budget;
+}
+
+bx::gfx_stream_stats_t bx::gfx_stream_get_stats() noexcept
+{
+	return g_stats;
+}
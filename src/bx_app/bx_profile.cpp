@@ -0,0 +1,669 @@
+#include <bx_app_impl.hpp>
+
+#include <chrono>
+#include <atomic>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#ifndef BX_PROFILE_CAPACITY
+#define BX_PROFILE_CAPACITY (1u << 14) // entries per thread, power of two
+#endif
+#define BX_PROFILE_MAX_DEPTH 256
+#define BX_PROFILE_MAX_THREADS 64
+
+static_assert((BX_PROFILE_CAPACITY & (BX_PROFILE_CAPACITY - 1)) == 0, "BX_PROFILE_CAPACITY must be a power of two");
+
+// Ring of the most recent entries recorded by one thread. Only the owning
+// thread writes, head is published with release so readers can merge.
+// End timestamps live in a separate atomic array since they are patched
+// after the entry has been published. Rings outlive their thread, the next
+// thread to register takes over a released one and keeps appending to it.
+struct profile_thread_t
+{
+	bx::profile_entry_t entries[BX_PROFILE_CAPACITY];
+	std::atomic<u64> end_ts[BX_PROFILE_CAPACITY];
+	std::atomic<u64> head{ 0 };
+	std::atomic<bool> in_use{ true };
+	u32 thread_id{ 0 };
+};
+
+static std::atomic<bool> g_profiling{ false };
+static std::atomic<u64> g_profile_start_ts{ 0 };
+static std::atomic<u32> g_profile_thread_count{ 0 };
+static std::atomic<profile_thread_t*> g_profile_threads[BX_PROFILE_MAX_THREADS];
+static bx::array<bx::profile_entry_t> g_profile_merged{};
+
+static constexpr u64 g_profile_no_slot = ~0ull;
+static thread_local profile_thread_t* t_profile_thread = nullptr;
+static thread_local bool t_profile_registered = false;
+static thread_local u32 t_profile_depth = 0;
+static thread_local cstring t_profile_stack[BX_PROFILE_MAX_DEPTH];
+static thread_local u64 t_profile_slots[BX_PROFILE_MAX_DEPTH];
+
+// Hands the ring back when its thread exits
+struct profile_thread_owner_t
+{
+	profile_thread_t* thread{ nullptr };
+
+	~profile_thread_owner_t() noexcept
+	{
+		if (!thread)
+			return;
+		t_profile_thread = nullptr;
+		thread->in_use.store(false, std::memory_order_release);
+	}
+};
+
+static thread_local profile_thread_owner_t t_profile_owner;
+
+// Not profiled, the profiler itself stamps every scope with it
+static u64 profile_timestamp_ns() noexcept
+{
+	auto now = std::chrono::steady_clock::now();
+	auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch());
+	return static_cast<u64>(ns.count());
+}
+
+static profile_thread_t* profile_claim_thread() noexcept
+{
+	// A ring released by a thread that exited
+	u32 count = g_profile_thread_count.load(std::memory_order_acquire);
+	if (count > BX_PROFILE_MAX_THREADS)
+		count = BX_PROFILE_MAX_THREADS;
+	for (u32 i = 0; i < count; ++i)
+	{
+		profile_thread_t* thread = g_profile_threads[i].load(std::memory_order_acquire);
+		bool in_use = false;
+		if (thread && thread->in_use.compare_exchange_strong(in_use, true, std::memory_order_acquire))
+			return thread;
+	}
+
+	const u32 index = g_profile_thread_count.fetch_add(1, std::memory_order_relaxed);
+	if (index >= BX_PROFILE_MAX_THREADS)
+		return nullptr;
+
+	profile_thread_t* thread = new (std::nothrow) profile_thread_t();
+	if (!thread)
+		return nullptr;
+
+	thread->thread_id = index + 1;
+	g_profile_threads[index].store(thread, std::memory_order_release);
+	return thread;
+}
+
+// Registers the calling thread on first use, nullptr when all slots were taken
+static profile_thread_t* profile_thread() noexcept
+{
+	if (t_profile_registered)
+		return t_profile_thread;
+	t_profile_registered = true;
+
+	t_profile_thread = profile_claim_thread();
+	t_profile_owner.thread = t_profile_thread;
+	return t_profile_thread;
+}
+
+// Entry i shares its slot with entry i + capacity, which the owner writes
+// before publishing head past it. Readers only trust i while head - i < capacity.
+static bool profile_slot_reused(u64 head, u64 i) noexcept
+{
+	return head - i >= BX_PROFILE_CAPACITY;
+}
+
+// Checked after copying entry i, true when the owner has since overwritten it
+static bool profile_lapped(const profile_thread_t& thread, u64 i) noexcept
+{
+	std::atomic_thread_fence(std::memory_order_acquire);
+	return profile_slot_reused(thread.head.load(std::memory_order_relaxed), i);
+}
+
+void bx::profile_start() noexcept
+{
+	bx_profile(bx);
+
+	g_profile_start_ts.store(profile_timestamp_ns(), std::memory_order_release);
+	g_profiling.store(true, std::memory_order_relaxed);
+}
+
+void bx::profile_stop() noexcept
+{
+	bx_profile(bx);
+
+	g_profiling.store(false, std::memory_order_relaxed);
+}
+
+bx::array_view<bx::profile_entry_t> bx::profile_get_entries() noexcept
+{
+	// Scopes still open on other threads show up with end_ts == 0
+	const u64 since = g_profile_start_ts.load(std::memory_order_acquire);
+	u32 thread_count = g_profile_thread_count.load(std::memory_order_acquire);
+	if (thread_count > BX_PROFILE_MAX_THREADS)
+		thread_count = BX_PROFILE_MAX_THREADS;
+
+	g_profile_merged.clear();
+	for (u32 t = 0; t < thread_count; ++t)
+	{
+		const profile_thread_t* thread = g_profile_threads[t].load(std::memory_order_acquire);
+		if (!thread)
+			continue;
+
+		const u64 head = thread->head.load(std::memory_order_acquire);
+		const u64 first = head >= BX_PROFILE_CAPACITY ? head - BX_PROFILE_CAPACITY + 1 : 0;
+		if (!g_profile_merged.reserve(g_profile_merged.size() + static_cast<usize>(head - first)))
+			break;
+
+		for (u64 i = first; i < head; ++i)
+		{
+			profile_entry_t entry = thread->entries[i & (BX_PROFILE_CAPACITY - 1)];
+			entry.end_ts = thread->end_ts[i & (BX_PROFILE_CAPACITY - 1)].load(std::memory_order_acquire);
+
+			// The owner may have lapped the ring while the entry was copied
+			if (profile_lapped(*thread, i))
+				continue;
+
+			if (entry.start_ts >= since)
+				g_profile_merged.push_back(entry);
+		}
+	}
+
+	// Each ring is already in start order, parents sort before children starting on the same tick
+	std::sort(g_profile_merged.begin(), g_profile_merged.end(),
+		[](const profile_entry_t& a, const profile_entry_t& b)
+		{
+			return a.start_ts != b.start_ts ? a.start_ts < b.start_ts : a.depth < b.depth;
+		});
+
+	return { g_profile_merged.data(), g_profile_merged.size() };
+}
+
+void bx::profile_push(u64 category, cstring label, cstring func, cstring file, i32 line) noexcept
+{
+	const u32 depth = t_profile_depth++;
+	if (depth >= BX_PROFILE_MAX_DEPTH)
+		return;
+
+	t_profile_stack[depth] = func;
+	t_profile_slots[depth] = g_profile_no_slot;
+
+	if (!g_profiling.load(std::memory_order_relaxed))
+		return;
+
+	profile_thread_t* thread = profile_thread();
+	if (!thread)
+		return;
+
+	const u64 head = thread->head.load(std::memory_order_relaxed);
+	profile_entry_t& entry = thread->entries[head & (BX_PROFILE_CAPACITY - 1)];
+	entry.category = category;
+	entry.depth = depth;
+	entry.thread_id = thread->thread_id;
+	entry.start_ts = profile_timestamp_ns();
+	entry.end_ts = 0;
+	entry.label = label;
+	entry.file = file;
+	entry.line = line;
+	thread->end_ts[head & (BX_PROFILE_CAPACITY - 1)].store(0, std::memory_order_relaxed);
+
+	thread->head.store(head + 1, std::memory_order_release);
+	t_profile_slots[depth] = head;
+}
+
+void bx::profile_pop() noexcept
+{
+	if (t_profile_depth == 0)
+		return;
+
+	const u32 depth = --t_profile_depth;
+	if (depth >= BX_PROFILE_MAX_DEPTH)
+		return;
+
+	// Close the entry this scope opened, not whatever was recorded last
+	const u64 slot = t_profile_slots[depth];
+	if (slot == g_profile_no_slot)
+		return;
+
+	profile_thread_t* thread = t_profile_thread;
+	if (!thread)
+		return; // released, the thread is exiting
+
+	if (profile_slot_reused(thread->head.load(std::memory_order_relaxed), slot))
+		return; // overwritten by the ring while the scope was open
+
+	thread->end_ts[slot & (BX_PROFILE_CAPACITY - 1)].store(profile_timestamp_ns(), std::memory_order_release);
+}
+
+bx_api bx::array_view<cstring> bx::profile_get_stack() noexcept
+{
+	const u32 depth = t_profile_depth < BX_PROFILE_MAX_DEPTH ? t_profile_depth : BX_PROFILE_MAX_DEPTH;
+	return { t_profile_stack, depth };
+}
+
+// ------------------------------------------
+// -            Capture export              -
+// ------------------------------------------
+
+#define BX_PROFILE_EXPORT_CHUNK (64 * 1024)
+#define BX_PROFILE_EXPORT_MAX_STRING 255
+
+struct profile_export_t
+{
+	std::FILE* file{ nullptr };
+	bx::profile_format_t format{ bx::profile_format_t::CHROME_JSON };
+	u64 base_ts{ 0 };
+	u64 dropped{ 0 };
+	bool first_event{ true };
+	bool failed{ false };
+
+	// Per thread read position, plus scopes that were still open when read
+	u64 cursors[BX_PROFILE_MAX_THREADS]{};
+	bool described[BX_PROFILE_MAX_THREADS]{};
+	u64 pending[BX_PROFILE_MAX_THREADS][BX_PROFILE_MAX_DEPTH];
+	u32 pending_count[BX_PROFILE_MAX_THREADS]{};
+
+	usize chunk_size{ 0 };
+	u8 chunk[BX_PROFILE_EXPORT_CHUNK];
+};
+
+static profile_export_t* g_profile_export = nullptr;
+
+static void export_flush_chunk(profile_export_t& ex) noexcept
+{
+	if (ex.chunk_size > 0 && std::fwrite(ex.chunk, 1, ex.chunk_size, ex.file) != ex.chunk_size)
+		ex.failed = true;
+	ex.chunk_size = 0;
+}
+
+static void export_write(profile_export_t& ex, cvptr data, usize size) noexcept
+{
+	if (ex.chunk_size + size > BX_PROFILE_EXPORT_CHUNK)
+		export_flush_chunk(ex);
+
+	if (size > BX_PROFILE_EXPORT_CHUNK)
+	{
+		if (std::fwrite(data, 1, size, ex.file) != size)
+			ex.failed = true;
+		return;
+	}
+
+	std::memcpy(ex.chunk + ex.chunk_size, data, size);
+	ex.chunk_size += size;
+}
+
+// Chrome Trace Event JSON, one "X" (complete) event per scope
+
+using json_line_t = bx::string_fixed<1024>;
+
+static void json_append_string(json_line_t& line, cstring str) noexcept
+{
+	line.push_back('"');
+	usize count = 0;
+	for (cstring c = str ? str : ""; *c && count < BX_PROFILE_EXPORT_MAX_STRING; ++c, ++count)
+	{
+		switch (*c)
+		{
+		case '"': line.append("\\\""); break;
+		case '\\': line.append("\\\\"); break;
+		case '\n': line.append("\\n"); break;
+		case '\t': line.append("\\t"); break;
+		default:
+			if (static_cast<uchar>(*c) < 0x20)
+				line.append_format("\\u%04x", static_cast<u32>(static_cast<uchar>(*c)));
+			else
+				line.push_back(*c);
+			break;
+		}
+	}
+	line.push_back('"');
+}
+
+static void json_append_us(json_line_t& line, u64 ns) noexcept
+{
+	line.append_format("%llu.%03llu", static_cast<unsigned long long>(ns / 1000), static_cast<unsigned long long>(ns % 1000));
+}
+
+static void json_write_event(profile_export_t& ex, const json_line_t& line) noexcept
+{
+	if (!ex.first_event)
+		export_write(ex, ",\n", 2);
+	ex.first_event = false;
+	export_write(ex, line.data(), line.size());
+}
+
+static void json_write_thread(profile_export_t& ex, u32 thread_id) noexcept
+{
+	json_line_t line;
+	line.format("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"thread %u\"}}", thread_id, thread_id);
+	json_write_event(ex, line);
+}
+
+static void json_write_entry(profile_export_t& ex, const bx::profile_entry_t& entry) noexcept
+{
+	json_line_t line;
+	line.append("{\"name\":");
+	json_append_string(line, entry.label);
+	line.append(",\"cat\":");
+	json_append_string(line, bx::category_name(entry.category));
+	line.append_format(",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":", entry.thread_id);
+	json_append_us(line, entry.start_ts - ex.base_ts);
+	line.append(",\"dur\":");
+	json_append_us(line, entry.end_ts - entry.start_ts);
+	line.append(",\"args\":{\"file\":");
+	json_append_string(line, entry.file);
+	line.append_format(",\"line\":%d}}", entry.line);
+	json_write_event(ex, line);
+}
+
+// Perfetto protobuf, see protos/perfetto/trace/trace_packet.proto and
+// track_event/track_event.proto. Every scope becomes a SLICE_BEGIN and a
+// SLICE_END packet on its thread track, the trace processor sorts them.
+
+struct pb_message_t
+{
+	u8 data[1024];
+	usize size{ 0 };
+};
+
+static void pb_raw(pb_message_t& msg, cvptr data, usize size) noexcept
+{
+	if (msg.size + size > sizeof(msg.data))
+		size = sizeof(msg.data) - msg.size;
+	std::memcpy(msg.data + msg.size, data, size);
+	msg.size += size;
+}
+
+static void pb_varint(pb_message_t& msg, u64 value) noexcept
+{
+	u8 bytes[10];
+	usize count = 0;
+	do
+	{
+		bytes[count] = static_cast<u8>(value & 0x7F);
+		value >>= 7;
+		if (value)
+			bytes[count] |= 0x80;
+		++count;
+	} while (value);
+	pb_raw(msg, bytes, count);
+}
+
+static void pb_uint(pb_message_t& msg, u32 field, u64 value) noexcept
+{
+	pb_varint(msg, (static_cast<u64>(field) << 3) | 0);
+	pb_varint(msg, value);
+}
+
+static void pb_bytes(pb_message_t& msg, u32 field, cvptr data, usize size) noexcept
+{
+	pb_varint(msg, (static_cast<u64>(field) << 3) | 2);
+	pb_varint(msg, size);
+	pb_raw(msg, data, size);
+}
+
+static void pb_string(pb_message_t& msg, u32 field, cstring str) noexcept
+{
+	str = str ? str : "";
+	const usize len = std::strlen(str);
+	pb_bytes(msg, field, str, len < BX_PROFILE_EXPORT_MAX_STRING ? len : BX_PROFILE_EXPORT_MAX_STRING);
+}
+
+static void pb_message(pb_message_t& msg, u32 field, const pb_message_t& sub) noexcept
+{
+	pb_bytes(msg, field, sub.data, sub.size);
+}
+
+enum : u32
+{
+	PB_TRACE_PACKET = 1,
+
+	PB_PACKET_TIMESTAMP = 8,
+	PB_PACKET_SEQUENCE_ID = 10,
+	PB_PACKET_TRACK_EVENT = 11,
+	PB_PACKET_SEQUENCE_FLAGS = 13,
+	PB_PACKET_TRACK_DESCRIPTOR = 60,
+
+	PB_TRACK_UUID = 1,
+	PB_TRACK_NAME = 2,
+	PB_TRACK_THREAD = 4,
+
+	PB_THREAD_PID = 1,
+	PB_THREAD_TID = 2,
+	PB_THREAD_NAME = 5,
+
+	PB_EVENT_TYPE = 9,
+	PB_EVENT_TRACK_UUID = 11,
+	PB_EVENT_CATEGORIES = 22,
+	PB_EVENT_NAME = 23,
+
+	PB_SLICE_BEGIN = 1,
+	PB_SLICE_END = 2,
+
+	PB_SEQUENCE_ID = 1,
+	PB_SEQ_INCREMENTAL_STATE_CLEARED = 1,
+};
+
+static u64 pb_track_uuid(u32 thread_id) noexcept
+{
+	return 0xB0000000ull + thread_id;
+}
+
+static void pb_write_packet(profile_export_t& ex, const pb_message_t& packet) noexcept
+{
+	pb_message_t header;
+	pb_varint(header, (static_cast<u64>(PB_TRACE_PACKET) << 3) | 2);
+	pb_varint(header, packet.size);
+	export_write(ex, header.data, header.size);
+	export_write(ex, packet.data, packet.size);
+}
+
+static void pb_write_thread(profile_export_t& ex, u32 thread_id) noexcept
+{
+	bx::string_fixed<32> name;
+	name.format("thread %u", thread_id);
+
+	pb_message_t thread;
+	pb_uint(thread, PB_THREAD_PID, 1);
+	pb_uint(thread, PB_THREAD_TID, thread_id);
+	pb_string(thread, PB_THREAD_NAME, name.c_str());
+
+	pb_message_t track;
+	pb_uint(track, PB_TRACK_UUID, pb_track_uuid(thread_id));
+	pb_string(track, PB_TRACK_NAME, name.c_str());
+	pb_message(track, PB_TRACK_THREAD, thread);
+
+	pb_message_t packet;
+	pb_uint(packet, PB_PACKET_SEQUENCE_ID, PB_SEQUENCE_ID);
+	if (ex.first_event)
+		pb_uint(packet, PB_PACKET_SEQUENCE_FLAGS, PB_SEQ_INCREMENTAL_STATE_CLEARED);
+	pb_message(packet, PB_PACKET_TRACK_DESCRIPTOR, track);
+	pb_write_packet(ex, packet);
+	ex.first_event = false;
+}
+
+static void pb_write_slice(profile_export_t& ex, u64 ts, u32 type, const bx::profile_entry_t& entry) noexcept
+{
+	pb_message_t event;
+	pb_uint(event, PB_EVENT_TYPE, type);
+	pb_uint(event, PB_EVENT_TRACK_UUID, pb_track_uuid(entry.thread_id));
+	if (type == PB_SLICE_BEGIN)
+	{
+		pb_string(event, PB_EVENT_CATEGORIES, bx::category_name(entry.category));
+		pb_string(event, PB_EVENT_NAME, entry.label);
+	}
+
+	pb_message_t packet;
+	pb_uint(packet, PB_PACKET_TIMESTAMP, ts);
+	pb_uint(packet, PB_PACKET_SEQUENCE_ID, PB_SEQUENCE_ID);
+	pb_message(packet, PB_PACKET_TRACK_EVENT, event);
+	pb_write_packet(ex, packet);
+}
+
+static void export_entry(profile_export_t& ex, const bx::profile_entry_t& entry) noexcept
+{
+	switch (ex.format)
+	{
+	case bx::profile_format_t::CHROME_JSON:
+		json_write_entry(ex, entry);
+		break;
+
+	case bx::profile_format_t::PERFETTO:
+		pb_write_slice(ex, entry.start_ts, PB_SLICE_BEGIN, entry);
+		pb_write_slice(ex, entry.end_ts, PB_SLICE_END, entry);
+		break;
+	}
+}
+
+static void export_thread(profile_export_t& ex, u32 t, const profile_thread_t& thread) noexcept
+{
+	if (!ex.described[t])
+	{
+		if (ex.format == bx::profile_format_t::PERFETTO)
+			pb_write_thread(ex, thread.thread_id);
+		else
+			json_write_thread(ex, thread.thread_id);
+		ex.described[t] = true;
+	}
+
+	const u64 head = thread.head.load(std::memory_order_acquire);
+
+	// Scopes that were open on an earlier flush
+	u32 kept = 0;
+	for (u32 p = 0; p < ex.pending_count[t]; ++p)
+	{
+		const u64 i = ex.pending[t][p];
+		if (profile_slot_reused(head, i))
+		{
+			++ex.dropped;
+			continue;
+		}
+
+		bx::profile_entry_t entry = thread.entries[i & (BX_PROFILE_CAPACITY - 1)];
+		entry.end_ts = thread.end_ts[i & (BX_PROFILE_CAPACITY - 1)].load(std::memory_order_acquire);
+		if (profile_lapped(thread, i))
+		{
+			++ex.dropped;
+			continue;
+		}
+
+		if (entry.end_ts == 0)
+			ex.pending[t][kept++] = i;
+		else
+			export_entry(ex, entry);
+	}
+	ex.pending_count[t] = kept;
+
+	u64 first = ex.cursors[t];
+	if (profile_slot_reused(head, first))
+	{
+		ex.dropped += head - BX_PROFILE_CAPACITY + 1 - first;
+		first = head - BX_PROFILE_CAPACITY + 1;
+	}
+
+	for (u64 i = first; i < head; ++i)
+	{
+		bx::profile_entry_t entry = thread.entries[i & (BX_PROFILE_CAPACITY - 1)];
+		entry.end_ts = thread.end_ts[i & (BX_PROFILE_CAPACITY - 1)].load(std::memory_order_acquire);
+
+		// The owner may have lapped the ring while the entry was copied
+		if (profile_lapped(thread, i))
+		{
+			++ex.dropped;
+			continue;
+		}
+
+		if (entry.start_ts < ex.base_ts)
+			continue;
+
+		if (entry.end_ts != 0)
+			export_entry(ex, entry);
+		else if (ex.pending_count[t] < BX_PROFILE_MAX_DEPTH)
+			ex.pending[t][ex.pending_count[t]++] = i;
+		else
+			++ex.dropped;
+	}
+	ex.cursors[t] = head;
+}
+
+bool bx::profile_export_begin(cstring filepath, profile_format_t format) noexcept
+{
+	if (g_profile_export || !filepath)
+		return false;
+
+	std::FILE* file = std::fopen(filepath, "wb");
+	if (!file)
+	{
+		bx_error(bx, "Failed to open profile export file {}", filepath);
+		return false;
+	}
+
+	profile_export_t* ex = new (std::nothrow) profile_export_t();
+	if (!ex)
+	{
+		std::fclose(file);
+		return false;
+	}
+
+	ex->file = file;
+	ex->format = format;
+	ex->base_ts = g_profile_start_ts.load(std::memory_order_acquire);
+	g_profile_export = ex;
+
+	if (format == profile_format_t::CHROME_JSON)
+	{
+		static const char header[] = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+		export_write(*ex, header, sizeof(header) - 1);
+	}
+	return true;
+}
+
+bool bx::profile_export_flush() noexcept
+{
+	profile_export_t* ex = g_profile_export;
+	if (!ex)
+		return false;
+
+	u32 thread_count = g_profile_thread_count.load(std::memory_order_acquire);
+	if (thread_count > BX_PROFILE_MAX_THREADS)
+		thread_count = BX_PROFILE_MAX_THREADS;
+
+	for (u32 t = 0; t < thread_count; ++t)
+	{
+		const profile_thread_t* thread = g_profile_threads[t].load(std::memory_order_acquire);
+		if (thread)
+			export_thread(*ex, t, *thread);
+	}
+	return !ex->failed;
+}
+
+bool bx::profile_export_end() noexcept
+{
+	profile_export_t* ex = g_profile_export;
+	if (!ex)
+		return false;
+
+	profile_export_flush();
+
+	if (ex->format == profile_format_t::CHROME_JSON)
+	{
+		static const char footer[] = "\n]}\n";
+		export_write(*ex, footer, sizeof(footer) - 1);
+	}
+	export_flush_chunk(*ex);
+
+	u64 open_scopes = 0;
+	for (u32 t = 0; t < BX_PROFILE_MAX_THREADS; ++t)
+		open_scopes += ex->pending_count[t];
+
+	if (ex->dropped > 0 || open_scopes > 0)
+		bx_warn(bx, "Profile export skipped {} overwritten and {} unfinished entries", ex->dropped, open_scopes);
+
+	const bool result = !ex->failed && std::fclose(ex->file) == 0;
+	delete ex;
+	g_profile_export = nullptr;
+	return result;
+}
+
+bool bx::profile_export(cstring filepath, profile_format_t format) noexcept
+{
+	return profile_export_begin(filepath, format) && profile_export_end();
+}
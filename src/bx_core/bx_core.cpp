@@ -1 +1,128 @@
 #include <bx/core.hpp>
+#include <bx/allocator.hpp>
+
+#include <cstdlib>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+// operator new[] only guarantees default_align, the aligned C allocations
+// take any power of two and are freed the same way whatever the alignment
+vptr bx::heap_allocator::allocate(usize size, usize align) noexcept
+{
+	if (!is_pow2(align))
+		return nullptr;
+	if (align < default_align)
+		align = default_align;
+
+	// Zero sized requests still return a unique pointer, as operator new[] did
+	if (size == 0)
+		size = 1;
+
+#ifdef _WIN32
+	return _aligned_malloc(size, align);
+#else
+	vptr ptr = nullptr;
+	return posix_memalign(&ptr, align, size) == 0 ? ptr : nullptr;
+#endif
+}
+
+void bx::heap_allocator::deallocate(vptr ptr, usize size) noexcept
+{
+	(void)size;
+#ifdef _WIN32
+	_aligned_free(ptr);
+#else
+	std::free(ptr);
+#endif
+}
+
+bx::linear_allocator::linear_allocator(vptr buffer, usize size) noexcept
+	: m_data(static_cast<u8*>(buffer))
+	, m_size(buffer ? size : 0)
+{
+}
+
+bx::linear_allocator::~linear_allocator() noexcept
+{
+	shutdown();
+}
+
+bool bx::linear_allocator::init(usize size) noexcept
+{
+	shutdown();
+
+	m_data = static_cast<u8*>(::operator new[](size, std::nothrow));
+	if (!m_data)
+		return false;
+
+	m_size = size;
+	m_owned = true;
+	return true;
+}
+
+void bx::linear_allocator::shutdown() noexcept
+{
+	if (m_owned)
+		::operator delete[](m_data, std::nothrow);
+
+	m_data = nullptr;
+	m_size = 0;
+	m_offset = 0;
+	m_last = 0;
+	m_peak = 0;
+	m_owned = false;
+}
+
+bx::pool_allocator::~pool_allocator() noexcept
+{
+	shutdown();
+}
+
+bool bx::pool_allocator::init(usize block_size, usize block_count, usize align) noexcept
+{
+	shutdown();
+
+	if (!is_pow2(align) || block_count == 0)
+		return false;
+
+	// Blocks hold the free list link while unused
+	if (align < alignof(node_t))
+		align = alignof(node_t);
+	block_size = align_up(block_size < sizeof(node_t) ? sizeof(node_t) : block_size, align);
+
+	// operator new[] only guarantees default_align, over allocate to realign
+	const usize padding = align > default_align ? align : 0;
+	m_data = static_cast<u8*>(::operator new[](block_size * block_count + padding, std::nothrow));
+	if (!m_data)
+		return false;
+
+	u8* blocks = reinterpret_cast<u8*>(align_up(reinterpret_cast<uptr>(m_data), align));
+	m_block_size = block_size;
+	m_block_count = block_count;
+	m_align = align;
+
+	m_free = nullptr;
+	for (usize i = block_count; i-- > 0; )
+	{
+		node_t* node = reinterpret_cast<node_t*>(blocks + i * block_size);
+		node->next = m_free;
+		m_free = node;
+	}
+	m_blocks = blocks;
+	return true;
+}
+
+void bx::pool_allocator::shutdown() noexcept
+{
+	::operator delete[](m_data, std::nothrow);
+
+	m_data = nullptr;
+	m_blocks = nullptr;
+	m_free = nullptr;
+	m_block_size = 0;
+	m_block_count = 0;
+	m_align = 0;
+	m_used = 0;
+}
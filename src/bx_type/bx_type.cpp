@@ -1,13 +1,13 @@
 #include <bx/type.hpp>
+#include <bx/hash_map.hpp>
 
 #include <iostream>
 #include <chrono>
 #include <atomic>
 #include <vector>
-#include <unordered_map>
 
 static bx::array<bx::type_t> g_types{};
-static std::unordered_map<bx::type_t, cstring> g_types_map{};
+static bx::hash_map<bx::type_t, cstring> g_types_map{};
 
 bx_register_type(u8)
 bx_register_type(u16)
@@ -26,16 +26,16 @@ bx::type_t bx::register_type(cstring name) noexcept
 	static type_t g_id{ 0 };
 	type_t next = g_id++;
 	g_types.emplace_back(next);
-	g_types_map.insert(std::make_pair(next, name));
+	g_types_map.insert(next, name);
 	return next;
 }
 
 cstring bx::type_name(type_t id) noexcept
 {
-	auto it = g_types_map.find(id);
-	if (it == g_types_map.end())
+	const auto name = g_types_map.get(id);
+	if (!name)
 		return "unknown";
-	return it->second;
+	return *name;
 }
 
 bx::array_view<bx::type_t> bx::get_types() noexcept
@@ -0,0 +1,208 @@
+#include <gtest/gtest.h>
+#include <bx/app.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace bx;
+
+//
+// File watcher and the stream reload it drives, against a temporary drive.
+// Only Linux has a watcher so far.
+//
+#ifdef __linux__
+
+static std::string g_root;
+
+static void write_file(const char* name, const char* content)
+{
+    const std::string path = g_root + "/" + name;
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    ASSERT_NE(file, nullptr) << path;
+    std::fwrite(content, 1, std::strlen(content), file);
+    std::fclose(file);
+}
+
+struct watch_calls_t
+{
+    std::vector<std::vector<std::string>> calls;
+};
+
+static void record_paths(vptr user, array_view<cstring> paths)
+{
+    std::vector<std::string> call;
+    for (const cstring path : paths)
+        call.emplace_back(path);
+    static_cast<watch_calls_t*>(user)->calls.push_back(call);
+}
+
+class file_watch : public ::testing::Test
+{
+protected:
+    // Drives can't be removed, the directory lives as long as the process
+    static void SetUpTestCase()
+    {
+        if (!g_root.empty())
+            return;
+
+        char root[] = "/tmp/bx_file_watch_XXXXXX";
+        ASSERT_NE(mkdtemp(root), nullptr);
+        g_root = root;
+        ASSERT_TRUE(file_add_drive("[watch_test]", g_root.c_str()));
+        std::atexit([] { std::system(("rm -rf " + g_root).c_str()); });
+    }
+
+    void SetUp() override
+    {
+        app_config_t config{};
+        config.width = 64;
+        config.height = 64;
+        config.title = "bx_tests";
+        config.watch_files = true;
+        ASSERT_EQ(app_init(config), result_t::OK);
+    }
+
+    void TearDown() override
+    {
+        app_shutdown();
+    }
+
+    // Runs frames for at least ms, or until done returns true
+    template <typename Fn>
+    static bool run_frames_for(u32 ms, Fn&& done)
+    {
+        const auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(ms);
+        while (std::chrono::steady_clock::now() < end)
+        {
+            app_begin_frame();
+            app_end_frame(true, false);
+            if (done())
+                return true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return false;
+    }
+};
+
+TEST_F(file_watch, reports_a_file_once_its_writes_settled)
+{
+    watch_calls_t watched;
+    const handle_id subscription = file_watch_subscribe(record_paths, &watched);
+    ASSERT_NE(subscription, invalid_handle);
+
+    // Writes closer together than the settle time, with frames in between
+    for (u32 i = 0; i < 4; ++i)
+    {
+        write_file("settle.txt", "settle");
+        run_frames_for(10, [] { return false; });
+    }
+
+    ASSERT_TRUE(run_frames_for(2000, [&] { return !watched.calls.empty(); }));
+    run_frames_for(200, [] { return false; });
+
+    ASSERT_EQ(watched.calls.size(), 1u);
+    ASSERT_EQ(watched.calls[0].size(), 1u);
+    EXPECT_EQ(watched.calls[0][0], "[watch_test]/settle.txt");
+    file_watch_unsubscribe(subscription);
+}
+
+struct resubscribe_t
+{
+    handle_id self{ invalid_handle };
+    handle_id other{ invalid_handle };
+    handle_id added{ invalid_handle };
+    watch_calls_t added_calls;
+    u32 calls{ 0 };
+};
+
+static void resubscribe(vptr user, array_view<cstring>)
+{
+    resubscribe_t& state = *static_cast<resubscribe_t*>(user);
+    ++state.calls;
+    file_watch_unsubscribe(state.self);
+    file_watch_unsubscribe(state.other);
+    state.added = file_watch_subscribe(record_paths, &state.added_calls);
+}
+
+TEST_F(file_watch, callbacks_may_subscribe_and_unsubscribe)
+{
+    resubscribe_t state;
+    watch_calls_t other_calls;
+    state.self = file_watch_subscribe(resubscribe, &state);
+    state.other = file_watch_subscribe(record_paths, &other_calls);
+
+    write_file("first.txt", "first");
+    ASSERT_TRUE(run_frames_for(2000, [&] { return state.calls > 0; }));
+
+    // The removed subscriber is skipped, the new one waits for the next change
+    EXPECT_EQ(state.calls, 1u);
+    EXPECT_TRUE(other_calls.calls.empty());
+    EXPECT_TRUE(state.added_calls.calls.empty());
+
+    write_file("second.txt", "second");
+    ASSERT_TRUE(run_frames_for(2000, [&] { return !state.added_calls.calls.empty(); }));
+    EXPECT_EQ(state.calls, 1u);
+    EXPECT_EQ(state.added_calls.calls[0][0], "[watch_test]/second.txt");
+    file_watch_unsubscribe(state.added);
+}
+
+static std::mutex g_loads_mutex;
+static std::vector<u32> g_loads;
+
+static bool load_watched_mip(vptr, u32 mip, u8* dst, u64 size)
+{
+    std::memset(dst, 0, static_cast<usize>(size));
+    std::lock_guard<std::mutex> lock(g_loads_mutex);
+    g_loads.push_back(mip);
+    return true;
+}
+
+static std::vector<u32> take_loads()
+{
+    std::lock_guard<std::mutex> lock(g_loads_mutex);
+    std::vector<u32> loads;
+    loads.swap(g_loads);
+    return loads;
+}
+
+TEST_F(file_watch, changed_stream_texture_loads_again)
+{
+    write_file("texture.bin", "v1");
+
+    gfx_stream_texture_desc_t desc{};
+    desc.texture.name = "test_watched";
+    desc.texture.format = gfx_texture_format_t::RGBA8U_NORM;
+    desc.texture.width = 16;
+    desc.texture.height = 16;
+    desc.texture.mip_levels = 5;
+    desc.load = load_watched_mip;
+    desc.filepath = "[watch_test]/texture.bin";
+    const handle_id texture = gfx_stream_texture(desc);
+    ASSERT_NE(texture, invalid_handle);
+
+    // Until every mip arrived and nothing is left in flight
+    std::vector<u32> loads;
+    auto loaded = [&]
+        {
+            gfx_stream_request(texture, 0);
+            const std::vector<u32> taken = take_loads();
+            loads.insert(loads.end(), taken.begin(), taken.end());
+            return loads.size() == desc.texture.mip_levels && gfx_stream_get_stats().loading == 0;
+        };
+    ASSERT_TRUE(run_frames_for(2000, loaded));
+
+    // The whole chain streams in again, coarse to fine
+    loads.clear();
+    write_file("texture.bin", "v2");
+    ASSERT_TRUE(run_frames_for(2000, loaded));
+    EXPECT_EQ(loads, (std::vector<u32>{ 4, 3, 2, 1, 0 }));
+    gfx_stream_release(texture);
+}
+
+#endif
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include <bx/app.hpp>
+
+#include <vector>
+
+using namespace bx;
+
+//
+// CPU decoding of BC blocks, known blocks against hand computed texels
+//
+static void expect_texel(const u8* rgba, u8 r, u8 g, u8 b, u8 a, u32 index)
+{
+    EXPECT_EQ(rgba[0], r) << "texel " << index;
+    EXPECT_EQ(rgba[1], g) << "texel " << index;
+    EXPECT_EQ(rgba[2], b) << "texel " << index;
+    EXPECT_EQ(rgba[3], a) << "texel " << index;
+}
+
+TEST(gfx_format, bc1_three_colors_and_transparent_black)
+{
+    // c0 blue <= c1 red, indices 0 1 2 3 along every row
+    const u8 block[8] = { 0x1f, 0x00, 0x00, 0xf8, 0xe4, 0xe4, 0xe4, 0xe4 };
+    u8 dst[4 * 4 * 4]{};
+    ASSERT_TRUE(gfx_decode_texture(gfx_texture_format_t::BC1U_NORM, 4, 4, block, dst));
+
+    for (u32 i = 0; i < 16; ++i)
+    {
+        const u8* texel = dst + i * 4;
+        switch (i % 4)
+        {
+        case 0: expect_texel(texel, 0, 0, 255, 255, i); break;
+        case 1: expect_texel(texel, 255, 0, 0, 255, i); break;
+        case 2: expect_texel(texel, 128, 0, 128, 255, i); break;
+        case 3: expect_texel(texel, 0, 0, 0, 0, i); break;
+        }
+    }
+}
+
+TEST(gfx_format, bc4_six_values_with_black_and_white)
+{
+    // v0 <= v1 interpolates 4 values and adds 0 and 255, index i % 8 per texel
+    u8 block[8] = { 40, 240 };
+    u64 indices = 0;
+    for (u32 i = 0; i < 16; ++i)
+        indices |= static_cast<u64>(i & 7) << (i * 3);
+    for (u32 i = 0; i < 6; ++i)
+        block[2 + i] = static_cast<u8>(indices >> (i * 8));
+
+    u8 dst[4 * 4 * 4]{};
+    ASSERT_TRUE(gfx_decode_texture(gfx_texture_format_t::BC4U_NORM, 4, 4, block, dst));
+
+    const u8 palette[8] = { 40, 240, 80, 120, 160, 200, 0, 255 };
+    for (u32 i = 0; i < 16; ++i)
+        expect_texel(dst + i * 4, palette[i & 7], 0, 0, 255, i);
+}
+
+TEST(gfx_format, edge_blocks_are_cropped_to_the_image)
+{
+    // 6x5 is 2x2 solid blocks: red, green, blue, white
+    const u8 blocks[4 * 8] = {
+        0x00, 0xf8, 0x00, 0x00, 0, 0, 0, 0,
+        0xe0, 0x07, 0x00, 0x00, 0, 0, 0, 0,
+        0x1f, 0x00, 0x00, 0x00, 0, 0, 0, 0,
+        0xff, 0xff, 0x00, 0x00, 0, 0, 0, 0,
+    };
+    const u32 width = 6;
+    const u32 height = 5;
+
+    // Guard bytes past the image catch writes of the overhanging texels
+    std::vector<u8> dst(width * height * 4 + 64, 0xab);
+    ASSERT_TRUE(gfx_decode_texture(gfx_texture_format_t::BC1U_NORM, width, height, blocks, dst.data()));
+
+    const u8 colors[4][4] = {
+        { 255, 0, 0, 255 }, { 0, 255, 0, 255 }, { 0, 0, 255, 255 }, { 255, 255, 255, 255 },
+    };
+    for (u32 y = 0; y < height; ++y)
+    {
+        for (u32 x = 0; x < width; ++x)
+        {
+            const u8* color = colors[(y / 4) * 2 + x / 4];
+            expect_texel(dst.data() + (y * width + x) * 4, color[0], color[1], color[2], color[3], y * width + x);
+        }
+    }
+
+    for (usize i = width * height * 4; i < dst.size(); ++i)
+        EXPECT_EQ(dst[i], 0xab) << "byte " << i;
+}
+
+TEST(gfx_format, decode_rejects_formats_it_does_not_know)
+{
+    const u8 block[16]{};
+    u8 dst[4 * 4 * 4]{};
+    EXPECT_FALSE(gfx_decode_texture(gfx_texture_format_t::BC7U_NORM, 4, 4, block, dst));
+    EXPECT_FALSE(gfx_decode_texture(gfx_texture_format_t::RGBA8U_NORM, 4, 4, block, dst));
+}
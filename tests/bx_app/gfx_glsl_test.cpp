@@ -0,0 +1,335 @@
+#include <gtest/gtest.h>
+#include <bx/app.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fstream>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+using namespace bx;
+
+//
+// GLSL preprocessing and the SPIR-V compile service, sources under a temporary
+// drive and the shader cache next to them
+//
+static std::string g_root;
+
+static void write_file(const char* name, const char* content)
+{
+    const std::string path = g_root + "/" + name;
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    ASSERT_NE(file, nullptr) << path;
+    std::fputs(content, file);
+    std::fclose(file);
+}
+
+class gfx_glsl : public ::testing::Test
+{
+protected:
+    // Drives can't be removed, the directory lives as long as the process
+    static void SetUpTestCase()
+    {
+        if (!g_root.empty())
+            return;
+
+        char root[] = "/tmp/bx_glsl_XXXXXX";
+        ASSERT_NE(mkdtemp(root), nullptr);
+        g_root = root;
+        ASSERT_EQ(mkdir((g_root + "/lib").c_str(), 0755), 0);
+        ASSERT_TRUE(file_add_drive("[glsl_test]", g_root.c_str()));
+        std::atexit([] { std::system(("rm -rf " + g_root).c_str()); });
+
+        write_file("common.glsl", "float bx_test_half(float x) { return x * 0.5; }\n");
+        write_file("lib/util.glsl",
+            "#include \"../common.glsl\"\n"
+            "float bx_test_quarter(float x) { return bx_test_half(bx_test_half(x)); }\n");
+        write_file("main.comp",
+            "#version 450\n"
+            "layout(local_size_x = 1) in;\n"
+            "#include \"lib/util.glsl\"\n"
+            "#include \"[glsl_test]/common.glsl\"\n"
+            "#ifndef BX_TEST_SCALE\n"
+            "#error BX_TEST_SCALE is not defined\n"
+            "#endif\n"
+            "layout(std430, binding = 0) buffer out_b { float values[]; };\n"
+            "void main() { values[0] = bx_test_quarter(BX_TEST_SCALE); }\n");
+    }
+
+    void SetUp() override
+    {
+        // A fresh cache directory per test, keys from other tests can't hit
+        name = ::testing::UnitTest::GetInstance()->current_test_info()->name();
+        cache = "[glsl_test]/cache_" + name;
+        init(false);
+    }
+
+    void TearDown() override
+    {
+        app_shutdown();
+    }
+
+    void init(bool warmup)
+    {
+        app_config_t config{};
+        config.width = 64;
+        config.height = 64;
+        config.title = "bx_tests";
+        config.watch_files = false;
+        config.shader_cache = cache.c_str();
+        config.shader_cache_warmup = warmup;
+        ASSERT_EQ(app_init(config), result_t::OK);
+    }
+
+    // A new run over the same cache directory
+    void restart(bool warmup)
+    {
+        app_shutdown();
+        init(warmup);
+    }
+
+    // Paths of the entries on disk, the index and temp files left out
+    std::vector<std::string> cache_entries() const
+    {
+        std::vector<std::string> entries;
+        const std::string directory = g_root + "/cache_" + name;
+        DIR* dir = opendir(directory.c_str());
+        if (!dir)
+            return entries;
+        while (const dirent* entry = readdir(dir))
+        {
+            const std::string file = entry->d_name;
+            if (file.size() > 4 && file.compare(file.size() - 4, 4, ".bin") == 0)
+                entries.push_back(directory + "/" + file);
+        }
+        closedir(dir);
+        return entries;
+    }
+
+    static gfx_shader_desc_t compute_desc()
+    {
+        gfx_shader_desc_t desc{};
+        desc.name = "glsl_test";
+        desc.stage = gfx_shader_stage_t::COMPUTE;
+        desc.lang = gfx_shader_lang_t::GLSL;
+        return desc;
+    }
+
+    static bool compile(const gfx_shader_desc_t& desc, array<u8>& spirv)
+    {
+        const handle_id job = gfx_compile_shader(desc);
+        return job != invalid_handle && gfx_compile_shader_wait(job, spirv);
+    }
+
+    // Compiles that ran glslang during the frame, cache hits excluded
+    static u32 end_frame_compiles()
+    {
+        app_begin_frame();
+        app_end_frame(true, false);
+        return gfx_get_frame_stats().shader_compiles;
+    }
+
+    std::string name;
+    std::string cache;
+};
+
+TEST_F(gfx_glsl, compiles_a_file_with_macros_and_nested_includes)
+{
+    gfx_shader_macro_t macro{};
+    macro.name = "BX_TEST_SCALE";
+    macro.value = "4.0";
+    gfx_shader_desc_t desc = compute_desc();
+    desc.filepath = "[glsl_test]/main.comp";
+    desc.macros = array_view<gfx_shader_macro_t>{ &macro, 1 };
+
+    array<u8> spirv;
+    ASSERT_TRUE(compile(desc, spirv));
+    ASSERT_GE(spirv.size(), 4u);
+    EXPECT_EQ(spirv.size() % 4, 0u);
+
+    u32 magic = 0;
+    std::memcpy(&magic, spirv.data(), sizeof(magic));
+    EXPECT_EQ(magic, 0x07230203u);
+}
+
+TEST_F(gfx_glsl, missing_includes_fail_before_compiling)
+{
+    gfx_shader_desc_t desc = compute_desc();
+    desc.source =
+        "#version 450\n"
+        "#include \"[glsl_test]/missing.glsl\"\n"
+        "void main() {}\n";
+    EXPECT_EQ(gfx_compile_shader(desc), invalid_handle);
+
+    // Relative paths need a file to be relative to
+    desc.source =
+        "#version 450\n"
+        "#include \"common.glsl\"\n"
+        "void main() {}\n";
+    EXPECT_EQ(gfx_compile_shader(desc), invalid_handle);
+    EXPECT_EQ(end_frame_compiles(), 0u);
+}
+
+TEST_F(gfx_glsl, one_file_spelled_two_ways_shares_the_cache_entry)
+{
+    gfx_shader_desc_t desc = compute_desc();
+    desc.source =
+        "#version 450\n"
+        "layout(local_size_x = 1) in;\n"
+        "#include \"[glsl_test]/common.glsl\"\n"
+        "#include \"[glsl_test]/common.glsl\"\n"
+        "void main() { bx_test_half(1.0); }\n";
+
+    array<u8> first;
+    ASSERT_TRUE(compile(desc, first));
+    EXPECT_EQ(end_frame_compiles(), 1u);
+
+    // Same file through dot segments, doubled and back slashes, still included once
+    desc.source =
+        "#version 450\n"
+        "layout(local_size_x = 1) in;\n"
+        "#include \"[glsl_test]/lib/..//./common.glsl\"\n"
+        "#include \"[glsl_test]\\\\common.glsl\"\n"
+        "void main() { bx_test_half(1.0); }\n";
+
+    array<u8> second;
+    ASSERT_TRUE(compile(desc, second));
+    EXPECT_EQ(end_frame_compiles(), 0u);
+    ASSERT_EQ(first.size(), second.size());
+    EXPECT_EQ(std::memcmp(first.data(), second.data(), first.size()), 0);
+}
+
+TEST_F(gfx_glsl, macros_are_part_of_the_cache_key)
+{
+    gfx_shader_macro_t macro{};
+    macro.name = "BX_TEST_SCALE";
+    macro.value = "4.0";
+    gfx_shader_desc_t desc = compute_desc();
+    desc.filepath = "[glsl_test]/main.comp";
+    desc.macros = array_view<gfx_shader_macro_t>{ &macro, 1 };
+
+    array<u8> spirv;
+    ASSERT_TRUE(compile(desc, spirv));
+    ASSERT_TRUE(compile(desc, spirv));
+    EXPECT_EQ(end_frame_compiles(), 1u);
+
+    macro.value = "8.0";
+    ASSERT_TRUE(compile(desc, spirv));
+    EXPECT_EQ(end_frame_compiles(), 1u);
+}
+
+//
+// Shader cache entries, header of magic, version, key, format and size ahead
+// of the binary. Damaged or foreign entries are compiled again and replaced.
+//
+static const char* g_cached_source =
+    "#version 450\n"
+    "layout(local_size_x = 1) in;\n"
+    "layout(std430, binding = 0) buffer out_b { float values[]; };\n"
+    "void main() { values[0] = 1.0; }\n";
+
+static void patch_entry(const std::string& path, std::streamoff offset, const void* data, usize size)
+{
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    ASSERT_TRUE(file.is_open()) << path;
+    file.seekp(offset);
+    file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    ASSERT_TRUE(file.good()) << path;
+}
+
+TEST_F(gfx_glsl, cache_entries_survive_a_restart)
+{
+    gfx_shader_desc_t desc = compute_desc();
+    desc.source = g_cached_source;
+
+    array<u8> first;
+    ASSERT_TRUE(compile(desc, first));
+    EXPECT_EQ(end_frame_compiles(), 1u);
+    ASSERT_EQ(cache_entries().size(), 1u);
+
+    // Read on load, then from the index ahead of time
+    for (const bool warmup : { false, true })
+    {
+        restart(warmup);
+        array<u8> second;
+        ASSERT_TRUE(compile(desc, second));
+        EXPECT_EQ(end_frame_compiles(), 0u) << "warmup " << warmup;
+        ASSERT_EQ(first.size(), second.size());
+        EXPECT_EQ(std::memcmp(first.data(), second.data(), first.size()), 0);
+    }
+}
+
+TEST_F(gfx_glsl, cache_entries_for_another_key_or_version_are_compiled_again)
+{
+    gfx_shader_desc_t desc = compute_desc();
+    desc.source = g_cached_source;
+
+    array<u8> spirv;
+    ASSERT_TRUE(compile(desc, spirv));
+    EXPECT_EQ(end_frame_compiles(), 1u);
+    const std::vector<std::string> entries = cache_entries();
+    ASSERT_EQ(entries.size(), 1u);
+
+    // Key and version as written by another target or an older build
+    const u64 key = 0x0123456789abcdefull;
+    const u32 version = 0xffffffffu;
+    const std::pair<std::streamoff, std::pair<const void*, usize>> patches[] = {
+        { 8, { &key, sizeof(key) } },
+        { 4, { &version, sizeof(version) } },
+    };
+    for (const auto& patch : patches)
+    {
+        restart(false);
+        patch_entry(entries[0], patch.first, patch.second.first, patch.second.second);
+        ASSERT_TRUE(compile(desc, spirv));
+        EXPECT_EQ(end_frame_compiles(), 1u) << "offset " << patch.first;
+    }
+
+    // The compile replaced the entry
+    restart(false);
+    ASSERT_TRUE(compile(desc, spirv));
+    EXPECT_EQ(end_frame_compiles(), 0u);
+}
+
+TEST_F(gfx_glsl, corrupt_cache_entries_are_compiled_again)
+{
+    gfx_shader_desc_t desc = compute_desc();
+    desc.source = g_cached_source;
+
+    array<u8> expected;
+    ASSERT_TRUE(compile(desc, expected));
+    EXPECT_EQ(end_frame_compiles(), 1u);
+    const std::vector<std::string> entries = cache_entries();
+    ASSERT_EQ(entries.size(), 1u);
+
+    const std::streamoff size_offset = 20;
+    const u32 payload = static_cast<u32>(expected.size());
+    const u32 sizes[] = {
+        0,                  // empty
+        payload - 4,        // shorter than the file, trailing bytes
+        payload + 4,        // past the end of the file
+        0xffffffffu,        // far past any sane entry
+    };
+    for (const u32 size : sizes)
+    {
+        restart(false);
+        patch_entry(entries[0], size_offset, &size, sizeof(size));
+        array<u8> spirv;
+        ASSERT_TRUE(compile(desc, spirv));
+        EXPECT_EQ(end_frame_compiles(), 1u) << "size " << size;
+        ASSERT_EQ(spirv.size(), expected.size()) << "size " << size;
+        EXPECT_EQ(std::memcmp(spirv.data(), expected.data(), expected.size()), 0) << "size " << size;
+    }
+
+    // Cut inside the header
+    restart(false);
+    ASSERT_EQ(truncate(entries[0].c_str(), 10), 0);
+    array<u8> spirv;
+    ASSERT_TRUE(compile(desc, spirv));
+    EXPECT_EQ(end_frame_compiles(), 1u);
+}
@@ -0,0 +1,749 @@
+#include <gtest/gtest.h>
+#include <bx/app.hpp>
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+using namespace bx;
+
+//
+// Null gfx backend tests, run headless against the Null device
+//
+class gfx_null : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        app_config_t config{};
+        config.width = 64;
+        config.height = 64;
+        config.title = "bx_tests";
+        config.watch_files = false;
+        ASSERT_EQ(app_init(config), result_t::OK);
+
+        gfx_null_set_logging(true);
+        gfx_null_clear_log();
+    }
+
+    void TearDown() override
+    {
+        gfx_null_clear_log();
+        app_shutdown();
+    }
+
+    static handle_id create_buffer(u64 size, gfx_buffer_usage_t usage = gfx_buffer_usage_t::VERTEX)
+    {
+        gfx_buffer_desc_t desc{};
+        desc.name = "test_buffer";
+        desc.usage = usage;
+        desc.size = size;
+        return gfx_create_buffer(desc);
+    }
+
+    static handle_id create_pipeline()
+    {
+        gfx_shader_desc_t shader_desc{};
+        shader_desc.name = "test_shader";
+        handle_id shader = gfx_create_shader(shader_desc);
+
+        gfx_pipeline_desc_t desc{};
+        desc.name = "test_pipeline";
+        desc.shaders = array_view<handle_id>{ &shader, 1 };
+        return gfx_create_pipeline(desc);
+    }
+};
+
+TEST_F(gfx_null, logs_calls_in_order)
+{
+    const handle_id pipeline = create_pipeline();
+    const handle_id vertices = create_buffer(1024);
+    gfx_null_clear_log();
+
+    const u64 offset = 64;
+    gfx_bind_pipeline(invalid_handle, pipeline);
+    gfx_bind_vertex_buffers(invalid_handle, 2, 1, &vertices, &offset);
+    gfx_draw(invalid_handle, 3, 2);
+
+    const auto log = gfx_null_get_log();
+    ASSERT_EQ(log.size(), 3u);
+
+    EXPECT_EQ(log[0].type, gfx_null_cmd_t::BIND_PIPELINE);
+    EXPECT_EQ(log[0].handles[0], pipeline);
+
+    EXPECT_EQ(log[1].type, gfx_null_cmd_t::BIND_VERTEX_BUFFER);
+    EXPECT_EQ(log[1].handles[0], vertices);
+    EXPECT_EQ(log[1].args[0], 2u);
+    EXPECT_EQ(log[1].args[1], 64u);
+
+    EXPECT_EQ(log[2].type, gfx_null_cmd_t::DRAW);
+    EXPECT_EQ(log[2].args[0], 3u);
+    EXPECT_EQ(log[2].args[1], 2u);
+    for (const auto& command : log)
+        EXPECT_FALSE(command.error);
+}
+
+TEST_F(gfx_null, logging_off_still_counts)
+{
+    const handle_id pipeline = create_pipeline();
+    gfx_null_set_logging(false);
+    gfx_null_clear_log();
+
+    gfx_bind_pipeline(invalid_handle, pipeline);
+    gfx_draw(invalid_handle, 6);
+
+    EXPECT_TRUE(gfx_null_get_log().empty());
+    EXPECT_EQ(gfx_null_get_current_stats().draws, 1u);
+    EXPECT_EQ(gfx_null_get_current_stats().vertices, 6u);
+}
+
+TEST_F(gfx_null, draw_without_pipeline_is_an_error)
+{
+    const u32 errors = gfx_null_get_current_stats().errors;
+
+    gfx_draw(invalid_handle, 3);
+
+    const auto log = gfx_null_get_log();
+    ASSERT_EQ(log.size(), 1u);
+    EXPECT_TRUE(log[0].error);
+    EXPECT_EQ(gfx_null_get_current_stats().errors, errors + 1);
+    EXPECT_EQ(gfx_null_get_current_stats().draws, 0u);
+}
+
+TEST_F(gfx_null, indexed_draw_needs_an_index_buffer)
+{
+    gfx_bind_pipeline(invalid_handle, create_pipeline());
+    gfx_draw_indexed(invalid_handle, 36);
+    EXPECT_TRUE(gfx_null_get_log()[gfx_null_get_log().size() - 1].error);
+
+    gfx_bind_index_buffer(invalid_handle, create_buffer(256, gfx_buffer_usage_t::INDEX));
+    gfx_draw_indexed(invalid_handle, 36);
+    EXPECT_FALSE(gfx_null_get_log()[gfx_null_get_log().size() - 1].error);
+}
+
+TEST_F(gfx_null, destroyed_pipeline_is_unbound)
+{
+    const handle_id pipeline = create_pipeline();
+    gfx_bind_pipeline(invalid_handle, pipeline);
+    gfx_destroy_pipeline(pipeline);
+
+    gfx_dispatch(invalid_handle, 1, 1, 1);
+    EXPECT_TRUE(gfx_null_get_log()[gfx_null_get_log().size() - 1].error);
+}
+
+TEST_F(gfx_null, bad_handles_are_rejected)
+{
+    const handle_id buffer = create_buffer(64);
+    gfx_destroy_buffer(buffer);
+    const u32 errors = gfx_null_get_current_stats().errors;
+
+    gfx_bind_pipeline(invalid_handle, buffer);
+    gfx_bind_index_buffer(invalid_handle, buffer);
+    gfx_destroy_buffer(buffer);
+    gfx_unmap_buffer(buffer);
+
+    EXPECT_EQ(gfx_null_get_current_stats().errors, errors + 4);
+    EXPECT_EQ(gfx_null_get_current_stats().buffer_binds, 0u);
+
+    // Destroying invalid_handle is allowed
+    gfx_destroy_texture(invalid_handle);
+    EXPECT_EQ(gfx_null_get_current_stats().errors, errors + 4);
+}
+
+TEST_F(gfx_null, buffer_ranges_are_checked)
+{
+    const handle_id buffer = create_buffer(16);
+    const u8 data[32]{ 1, 2, 3, 4 };
+
+    gfx_update_buffer(buffer, 8, data, 8);
+    gfx_update_buffer(buffer, 8, data, 16);
+    gfx_update_buffer(buffer, ~u64(0), data, 2);
+
+    EXPECT_NE(gfx_map_buffer(buffer, 0, 16), nullptr);
+    EXPECT_EQ(gfx_map_buffer(buffer, 4, 16), nullptr);
+
+    gfx_copy_buffer(invalid_handle, buffer, buffer, 0, 8, 9);
+
+    const gfx_null_stats_t stats = gfx_null_get_current_stats();
+    EXPECT_EQ(stats.errors, 4u);
+    EXPECT_EQ(stats.uploads, 1u);
+    EXPECT_EQ(stats.upload_bytes, 8u);
+    EXPECT_EQ(stats.copies, 0u);
+
+    // The valid update landed, the rejected ones did not touch memory
+    const u8* mapped = gfx_map_buffer(buffer, 0, 16);
+    ASSERT_NE(mapped, nullptr);
+    EXPECT_EQ(mapped[8], 1);
+    EXPECT_EQ(mapped[0], 0);
+}
+
+TEST_F(gfx_null, indirect_draws_stay_in_the_buffer)
+{
+    gfx_bind_pipeline(invalid_handle, create_pipeline());
+    const handle_id commands = create_buffer(4 * sizeof(gfx_draw_indirect_command_t), gfx_buffer_usage_t::INDIRECT);
+
+    gfx_draw_indirect(invalid_handle, commands, 0, 4);
+    gfx_draw_indirect(invalid_handle, commands, sizeof(gfx_draw_indirect_command_t), 4);
+    gfx_draw_indirect(invalid_handle, commands, 0, 2, 3 * sizeof(gfx_draw_indirect_command_t));
+
+    const gfx_null_stats_t stats = gfx_null_get_current_stats();
+    EXPECT_EQ(stats.draws, 2u);
+    EXPECT_EQ(stats.errors, 1u);
+}
+
+TEST_F(gfx_null, frame_stats_roll_over_at_end_frame)
+{
+    gfx_bind_pipeline(invalid_handle, create_pipeline());
+    gfx_draw(invalid_handle, 3);
+    gfx_draw(invalid_handle, 3, 4);
+
+    app_begin_frame();
+    app_end_frame(true, false);
+
+    const gfx_null_stats_t last = gfx_null_get_frame_stats();
+    EXPECT_EQ(last.draws, 2u);
+    EXPECT_EQ(last.vertices, 15u);
+    EXPECT_EQ(last.pipeline_binds, 1u);
+    EXPECT_EQ(gfx_null_get_current_stats().draws, 0u);
+
+    bool begin = false, end = false;
+    for (const auto& command : gfx_null_get_log())
+    {
+        begin = begin || command.type == gfx_null_cmd_t::BEGIN_FRAME;
+        end = end || command.type == gfx_null_cmd_t::END_FRAME;
+    }
+    EXPECT_TRUE(begin);
+    EXPECT_TRUE(end);
+}
+
+TEST_F(gfx_null, upload_ring_allocations_are_aligned_and_disjoint)
+{
+    const gfx_upload_t a = gfx_upload_alloc(100);
+    const gfx_upload_t b = gfx_upload_alloc(10, 64);
+    const gfx_upload_t c = gfx_upload_alloc(300, 1024);
+    ASSERT_NE(a.data, nullptr);
+    ASSERT_NE(b.data, nullptr);
+    ASSERT_NE(c.data, nullptr);
+
+    EXPECT_EQ(a.buffer, b.buffer);
+    EXPECT_EQ(a.offset % 256, 0u);
+    EXPECT_EQ(b.offset % 64, 0u);
+    EXPECT_EQ(c.offset % 1024, 0u);
+    EXPECT_GE(b.offset, a.offset + a.size);
+    EXPECT_GE(c.offset, b.offset + b.size);
+    EXPECT_EQ(b.data - a.data, static_cast<std::ptrdiff_t>(b.offset - a.offset));
+}
+
+TEST_F(gfx_null, upload_ring_reuses_a_frame_slice_after_the_frames_in_flight)
+{
+    // Frame 0 writes its memory, the frames after it must not hand it out again
+    const u64 size = 4096;
+    const gfx_upload_t first = gfx_upload_alloc(size);
+    ASSERT_NE(first.data, nullptr);
+    std::memset(first.data, 0xab, size);
+
+    u32 frames_in_flight = 0;
+    for (u32 frame = 1; frame <= 8 && frames_in_flight == 0; ++frame)
+    {
+        app_begin_frame();
+        app_end_frame(true, false);
+
+        const gfx_upload_t upload = gfx_upload_alloc(size);
+        ASSERT_NE(upload.data, nullptr);
+        if (upload.offset == first.offset)
+        {
+            frames_in_flight = frame;
+            break;
+        }
+
+        EXPECT_TRUE(upload.offset + size <= first.offset || upload.offset >= first.offset + size) << "frame " << frame;
+        std::memset(upload.data, 0xcd, size);
+        for (u64 i = 0; i < size; ++i)
+            ASSERT_EQ(first.data[i], 0xab) << "frame " << frame << " byte " << i;
+    }
+
+    // The ring wrapped around to the first slice, at the same place every lap
+    ASSERT_GE(frames_in_flight, 2u);
+    for (u32 frame = 0; frame < frames_in_flight; ++frame)
+    {
+        app_begin_frame();
+        app_end_frame(true, false);
+    }
+    EXPECT_EQ(gfx_upload_alloc(size).offset, first.offset);
+}
+
+TEST_F(gfx_null, upload_ring_refuses_more_than_the_frame_share)
+{
+    app_config_t config{};
+    const u64 ring = config.upload_memory;
+    EXPECT_EQ(gfx_upload_alloc(ring + 1).data, nullptr);
+    EXPECT_EQ(gfx_upload_alloc(0).data, nullptr);
+
+    // Used up within the frame, the next frame has room again
+    const u64 chunk = 64 * 1024;
+    u64 allocated = 0;
+    while (gfx_upload_alloc(chunk).data)
+        allocated += chunk;
+    EXPECT_GT(allocated, 0u);
+    EXPECT_LT(allocated, ring);
+    EXPECT_EQ(gfx_upload_alloc(chunk).data, nullptr);
+
+    app_begin_frame();
+    app_end_frame(true, false);
+    EXPECT_NE(gfx_upload_alloc(chunk).data, nullptr);
+}
+
+TEST_F(gfx_null, command_buffers_log_at_submit)
+{
+    const handle_id pipeline = create_pipeline();
+    gfx_null_clear_log();
+
+    const handle_id cb = gfx_begin_command_buffer();
+    ASSERT_NE(cb, invalid_handle);
+    gfx_bind_pipeline(cb, pipeline);
+    gfx_draw(cb, 3);
+    EXPECT_TRUE(gfx_null_get_log().empty());
+
+    gfx_submit(cb);
+
+    const auto log = gfx_null_get_log();
+    ASSERT_EQ(log.size(), 3u);
+    EXPECT_EQ(log[0].type, gfx_null_cmd_t::SUBMIT);
+    EXPECT_EQ(log[1].type, gfx_null_cmd_t::BIND_PIPELINE);
+    EXPECT_EQ(log[2].type, gfx_null_cmd_t::DRAW);
+    EXPECT_EQ(gfx_null_get_current_stats().submits, 1u);
+}
+
+TEST_F(gfx_null, replay_issues_the_same_commands)
+{
+    const handle_id pipeline = create_pipeline();
+    const handle_id indices = create_buffer(256, gfx_buffer_usage_t::INDEX);
+    gfx_null_clear_log();
+
+    gfx_bind_pipeline(invalid_handle, pipeline);
+    gfx_bind_index_buffer(invalid_handle, indices, gfx_index_type_t::UINT16);
+    gfx_draw_indexed(invalid_handle, 12, 2, 6, -4, 3);
+    gfx_dispatch(invalid_handle, 8, 4, 1);
+    const usize recorded = gfx_null_get_log().size();
+
+    // The live log may be replayed, the copies are appended behind it
+    gfx_null_replay(gfx_null_get_log());
+
+    const auto log = gfx_null_get_log();
+    ASSERT_EQ(log.size(), recorded * 2);
+    for (usize i = 0; i < recorded; ++i)
+    {
+        const auto& a = log[i];
+        const auto& b = log[recorded + i];
+        EXPECT_EQ(a.type, b.type);
+        EXPECT_EQ(a.error, b.error);
+        for (u32 h = 0; h < 3; ++h)
+            EXPECT_EQ(a.handles[h], b.handles[h]);
+        for (u32 arg = 0; arg < 5; ++arg)
+            EXPECT_EQ(a.args[arg], b.args[arg]);
+    }
+}
+
+TEST_F(gfx_null, replay_into_a_command_buffer)
+{
+    const handle_id pipeline = create_pipeline();
+    gfx_null_clear_log();
+
+    gfx_bind_pipeline(invalid_handle, pipeline);
+    gfx_draw(invalid_handle, 3);
+
+    gfx_null_command_t commands[2]{};
+    commands[0] = gfx_null_get_log()[0];
+    commands[1] = gfx_null_get_log()[1];
+    gfx_null_clear_log();
+
+    const handle_id cb = gfx_begin_command_buffer();
+    gfx_null_replay(array_view<gfx_null_command_t>{ commands, 2 }, cb);
+    EXPECT_TRUE(gfx_null_get_log().empty());
+
+    gfx_submit(cb);
+    EXPECT_EQ(gfx_null_get_log().size(), 3u);
+    EXPECT_EQ(gfx_null_get_current_stats().draws, 2u);
+}
+
+TEST_F(gfx_null, command_buffers_keep_the_first_instance)
+{
+    const handle_id pipeline = create_pipeline();
+    const handle_id indices = create_buffer(256, gfx_buffer_usage_t::INDEX);
+    gfx_null_clear_log();
+
+    const handle_id cb = gfx_begin_command_buffer();
+    gfx_bind_pipeline(cb, pipeline);
+    gfx_bind_index_buffer(cb, indices);
+    gfx_draw(cb, 3, 4, 0, 7);
+    gfx_draw_indexed(cb, 6, 2, 0, 0, 9);
+    gfx_submit(cb);
+
+    const auto log = gfx_null_get_log();
+    ASSERT_EQ(log.size(), 5u);
+    EXPECT_EQ(log[3].type, gfx_null_cmd_t::DRAW);
+    EXPECT_EQ(log[3].args[3], 7u);
+    EXPECT_EQ(log[4].type, gfx_null_cmd_t::DRAW_INDEXED);
+    EXPECT_EQ(log[4].args[1], 2u);
+    EXPECT_EQ(log[4].args[4], 9u);
+}
+
+TEST_F(gfx_null, cull_compacts_the_visible_instances)
+{
+    // Only the x >= 0 plane can reject, the one at x = -5 lies fully behind it
+    const f32 centers[4] = { -5.0f, 2.0f, -0.5f, 3.0f };
+    gfx_cull_instance_t instances[4]{};
+    for (u32 i = 0; i < 4; ++i)
+    {
+        instances[i].center[0] = centers[i];
+        instances[i].radius = 1.0f;
+        instances[i].index_count = 3 * (i + 1);
+        instances[i].first_index = 100 * i;
+    }
+
+    gfx_cull_desc_t desc{};
+    desc.instances = create_buffer(sizeof(instances), gfx_buffer_usage_t::STORAGE);
+    desc.commands = create_buffer(4 * sizeof(gfx_draw_indexed_indirect_command_t), gfx_buffer_usage_t::INDIRECT);
+    desc.count = create_buffer(sizeof(u32), gfx_buffer_usage_t::INDIRECT);
+    desc.visible = create_buffer(4 * sizeof(u32), gfx_buffer_usage_t::STORAGE);
+    desc.instance_count = 4;
+    desc.planes[0][0] = 1.0f;
+    for (u32 p = 1; p < 6; ++p)
+        desc.planes[p][3] = 1.0f;
+    gfx_update_buffer(desc.instances, 0, instances, sizeof(instances));
+
+    const handle_id pipeline = create_pipeline();
+    gfx_null_clear_log();
+
+    // Recorded next to a user dispatch, both count as dispatches at submit
+    const handle_id cb = gfx_begin_command_buffer();
+    gfx_bind_pipeline(cb, pipeline);
+    gfx_dispatch(cb, 2, 1, 1);
+    gfx_cull_instances(cb, desc);
+    gfx_submit(cb);
+
+    const auto log = gfx_null_get_log();
+    ASSERT_EQ(log.size(), 4u);
+    EXPECT_EQ(log[2].type, gfx_null_cmd_t::DISPATCH);
+    EXPECT_EQ(log[2].args[0], 2u);
+    EXPECT_EQ(log[3].type, gfx_null_cmd_t::CULL_INSTANCES);
+    EXPECT_EQ(log[3].args[0], 4u);
+    for (const auto& command : log)
+        EXPECT_FALSE(command.error);
+    EXPECT_EQ(gfx_null_get_current_stats().dispatches, 2u);
+
+    u32 count = 0;
+    std::memcpy(&count, gfx_map_buffer(desc.count, 0, sizeof(u32)), sizeof(u32));
+    ASSERT_EQ(count, 3u);
+
+    gfx_draw_indexed_indirect_command_t commands[3];
+    std::memcpy(commands, gfx_map_buffer(desc.commands, 0, sizeof(commands)), sizeof(commands));
+    u32 visible[3];
+    std::memcpy(visible, gfx_map_buffer(desc.visible, 0, sizeof(visible)), sizeof(visible));
+
+    // In instance order, first_instance and the visible buffer both name the instance
+    const u32 expected[3] = { 1, 2, 3 };
+    const bool base_instance = gfx_get_info().features.supports_base_instance;
+    for (u32 i = 0; i < 3; ++i)
+    {
+        const u32 instance = expected[i];
+        EXPECT_EQ(visible[i], instance);
+        EXPECT_EQ(commands[i].index_count, instances[instance].index_count);
+        EXPECT_EQ(commands[i].instance_count, 1u);
+        EXPECT_EQ(commands[i].first_index, instances[instance].first_index);
+        EXPECT_EQ(commands[i].first_instance, base_instance ? instance : 0u);
+    }
+}
+
+TEST_F(gfx_null, cull_rejects_a_visible_buffer_too_small)
+{
+    gfx_cull_desc_t desc{};
+    desc.instances = create_buffer(4 * sizeof(gfx_cull_instance_t), gfx_buffer_usage_t::STORAGE);
+    desc.commands = create_buffer(4 * sizeof(gfx_draw_indexed_indirect_command_t), gfx_buffer_usage_t::INDIRECT);
+    desc.count = create_buffer(sizeof(u32), gfx_buffer_usage_t::INDIRECT);
+    desc.visible = create_buffer(3 * sizeof(u32), gfx_buffer_usage_t::STORAGE);
+    desc.instance_count = 4;
+    gfx_null_clear_log();
+
+    gfx_cull_instances(invalid_handle, desc);
+
+    const auto log = gfx_null_get_log();
+    ASSERT_EQ(log.size(), 1u);
+    EXPECT_EQ(log[0].type, gfx_null_cmd_t::CULL_INSTANCES);
+    EXPECT_TRUE(log[0].error);
+}
+
+TEST_F(gfx_null, dump_writes_one_line_per_command)
+{
+    gfx_draw(invalid_handle, 3);
+    gfx_dispatch(invalid_handle, 1, 1, 1);
+
+    const char* path = "bx_gfx_null_dump.txt";
+    ASSERT_TRUE(gfx_null_dump_log(path));
+
+    std::ifstream file(path);
+    std::string first, second, extra;
+    ASSERT_TRUE(static_cast<bool>(std::getline(file, first)));
+    ASSERT_TRUE(static_cast<bool>(std::getline(file, second)));
+    EXPECT_FALSE(static_cast<bool>(std::getline(file, extra)));
+    file.close();
+    std::remove(path);
+
+    EXPECT_NE(first.find("DRAW"), std::string::npos);
+    EXPECT_NE(first.find("error"), std::string::npos);
+    EXPECT_NE(second.find("DISPATCH"), std::string::npos);
+}
+
+TEST_F(gfx_null, frame_stats_count_work_and_resources)
+{
+    // The backend owns buffers of its own, like the upload ring
+    app_begin_frame();
+    app_end_frame(true, false);
+    const gfx_frame_stats_t before = gfx_get_frame_stats();
+
+    const handle_id pipeline = create_pipeline();
+    const handle_id vertices = create_buffer(1024);
+    const handle_id indices = create_buffer(256, gfx_buffer_usage_t::INDEX);
+
+    gfx_texture_desc_t texture_desc{};
+    texture_desc.name = "test_texture";
+    texture_desc.format = gfx_texture_format_t::RGBA8U_NORM;
+    texture_desc.width = 4;
+    texture_desc.height = 4;
+    texture_desc.mip_levels = 3;
+    const handle_id texture = gfx_create_texture(texture_desc);
+
+    const u8 data[64]{};
+    gfx_update_buffer(vertices, 0, data, 64);
+
+    gfx_bind_pipeline(invalid_handle, pipeline);
+    gfx_bind_pipeline(invalid_handle, pipeline);
+    gfx_bind_vertex_buffers(invalid_handle, 0, 1, &vertices, nullptr);
+    gfx_bind_index_buffer(invalid_handle, indices);
+    gfx_draw(invalid_handle, 3);
+    gfx_draw_indexed(invalid_handle, 6);
+    gfx_dispatch(invalid_handle, 1, 1, 1);
+
+    app_begin_frame();
+    app_end_frame(true, false);
+
+    const gfx_frame_stats_t& stats = gfx_get_frame_stats();
+    EXPECT_EQ(stats.draws, 2u);
+    EXPECT_EQ(stats.dispatches, 1u);
+    EXPECT_EQ(stats.pipeline_binds, 2u);
+    EXPECT_EQ(stats.redundant_binds, 1u);
+    EXPECT_EQ(stats.buffer_binds, 2u);
+    EXPECT_EQ(stats.upload_bytes, 64u);
+    EXPECT_EQ(stats.frame, before.frame + 1);
+    EXPECT_EQ(stats.pipelines.count, before.pipelines.count + 1);
+    EXPECT_EQ(stats.buffers.count, before.buffers.count + 2);
+    EXPECT_EQ(stats.buffers.bytes, before.buffers.bytes + 1280);
+    EXPECT_EQ(stats.textures.count, before.textures.count + 1);
+    EXPECT_EQ(stats.textures.bytes, before.textures.bytes + 64 + 16 + 4);
+
+    // Counters restart, resources carry over until destroyed
+    gfx_destroy_texture(texture);
+    app_begin_frame();
+    app_end_frame(true, false);
+
+    EXPECT_EQ(gfx_get_frame_stats().draws, 0u);
+    EXPECT_EQ(gfx_get_frame_stats().buffers.count, before.buffers.count + 2);
+    EXPECT_EQ(gfx_get_frame_stats().textures.count, before.textures.count);
+    EXPECT_EQ(gfx_get_frame_stats().textures.bytes, before.textures.bytes);
+}
+
+TEST_F(gfx_null, frame_stats_history_is_oldest_first)
+{
+    for (u32 i = 0; i < 3; ++i)
+    {
+        app_begin_frame();
+        app_end_frame(true, false);
+    }
+
+    gfx_frame_stats_t history[8]{};
+    ASSERT_GE(gfx_get_frame_stats_history(history, 8), 3u);
+    ASSERT_EQ(gfx_get_frame_stats_history(history, 3), 3u);
+    EXPECT_LT(history[0].frame, history[1].frame);
+    EXPECT_LT(history[1].frame, history[2].frame);
+    EXPECT_EQ(history[2].frame, gfx_get_frame_stats().frame);
+}
+
+TEST_F(gfx_null, resource_sets_check_their_bindings)
+{
+    const handle_id uniforms = create_buffer(256, gfx_buffer_usage_t::UNIFORM);
+    const handle_id vertices = create_buffer(256);
+
+    gfx_texture_desc_t texture_desc{};
+    texture_desc.width = 4;
+    texture_desc.height = 4;
+    const handle_id texture = gfx_create_texture(texture_desc);
+
+    gfx_resource_binding_t bindings[2]{};
+    bindings[0].binding = 0;
+    bindings[0].type = gfx_resource_type_t::UNIFORM_BUFFER;
+    bindings[0].resource = uniforms;
+    bindings[1].binding = 0;
+    bindings[1].type = gfx_resource_type_t::TEXTURE;
+    bindings[1].resource = texture;
+
+    gfx_resource_set_desc_t desc{};
+    desc.name = "test_set";
+    desc.bindings = array_view<gfx_resource_binding_t>{ bindings, 2 };
+    EXPECT_NE(gfx_create_resource_set(desc), invalid_handle);
+
+    // Uniform bindings need a uniform buffer and a range inside it
+    bindings[0].resource = vertices;
+    EXPECT_EQ(gfx_create_resource_set(desc), invalid_handle);
+    bindings[0].resource = uniforms;
+    bindings[0].offset = 128;
+    bindings[0].size = 256;
+    EXPECT_EQ(gfx_create_resource_set(desc), invalid_handle);
+
+    // Same type and binding twice
+    bindings[0] = bindings[1];
+    EXPECT_EQ(gfx_create_resource_set(desc), invalid_handle);
+}
+
+TEST_F(gfx_null, resource_sets_bind_against_the_layout)
+{
+    gfx_shader_desc_t shader_desc{};
+    shader_desc.name = "test_shader";
+    handle_id shader = gfx_create_shader(shader_desc);
+
+    gfx_resource_layout_binding_t layout{};
+    layout.set = 1;
+    layout.binding = 2;
+    layout.type = gfx_resource_type_t::STORAGE_BUFFER;
+
+    gfx_pipeline_desc_t pipeline_desc{};
+    pipeline_desc.shaders = array_view<handle_id>{ &shader, 1 };
+    pipeline_desc.resource_layout.bindings = array_view<gfx_resource_layout_binding_t>{ &layout, 1 };
+    const handle_id pipeline = gfx_create_pipeline(pipeline_desc);
+
+    const handle_id storage = create_buffer(64, gfx_buffer_usage_t::STORAGE);
+    gfx_resource_binding_t binding{};
+    binding.binding = 2;
+    binding.type = gfx_resource_type_t::STORAGE_BUFFER;
+    binding.resource = storage;
+
+    gfx_resource_set_desc_t desc{};
+    desc.bindings = array_view<gfx_resource_binding_t>{ &binding, 1 };
+    const handle_id set = gfx_create_resource_set(desc);
+    ASSERT_NE(set, invalid_handle);
+    gfx_null_clear_log();
+
+    gfx_bind_resource_set(invalid_handle, pipeline, set, 1);
+    gfx_bind_resource_set(invalid_handle, pipeline, set, 0);
+    gfx_destroy_buffer(storage);
+    gfx_bind_resource_set(invalid_handle, pipeline, set, 1);
+
+    const auto log = gfx_null_get_log();
+    ASSERT_EQ(log.size(), 4u);
+    EXPECT_FALSE(log[0].error);
+    EXPECT_TRUE(log[1].error);
+    EXPECT_TRUE(log[3].error);
+    EXPECT_EQ(gfx_null_get_current_stats().resource_set_binds, 1u);
+}
+
+TEST_F(gfx_null, identical_descs_share_one_pipeline)
+{
+    const handle_id first = create_pipeline();
+    const handle_id second = create_pipeline();
+    EXPECT_EQ(first, second);
+
+    // Names don't matter, the topology does
+    gfx_shader_desc_t shader_desc{};
+    shader_desc.name = "renamed_shader";
+    handle_id shader = gfx_create_shader(shader_desc);
+
+    gfx_pipeline_desc_t desc{};
+    desc.shaders = array_view<handle_id>{ &shader, 1 };
+    desc.topology = gfx_topology_t::LINES;
+    const handle_id lines = gfx_create_pipeline(desc);
+    EXPECT_NE(lines, first);
+
+    // Each create holds a reference
+    gfx_destroy_pipeline(first);
+    gfx_bind_pipeline(invalid_handle, second);
+    EXPECT_FALSE(gfx_null_get_log()[gfx_null_get_log().size() - 1].error);
+
+    gfx_destroy_pipeline(second);
+    gfx_bind_pipeline(invalid_handle, second);
+    EXPECT_TRUE(gfx_null_get_log()[gfx_null_get_log().size() - 1].error);
+
+    gfx_bind_pipeline(invalid_handle, lines);
+    EXPECT_FALSE(gfx_null_get_log()[gfx_null_get_log().size() - 1].error);
+}
+
+TEST_F(gfx_null, pipeline_list_warms_up_the_next_run)
+{
+    gfx_shader_macro_t macro{};
+    macro.name = "LIT";
+    macro.value = "1";
+
+    gfx_shader_desc_t shader_desc{};
+    shader_desc.name = "warm_shader";
+    shader_desc.stage = gfx_shader_stage_t::VERTEX;
+    shader_desc.lang = gfx_shader_lang_t::GLSL;
+    shader_desc.source = "void main() {}";
+    shader_desc.macros = array_view<gfx_shader_macro_t>{ &macro, 1 };
+
+    gfx_vertex_attribute_t attribute{};
+    attribute.count = 3;
+    attribute.offset = 12;
+
+    auto create = [&]()
+    {
+        handle_id shader = gfx_create_shader(shader_desc);
+        gfx_pipeline_desc_t desc{};
+        desc.name = "warm_pipeline";
+        desc.shaders = array_view<handle_id>{ &shader, 1 };
+        desc.topology = gfx_topology_t::POINTS;
+        desc.input_layout.attributes = array_view<gfx_vertex_attribute_t>{ &attribute, 1 };
+        return gfx_create_pipeline(desc);
+    };
+
+    ASSERT_NE(create(), invalid_handle);
+
+    const char* path = "bx_pipeline_list.bin";
+    ASSERT_TRUE(gfx_save_pipeline_list(path));
+
+    TearDown();
+    SetUp();
+
+    EXPECT_EQ(gfx_warm_up_pipelines(path), 1u);
+    std::remove(path);
+
+    // Creating it again finds what the warm up made
+    const handle_id pipeline = create();
+    app_begin_frame();
+    app_end_frame(true, false);
+    EXPECT_NE(pipeline, invalid_handle);
+    EXPECT_EQ(gfx_get_frame_stats().shaders.count, 1u);
+    EXPECT_EQ(gfx_get_frame_stats().pipelines.count, 1u);
+
+    EXPECT_EQ(gfx_warm_up_pipelines("bx_missing_pipeline_list.bin"), 0u);
+
+    // Shutdown hands back the warm up references, the last one destroys
+    gfx_destroy_pipeline(pipeline);
+    gfx_null_clear_log();
+    app_shutdown();
+
+    const auto log = gfx_null_get_log();
+    u32 destroyed_pipelines = 0;
+    u32 destroyed_shaders = 0;
+    for (const auto& command : log)
+    {
+        EXPECT_FALSE(command.error);
+        if (command.type == gfx_null_cmd_t::DESTROY_PIPELINE && command.handles[0] == pipeline)
+            ++destroyed_pipelines;
+        if (command.type == gfx_null_cmd_t::DESTROY_SHADER)
+            ++destroyed_shaders;
+    }
+    EXPECT_EQ(destroyed_pipelines, 1u);
+    EXPECT_EQ(destroyed_shaders, 1u);
+
+    SetUp();
+}
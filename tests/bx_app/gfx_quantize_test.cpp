@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include <bx/app.hpp>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using namespace bx;
+
+//
+// Vertex attribute formats and quantization, lengths chosen so both the SIMD
+// loops and the scalar tails run
+//
+static f32 clamp(f32 value, f32 lo, f32 hi)
+{
+    return !(value >= lo) ? lo : (value > hi ? hi : value);
+}
+
+static std::vector<f32> ramp(usize count, f32 lo, f32 hi)
+{
+    std::vector<f32> values(count);
+    for (usize i = 0; i < count; ++i)
+        values[i] = lo + (hi - lo) * static_cast<f32>(i) / static_cast<f32>(count - 1);
+    return values;
+}
+
+TEST(gfx_quantize, attribute_sizes)
+{
+    EXPECT_EQ(gfx_attribute_size(gfx_attribute_format_t::FLOAT32, 3), 12u);
+    EXPECT_EQ(gfx_attribute_size(gfx_attribute_format_t::FLOAT16, 2), 4u);
+    EXPECT_EQ(gfx_attribute_size(gfx_attribute_format_t::SNORM8, 4), 4u);
+    EXPECT_EQ(gfx_attribute_size(gfx_attribute_format_t::UNORM16, 4), 8u);
+    EXPECT_EQ(gfx_attribute_size(gfx_attribute_format_t::UINT8, 1), 1u);
+    EXPECT_EQ(gfx_attribute_size(gfx_attribute_format_t::INT_2_10_10_10_REV, 4), 4u);
+
+    EXPECT_EQ(gfx_attribute_size(gfx_attribute_format_t::INT_2_10_10_10_REV, 3), 0u);
+    EXPECT_EQ(gfx_attribute_size(gfx_attribute_format_t::FLOAT32, 0), 0u);
+    EXPECT_EQ(gfx_attribute_size(gfx_attribute_format_t::FLOAT32, 5), 0u);
+}
+
+TEST(gfx_quantize, half_rounds_to_nearest_even)
+{
+    const f32 inf = std::numeric_limits<f32>::infinity();
+    const f32 src[] = {
+        0.0f, -0.0f, 1.0f, -2.0f, 0.5f, 0.1f, 65504.0f, 65519.0f,
+        65520.0f, inf, -inf, 6.0e-8f, 1.0e-8f, 6.103515625e-5f,
+        1.0f + 1.0f / 2048.0f, 1.0f + 3.0f / 2048.0f, 1.0f / 3.0f, -1.0e6f, 2.0f,
+    };
+    const u16 expected[] = {
+        0x0000, 0x8000, 0x3c00, 0xc000, 0x3800, 0x2e66, 0x7bff, 0x7bff,
+        0x7c00, 0x7c00, 0xfc00, 0x0001, 0x0000, 0x0400,
+        0x3c00, 0x3c02, 0x3555, 0xfc00, 0x4000,
+    };
+    static_assert(sizeof(src) / sizeof(src[0]) == sizeof(expected) / sizeof(expected[0]), "one expected value per input");
+
+    const usize count = sizeof(src) / sizeof(src[0]);
+    u16 dst[count]{};
+    gfx_quantize_f16(src, dst, count);
+    for (usize i = 0; i < count; ++i)
+        EXPECT_EQ(dst[i], expected[i]) << "at " << i << ", " << src[i];
+
+    // NaN stays NaN in either place
+    f32 nans[9];
+    for (f32& value : nans)
+        value = std::numeric_limits<f32>::quiet_NaN();
+    u16 halfs[9]{};
+    gfx_quantize_f16(nans, halfs, 9);
+    for (const u16 half : halfs)
+    {
+        EXPECT_EQ(half & 0x7c00, 0x7c00);
+        EXPECT_NE(half & 0x03ff, 0);
+    }
+}
+
+TEST(gfx_quantize, normalized_formats_clamp_and_round)
+{
+    std::vector<f32> src = ramp(37, -1.5f, 1.5f);
+    src[5] = std::numeric_limits<f32>::quiet_NaN();
+    const usize count = src.size();
+
+    std::vector<i8> snorm8(count);
+    std::vector<u8> unorm8(count);
+    std::vector<i16> snorm16(count);
+    std::vector<u16> unorm16(count);
+    gfx_quantize_snorm8(src.data(), snorm8.data(), count);
+    gfx_quantize_unorm8(src.data(), unorm8.data(), count);
+    gfx_quantize_snorm16(src.data(), snorm16.data(), count);
+    gfx_quantize_unorm16(src.data(), unorm16.data(), count);
+
+    for (usize i = 0; i < count; ++i)
+    {
+        EXPECT_EQ(snorm8[i], std::lrint(clamp(src[i], -1.0f, 1.0f) * 127.0f)) << "at " << i;
+        EXPECT_EQ(unorm8[i], std::lrint(clamp(src[i], 0.0f, 1.0f) * 255.0f)) << "at " << i;
+        EXPECT_EQ(snorm16[i], std::lrint(clamp(src[i], -1.0f, 1.0f) * 32767.0f)) << "at " << i;
+        EXPECT_EQ(unorm16[i], std::lrint(clamp(src[i], 0.0f, 1.0f) * 65535.0f)) << "at " << i;
+    }
+
+    EXPECT_EQ(snorm8[0], -127);
+    EXPECT_EQ(snorm8[count - 1], 127);
+    EXPECT_EQ(unorm16[count - 1], 65535);
+    EXPECT_EQ(snorm16[5], -32767);
+    EXPECT_EQ(unorm8[5], 0);
+}
+
+TEST(gfx_quantize, tangents_pack_10_10_10_2)
+{
+    const f32 src[] = {
+        1.0f, 0.0f, -1.0f, -1.0f,
+        0.5f, -0.5f, 2.0f, 1.0f,
+        0.0f, 0.0f, 1.0f, 0.0f,
+        -0.25f, 0.75f, 0.0f, -0.4f,
+        1.0f, 0.0f, -1.0f, -1.0f,
+    };
+    u32 dst[5]{};
+    gfx_quantize_snorm_10_10_10_2(src, dst, 5);
+
+    const u32 first = 0x1ffu | (0x000u << 10) | (0x201u << 20) | (0x3u << 30);
+    EXPECT_EQ(dst[0], first);
+    EXPECT_EQ(dst[4], first);
+
+    // Sign extend each field back and check it lands on the nearest step
+    for (usize i = 0; i < 5; ++i)
+    {
+        for (u32 c = 0; c < 3; ++c)
+        {
+            const i32 field = static_cast<i32>(dst[i] << (22 - c * 10)) >> 22;
+            EXPECT_EQ(field, std::lrint(clamp(src[i * 4 + c], -1.0f, 1.0f) * 511.0f)) << "vertex " << i << ", component " << c;
+        }
+        EXPECT_EQ(static_cast<i32>(dst[i]) >> 30, std::lrint(src[i * 4 + 3])) << "vertex " << i;
+    }
+}
+
+TEST(gfx_quantize, positions_map_the_bounds_to_unorm16)
+{
+    const f32 min[3] = { -1.0f, 0.0f, 5.0f };
+    const f32 max[3] = { 1.0f, 10.0f, 5.0f };
+    const f32 src[] = {
+        -1.0f, 0.0f, 5.0f,
+        1.0f, 10.0f, 5.0f,
+        0.0f, 5.0f, 5.0f,
+        2.0f, -3.0f, 7.0f,
+        -0.5f, 2.5f, 5.0f,
+    };
+    u16 dst[5 * 4]{};
+    gfx_quantize_positions(src, dst, 5, min, max);
+
+    const u16 expected[] = {
+        0, 0, 0, 65535,
+        65535, 65535, 0, 65535,
+        32768, 32768, 0, 65535,
+        65535, 0, 0, 65535,
+        16384, 16384, 0, 65535,
+    };
+    for (usize i = 0; i < 5 * 4; ++i)
+        EXPECT_EQ(dst[i], expected[i]) << "vertex " << i / 4 << ", component " << i % 4;
+}
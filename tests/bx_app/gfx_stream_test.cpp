@@ -0,0 +1,206 @@
+#include <gtest/gtest.h>
+#include <bx/app.hpp>
+
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace bx;
+
+//
+// Texture streaming against the Null backend. The load callbacks run on the
+// streaming workers, they only record which mip of which texture was asked for.
+//
+static std::mutex g_loads_mutex;
+static std::vector<std::pair<u32, u32>> g_loads; // texture id, mip
+
+static bool load_mip(vptr user, u32 mip, u8* dst, u64 size)
+{
+    std::memset(dst, static_cast<int>(mip), static_cast<usize>(size));
+
+    std::lock_guard<std::mutex> lock(g_loads_mutex);
+    g_loads.emplace_back(static_cast<u32>(reinterpret_cast<uptr>(user)), mip);
+    return true;
+}
+
+class gfx_stream : public ::testing::Test
+{
+protected:
+    // 64x64 RGBA8 with a full chain, mips of 16384 down to 4 bytes
+    static constexpr u32 mip_levels = 7;
+    static constexpr u64 chain_bytes = 16384 + 4096 + 1024 + 256 + 64 + 16 + 4;
+
+    void SetUp() override
+    {
+        app_config_t config{};
+        config.width = 64;
+        config.height = 64;
+        config.title = "bx_tests";
+        config.watch_files = false;
+        ASSERT_EQ(app_init(config), result_t::OK);
+
+        gfx_stream_set_budget(gfx_stream_budget_t{});
+        clear_loads();
+    }
+
+    void TearDown() override
+    {
+        app_shutdown();
+        gfx_stream_set_budget(gfx_stream_budget_t{});
+    }
+
+    static handle_id stream_texture(u32 id)
+    {
+        gfx_stream_texture_desc_t desc{};
+        desc.texture.name = "test_stream";
+        desc.texture.format = gfx_texture_format_t::RGBA8U_NORM;
+        desc.texture.width = 64;
+        desc.texture.height = 64;
+        desc.texture.mip_levels = mip_levels;
+        desc.load = load_mip;
+        desc.user = reinterpret_cast<vptr>(static_cast<uptr>(id));
+        return gfx_stream_texture(desc);
+    }
+
+    static std::vector<std::pair<u32, u32>> loads()
+    {
+        std::lock_guard<std::mutex> lock(g_loads_mutex);
+        return g_loads;
+    }
+
+    static void clear_loads()
+    {
+        std::lock_guard<std::mutex> lock(g_loads_mutex);
+        g_loads.clear();
+    }
+
+    static std::vector<u32> loads_of(u32 id)
+    {
+        std::vector<u32> mips;
+        for (const auto& load : loads())
+        {
+            if (load.first == id)
+                mips.push_back(load.second);
+        }
+        return mips;
+    }
+
+    // Runs frames until nothing is loading or waiting for upload, calling request before each
+    template <typename Fn>
+    static bool settle(Fn&& request, std::vector<u64>* uploads = nullptr)
+    {
+        for (u32 frame = 0; frame < 1000; ++frame)
+        {
+            request();
+            app_begin_frame();
+            app_end_frame(true, false);
+
+            const gfx_stream_stats_t stats = gfx_stream_get_stats();
+            if (uploads)
+                uploads->push_back(stats.uploaded_bytes);
+            if (stats.loading == 0)
+                return true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return false;
+    }
+
+    template <typename Fn>
+    static void run_frames(u32 count, Fn&& request)
+    {
+        for (u32 frame = 0; frame < count; ++frame)
+        {
+            request();
+            app_begin_frame();
+            app_end_frame(true, false);
+        }
+    }
+};
+
+constexpr u32 gfx_stream::mip_levels;
+constexpr u64 gfx_stream::chain_bytes;
+
+TEST_F(gfx_stream, uploads_coarse_to_fine_within_the_frame_budget)
+{
+    gfx_stream_budget_t budget{};
+    budget.upload_bytes_per_frame = 4096;
+    gfx_stream_set_budget(budget);
+
+    const handle_id a = stream_texture(1);
+    const handle_id b = stream_texture(2);
+    ASSERT_NE(a, invalid_handle);
+    ASSERT_NE(b, invalid_handle);
+
+    std::vector<u64> uploads;
+    ASSERT_TRUE(settle([&] { gfx_stream_request(a, 0); gfx_stream_request(b, 0); }, &uploads));
+
+    // Each chain grows one mip at a time from the coarse end
+    for (const u32 id : { 1u, 2u })
+    {
+        const std::vector<u32> mips = loads_of(id);
+        ASSERT_EQ(mips.size(), mip_levels) << "texture " << id;
+        for (u32 i = 0; i < mip_levels; ++i)
+            EXPECT_EQ(mips[i], mip_levels - 1 - i) << "texture " << id;
+    }
+
+    // Over the budget only when a single mip is larger than it
+    u64 total = 0;
+    for (const u64 bytes : uploads)
+    {
+        EXPECT_TRUE(bytes <= budget.upload_bytes_per_frame || bytes == 16384) << bytes;
+        total += bytes;
+    }
+    EXPECT_EQ(total, 2 * chain_bytes);
+    EXPECT_EQ(gfx_stream_get_stats().resident_bytes, 2 * chain_bytes);
+}
+
+TEST_F(gfx_stream, trims_the_least_recently_requested_texture)
+{
+    const handle_id a = stream_texture(1);
+    const handle_id b = stream_texture(2);
+    ASSERT_TRUE(settle([&] { gfx_stream_request(a, 0); gfx_stream_request(b, 0); }));
+    ASSERT_EQ(gfx_stream_get_stats().resident_bytes, 2 * chain_bytes);
+
+    // Room for one full chain and the other without its finest mip
+    gfx_stream_budget_t budget{};
+    budget.resident_bytes = 2 * chain_bytes - 16384;
+    gfx_stream_set_budget(budget);
+    clear_loads();
+
+    run_frames(4, [&] { gfx_stream_request(b, 0); });
+
+    const gfx_stream_stats_t stats = gfx_stream_get_stats();
+    EXPECT_EQ(stats.evicted_mips, 1u);
+    EXPECT_EQ(stats.resident_bytes, budget.resident_bytes);
+
+    // The texture still in use kept its chain, nothing loads again
+    ASSERT_TRUE(settle([&] { gfx_stream_request(b, 0); }));
+    EXPECT_TRUE(loads().empty());
+}
+
+TEST_F(gfx_stream, reloads_a_trimmed_mip_when_requested_again)
+{
+    const handle_id a = stream_texture(1);
+    const handle_id b = stream_texture(2);
+    ASSERT_TRUE(settle([&] { gfx_stream_request(a, 0); gfx_stream_request(b, 0); }));
+
+    gfx_stream_budget_t budget{};
+    budget.resident_bytes = 2 * chain_bytes - 16384;
+    gfx_stream_set_budget(budget);
+    run_frames(4, [&] { gfx_stream_request(b, 0); });
+    ASSERT_EQ(gfx_stream_get_stats().evicted_mips, 1u);
+
+    // With the room back, asking for the trimmed mip loads only that one
+    gfx_stream_set_budget(gfx_stream_budget_t{});
+    clear_loads();
+    ASSERT_TRUE(settle([&] { gfx_stream_request(a, 0); gfx_stream_request(b, 0); }));
+
+    const std::vector<std::pair<u32, u32>> reloads = loads();
+    ASSERT_EQ(reloads.size(), 1u);
+    EXPECT_EQ(reloads[0].first, 1u);
+    EXPECT_EQ(reloads[0].second, 0u);
+    EXPECT_EQ(gfx_stream_get_stats().resident_bytes, 2 * chain_bytes);
+}
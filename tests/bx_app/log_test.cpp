@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include <bx/app.hpp>
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace bx;
+
+bx_register_category(log_test, 40)
+
+//
+// Category filtering, fatal errors and asserts always reach the output
+//
+TEST(log, fatal_ignores_the_category_filter)
+{
+    bx_log_set_category_types(log_test, static_cast<log_t>(0));
+    EXPECT_DEATH(bx_fatal(log_test, "fatal {}", 42), "fatal 42");
+    bx_log_set_category_types(log_test, static_cast<log_t>(0xff));
+}
+
+TEST(log, assert_ignores_the_category_filter)
+{
+    bx_log_set_category_types(bx, static_cast<log_t>(0));
+    EXPECT_DEATH(bx_assert(false, "log_test_assert"), "Assertion failed 'log_test_assert'");
+    bx_log_set_category_types(bx, static_cast<log_t>(0xff));
+}
+
+TEST(log, register_category_rejects_a_taken_bit)
+{
+    const category_t mask = category_mask<bx_category_log_test_t>();
+    EXPECT_EQ(register_category("log_test", 40), mask);
+    EXPECT_DEATH(register_category("log_test_other", 40), "already owned by 'log_test'");
+    EXPECT_STREQ(category_name(mask), "log_test");
+}
+
+//
+// Async queue, the callback runs on the writer thread
+//
+static std::atomic<u32> g_received{ 0 };
+static std::atomic<u32> g_pongs{ 0 };
+static std::atomic<bool> g_stall{ false };
+
+static void count_callback(log_t, category_t, cstring, cstring, i32, cstring msg)
+{
+    if (std::strstr(msg, "log_test_pong"))
+    {
+        g_pongs.fetch_add(1);
+        return;
+    }
+    g_received.fetch_add(1);
+
+    // Logging and flushing from the writer, with the queue full or not
+    if (std::strstr(msg, "log_test_ping"))
+    {
+        for (u32 i = 0; i < 2000; ++i)
+            bx_info(log_test, "log_test_pong {}", i);
+        log_flush();
+    }
+
+    while (g_stall.load())
+        std::this_thread::yield();
+}
+
+class log_async : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        g_received.store(0);
+        g_pongs.store(0);
+        g_stall.store(false);
+        log_set_callback(count_callback);
+        log_set_async(true);
+    }
+
+    void TearDown() override
+    {
+        g_stall.store(false);
+        log_set_async(false);
+        log_set_callback(nullptr);
+    }
+
+    // More messages than the queue holds, from several threads at once
+    static u32 log_from_threads(u32 thread_count, u32 per_thread)
+    {
+        std::vector<std::thread> threads;
+        for (u32 t = 0; t < thread_count; ++t)
+        {
+            threads.emplace_back([t, per_thread]
+                {
+                    for (u32 i = 0; i < per_thread; ++i)
+                        bx_info(log_test, "log_test thread {} message {}", t, i);
+                });
+        }
+        for (std::thread& thread : threads)
+            thread.join();
+        return thread_count * per_thread;
+    }
+};
+
+TEST_F(log_async, overflow_from_many_producers_loses_nothing)
+{
+    const u64 dropped = log_dropped_count();
+    const u32 sent = log_from_threads(4, 1000);
+
+    log_flush();
+    EXPECT_EQ(g_received.load(), sent);
+    EXPECT_EQ(log_dropped_count(), dropped);
+}
+
+TEST_F(log_async, writer_may_log_and_flush_from_the_callback)
+{
+    bx_info(log_test, "log_test_ping");
+    log_flush();
+    EXPECT_EQ(g_received.load(), 1u);
+    EXPECT_EQ(g_pongs.load(), 2000u);
+}
+
+TEST_F(log_async, stalled_writer_drops_instead_of_blocking)
+{
+    // The first message parks the writer inside the callback
+    const u64 dropped = log_dropped_count();
+    g_stall.store(true);
+    const u32 sent = log_from_threads(4, 1000);
+
+    g_stall.store(false);
+    log_flush();
+    const u64 lost = log_dropped_count() - dropped;
+    EXPECT_GT(lost, 0u);
+    EXPECT_EQ(g_received.load() + lost, sent);
+}
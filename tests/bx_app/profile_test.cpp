@@ -0,0 +1,318 @@
+#include <gtest/gtest.h>
+#include <bx/app.hpp>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace bx;
+
+//
+// Profiler rings and exporters, recorded from short lived threads
+//
+struct exported_event_t
+{
+    std::string name;
+    u64 track{ 0 };
+    u64 begin{ 0 };
+    u64 end{ 0 };
+};
+
+static const char* g_outer = "profile_test_outer";
+static const char* g_inner = "profile_test_inner";
+
+// Two threads, each with an inner scope inside an outer one, both open at once
+static void record_nested_scopes()
+{
+    std::atomic<u32> entered{ 0 };
+    auto body = [&entered]
+        {
+            profile_t outer{ 0, g_outer, __func__, __FILE__, __LINE__ };
+            {
+                profile_t inner{ 0, g_inner, __func__, __FILE__, __LINE__ };
+                entered.fetch_add(1);
+                while (entered.load() < 2)
+                    std::this_thread::yield();
+            }
+        };
+
+    profile_start();
+    std::thread a(body);
+    std::thread b(body);
+    a.join();
+    b.join();
+    profile_stop();
+}
+
+static std::string read_file(const char* path)
+{
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+static std::string json_field(const std::string& event, const char* key)
+{
+    const std::string pattern = std::string("\"") + key + "\":";
+    const usize start = event.find(pattern);
+    if (start == std::string::npos)
+        return {};
+    usize first = start + pattern.size();
+    usize last = first;
+    if (event[first] == '"')
+        last = event.find('"', ++first);
+    else
+        last = event.find_first_of(",}", first);
+    return event.substr(first, last - first);
+}
+
+// "123.456" microseconds back to nanoseconds
+static u64 json_ns(const std::string& us)
+{
+    const usize dot = us.find('.');
+    return std::strtoull(us.substr(0, dot).c_str(), nullptr, 10) * 1000 + std::strtoull(us.substr(dot + 1).c_str(), nullptr, 10);
+}
+
+static std::vector<exported_event_t> parse_chrome(const std::string& trace)
+{
+    std::vector<exported_event_t> events;
+    std::istringstream lines(trace);
+    std::string line;
+    while (std::getline(lines, line))
+    {
+        if (json_field(line, "ph") != "X")
+            continue;
+        exported_event_t event;
+        event.name = json_field(line, "name");
+        event.track = std::strtoull(json_field(line, "tid").c_str(), nullptr, 10);
+        event.begin = json_ns(json_field(line, "ts"));
+        event.end = event.begin + json_ns(json_field(line, "dur"));
+        events.push_back(event);
+    }
+    return events;
+}
+
+struct pb_reader_t
+{
+    const u8* data;
+    const u8* end;
+
+    bool done() const { return data >= end; }
+
+    u64 varint()
+    {
+        u64 value = 0;
+        for (u32 shift = 0; data < end; shift += 7)
+        {
+            const u8 byte = *data++;
+            value |= static_cast<u64>(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+                break;
+        }
+        return value;
+    }
+
+    // Calls fn(field, value, sub) for every field, sub only set for bytes
+    template <typename Fn>
+    void fields(Fn&& fn)
+    {
+        while (!done())
+        {
+            const u64 key = varint();
+            if ((key & 7) == 2)
+            {
+                const u64 size = varint();
+                pb_reader_t sub{ data, data + size };
+                data += size;
+                fn(static_cast<u32>(key >> 3), size, &sub);
+            }
+            else
+            {
+                fn(static_cast<u32>(key >> 3), varint(), nullptr);
+            }
+        }
+    }
+};
+
+// Pairs each SLICE_BEGIN with the next SLICE_END on its track
+static std::vector<exported_event_t> parse_perfetto(const std::string& trace)
+{
+    std::vector<exported_event_t> events;
+    std::map<u64, std::vector<usize>> open;
+
+    const u8* bytes = reinterpret_cast<const u8*>(trace.data());
+    pb_reader_t reader{ bytes, bytes + trace.size() };
+    reader.fields([&](u32 field, u64, pb_reader_t* packet)
+        {
+            if (field != 1 || !packet)
+                return;
+
+            u64 ts = 0, type = 0, track = 0;
+            std::string name;
+            packet->fields([&](u32 packet_field, u64 value, pb_reader_t* sub)
+                {
+                    if (packet_field == 8)
+                        ts = value;
+                    if (packet_field != 11 || !sub)
+                        return;
+                    sub->fields([&](u32 event_field, u64 event_value, pb_reader_t* str)
+                        {
+                            if (event_field == 9)
+                                type = event_value;
+                            else if (event_field == 11)
+                                track = event_value;
+                            else if (event_field == 23 && str)
+                                name.assign(reinterpret_cast<const char*>(str->data), static_cast<usize>(event_value));
+                        });
+                });
+
+            if (type == 1)
+            {
+                exported_event_t event;
+                event.name = name;
+                event.track = track;
+                event.begin = ts;
+                open[track].push_back(events.size());
+                events.push_back(event);
+            }
+            else if (type == 2 && !open[track].empty())
+            {
+                events[open[track].back()].end = ts;
+                open[track].pop_back();
+            }
+        });
+    return events;
+}
+
+// Both threads on their own track, each inner scope inside its outer one
+static void expect_nested_scopes(const std::vector<exported_event_t>& events)
+{
+    std::map<u64, const exported_event_t*> outers;
+    std::map<u64, const exported_event_t*> inners;
+    for (const exported_event_t& event : events)
+    {
+        if (event.name == g_outer)
+            outers[event.track] = &event;
+        else if (event.name == g_inner)
+            inners[event.track] = &event;
+    }
+
+    ASSERT_EQ(outers.size(), 2u);
+    ASSERT_EQ(inners.size(), 2u);
+    for (const auto& outer : outers)
+    {
+        ASSERT_EQ(inners.count(outer.first), 1u) << "track " << outer.first;
+        const exported_event_t& inner = *inners[outer.first];
+        EXPECT_LE(outer.second->begin, inner.begin);
+        EXPECT_LE(inner.begin, inner.end);
+        EXPECT_LE(inner.end, outer.second->end);
+    }
+}
+
+TEST(profile, exited_threads_hand_their_slot_to_new_ones)
+{
+    static const char* label = "profile_test_thread_scope";
+
+    // More threads than there are slots, one after the other
+    profile_start();
+    const u32 thread_count = 100;
+    for (u32 i = 0; i < thread_count; ++i)
+    {
+        std::thread thread([]
+            {
+                profile_t scope{ 0, label, __func__, __FILE__, __LINE__ };
+            });
+        thread.join();
+    }
+    profile_stop();
+
+    u32 recorded = 0;
+    for (const profile_entry_t& entry : profile_get_entries())
+    {
+        if (entry.label == label)
+        {
+            EXPECT_NE(entry.end_ts, 0u);
+            ++recorded;
+        }
+    }
+    EXPECT_EQ(recorded, thread_count);
+}
+
+TEST(profile, chrome_export_keeps_nested_scopes_per_thread)
+{
+    record_nested_scopes();
+
+    const char* path = "bx_profile_test.json";
+    ASSERT_TRUE(profile_export(path, profile_format_t::CHROME_JSON));
+    const std::string trace = read_file(path);
+    std::remove(path);
+
+    EXPECT_EQ(trace.compare(0, 1, "{"), 0);
+    EXPECT_NE(trace.find("]}"), std::string::npos);
+    expect_nested_scopes(parse_chrome(trace));
+}
+
+TEST(profile, perfetto_export_keeps_nested_scopes_per_thread)
+{
+    record_nested_scopes();
+
+    const char* path = "bx_profile_test.pftrace";
+    ASSERT_TRUE(profile_export(path, profile_format_t::PERFETTO));
+    const std::string trace = read_file(path);
+    std::remove(path);
+
+    expect_nested_scopes(parse_perfetto(trace));
+}
+
+TEST(profile, an_entry_one_full_lap_behind_head_is_dropped)
+{
+    static const char* outer_label = "profile_test_lap_outer";
+    static const char* inner_label = "profile_test_lap_inner";
+    const u32 capacity = 1u << 14; // BX_PROFILE_CAPACITY
+
+    // The outer scope's slot is taken again by the entry recorded a full ring later
+    profile_start();
+    std::thread thread([capacity]
+        {
+            profile_t outer{ 0, outer_label, __func__, __FILE__, __LINE__ };
+            for (u32 i = 0; i < capacity; ++i)
+                profile_t inner{ 0, inner_label, __func__, __FILE__, __LINE__ };
+        });
+    thread.join();
+    profile_stop();
+
+    u32 outers = 0;
+    u32 inners = 0;
+    for (const profile_entry_t& entry : profile_get_entries())
+    {
+        if (entry.label == outer_label)
+            ++outers;
+        if (entry.label == inner_label)
+        {
+            EXPECT_NE(entry.end_ts, 0u);
+            ++inners;
+        }
+    }
+    EXPECT_EQ(outers, 0u);
+    EXPECT_EQ(inners, capacity - 1);
+
+    const char* path = "bx_profile_lap_test.json";
+    ASSERT_TRUE(profile_export(path, profile_format_t::CHROME_JSON));
+    const std::string trace = read_file(path);
+    std::remove(path);
+
+    u32 exported = 0;
+    for (const exported_event_t& event : parse_chrome(trace))
+    {
+        EXPECT_NE(event.name, outer_label);
+        exported += event.name == inner_label ? 1 : 0;
+    }
+    EXPECT_EQ(exported, capacity - 1);
+}
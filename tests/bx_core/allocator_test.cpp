@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+#include <bx/allocator.hpp>
+
+using namespace bx;
+
+//
+// heap_allocator tests
+//
+TEST(heap_allocator, honors_over_alignment)
+{
+    heap_allocator h;
+
+    for (usize align = 1; align <= 4096; align *= 2)
+    {
+        vptr p = h.allocate(24, align);
+        ASSERT_NE(p, nullptr) << align;
+        EXPECT_EQ(reinterpret_cast<uptr>(p) % align, 0u) << align;
+        EXPECT_EQ(reinterpret_cast<uptr>(p) % default_align, 0u) << align;
+        h.deallocate(p, 24);
+    }
+
+    EXPECT_EQ(h.allocate(24, 3 * default_align), nullptr);
+}
+
+//
+// linear_allocator tests
+//
+TEST(linear_allocator, bump_and_align)
+{
+    linear_allocator a;
+    ASSERT_TRUE(a.init(256));
+
+    vptr p0 = a.allocate(3, 1);
+    vptr p1 = a.allocate(8, 16);
+
+    ASSERT_NE(p0, nullptr);
+    ASSERT_NE(p1, nullptr);
+    EXPECT_EQ(reinterpret_cast<uptr>(p1) % 16, 0u);
+    EXPECT_GT(p1, p0);
+    EXPECT_LE(a.used(), 256u);
+}
+
+TEST(linear_allocator, out_of_memory)
+{
+    linear_allocator a;
+    ASSERT_TRUE(a.init(64));
+
+    EXPECT_NE(a.allocate(48, 1), nullptr);
+    EXPECT_EQ(a.allocate(32, 1), nullptr);
+    EXPECT_NE(a.allocate(16, 1), nullptr);
+}
+
+TEST(linear_allocator, free_last_and_reset)
+{
+    u8 buffer[128];
+    linear_allocator a(buffer, sizeof(buffer));
+
+    vptr p0 = a.allocate(16, 1);
+    const usize used = a.used();
+    vptr p1 = a.allocate(32, 1);
+
+    a.deallocate(p1, 32);
+    EXPECT_EQ(a.used(), used);
+
+    // Only the most recent allocation can roll back
+    a.deallocate(p0, 16);
+    EXPECT_EQ(a.used(), used);
+
+    a.reset();
+    EXPECT_EQ(a.used(), 0u);
+    EXPECT_EQ(a.allocate(16, 1), p0);
+    EXPECT_EQ(a.peak(), 48u);
+}
+
+TEST(linear_allocator, marker)
+{
+    linear_allocator a;
+    ASSERT_TRUE(a.init(128));
+
+    a.allocate(16, 1);
+    const auto marker = a.marker();
+    a.allocate(64, 1);
+    a.rewind(marker);
+
+    EXPECT_EQ(a.used(), 16u);
+}
+
+//
+// pool_allocator tests
+//
+TEST(pool_allocator, allocate_all_blocks)
+{
+    pool_allocator p;
+    ASSERT_TRUE(p.init(24, 4, 32));
+
+    vptr blocks[4];
+    for (auto& b : blocks)
+    {
+        b = p.allocate(24, 32);
+        ASSERT_NE(b, nullptr);
+        EXPECT_EQ(reinterpret_cast<uptr>(b) % 32, 0u);
+        EXPECT_TRUE(p.owns(b));
+    }
+
+    EXPECT_EQ(p.used(), 4u);
+    EXPECT_EQ(p.allocate(24, 32), nullptr);
+
+    p.deallocate(blocks[2], 24);
+    EXPECT_EQ(p.allocate(24, 32), blocks[2]);
+}
+
+TEST(pool_allocator, rejects_oversized)
+{
+    pool_allocator p;
+    ASSERT_TRUE(p.init(16, 2));
+
+    EXPECT_EQ(p.allocate(17), nullptr);
+    EXPECT_EQ(p.allocate(8, 2 * default_align), nullptr);
+    EXPECT_NE(p.allocate(16), nullptr);
+}
+
+//
+// tracking_allocator tests
+//
+TEST(tracking_allocator, counts_bytes)
+{
+    tracking_allocator<> t;
+
+    vptr a = t.allocate(100);
+    vptr b = t.allocate(50);
+    EXPECT_EQ(t.bytes(), 150u);
+    EXPECT_EQ(t.count(), 2u);
+
+    t.deallocate(a, 100);
+    EXPECT_EQ(t.bytes(), 50u);
+    EXPECT_EQ(t.peak_bytes(), 150u);
+
+    t.deallocate(b, 50);
+    EXPECT_EQ(t.bytes(), 0u);
+    EXPECT_EQ(t.total_count(), 2u);
+}
+
+TEST(tracking_allocator, wraps_reference)
+{
+    linear_allocator arena;
+    ASSERT_TRUE(arena.init(64));
+
+    tracking_allocator<allocator_ref<linear_allocator>> t{ allocator_ref<linear_allocator>(arena) };
+    EXPECT_NE(t.allocate(32, 1), nullptr);
+
+    EXPECT_EQ(t.bytes(), 32u);
+    EXPECT_EQ(arena.used(), 32u);
+}
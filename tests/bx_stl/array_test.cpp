@@ -146,4 +146,38 @@ TEST(array_view, bool_operator)
     array_view<int> v_single(single);
 
     EXPECT_TRUE(v_single);
-}
\ No newline at end of file
+}
+
+TEST(array, custom_allocator)
+{
+    tracking_allocator<> tracker;
+    {
+        array<int, allocator_ref<tracking_allocator<>>> a(tracker);
+        for (int i = 0; i < 100; ++i)
+            a.push_back(i);
+
+        EXPECT_GT(tracker.bytes(), 0u);
+        EXPECT_EQ(tracker.bytes(), a.capacity() * sizeof(int));
+    }
+    EXPECT_EQ(tracker.bytes(), 0u);
+    EXPECT_EQ(tracker.count(), 0u);
+}
+
+TEST(array, linear_allocator)
+{
+    linear_allocator arena;
+    ASSERT_TRUE(arena.init(1024));
+
+    array<u32, allocator_ref<linear_allocator>> a(arena);
+    a.reserve(16);
+    for (u32 i = 0; i < 16; ++i)
+        a.push_back(i);
+
+    EXPECT_EQ(a[15], 15u);
+    EXPECT_EQ(arena.used(), 16 * sizeof(u32));
+}
+
+TEST(array, stateless_allocator_is_free)
+{
+    EXPECT_EQ(sizeof(array<int>), sizeof(int*) + 2 * sizeof(usize));
+}
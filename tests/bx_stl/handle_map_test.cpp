@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+#include <bx/handle_map.hpp>
+
+#include <string>
+
+using namespace bx;
+
+//
+// handle_map tests
+//
+TEST(handle_map, default_constructed)
+{
+    handle_map<int> m;
+
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQ(m.size(), 0u);
+    EXPECT_EQ(m.get(invalid_handle), nullptr);
+    EXPECT_FALSE(m.remove(invalid_handle));
+}
+
+TEST(handle_map, insert_and_get)
+{
+    handle_map<int> m;
+
+    const handle_id a = m.insert(10);
+    const handle_id b = m.insert(20);
+
+    EXPECT_NE(a, invalid_handle);
+    EXPECT_NE(b, invalid_handle);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(m.size(), 2u);
+
+    ASSERT_NE(m.get(a), nullptr);
+    EXPECT_EQ(*m.get(a), 10);
+    EXPECT_EQ(*m.get(b), 20);
+}
+
+TEST(handle_map, handle_layout)
+{
+    handle_map<int> m;
+
+    const handle_id h = m.insert(1);
+
+    // Index in the low half, odd generation in the high half
+    EXPECT_EQ(handle_map<int>::handle_index(h), 0u);
+    EXPECT_EQ(handle_map<int>::handle_generation(h) & 1u, 1u);
+}
+
+TEST(handle_map, stale_handle_fails)
+{
+    handle_map<int> m;
+
+    const handle_id a = m.insert(1);
+    EXPECT_TRUE(m.remove(a));
+    EXPECT_EQ(m.get(a), nullptr);
+    EXPECT_FALSE(m.remove(a));
+
+    // Slot is reused, old handle must not alias the new object
+    const handle_id b = m.insert(2);
+    EXPECT_EQ(handle_map<int>::handle_index(a), handle_map<int>::handle_index(b));
+    EXPECT_NE(a, b);
+    EXPECT_EQ(m.get(a), nullptr);
+    EXPECT_EQ(*m.get(b), 2);
+}
+
+TEST(handle_map, freed_slot_handle_fails)
+{
+    handle_map<int> m;
+
+    const handle_id a = m.insert(1);
+    m.remove(a);
+
+    // A forged handle carrying the free slot's generation is rejected too
+    const handle_id forged = handle_map<int>::make_handle(
+        handle_map<int>::handle_index(a), handle_map<int>::handle_generation(a) + 1);
+    EXPECT_EQ(m.get(forged), nullptr);
+}
+
+TEST(handle_map, remove_keeps_storage_dense)
+{
+    handle_map<std::string> m;
+
+    const handle_id a = m.insert("a");
+    const handle_id b = m.insert("b");
+    const handle_id c = m.insert("c");
+
+    m.remove(a);
+
+    EXPECT_EQ(m.size(), 2u);
+    EXPECT_EQ(*m.get(b), "b");
+    EXPECT_EQ(*m.get(c), "c");
+
+    usize count = 0;
+    for (const auto& s : m)
+    {
+        EXPECT_NE(s, "a");
+        ++count;
+    }
+    EXPECT_EQ(count, 2u);
+
+    for (usize i = 0; i < m.size(); ++i)
+        EXPECT_EQ(m.get(m.handle_at(i)), m.data() + i);
+}
+
+TEST(handle_map, clear)
+{
+    handle_map<int> m;
+
+    const handle_id a = m.insert(1);
+    m.insert(2);
+    m.clear();
+
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQ(m.get(a), nullptr);
+
+    const handle_id c = m.insert(3);
+    EXPECT_EQ(*m.get(c), 3);
+}
+
+TEST(handle_map, move_semantics)
+{
+    handle_map<int> a;
+    const handle_id h = a.insert(42);
+
+    handle_map<int> b = std::move(a);
+
+    EXPECT_EQ(b.size(), 1u);
+    EXPECT_EQ(*b.get(h), 42);
+    EXPECT_TRUE(a.empty());
+    EXPECT_EQ(a.get(h), nullptr);
+
+    const handle_id n = a.insert(7);
+    EXPECT_EQ(*a.get(n), 7);
+}
+
+TEST(handle_map, inserts_grow_storage_geometrically)
+{
+    handle_map<int> m;
+
+    const int count = 100000;
+    usize growths = 0;
+    usize capacity = m.capacity();
+    for (int i = 0; i < count; ++i)
+    {
+        const handle_id h = m.insert(i);
+        ASSERT_NE(h, invalid_handle);
+        if (m.capacity() != capacity)
+        {
+            EXPECT_GE(m.capacity(), capacity * 2);
+            capacity = m.capacity();
+            ++growths;
+        }
+    }
+
+    EXPECT_EQ(m.size(), static_cast<usize>(count));
+    EXPECT_LT(growths, 20u);
+}
@@ -0,0 +1,201 @@
+#include <gtest/gtest.h>
+#include <bx/hash_map.hpp>
+
+#include <string>
+
+using namespace bx;
+
+//
+// hash_map tests
+//
+TEST(hash_map, default_constructed)
+{
+    hash_map<u64, int> m;
+
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQ(m.size(), 0u);
+    EXPECT_EQ(m.capacity(), 0u);
+    EXPECT_EQ(m.find(42), m.end());
+    EXPECT_EQ(m.get(42), nullptr);
+    EXPECT_FALSE(m.erase(42));
+    EXPECT_EQ(m.begin(), m.end());
+}
+
+TEST(hash_map, insert_and_find)
+{
+    hash_map<u64, int> m;
+
+    m.insert(1, 10);
+    m.insert(2, 20);
+    m.emplace(3, 30);
+
+    EXPECT_EQ(m.size(), 3u);
+    ASSERT_NE(m.find(2), m.end());
+    EXPECT_EQ(m.find(2)->second, 20);
+    ASSERT_NE(m.get(3), nullptr);
+    EXPECT_EQ(*m.get(3), 30);
+    EXPECT_TRUE(m.contains(1));
+    EXPECT_FALSE(m.contains(4));
+}
+
+TEST(hash_map, insert_does_not_overwrite)
+{
+    hash_map<u64, int> m;
+
+    m.insert(7, 1);
+    auto it = m.insert(7, 2);
+
+    EXPECT_EQ(m.size(), 1u);
+    EXPECT_EQ(it->second, 1);
+
+    m.insert_or_assign(7, 3);
+    EXPECT_EQ(m.size(), 1u);
+    EXPECT_EQ(*m.get(7), 3);
+}
+
+TEST(hash_map, grow_keeps_entries)
+{
+    hash_map<u64, u64> m;
+
+    for (u64 i = 0; i < 10000; ++i)
+        m.insert(i, i * 2);
+
+    EXPECT_EQ(m.size(), 10000u);
+    EXPECT_LE(m.size() * 8, m.capacity() * 7);
+
+    for (u64 i = 0; i < 10000; ++i)
+    {
+        ASSERT_NE(m.get(i), nullptr);
+        EXPECT_EQ(*m.get(i), i * 2);
+    }
+    EXPECT_FALSE(m.contains(10000));
+}
+
+TEST(hash_map, erase_shifts_probe_run)
+{
+    hash_map<u64, u64> m;
+
+    for (u64 i = 0; i < 2000; ++i)
+        m.insert(i, i);
+
+    // Remove every other key, the rest must stay reachable without tombstones
+    for (u64 i = 0; i < 2000; i += 2)
+        EXPECT_TRUE(m.erase(i));
+
+    EXPECT_EQ(m.size(), 1000u);
+    for (u64 i = 0; i < 2000; ++i)
+        EXPECT_EQ(m.contains(i), (i % 2) == 1);
+
+    // Reinsert into the freed slots
+    for (u64 i = 0; i < 2000; i += 2)
+        m.insert(i, i + 1);
+
+    EXPECT_EQ(m.size(), 2000u);
+    EXPECT_EQ(*m.get(10), 11u);
+}
+
+TEST(hash_map, reserve)
+{
+    hash_map<u64, int> m;
+
+    EXPECT_TRUE(m.reserve(100));
+    const usize capacity = m.capacity();
+    EXPECT_GE(capacity * 7 / 8, 100u);
+
+    for (u64 i = 0; i < 100; ++i)
+        m.insert(i, 0);
+
+    EXPECT_EQ(m.capacity(), capacity);
+}
+
+TEST(hash_map, iteration)
+{
+    hash_map<u64, u64> m;
+
+    for (u64 i = 1; i <= 100; ++i)
+        m.insert(i, i);
+
+    u64 sum = 0;
+    usize count = 0;
+    for (const auto& e : m)
+    {
+        EXPECT_EQ(e.first, e.second);
+        sum += e.second;
+        ++count;
+    }
+
+    EXPECT_EQ(count, 100u);
+    EXPECT_EQ(sum, 5050u);
+}
+
+TEST(hash_map, clear)
+{
+    hash_map<u64, int> m;
+    m.insert(1, 1);
+    m.insert(2, 2);
+
+    m.clear();
+
+    EXPECT_TRUE(m.empty());
+    EXPECT_FALSE(m.contains(1));
+    EXPECT_EQ(m.begin(), m.end());
+
+    m.insert(3, 3);
+    EXPECT_EQ(*m.get(3), 3);
+}
+
+TEST(hash_map, move_semantics)
+{
+    hash_map<u64, int> a;
+    a.insert(42, 1);
+
+    hash_map<u64, int> b = std::move(a);
+
+    EXPECT_EQ(b.size(), 1u);
+    EXPECT_EQ(*b.get(42), 1);
+    EXPECT_TRUE(a.empty());
+    EXPECT_FALSE(a.contains(42));
+
+    a = std::move(b);
+    EXPECT_EQ(*a.get(42), 1);
+    EXPECT_TRUE(b.empty());
+}
+
+TEST(hash_map, non_trivial_values)
+{
+    hash_map<std::string, std::string> m;
+
+    for (int i = 0; i < 200; ++i)
+        m.insert(std::to_string(i), std::string(64, static_cast<char>('a' + i % 26)));
+
+    for (int i = 0; i < 200; i += 3)
+        EXPECT_TRUE(m.erase(std::to_string(i)));
+
+    for (int i = 0; i < 200; ++i)
+    {
+        const auto* v = m.get(std::to_string(i));
+        if (i % 3 == 0)
+        {
+            EXPECT_EQ(v, nullptr);
+        }
+        else
+        {
+            ASSERT_NE(v, nullptr);
+            EXPECT_EQ((*v)[0], static_cast<char>('a' + i % 26));
+        }
+    }
+}
+
+TEST(hash_map, custom_allocator)
+{
+    tracking_allocator<> tracker;
+    {
+        hash_map<u64, u64, hash<u64>, allocator_ref<tracking_allocator<>>> m(tracker);
+        for (u64 i = 0; i < 1000; ++i)
+            m.insert(i, i);
+
+        EXPECT_EQ(tracker.count(), 1u);
+        EXPECT_EQ(*m.get(999), 999u);
+    }
+    EXPECT_EQ(tracker.bytes(), 0u);
+}
@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include <bx/string.hpp>
+#include <bx/hash_map.hpp>
+
+#include <utility>
+
+using namespace bx;
+
+//
+// string tests
+//
+TEST(string, default_constructed)
+{
+    string s;
+
+    EXPECT_TRUE(s.empty());
+    EXPECT_EQ(s.size(), 0u);
+    EXPECT_EQ(s.capacity(), string::inline_capacity());
+    EXPECT_STREQ(s.c_str(), "");
+}
+
+TEST(string, inline_storage)
+{
+    string s = "12345678901234567890123";
+
+    EXPECT_EQ(s.size(), 23u);
+    EXPECT_EQ(s.capacity(), string::inline_capacity());
+    EXPECT_GE(s.data(), reinterpret_cast<const char*>(&s));
+    EXPECT_LT(s.data(), reinterpret_cast<const char*>(&s + 1));
+    EXPECT_STREQ(s.c_str(), "12345678901234567890123");
+}
+
+TEST(string, heap_storage)
+{
+    string s = "12345678901234567890123";
+    s.push_back('4');
+
+    EXPECT_EQ(s.size(), 24u);
+    EXPECT_GT(s.capacity(), string::inline_capacity());
+    EXPECT_STREQ(s.c_str(), "123456789012345678901234");
+}
+
+TEST(string, append)
+{
+    string s;
+    for (int i = 0; i < 100; ++i)
+        s += "ab";
+
+    EXPECT_EQ(s.size(), 200u);
+    EXPECT_EQ(s[0], 'a');
+    EXPECT_EQ(s[199], 'b');
+    EXPECT_EQ(s.c_str()[200], '\0');
+
+    // Appending from itself must survive the reallocation
+    s.append(s.data(), s.size());
+    EXPECT_EQ(s.size(), 400u);
+    EXPECT_EQ(s[398], 'a');
+}
+
+TEST(string, copy_and_move)
+{
+    string a = "a string long enough to live on the heap";
+    string b = a;
+
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a.data(), b.data());
+
+    const char* heap = a.data();
+    string c = std::move(a);
+    EXPECT_EQ(c.data(), heap);
+    EXPECT_TRUE(a.empty());
+
+    string d = "short";
+    string e = std::move(d);
+    EXPECT_EQ(e, "short");
+    EXPECT_TRUE(d.empty());
+
+    e = std::move(c);
+    EXPECT_EQ(e, b);
+}
+
+TEST(string, resize_and_clear)
+{
+    string s = "abc";
+    s.resize(6, 'x');
+    EXPECT_EQ(s, "abcxxx");
+
+    s.resize(2);
+    EXPECT_EQ(s, "ab");
+
+    s.clear();
+    EXPECT_TRUE(s.empty());
+    EXPECT_STREQ(s.c_str(), "");
+}
+
+TEST(string, hash_map_key)
+{
+    hash_map<string, int> m;
+    m.insert("short", 1);
+    m.insert("a key that does not fit inline", 2);
+
+    EXPECT_EQ(*m.get("short"), 1);
+    EXPECT_EQ(*m.get("a key that does not fit inline"), 2);
+    EXPECT_FALSE(m.contains("missing"));
+}
+
+//
+// string_fixed tests
+//
+TEST(string_fixed, assign_and_append)
+{
+    string_fixed<16> s = "hello";
+
+    EXPECT_EQ(s.size(), 5u);
+    EXPECT_TRUE(s.append(", world"));
+    EXPECT_EQ(s, "hello, world");
+    EXPECT_EQ(string_fixed<16>::capacity(), 15u);
+}
+
+TEST(string_fixed, truncation)
+{
+    string_fixed<8> s;
+
+    EXPECT_FALSE(s.assign("0123456789"));
+    EXPECT_EQ(s.size(), 7u);
+    EXPECT_EQ(s, "0123456");
+
+    EXPECT_FALSE(s.push_back('x'));
+    EXPECT_EQ(s.size(), 7u);
+    EXPECT_EQ(s.c_str()[7], '\0');
+}
+
+TEST(string_fixed, format)
+{
+    string_fixed<32> s;
+
+    EXPECT_TRUE(s.format("%d-%s", 42, "abc"));
+    EXPECT_EQ(s, "42-abc");
+
+    EXPECT_TRUE(s.append_format("/%u", 7u));
+    EXPECT_EQ(s, "42-abc/7");
+
+    string_fixed<8> t;
+    EXPECT_FALSE(t.format("%s", "too long for this"));
+    EXPECT_EQ(t, "too lon");
+}
+
+TEST(string, custom_allocator)
+{
+    tracking_allocator<> tracker;
+    {
+        basic_string<allocator_ref<tracking_allocator<>>> s(tracker);
+        s = "short";
+        EXPECT_EQ(tracker.count(), 0u);
+
+        s += " but now it is long enough to need the heap";
+        EXPECT_EQ(tracker.count(), 1u);
+        EXPECT_EQ(s, "short but now it is long enough to need the heap");
+    }
+    EXPECT_EQ(tracker.bytes(), 0u);
+}